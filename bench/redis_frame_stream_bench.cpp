@@ -0,0 +1,223 @@
+// Publishes frames at the agent's tick cadence against a live redis-server (with the RedisTimeSeries
+// module) and compares two consumers that want every complete frame: one polls TS.MGET over the
+// node's labelled series, the other XREAD BLOCKs on <prefix>:frames and decodes the binary frame.
+// Reports frames seen, consumer CPU per frame and publish-to-consume latency for each.
+//
+//   cmake -DBUILD_HW_AGENT_BENCHMARKS=ON ..
+//   ./hw_agent_frame_stream_bench [host] [port] [ticks] [tick_ms] [poll_ms]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <hiredis/hiredis.h>
+
+#include "core/timestamp.hpp"
+#include "model/frame_codec.hpp"
+#include "model/signal_frame.hpp"
+#include "sinks/redis_ts.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kPrefix = "edge:bench";
+
+struct Settings {
+  std::string host{"127.0.0.1"};
+  int port{6379};
+  long ticks{600};
+  long tick_ms{100};
+  // TS.MGET interval of the polling consumer.
+  long poll_ms{100};
+};
+
+struct ConsumerResult {
+  std::size_t frames{0};
+  double cpu_ms{0.0};
+  std::vector<double> latency_ms{};
+};
+
+double percentile(std::vector<double> values, const double quantile) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  const auto rank = static_cast<std::size_t>(quantile * static_cast<double>(values.size() - 1));
+  return values[rank];
+}
+
+double thread_cpu_ms() {
+  timespec now{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return (static_cast<double>(now.tv_sec) * 1e3) + (static_cast<double>(now.tv_nsec) / 1e6);
+}
+
+double unix_ms_now() { return static_cast<double>(hw_agent::core::unix_timestamp_now_ns()) / 1e6; }
+
+redisContext* connect(const Settings& settings) {
+  timeval timeout{2, 0};
+  redisContext* context = redisConnectWithTimeout(settings.host.c_str(), settings.port, timeout);
+  if (context != nullptr && context->err != REDIS_OK) {
+    redisFree(context);
+    return nullptr;
+  }
+  return context;
+}
+
+// TS.MGET FILTER node=<prefix>: one reply with every series' latest sample; a new frame is seen
+// when the newest sample timestamp moves.
+void poll_series(const Settings& settings, const std::atomic<bool>& stop, ConsumerResult& result) {
+  redisContext* context = connect(settings);
+  if (context == nullptr) {
+    return;
+  }
+  const std::string filter = std::string("node=") + kPrefix;
+  long long last_seen = 0;
+  const double cpu_start = thread_cpu_ms();
+  while (!stop.load(std::memory_order_relaxed)) {
+    auto* reply = static_cast<redisReply*>(redisCommand(context, "TS.MGET FILTER %s", filter.c_str()));
+    if (reply == nullptr) {
+      break;
+    }
+    long long newest = 0;
+    for (std::size_t i = 0; reply->type == REDIS_REPLY_ARRAY && i < reply->elements; ++i) {
+      const redisReply* series = reply->element[i];
+      if (series->type != REDIS_REPLY_ARRAY || series->elements < 3) {
+        continue;
+      }
+      const redisReply* sample = series->element[2];
+      if (sample->type == REDIS_REPLY_ARRAY && sample->elements == 2) {
+        newest = std::max(newest, sample->element[0]->integer);
+      }
+    }
+    freeReplyObject(reply);
+    if (newest > last_seen) {
+      last_seen = newest;
+      ++result.frames;
+      result.latency_ms.push_back(unix_ms_now() - static_cast<double>(newest));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(settings.poll_ms));
+  }
+  result.cpu_ms = thread_cpu_ms() - cpu_start;
+  redisFree(context);
+}
+
+// XREAD BLOCK on <prefix>:frames: woken per entry, each decoded into a signal_frame.
+void read_stream(const Settings& settings, const std::atomic<bool>& stop, ConsumerResult& result) {
+  redisContext* context = connect(settings);
+  if (context == nullptr) {
+    return;
+  }
+  const std::string stream = std::string(kPrefix) + ":frames";
+  std::string last_id = "$";
+  hw_agent::model::signal_frame frame{};
+  const double cpu_start = thread_cpu_ms();
+  while (!stop.load(std::memory_order_relaxed)) {
+    auto* reply = static_cast<redisReply*>(
+        redisCommand(context, "XREAD COUNT 100 BLOCK 200 STREAMS %s %s", stream.c_str(), last_id.c_str()));
+    if (reply == nullptr) {
+      break;
+    }
+    // [[stream, [[id, [field, value]], ...]]]
+    if (reply->type == REDIS_REPLY_ARRAY && reply->elements == 1 && reply->element[0]->elements == 2) {
+      const redisReply* entries = reply->element[0]->element[1];
+      for (std::size_t i = 0; i < entries->elements; ++i) {
+        const redisReply* entry = entries->element[i];
+        const redisReply* fields = entry->element[1];
+        std::uint64_t unix_ms = 0;
+        if (fields->elements == 2 &&
+            hw_agent::model::decode_frame(fields->element[1]->str, fields->element[1]->len, frame, unix_ms)) {
+          ++result.frames;
+          result.latency_ms.push_back(unix_ms_now() - static_cast<double>(unix_ms));
+        }
+        last_id.assign(entry->element[0]->str, entry->element[0]->len);
+      }
+    }
+    freeReplyObject(reply);
+  }
+  result.cpu_ms = thread_cpu_ms() - cpu_start;
+  redisFree(context);
+}
+
+void print_result(const char* name, const ConsumerResult& result, const long ticks) {
+  const double per_frame = result.frames > 0 ? result.cpu_ms * 1e3 / static_cast<double>(result.frames) : 0.0;
+  std::printf("%-8s %8zu %8ld %14.1f %10.3f %10.3f %10.3f\n", name, result.frames,
+              std::max(0L, ticks - static_cast<long>(result.frames)), per_frame, percentile(result.latency_ms, 0.50),
+              percentile(result.latency_ms, 0.99),
+              result.latency_ms.empty() ? 0.0 : *std::max_element(result.latency_ms.begin(), result.latency_ms.end()));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings{};
+  if (argc > 1) {
+    settings.host = argv[1];
+  }
+  if (argc > 2) {
+    settings.port = std::atoi(argv[2]);
+  }
+  if (argc > 3) {
+    settings.ticks = std::strtol(argv[3], nullptr, 10);
+  }
+  if (argc > 4) {
+    settings.tick_ms = std::strtol(argv[4], nullptr, 10);
+  }
+  if (argc > 5) {
+    settings.poll_ms = std::strtol(argv[5], nullptr, 10);
+  }
+  if (settings.port <= 0 || settings.ticks <= 0 || settings.tick_ms <= 0 || settings.poll_ms <= 0) {
+    std::fprintf(stderr, "usage: %s [host] [port] [ticks] [tick_ms] [poll_ms]\n", argv[0]);
+    return 2;
+  }
+
+  hw_agent::sinks::RedisTsOptions options{};
+  options.host = settings.host;
+  options.port = static_cast<std::uint16_t>(settings.port);
+  options.key_prefix = kPrefix;
+  options.async = true;
+  hw_agent::sinks::RedisTsSink sink(options);
+  if (!sink.check_connectivity()) {
+    std::fprintf(stderr, "cannot reach redis at %s:%d\n", settings.host.c_str(), settings.port);
+    return 1;
+  }
+
+  std::atomic<bool> stop{false};
+  ConsumerResult polled{};
+  ConsumerResult streamed{};
+  std::thread poller(poll_series, std::cref(settings), std::cref(stop), std::ref(polled));
+  std::thread reader(read_stream, std::cref(settings), std::cref(stop), std::ref(streamed));
+  // Let both consumers connect before the first frame.
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  const auto tick = std::chrono::milliseconds(settings.tick_ms);
+  hw_agent::model::signal_frame frame{};
+  auto next_wakeup = Clock::now();
+  for (long i = 0; i < settings.ticks; ++i) {
+    frame.cpu = static_cast<float>(i % 100);
+    frame.agent.heartbeat_ms = static_cast<std::uint64_t>(i);
+    (void)sink.publish(frame);
+    (void)sink.publish_frame_stream(frame);
+    next_wakeup += tick;
+    sink.service_until(next_wakeup);
+  }
+  sink.service_until(Clock::now() + std::chrono::milliseconds(500));
+  stop.store(true);
+  poller.join();
+  reader.join();
+
+  std::printf("%zu-byte stream frames, %ld ticks every %ld ms, TS.MGET every %ld ms\n",
+              hw_agent::model::kEncodedFrameSize, settings.ticks, settings.tick_ms, settings.poll_ms);
+  std::printf("%-8s %8s %8s %14s %10s %10s %10s\n", "consumer", "frames", "missed", "cpu_us/frame", "lat_p50",
+              "lat_p99", "lat_max");
+  print_result("ts.mget", polled, settings.ticks);
+  print_result("xread", streamed, settings.ticks);
+  return 0;
+}
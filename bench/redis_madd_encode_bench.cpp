@@ -0,0 +1,127 @@
+// Encodes one TS.MADD frame per iteration the way the sink used to (argv strings rebuilt per tick
+// with an unordered_set lookup per metric) and with the pre-rendered MaddTemplate, and reports
+// time, heap allocations and bytes per frame.
+//
+//   cmake -DBUILD_HW_AGENT_BENCHMARKS=ON .. && ./hw_agent_madd_encode_bench [iterations]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "sinks/resp_template.hpp"
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{0};
+
+// Same shape as the default publish: 76 series under the default prefix.
+constexpr std::size_t kMetricCount = 76;
+constexpr std::uint64_t kTimestampMs = 1'700'000'000'000ULL;
+
+std::vector<std::string> metric_suffixes() {
+  std::vector<std::string> suffixes;
+  for (std::size_t i = 0; i < kMetricCount; ++i) {
+    suffixes.push_back((i < 60 ? "raw:metric_" : "derived:metric_") + std::to_string(i));
+  }
+  return suffixes;
+}
+
+double metric_value(const std::size_t metric, const long iteration) {
+  return static_cast<double>(static_cast<float>((metric * 7 + static_cast<std::size_t>(iteration)) % 1000) * 0.37F);
+}
+
+struct LegacyEncoder {
+  std::string key_prefix{"edge:node"};
+  std::vector<std::string> suffixes;
+  std::unordered_set<std::string> enabled;
+  std::vector<std::string> args;
+  std::vector<const char*> argv;
+  std::vector<std::size_t> argv_len;
+
+  std::size_t encode(const long iteration) {
+    args.clear();
+    argv.clear();
+    argv_len.clear();
+    args.emplace_back("TS.MADD");
+    for (std::size_t i = 0; i < suffixes.size(); ++i) {
+      if (enabled.find(suffixes[i].c_str()) == enabled.end()) {
+        continue;
+      }
+      args.emplace_back(key_prefix + ":" + suffixes[i]);
+      args.emplace_back(std::to_string(kTimestampMs + static_cast<std::uint64_t>(iteration)));
+      args.emplace_back(std::to_string(metric_value(i, iteration)));
+    }
+    std::size_t bytes = 0;
+    for (const auto& arg : args) {
+      argv.push_back(arg.c_str());
+      argv_len.push_back(arg.size());
+      bytes += arg.size();
+    }
+    return bytes;
+  }
+};
+
+template <typename Encode>
+void measure(const char* name, const long iterations, Encode&& encode) {
+  std::size_t bytes = encode(0);
+  const std::size_t allocations_before = g_allocations.load(std::memory_order_relaxed);
+  const auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; ++i) {
+    bytes = encode(i);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  const std::size_t allocations = g_allocations.load(std::memory_order_relaxed) - allocations_before;
+
+  const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::printf("%-10s %12.1f %14.2f %12zu\n", name, ns / static_cast<double>(iterations),
+              static_cast<double>(allocations) / static_cast<double>(iterations), bytes);
+}
+
+}  // namespace
+
+void* operator new(const std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size != 0 ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+int main(int argc, char** argv) {
+  const long iterations = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 200'000;
+  if (iterations <= 0) {
+    std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 2;
+  }
+
+  const std::vector<std::string> suffixes = metric_suffixes();
+  LegacyEncoder legacy{};
+  legacy.suffixes = suffixes;
+  legacy.enabled = std::unordered_set<std::string>(suffixes.begin(), suffixes.end());
+
+  std::vector<std::string> keys;
+  for (const std::string& suffix : suffixes) {
+    keys.push_back("edge:node:" + suffix);
+  }
+  hw_agent::sinks::MaddTemplate madd(keys);
+
+  std::printf("%-10s %12s %14s %12s\n", "encoder", "ns/frame", "allocs/frame", "bytes/frame");
+  measure("argv", iterations, [&](const long i) { return legacy.encode(i); });
+  measure("template", iterations, [&](const long i) {
+    madd.set_timestamp(kTimestampMs + static_cast<std::uint64_t>(i));
+    for (std::size_t slot = 0; slot < madd.slots(); ++slot) {
+      madd.set_value(slot, metric_value(slot, i));
+    }
+    return madd.command().size();
+  });
+  return 0;
+}
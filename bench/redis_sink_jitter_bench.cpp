@@ -0,0 +1,152 @@
+// Drives the Redis sink at the agent's tick cadence against a live redis-server (with the
+// RedisTimeSeries module) in sync and async mode and reports how much of each tick the publish
+// took and how late the loop woke up. A side connection can pause the server's clients every few
+// ticks to show what a slow Redis does to each mode.
+//
+//   cmake -DBUILD_HW_AGENT_BENCHMARKS=ON ..
+//   ./hw_agent_redis_sink_bench [host] [port] [ticks] [tick_ms] [pause_every_ticks] [pause_ms]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <hiredis/hiredis.h>
+
+#include "model/signal_frame.hpp"
+#include "sinks/redis_ts.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Settings {
+  std::string host{"127.0.0.1"};
+  int port{6379};
+  long ticks{600};
+  long tick_ms{100};
+  // CLIENT PAUSE the server every this many ticks (0 disables) for pause_ms.
+  long pause_every_ticks{50};
+  long pause_ms{250};
+};
+
+double percentile(std::vector<double> values, const double quantile) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  const auto rank = static_cast<std::size_t>(quantile * static_cast<double>(values.size() - 1));
+  return values[rank];
+}
+
+void pause_server(redisContext* control, const long pause_ms) {
+  if (control == nullptr) {
+    return;
+  }
+  const std::string timeout = std::to_string(pause_ms);
+  auto* reply = static_cast<redisReply*>(redisCommand(control, "CLIENT PAUSE %s WRITE", timeout.c_str()));
+  if (reply != nullptr) {
+    freeReplyObject(reply);
+  }
+}
+
+int run(const Settings& settings, const bool async) {
+  hw_agent::sinks::RedisTsOptions options{};
+  options.host = settings.host;
+  options.port = static_cast<std::uint16_t>(settings.port);
+  options.key_prefix = "edge:bench";
+  options.async = async;
+  hw_agent::sinks::RedisTsSink sink(options);
+  if (!sink.check_connectivity()) {
+    std::fprintf(stderr, "%s: cannot reach redis at %s:%d\n", async ? "async" : "sync", settings.host.c_str(),
+                 settings.port);
+    return 1;
+  }
+
+  timeval timeout{1, 0};
+  redisContext* control = redisConnectWithTimeout(settings.host.c_str(), settings.port, timeout);
+  if (control != nullptr && control->err != REDIS_OK) {
+    redisFree(control);
+    control = nullptr;
+  }
+
+  const auto tick = std::chrono::milliseconds(settings.tick_ms);
+  std::vector<double> publish_ms;
+  std::vector<double> wake_late_ms;
+  publish_ms.reserve(static_cast<std::size_t>(settings.ticks));
+  wake_late_ms.reserve(static_cast<std::size_t>(settings.ticks));
+  std::size_t failed = 0;
+  std::size_t overruns = 0;
+
+  hw_agent::model::signal_frame frame{};
+  auto next_wakeup = Clock::now();
+  for (long i = 0; i < settings.ticks; ++i) {
+    const auto cycle_start = Clock::now();
+    wake_late_ms.push_back(std::chrono::duration<double, std::milli>(cycle_start - next_wakeup).count());
+
+    if (settings.pause_every_ticks > 0 && i > 0 && i % settings.pause_every_ticks == 0) {
+      pause_server(control, settings.pause_ms);
+    }
+
+    frame.cpu = static_cast<float>(i % 100);
+    frame.agent.heartbeat_ms = static_cast<std::uint64_t>(i);
+    const auto publish_start = Clock::now();
+    failed += sink.publish(frame) ? 0 : 1;
+    const auto publish_end = Clock::now();
+    publish_ms.push_back(std::chrono::duration<double, std::milli>(publish_end - publish_start).count());
+    if (publish_end - cycle_start > tick) {
+      ++overruns;
+    }
+
+    next_wakeup += tick;
+    sink.service_until(next_wakeup);
+  }
+
+  if (control != nullptr) {
+    redisFree(control);
+  }
+
+  std::printf("%-6s %10.3f %10.3f %10.3f %12.3f %12.3f %9zu %9zu %9u\n", async ? "async" : "sync",
+              percentile(publish_ms, 0.50), percentile(publish_ms, 0.99),
+              *std::max_element(publish_ms.begin(), publish_ms.end()), percentile(wake_late_ms, 0.99),
+              *std::max_element(wake_late_ms.begin(), wake_late_ms.end()), overruns, failed, frame.agent.redis_dropped);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings{};
+  if (argc > 1) {
+    settings.host = argv[1];
+  }
+  if (argc > 2) {
+    settings.port = std::atoi(argv[2]);
+  }
+  if (argc > 3) {
+    settings.ticks = std::strtol(argv[3], nullptr, 10);
+  }
+  if (argc > 4) {
+    settings.tick_ms = std::strtol(argv[4], nullptr, 10);
+  }
+  if (argc > 5) {
+    settings.pause_every_ticks = std::strtol(argv[5], nullptr, 10);
+  }
+  if (argc > 6) {
+    settings.pause_ms = std::strtol(argv[6], nullptr, 10);
+  }
+  if (settings.port <= 0 || settings.ticks <= 0 || settings.tick_ms <= 0 || settings.pause_every_ticks < 0 ||
+      settings.pause_ms < 0) {
+    std::fprintf(stderr, "usage: %s [host] [port] [ticks] [tick_ms] [pause_every_ticks] [pause_ms]\n", argv[0]);
+    return 2;
+  }
+
+  std::printf("%-6s %10s %10s %10s %12s %12s %9s %9s %9s\n", "mode", "pub_p50", "pub_p99", "pub_max",
+              "late_p99", "late_max", "overruns", "failed", "dropped");
+  if (int rc = run(settings, false); rc != 0) {
+    return rc;
+  }
+  return run(settings, true);
+}
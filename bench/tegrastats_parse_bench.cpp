@@ -0,0 +1,113 @@
+// Parses recorded tegrastats lines from several Jetson generations in a tight loop and reports
+// throughput and heap allocations per line.
+//
+//   cmake -DBUILD_HW_AGENT_BENCHMARKS=ON .. && ./hw_agent_tegrastats_bench [iterations]
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+
+#include "sensors/tegrastats.hpp"
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{0};
+
+struct Recording {
+  const char* board;
+  std::string_view line;
+};
+
+constexpr std::array<Recording, 6> kRecordings = {{
+    {"Nano (L4T 32)",
+     "RAM 2337/3964MB (lfb 4x2MB) SWAP 0/1982MB (cached 0MB) CPU [17%@1479,12%@1479,9%@1479,11%@1479] "
+     "EMC_FREQ 9%@1600 GR3D_FREQ 0%@921 APE 25 PLL@31C CPU@33.5C PMIC@100C GPU@32C AO@40C thermal@32.75C "
+     "POM_5V_IN 2962/2962 POM_5V_GPU 78/78 POM_5V_CPU 627/627"},
+    {"TX2 (L4T 32)",
+     "RAM 2041/7851MB (lfb 1051x4MB) SWAP 0/3926MB (cached 0MB) CPU [3%@345,off,off,1%@345,1%@345,0%@345] "
+     "EMC_FREQ 3%@1866 GR3D_FREQ 0%@114 APE 150 PLL@38C MCPU@38C PMIC@100C Tboard@33C GPU@36C BCPU@38C "
+     "thermal@37.1C Tdiode@35.75C VDD_SYS_GPU 152/152 VDD_SYS_SOC 686/686 VDD_4V0_WIFI 0/0 VDD_IN 2631/2631 "
+     "VDD_SYS_CPU 152/152 VDD_SYS_DDR 520/520"},
+    {"Xavier NX (L4T 32)",
+     "RAM 2462/7772MB (lfb 867x4MB) SWAP 0/3886MB (cached 0MB) CPU [6%@1190,3%@1190,2%@1190,4%@1190,off,off] "
+     "EMC_FREQ 0% GR3D_FREQ 0% AUX@32.5C CPU@34.5C thermal@33.3C AO@32.5C GPU@33C PMIC@100C VDD_IN 4139/4139 "
+     "VDD_CPU_GPU_CV 572/572 VDD_SOC 1227/1227"},
+    {"AGX Xavier (L4T 32)",
+     "RAM 3307/31919MB (lfb 6609x4MB) SWAP 0/15959MB (cached 0MB) "
+     "CPU [2%@1190,1%@1190,0%@1190,0%@1190,0%@1190,0%@1190,1%@1190,0%@1190] EMC_FREQ 0%@2133 GR3D_FREQ 0%@1377 "
+     "APE 150 MTS fg 0% bg 0% AO@32C GPU@32C Tdiode@35.5C PMIC@100C AUX@31.5C CPU@33C thermal@32.4C Tboard@32C "
+     "GPU 0/0 CPU 310/310 SOC 1084/1084 CV 0/0 VDDRQ 155/155 SYS5V 1991/1991"},
+    {"AGX Orin (L4T 35)",
+     "08-21-2024 10:15:02 RAM 5243/30536MB (lfb 5391x4MB) SWAP 0/15268MB (cached 0MB) "
+     "CPU [1%@729,0%@729,0%@729,0%@729,0%@729,0%@729,0%@729,0%@729,0%@729,0%@729,0%@729,0%@729] "
+     "EMC_FREQ 0%@2133 GR3D_FREQ 0%@[0,0] VIC_FREQ 729 APE 174 CV0@-256C CPU@46.5C Tboard@35C SOC2@42.312C "
+     "Tdiode@37.75C SOC0@43.937C CV1@-256C GPU@-256C tj@46.5C SOC1@42.562C CV2@-256C VDD_GPU_SOC 3987mW/3987mW "
+     "VDD_CPU_CV 797mW/797mW VIN_SYS_5V0 4322mW/4322mW NC 0mW/0mW VDDQ_VDD2_1V8AO 502mW/502mW NC 0mW/0mW"},
+    {"Orin Nano (L4T 36)",
+     "10-02-2024 16:40:11 RAM 3102/7620MB (lfb 2x4MB) SWAP 0/3810MB (cached 0MB) "
+     "CPU [4%@1510,2%@1510,1%@1510,3%@1510,0%@729,0%@729] EMC_FREQ 5%@2133 GR3D_FREQ 37%@[624] "
+     "cpu@47.343C soc2@45.375C soc0@46.187C gpu@45.906C tj@47.343C soc1@45.406C VDD_IN 4628mW/4628mW "
+     "VDD_CPU_GPU_CV 593mW/593mW VDD_SOC 1344mW/1344mW"},
+}};
+
+}  // namespace
+
+void* operator new(const std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size != 0 ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+int main(int argc, char** argv) {
+  const long iterations = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 200'000;
+  if (iterations <= 0) {
+    std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 2;
+  }
+
+  hw_agent::sensors::TegraStatsSensor sensor(-1, false);
+  std::size_t total_lines = 0;
+  std::size_t total_bytes = 0;
+  std::size_t total_allocations = 0;
+  double total_ns = 0.0;
+
+  std::printf("%-22s %12s %12s %14s\n", "board", "ns/line", "MB/s", "allocs/line");
+  for (const Recording& recording : kRecordings) {
+    sensor.parse_line(recording.line);
+
+    const std::size_t allocations_before = g_allocations.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+      sensor.parse_line(recording.line);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const std::size_t allocations = g_allocations.load(std::memory_order_relaxed) - allocations_before;
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    const double bytes = static_cast<double>(recording.line.size()) * static_cast<double>(iterations);
+    std::printf("%-22s %12.1f %12.1f %14.3f\n", recording.board, ns / static_cast<double>(iterations),
+                bytes / ns * 1000.0, static_cast<double>(allocations) / static_cast<double>(iterations));
+
+    total_lines += static_cast<std::size_t>(iterations);
+    total_bytes += static_cast<std::size_t>(bytes);
+    total_allocations += allocations;
+    total_ns += ns;
+  }
+
+  std::printf("%-22s %12.1f %12.1f %14.3f\n", "all", total_ns / static_cast<double>(total_lines),
+              static_cast<double>(total_bytes) / total_ns * 1000.0,
+              static_cast<double>(total_allocations) / static_cast<double>(total_lines));
+  std::printf("gpu=%.0f%% emc=%.0f%% rails=%.0fmW temps=%zu\n", sensor.raw().gpu_util_pct, sensor.raw().emc_util_pct,
+              sensor.raw().total_rail_power_mw, sensor.raw().temperatures_c.size());
+  return total_allocations == 0 ? 0 : 1;
+}
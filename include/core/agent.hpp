@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <functional>
@@ -25,13 +26,21 @@
 #include "sensors/gpu/gpu.hpp"
 #include "sensors/disk.hpp"
 #include "sensors/interrupts.hpp"
+#include "sensors/jetson_sysfs.hpp"
 #include "sensors/memory.hpp"
+#include "sensors/netstack.hpp"
 #include "sensors/network.hpp"
+#include "sensors/perf_events.hpp"
 #include "sensors/power.hpp"
+#include "sensors/process_attribution.hpp"
+#include "sensors/powercap.hpp"
 #include "sensors/psi.hpp"
+#include "sensors/schedstat.hpp"
 #include "sensors/softirqs.hpp"
+#include "sensors/softnet.hpp"
 #include "sensors/tegrastats.hpp"
 #include "sensors/thermal.hpp"
+#include "sensors/wakeup_latency.hpp"
 #include "sinks/redis_ts.hpp"
 #include "sinks/stdout_debug.hpp"
 
@@ -50,6 +59,8 @@ class Agent {
   explicit Agent(AgentConfig config = {});
 
   AgentStats run_for_ticks(std::size_t total_ticks);
+  // Runs one culprit attribution pass pair even while risk:state is STABLE.
+  void request_process_attribution() noexcept;
 
  private:
   struct SensorRegistration {
@@ -57,13 +68,37 @@ class Agent {
     std::uint64_t every_ticks;
     bool enabled;
     std::function<bool(model::signal_frame&)> sample;
+    // The last sample failed; a change is a sensor event.
+    bool failing{false};
   };
 
+  // One Redis sink and its policy: redis itself, then each redis.targets entry.
+  struct RedisTarget {
+    std::string name;
+    std::unique_ptr<sinks::RedisTsSink> sink;
+    std::uint64_t every_ticks{1};
+    bool frames{false};
+    bool events{false};
+    // No metrics list: the per-CPU, per-GPU and culprit streams go here too.
+    bool full{true};
+    // Change-only handles, one per sensor_registry_ entry.
+    std::vector<int> refresh_groups{};
+    // Targets after the first write their own copy of the frame, so agent:redis_* describes their
+    // own connection.
+    model::signal_frame frame{};
+    bool was_ok{true};
+  };
+
+  void add_redis_target(const AgentConfig& config, const std::string& name, const RedisConfig& redis);
+  void publish_redis(RedisTarget& target, bool first);
   void register_sensors(const AgentConfig& config);
   [[nodiscard]] bool sensor_enabled(const AgentConfig& config, const std::string& name) const;
   void collect_sensors(AgentStats& stats);
   void compute_derived(AgentStats& stats);
   void compute_risk(AgentStats& stats);
+  // Queues the state and PSI threshold events of this tick for publish_sinks.
+  void detect_events(model::system_state previous_state);
+  void attribute_processes();
   void publish_sinks(AgentStats& stats);
   void update_agent_health(float actual_period_ms, float compute_time_ms);
 
@@ -81,14 +116,27 @@ class Agent {
   sensors::CpuSensor cpu_sensor_{};
   sensors::InterruptsSensor interrupts_sensor_{};
   sensors::SoftirqsSensor softirqs_sensor_{};
+  sensors::SoftnetSensor softnet_sensor_{};
+  std::unique_ptr<sensors::PerfEventSensor> perf_sensor_{};
+  sensors::SchedstatSensor schedstat_sensor_{};
   sensors::MemorySensor memory_sensor_{};
   sensors::DiskSensor disk_sensor_{};
   sensors::NetworkSensor network_sensor_{};
-  sensors::TegraStatsSensor tegrastats_sensor_{};
+  sensors::NetStackSensor netstack_sensor_{};
+  std::unique_ptr<sensors::TegraStatsSensor> tegrastats_sensor_{};
+  std::unique_ptr<sensors::JetsonSysfsSensor> jetson_sysfs_sensor_{};
   sensors::ThermalSensor thermal_sensor_{};
   sensors::CpuThrottleSensor cpu_throttle_sensor_{};
+  sensors::PowerCapSensor powercap_sensor_{};
   sensors::CpuFreqSensor cpufreq_sensor_{};
   std::unique_ptr<sensors::gpu::GpuSensor> gpu_sensor_{};
+  bool gpu_ready_{false};
+  std::vector<sensors::gpu::GpuWorkload> gpu_workloads_{};
+  bool gpu_workloads_ready_{false};
+  std::unique_ptr<sensors::WakeupLatencyProbe> wakeup_probe_{};
+  bool wakeup_ready_{false};
+  bool perf_ready_{false};
+  bool wakeup_setup_logged_{false};
 
   derived::SchedulerPressure scheduler_pressure_{};
   derived::MemoryPressure memory_pressure_{};
@@ -101,9 +149,17 @@ class Agent {
   risk::SaturationRisk saturation_risk_{};
   risk::SystemState system_state_{};
 
+  std::unique_ptr<sensors::ProcessAttribution> process_attribution_{};
+  bool attribution_ready_{false};
+
   sinks::StdoutDebugSink stdout_sink_{};
-  std::unique_ptr<sinks::RedisTsSink> redis_sink_{};
-  bool redis_was_ok_{true};
+  std::vector<RedisTarget> redis_targets_{};
+  std::vector<sinks::RedisTsSink*> redis_sinks_{};
+  bool publish_events_{false};
+  float psi_event_threshold_{10.0F};
+  // cpu, memory, io avg10 above the event threshold (cleared below half of it).
+  std::array<bool, 3> psi_over_{};
+  std::vector<sinks::RiskEvent> pending_events_{};
 };
 
 }  // namespace hw_agent::core
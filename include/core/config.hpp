@@ -4,14 +4,96 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sched.h>
 
 namespace hw_agent::core {
 
+// "avg:1m:30d" in YAML: aggregation, bucket and optional retention of the compacted series.
+struct RedisCompaction {
+  std::string aggregation{};
+  std::uint64_t bucket_ms{0};
+  std::uint64_t retention_ms{0};
+};
+
 struct RedisConfig {
   std::string host{"127.0.0.1"};
   std::uint16_t port{6379};
   std::string unix_socket{};
   bool enabled{false};
+  // redis.mode: async pipelines writes on a non-blocking connection instead of waiting per tick.
+  bool async{false};
+  std::uint32_t max_in_flight{4};
+  // 0 picks 2000 ms in async mode and half a tick in sync mode, where every frame waits for its
+  // reply inside the tick; an explicit sync value must stay below the tick interval.
+  std::uint32_t reply_timeout_ms{0};
+  // Jittered exponential reconnect backoff bounds.
+  std::uint32_t reconnect_min_ms{100};
+  std::uint32_t reconnect_max_ms{30000};
+  // Write a series only when it changed (beyond its deadband) or keepalive_ms has passed.
+  bool change_only{false};
+  std::uint32_t keepalive_ms{10000};
+  // "raw:memory=0.5,derived:io_pressure=0.02" in YAML.
+  std::vector<std::pair<std::string, double>> deadbands{};
+  // Join up to batch_ticks ticks into one TS.MADD, holding none longer than batch_ms (0: no limit).
+  std::uint32_t batch_ticks{1};
+  std::uint32_t batch_ms{0};
+  // Outage spool: memory-mapped file (empty disables), size cap and frames backfilled per write.
+  std::string spool_path{};
+  std::uint32_t spool_max_mb{64};
+  std::uint32_t spool_drain_frames{10};
+  // Series schema: node label (empty: the key prefix), raw retention (0 keeps everything), chunk
+  // bytes and TS.CREATERULE compactions.
+  std::string node_label{};
+  std::uint64_t retention_ms{0};
+  std::uint32_t chunk_size{4096};
+  std::vector<RedisCompaction> compactions{};
+  // XADD every frame, binary encoded, to <prefix>:frames (capped near frames_maxlen entries).
+  bool frames_stream{false};
+  std::uint32_t frames_maxlen{3000};
+  // PUBLISH risk:state transitions, PSI threshold crossings (avg10 percent) and sensor failure
+  // onset/recovery to <prefix>:events.
+  bool events{false};
+  float events_psi_threshold{10.0F};
+  // Redis Cluster: address is a seed node and keys are hash-tagged with the node label.
+  bool cluster{false};
+  // Series written, as key suffix prefixes ("risk:", "raw:cpu"); empty writes every enabled one.
+  std::vector<std::string> metrics{};
+  // Write every Nth tick; events still go out in the tick they happen.
+  std::uint32_t every_ticks{1};
+};
+
+// redis.targets.<name>: another Redis written with its own connection and policy, always async so
+// it can never hold up the tick or the other targets.
+struct RedisTargetConfig {
+  std::string name{};
+  RedisConfig redis{};
+};
+
+struct AttributionConfig {
+  bool enabled{true};
+  std::uint32_t top_n{5};
+  // Percent of one CPU the /proc scan may use while risk:state >= DEGRADED.
+  float cpu_budget_pct{2.0F};
+};
+
+struct WakeupProbeConfig {
+  bool enabled{false};
+  // Probed CPUs ("0,2-3" in YAML); empty probes CPU 0.
+  std::vector<int> cpus{};
+  int policy{SCHED_FIFO};
+  int priority{80};
+  std::uint32_t interval_us{1000};
+};
+
+enum class JetsonBackend : std::uint8_t { automatic, sysfs, tegrastats };
+
+struct JetsonConfig {
+  // automatic prefers sysfs when it finds GPU load or INA3221 rails, else forks tegrastats.
+  JetsonBackend backend{JetsonBackend::automatic};
+  std::string sysfs_root{"/sys"};
 };
 
 struct AgentConfig {
@@ -19,12 +101,26 @@ struct AgentConfig {
   float thermal_throttle_temp_c{85.0F};
   float thermal_pressure_warning_window_c{30.0F};
   std::uint32_t gpu_device_index{0};
+  // NVML devices to monitor ("all" or "0,2-3" in YAML); empty monitors every device.
+  // gpu.device_index pins a single device.
+  std::vector<std::uint32_t> gpu_devices{};
+  // Root for the DRM (AMD/Intel) backend, used when NVML is unavailable.
+  std::string gpu_sysfs_root{"/sys"};
+  // Per-cgroup GPU usage from NVML process queries, on a slow cadence.
+  bool gpu_process_utilization{true};
   bool publish_health{true};
   bool stdout_debug{true};
   RedisConfig redis{};
+  std::vector<RedisTargetConfig> redis_targets{};
+  AttributionConfig attribution{};
+  WakeupProbeConfig wakeup_probe{};
+  JetsonConfig jetson{};
   std::unordered_map<std::string, bool> sensor_enabled{};
 };
 
 AgentConfig load_agent_config(const std::string& path);
 
+// redis.reply_timeout_ms with 0 resolved for the section's mode at this tick interval.
+std::uint32_t effective_reply_timeout_ms(const RedisConfig& redis, std::chrono::milliseconds tick_interval);
+
 }  // namespace hw_agent::core
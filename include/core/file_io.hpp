@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdio>
+
+namespace hw_agent::core {
+
+// Rewinds a long-lived procfs/sysfs handle so the next read asks the kernel for a fresh snapshot.
+// glibc satisfies an fseek() that lands inside the current read buffer without a syscall, which
+// would replay the previous contents forever; fflush() on an input stream drops that buffer first.
+inline bool rewind_file(std::FILE* file) noexcept {
+  std::fflush(file);
+  return std::fseek(file, 0L, SEEK_SET) == 0;
+}
+
+}  // namespace hw_agent::core
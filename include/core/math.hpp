@@ -8,4 +8,12 @@ inline constexpr float clamp01(const float value) noexcept {
   return std::clamp(value, 0.0F, 1.0F);
 }
 
+// A cpufreq policy max clamped this far below cpuinfo_max_freq counts as fully throttled.
+inline constexpr float kFullCpufreqCapDepth = 0.50F;
+
+// signal_frame::cpufreq_cap_depth as a [0,1] throttle level, shared by the thermal and power pressures.
+inline constexpr float cpufreq_cap_norm(const float cap_depth) noexcept {
+  return clamp01(cap_depth / kFullCpufreqCapDepth);
+}
+
 }  // namespace hw_agent::core
@@ -14,6 +14,11 @@ class LatencyJitter {
 
  private:
   static constexpr std::size_t kWindow = 8;
+  // Average runqueue wait per timeslice at which scheduling latency alone saturates the jitter term.
+  static constexpr float kSliceWaitSaturationUs = 2000.0F;
+  // Probe wakeup overshoot at which the measured tail alone saturates the jitter term.
+  static constexpr float kWakeupP99SaturationUs = 500.0F;
+  static constexpr float kWakeupP999SaturationUs = 2000.0F;
 
   std::array<std::uint64_t, kWindow> intervals_ns_{};
   std::size_t count_{0};
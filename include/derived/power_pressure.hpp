@@ -9,6 +9,9 @@ class PowerPressure {
   void sample(model::signal_frame& frame) noexcept;
 
  private:
+  // RAPL draw above this fraction of PL1 means the package is about to be power-limited.
+  static constexpr float kLimitKnee = 0.80F;
+
   float ema_{0.0F};
   bool has_ema_{false};
 };
@@ -9,6 +9,9 @@ class SchedulerPressure {
   void sample(model::signal_frame& frame) noexcept;
 
  private:
+  // p99 per-CPU run delay (ms waited per second) treated as a saturated runqueue.
+  static constexpr float kRunDelaySaturationMsPerS = 500.0F;
+
   float irq_baseline_{1.0F};
   bool has_irq_baseline_{false};
   float ema_{0.0F};
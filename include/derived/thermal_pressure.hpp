@@ -10,6 +10,9 @@ class ThermalPressure {
   void sample(model::signal_frame& frame) noexcept;
 
  private:
+  // Projected time-to-trip below this horizon ramps pressure up before headroom is actually gone.
+  static constexpr float kTripHorizonS = 120.0F;
+
   float warning_window_c_{30.0F};
   float ema_{0.0F};
   bool has_ema_{false};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::model {
+
+// Compact, versioned binary encoding of one signal_frame, as carried by the <prefix>:frames stream.
+// All integers and floats are little-endian:
+//
+//    0  "HWF" magic and a 1-byte version
+//    4  u16 float field count, u16 counter field count
+//    8  u64 unix milliseconds, u64 monotonic_ns, u64 agent.heartbeat_ms
+//   32  u8 system_state, 3 reserved bytes
+//   36  one f32 per kFrameFloatFields entry, then one u32 per kFrameCounterFields entry
+//
+// Fields are only ever appended to either table, so a decoder takes the fields it knows from a
+// newer frame and leaves the ones an older frame lacks at zero. The version changes only when the
+// header does.
+inline constexpr std::uint8_t kFrameCodecVersion = 1;
+inline constexpr std::size_t kFrameHeaderSize = 36;
+
+struct FrameFloatField {
+  const char* name;
+  // Exactly one of the two is set.
+  float signal_frame::*field;
+  float signal_frame::AgentHealth::*agent_field;
+};
+
+struct FrameCounterField {
+  const char* name;
+  std::uint32_t signal_frame::AgentHealth::*field;
+};
+
+// Append only: never reorder or remove entries.
+inline constexpr FrameFloatField kFrameFloatFields[] = {
+    {"psi", &signal_frame::psi, nullptr},
+    {"psi_memory", &signal_frame::psi_memory, nullptr},
+    {"psi_io", &signal_frame::psi_io, nullptr},
+    {"cpu", &signal_frame::cpu, nullptr},
+    {"irq", &signal_frame::irq, nullptr},
+    {"softirqs", &signal_frame::softirqs, nullptr},
+    {"softnet_squeeze", &signal_frame::softnet_squeeze, nullptr},
+    {"softnet_drops", &signal_frame::softnet_drops, nullptr},
+    {"softnet_hot_cpu", &signal_frame::softnet_hot_cpu, nullptr},
+    {"perf_context_switches", &signal_frame::perf_context_switches, nullptr},
+    {"perf_migrations", &signal_frame::perf_migrations, nullptr},
+    {"perf_major_faults", &signal_frame::perf_major_faults, nullptr},
+    {"perf_ipc", &signal_frame::perf_ipc, nullptr},
+    {"perf_llc_misses", &signal_frame::perf_llc_misses, nullptr},
+    {"perf_hot_cpu", &signal_frame::perf_hot_cpu, nullptr},
+    {"sched_run_delay", &signal_frame::sched_run_delay, nullptr},
+    {"sched_run_delay_p99", &signal_frame::sched_run_delay_p99, nullptr},
+    {"sched_run_delay_max", &signal_frame::sched_run_delay_max, nullptr},
+    {"sched_worst_cpu", &signal_frame::sched_worst_cpu, nullptr},
+    {"sched_wait_per_slice_us", &signal_frame::sched_wait_per_slice_us, nullptr},
+    {"wakeup_latency_p50_us", &signal_frame::wakeup_latency_p50_us, nullptr},
+    {"wakeup_latency_p99_us", &signal_frame::wakeup_latency_p99_us, nullptr},
+    {"wakeup_latency_p999_us", &signal_frame::wakeup_latency_p999_us, nullptr},
+    {"wakeup_latency_max_us", &signal_frame::wakeup_latency_max_us, nullptr},
+    {"memory", &signal_frame::memory, nullptr},
+    {"thermal", &signal_frame::thermal, nullptr},
+    {"thermal_slope", &signal_frame::thermal_slope, nullptr},
+    {"thermal_seconds_to_trip", &signal_frame::thermal_seconds_to_trip, nullptr},
+    {"cpufreq", &signal_frame::cpufreq, nullptr},
+    {"cpufreq_min_ratio", &signal_frame::cpufreq_min_ratio, nullptr},
+    {"cpufreq_avg_ratio", &signal_frame::cpufreq_avg_ratio, nullptr},
+    {"cpufreq_capped", &signal_frame::cpufreq_capped, nullptr},
+    {"cpufreq_cap_depth", &signal_frame::cpufreq_cap_depth, nullptr},
+    {"cpu_throttle_ratio", &signal_frame::cpu_throttle_ratio, nullptr},
+    {"rapl_package_watts", &signal_frame::rapl_package_watts, nullptr},
+    {"rapl_package_limit_ratio", &signal_frame::rapl_package_limit_ratio, nullptr},
+    {"rapl_dram_watts", &signal_frame::rapl_dram_watts, nullptr},
+    {"rapl_dram_limit_ratio", &signal_frame::rapl_dram_limit_ratio, nullptr},
+    {"disk", &signal_frame::disk, nullptr},
+    {"network", &signal_frame::network, nullptr},
+    {"tcp_retrans", &signal_frame::tcp_retrans, nullptr},
+    {"listen_drops", &signal_frame::listen_drops, nullptr},
+    {"udp_buf_errors", &signal_frame::udp_buf_errors, nullptr},
+    {"tcp_mem_ratio", &signal_frame::tcp_mem_ratio, nullptr},
+    {"gpu_util", &signal_frame::gpu_util, nullptr},
+    {"gpu_mem_util", &signal_frame::gpu_mem_util, nullptr},
+    {"emc_util", &signal_frame::emc_util, nullptr},
+    {"gpu_mem_free", &signal_frame::gpu_mem_free, nullptr},
+    {"gpu_temp", &signal_frame::gpu_temp, nullptr},
+    {"gpu_clock_ratio", &signal_frame::gpu_clock_ratio, nullptr},
+    {"gpu_power_ratio", &signal_frame::gpu_power_ratio, nullptr},
+    {"gpu_throttle", &signal_frame::gpu_throttle, nullptr},
+    {"nvml_gpu_util", &signal_frame::nvml_gpu_util, nullptr},
+    {"nvml_gpu_temp", &signal_frame::nvml_gpu_temp, nullptr},
+    {"nvml_gpu_power_ratio", &signal_frame::nvml_gpu_power_ratio, nullptr},
+    {"nvml_gpu_devices", &signal_frame::nvml_gpu_devices, nullptr},
+    {"nvml_gpu_throttled", &signal_frame::nvml_gpu_throttled, nullptr},
+    {"nvml_gpu_worst_device", &signal_frame::nvml_gpu_worst_device, nullptr},
+    {"drm_gpu_util", &signal_frame::drm_gpu_util, nullptr},
+    {"drm_gpu_temp", &signal_frame::drm_gpu_temp, nullptr},
+    {"drm_gpu_clock_ratio", &signal_frame::drm_gpu_clock_ratio, nullptr},
+    {"drm_gpu_power_ratio", &signal_frame::drm_gpu_power_ratio, nullptr},
+    {"tegra_gpu_util", &signal_frame::tegra_gpu_util, nullptr},
+    {"tegra_emc_util", &signal_frame::tegra_emc_util, nullptr},
+    {"tegra_gpu_temp", &signal_frame::tegra_gpu_temp, nullptr},
+    {"tegra_gpu_power_mw", &signal_frame::tegra_gpu_power_mw, nullptr},
+    {"scheduler_pressure", &signal_frame::scheduler_pressure, nullptr},
+    {"memory_pressure", &signal_frame::memory_pressure, nullptr},
+    {"io_pressure", &signal_frame::io_pressure, nullptr},
+    {"thermal_pressure", &signal_frame::thermal_pressure, nullptr},
+    {"power_pressure", &signal_frame::power_pressure, nullptr},
+    {"latency_jitter", &signal_frame::latency_jitter, nullptr},
+    {"realtime_risk", &signal_frame::realtime_risk, nullptr},
+    {"saturation_risk", &signal_frame::saturation_risk, nullptr},
+    {"agent_loop_jitter_ms", nullptr, &signal_frame::AgentHealth::loop_jitter_ms},
+    {"agent_compute_time_ms", nullptr, &signal_frame::AgentHealth::compute_time_ms},
+    {"agent_redis_latency_ms", nullptr, &signal_frame::AgentHealth::redis_latency_ms},
+};
+
+// Append only: never reorder or remove entries.
+inline constexpr FrameCounterField kFrameCounterFields[] = {
+    {"agent_redis_errors", &signal_frame::AgentHealth::redis_errors},
+    {"agent_redis_dropped", &signal_frame::AgentHealth::redis_dropped},
+    {"agent_redis_samples", &signal_frame::AgentHealth::redis_samples},
+    {"agent_redis_suppressed", &signal_frame::AgentHealth::redis_suppressed},
+    {"agent_redis_spooled", &signal_frame::AgentHealth::redis_spooled},
+    {"agent_redis_breaker", &signal_frame::AgentHealth::redis_breaker},
+    {"agent_sensor_failures", &signal_frame::AgentHealth::sensor_failures},
+    {"agent_missed_cycles", &signal_frame::AgentHealth::missed_cycles},
+};
+
+inline constexpr std::size_t kEncodedFrameSize =
+    kFrameHeaderSize + (std::size(kFrameFloatFields) * 4) + (std::size(kFrameCounterFields) * 4);
+
+// Writes kEncodedFrameSize bytes to out.
+void encode_frame(const signal_frame& frame, std::uint64_t unix_ms, unsigned char* out) noexcept;
+
+// Fills frame (zeroing fields the encoding lacks) and unix_ms. False when data is not an encoded
+// frame: wrong magic or version, or shorter than its header says.
+bool decode_frame(const void* data, std::size_t size, signal_frame& frame, std::uint64_t& unix_ms) noexcept;
+
+}  // namespace hw_agent::model
@@ -21,6 +21,15 @@ struct signal_frame {
         float compute_time_ms;
         float redis_latency_ms;
         std::uint32_t redis_errors;
+        // Frames the async Redis sink dropped because its in-flight window was full.
+        std::uint32_t redis_dropped;
+        // TS.MADD samples the previous frame wrote and, in change-only mode, left out as unchanged.
+        std::uint32_t redis_samples;
+        std::uint32_t redis_suppressed;
+        // Frames waiting in the outage spool for backfill.
+        std::uint32_t redis_spooled;
+        // Redis connection circuit breaker: 0 closed, 1 half-open (connect in progress), 2 open.
+        std::uint32_t redis_breaker;
         std::uint32_t sensor_failures;
         std::uint32_t missed_cycles;
     };
@@ -34,13 +43,66 @@ struct signal_frame {
     float cpu;
     float irq;
     float softirqs;
+    // NET_RX backlog health from /proc/net/softnet_stat: time_squeeze and backlog drops per second
+    // summed across CPUs, plus the CPU index with the most events this sample (-1 when idle).
+    float softnet_squeeze;
+    float softnet_drops;
+    float softnet_hot_cpu;
+    // System-wide perf_event counters: context switches, CPU migrations and major faults per second
+    // summed across CPUs, and the CPU with the most switches + migrations (-1 when idle). Hardware
+    // IPC and cache misses per second stay 0 when the PMU is unavailable.
+    float perf_context_switches;
+    float perf_migrations;
+    float perf_major_faults;
+    float perf_ipc;
+    float perf_llc_misses;
+    float perf_hot_cpu;
+    // Runqueue wait from /proc/schedstat run_delay: milliseconds waited per second per CPU (mean,
+    // nearest-rank p99 and worst CPU), the worst CPU index (-1 when nothing waited) and the
+    // average wait per timeslice in microseconds.
+    float sched_run_delay;
+    float sched_run_delay_p99;
+    float sched_run_delay_max;
+    float sched_worst_cpu;
+    float sched_wait_per_slice_us;
+    // Wakeup overshoot of the optional absolute-deadline probe threads, in microseconds: p50, p99,
+    // p99.9 and max over the last window, each the worst across probed CPUs (0 when the probe is off).
+    float wakeup_latency_p50_us;
+    float wakeup_latency_p99_us;
+    float wakeup_latency_p999_us;
+    float wakeup_latency_max_us;
     float memory;
     float thermal;
+    // Steepest thermal zone slope (degrees C per second) and shortest projected seconds until a warming
+    // zone reaches its trip point: 0 when a zone is at or past its trip, the 3600 s ceiling when
+    // nothing is warming or no zone could be read.
+    float thermal_slope;
+    float thermal_seconds_to_trip;
     float cpufreq;
+    // Per-policy frequency headroom from /sys/devices/system/cpu/cpufreq/policy*: lowest and mean
+    // scaling_cur_freq / cpuinfo_max_freq [0,1], the number of policies whose scaling_max_freq is held
+    // below cpuinfo_max_freq (firmware, thermal or user caps) and the deepest cap as 1 - max ratio.
+    float cpufreq_min_ratio;
+    float cpufreq_avg_ratio;
+    float cpufreq_capped;
+    float cpufreq_cap_depth;
     // CPU thermal throttle activity ratio [0,1] from /sys/devices/system/cpu/cpu*/thermal_throttle.
     float cpu_throttle_ratio;
+    // RAPL package and DRAM power from /sys/class/powercap, in watts summed across sockets, and the
+    // draw relative to the long-term (PL1) power limit (0 when the zone exposes no limit).
+    float rapl_package_watts;
+    float rapl_package_limit_ratio;
+    float rapl_dram_watts;
+    float rapl_dram_limit_ratio;
     float disk;
     float network;
+    // Kernel network stack health from /proc/net/{snmp,netstat,sockstat}.
+    // TCP RetransSegs, ListenDrops and UDP Rcvbuf+Sndbuf errors are per-second rates.
+    float tcp_retrans;
+    float listen_drops;
+    float udp_buf_errors;
+    // TCP socket memory pages against the tcp_mem hard limit [0,1].
+    float tcp_mem_ratio;
     float gpu_util;
     // GPU memory utilization percentage [0,100], sourced from backend GPU-memory metrics.
     float gpu_mem_util;
@@ -55,6 +117,19 @@ struct signal_frame {
     float nvml_gpu_util;
     float nvml_gpu_temp;
     float nvml_gpu_power_ratio;
+    // Multi-GPU NVML: devices read by the last collect, how many had a throttle reason set, and the
+    // index of the worst one (throttled first, then hottest). The gpu_* and nvml_gpu_* values above
+    // are worst-case across devices (max utilization/temperature/power, min free memory), except
+    // gpu_clock_ratio, which is the worst device's own.
+    float nvml_gpu_devices;
+    float nvml_gpu_throttled;
+    float nvml_gpu_worst_device;
+    // DRM backend (amdgpu/i915 sysfs), worst card: gpu_busy_percent, edge temperature, current
+    // over highest DPM/GT clock, and hwmon power over power1_cap.
+    float drm_gpu_util;
+    float drm_gpu_temp;
+    float drm_gpu_clock_ratio;
+    float drm_gpu_power_ratio;
     float tegra_gpu_util;
     float tegra_emc_util;
     float tegra_gpu_temp;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdio>
+#include <string>
 #include <vector>
 
 #include "model/signal_frame.hpp"
@@ -9,18 +11,49 @@ namespace hw_agent::sensors {
 
 class CpuFreqSensor {
  public:
+  struct RawFields {
+    std::size_t readable_policies{0};
+    std::size_t capped_policies{0};
+    float average_mhz{0.0F};
+    // scaling_cur_freq / cpuinfo_max_freq across policies with a known hardware maximum.
+    float min_ratio{0.0F};
+    float avg_ratio{0.0F};
+    // Deepest cap as 1 - scaling_max_freq / cpuinfo_max_freq, 0 when no policy is capped.
+    float cap_depth{0.0F};
+  };
+
+  // One cpufreq policy directory (shared by every CPU in the same frequency domain).
+  struct PolicySource {
+    std::string name{};
+    std::FILE* cur_freq_file{nullptr};
+    // Optional; nullptr disables cap detection for this policy.
+    std::FILE* scaling_max_file{nullptr};
+    // Static hardware ceiling from cpuinfo_max_freq, 0 when unknown (ratios are skipped).
+    std::uint64_t cpuinfo_max_khz{0};
+  };
+
+  // scaling_max_freq below this fraction of cpuinfo_max_freq counts as a firmware/thermal/user cap.
+  static constexpr float kCapThreshold = 0.98F;
+
   CpuFreqSensor();
-  explicit CpuFreqSensor(std::vector<std::FILE*> files, bool owns_files = false);
+  explicit CpuFreqSensor(std::string cpufreq_root);
+  explicit CpuFreqSensor(std::vector<PolicySource> policies, bool owns_files = false);
   ~CpuFreqSensor();
 
   CpuFreqSensor(const CpuFreqSensor&) = delete;
   CpuFreqSensor& operator=(const CpuFreqSensor&) = delete;
 
   bool sample(model::signal_frame& frame) noexcept;
+  const RawFields& raw() const noexcept;
+  const std::vector<PolicySource>& policies() const noexcept;
 
  private:
-  std::vector<std::FILE*> files_{};
+  void discover_policies(const std::string& cpufreq_root);
+  static bool read_khz(std::FILE* file, std::uint64_t& khz) noexcept;
+
+  std::vector<PolicySource> policies_{};
   bool owns_files_{true};
+  RawFields raw_{};
   float ema_mhz_{0.0F};
   bool has_ema_{false};
 };
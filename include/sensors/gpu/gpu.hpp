@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "model/signal_frame.hpp"
 
@@ -8,14 +12,73 @@ namespace hw_agent::sensors::gpu {
 
 using SignalFrame = model::signal_frame;
 
+// One device's reading from the last collect.
+struct GpuDeviceSample {
+  unsigned int index{0};
+  float util{0.0F};
+  float mem_util{0.0F};
+  float mem_free_mb{0.0F};
+  float temp_c{0.0F};
+  float clock_ratio{0.0F};
+  float power_mw{0.0F};
+  float power_ratio{0.0F};
+  bool throttled{false};
+};
+
+// GPU usage of one cgroup (container/service) over the last workload window.
+struct GpuWorkload {
+  // cgroup v2 path of the owning processes, "<unknown>" when /proc has no entry for them.
+  std::string cgroup{};
+  std::uint32_t processes{0};
+  // Summed over processes and devices, so 100 is one fully used GPU.
+  float sm_util{0.0F};
+  float mem_util{0.0F};
+  float fb_used_mb{0.0F};
+};
+
+struct NvmlOptions {
+  // Device indices to monitor; empty monitors every device NVML reports.
+  std::vector<unsigned int> devices{};
+  // dlopen name or path of the NVML library.
+  std::string library{"libnvidia-ml.so.1"};
+  // Where PIDs from NVML are mapped to cgroups.
+  std::string proc_root{"/proc"};
+};
+
+// Throttled beats hot beats busy: the device most likely to be missing its deadlines.
+// devices must not be empty.
+inline const GpuDeviceSample& worst_device(const std::vector<GpuDeviceSample>& devices) {
+  return *std::max_element(devices.begin(), devices.end(), [](const GpuDeviceSample& lhs, const GpuDeviceSample& rhs) {
+    if (lhs.throttled != rhs.throttled) {
+      return rhs.throttled;
+    }
+    if (lhs.temp_c != rhs.temp_c) {
+      return lhs.temp_c < rhs.temp_c;
+    }
+    return lhs.util < rhs.util;
+  });
+}
+
 class GpuSensor {
  public:
+  // Series prefix for per-device keys: raw:<source>_gpu_<stat>:gpu<N>.
+  virtual const char* source() const = 0;
   virtual bool available() const = 0;
   virtual bool collect(SignalFrame& frame) = 0;
+  // Devices read successfully by the last collect, in index order.
+  virtual const std::vector<GpuDeviceSample>& devices() const = 0;
+  // Per-cgroup usage since the previous call, busiest first; false when the backend cannot
+  // attribute GPU time to processes.
+  virtual bool collect_workloads(std::vector<GpuWorkload>& workloads) {
+    workloads.clear();
+    return false;
+  }
   virtual ~GpuSensor() = default;
 };
 
-std::unique_ptr<GpuSensor> make_nvml_sensor(unsigned int device_index);
+std::unique_ptr<GpuSensor> make_nvml_sensor(const NvmlOptions& options);
+// AMD/Intel GPUs through <sysfs_root>/class/drm/card*/device.
+std::unique_ptr<GpuSensor> make_drm_sensor(const std::string& sysfs_root);
 std::unique_ptr<GpuSensor> make_none_sensor();
 
 }  // namespace hw_agent::sensors::gpu
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::sensors {
+
+// Native Jetson backend reading the same sources tegrastats scrapes, on the agent's cadence:
+// GPU load from devfreq (per-mille), EMC activity from actmon against the EMC clock, INA3221
+// rail power from hwmon and temperatures from thermal zones. All paths are under a configurable
+// sysfs root so discovery can run against a fake tree.
+class JetsonSysfsSensor {
+ public:
+  struct Rail {
+    std::string label{};
+    // in<N>_input (mV) and curr<N>_input (mA) of one INA3221 channel.
+    std::FILE* voltage_file{nullptr};
+    std::FILE* current_file{nullptr};
+    float power_mw{0.0F};
+  };
+
+  struct Zone {
+    std::string type{};
+    std::FILE* temp_file{nullptr};
+    // Type starts with "gpu" (GPU-therm on Nano/Xavier, gpu-thermal on Orin).
+    bool gpu{false};
+    float temp_c{0.0F};
+  };
+
+  struct RawFields {
+    float gpu_util_pct{0.0F};
+    float emc_util_pct{0.0F};
+    float total_rail_power_mw{0.0F};
+    // Hottest GPU zone; Orin reports -256 C for power-gated zones, which are ignored.
+    float gpu_temp_c{0.0F};
+    bool has_gpu_temp{false};
+  };
+
+  JetsonSysfsSensor();
+  explicit JetsonSysfsSensor(std::string sysfs_root);
+  ~JetsonSysfsSensor();
+
+  JetsonSysfsSensor(const JetsonSysfsSensor&) = delete;
+  JetsonSysfsSensor& operator=(const JetsonSysfsSensor&) = delete;
+  JetsonSysfsSensor(JetsonSysfsSensor&&) = delete;
+  JetsonSysfsSensor& operator=(JetsonSysfsSensor&&) = delete;
+
+  bool sample(model::signal_frame& frame) noexcept;
+  // True when a GPU load file or INA3221 rail was found, i.e. this looks like a Jetson.
+  [[nodiscard]] bool available() const noexcept;
+  const RawFields& raw() const noexcept;
+  const std::vector<Rail>& rails() const noexcept;
+  const std::vector<Zone>& zones() const noexcept;
+
+ private:
+  void discover(const std::string& sysfs_root);
+  static bool read_u64_file(std::FILE* file, std::uint64_t& value) noexcept;
+  static bool read_i64_file(std::FILE* file, std::int64_t& value) noexcept;
+
+  std::FILE* gpu_load_file_{nullptr};
+  std::FILE* emc_activity_file_{nullptr};
+  std::FILE* emc_rate_file_{nullptr};
+  std::vector<Rail> rails_{};
+  std::vector<Zone> zones_{};
+  RawFields raw_{};
+};
+
+}  // namespace hw_agent::sensors
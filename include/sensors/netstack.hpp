@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::sensors {
+
+class NetStackSensor {
+ public:
+  struct RawFields {
+    std::uint64_t tcp_retrans_segs{0};
+    std::uint64_t tcp_out_segs{0};
+    std::uint64_t listen_overflows{0};
+    std::uint64_t listen_drops{0};
+    std::uint64_t udp_rcvbuf_errors{0};
+    std::uint64_t udp_sndbuf_errors{0};
+    std::uint64_t tcp_mem_pages{0};
+    std::uint64_t tcp_mem_pressure_pages{0};
+    std::uint64_t tcp_mem_max_pages{0};
+    float tcp_retrans_per_sec{0.0F};
+    float listen_drops_per_sec{0.0F};
+    float udp_buf_errors_per_sec{0.0F};
+    float tcp_mem_ratio{0.0F};
+  };
+
+  NetStackSensor();
+  NetStackSensor(std::FILE* snmp, std::FILE* netstat, std::FILE* sockstat, std::FILE* tcp_mem,
+                 bool owns_files = false);
+  ~NetStackSensor();
+
+  NetStackSensor(const NetStackSensor&) = delete;
+  NetStackSensor& operator=(const NetStackSensor&) = delete;
+
+  bool sample(model::signal_frame& frame) noexcept;
+  const RawFields& raw() const noexcept;
+
+ private:
+  // TcpExt header lines in /proc/net/netstat exceed 2 KiB on current kernels.
+  static constexpr std::size_t kReadBufferSize = 8192;
+
+  bool parse_snmp() noexcept;
+  bool parse_netstat() noexcept;
+  bool parse_sockstat() noexcept;
+  bool parse_tcp_mem() noexcept;
+
+  std::FILE* snmp_{nullptr};
+  std::FILE* netstat_{nullptr};
+  std::FILE* sockstat_{nullptr};
+  std::FILE* tcp_mem_{nullptr};
+  bool owns_files_{true};
+  RawFields raw_{};
+  std::uint64_t prev_retrans_{0};
+  std::uint64_t prev_listen_drops_{0};
+  std::uint64_t prev_udp_buf_errors_{0};
+  std::uint64_t prev_timestamp_ns_{0};
+  bool has_prev_{false};
+};
+
+}  // namespace hw_agent::sensors
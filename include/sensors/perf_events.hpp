@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::sensors {
+
+// System-wide per-CPU perf_event_open counters. Each CPU gets one software group (cpu-clock leader
+// with context switches, migrations and major faults) and, when the PMU allows it, one hardware
+// group (instructions leader with cycles and cache misses). Each group is read with a single
+// read() in PERF_FORMAT_GROUP layout.
+class PerfEventSensor {
+ public:
+  struct CpuGroup {
+    int cpu{-1};
+    // Group leader descriptors; members are only kept open so they stay in the group.
+    int software_fd{-1};
+    int hardware_fd{-1};
+    std::vector<int> member_fds{};
+  };
+
+  struct CpuRates {
+    int cpu{-1};
+    float context_switches_per_sec{0.0F};
+    float migrations_per_sec{0.0F};
+    float major_faults_per_sec{0.0F};
+    // Instructions per cycle and cache misses per second; 0 without a hardware group.
+    float ipc{0.0F};
+    float llc_misses_per_sec{0.0F};
+  };
+
+  struct RawFields {
+    std::size_t software_cpus{0};
+    std::size_t hardware_cpus{0};
+    // errno of the first failed open, 0 when every group opened.
+    int software_open_errno{0};
+    int hardware_open_errno{0};
+    std::vector<CpuRates> per_cpu{};
+    float context_switches_per_sec{0.0F};
+    float migrations_per_sec{0.0F};
+    float major_faults_per_sec{0.0F};
+    float ipc{0.0F};
+    float llc_misses_per_sec{0.0F};
+    int hot_cpu{-1};
+  };
+
+  PerfEventSensor();
+  explicit PerfEventSensor(std::vector<CpuGroup> cpus, bool owns_fds = false);
+  ~PerfEventSensor();
+
+  PerfEventSensor(const PerfEventSensor&) = delete;
+  PerfEventSensor& operator=(const PerfEventSensor&) = delete;
+  PerfEventSensor(PerfEventSensor&&) = delete;
+  PerfEventSensor& operator=(PerfEventSensor&&) = delete;
+
+  bool sample(model::signal_frame& frame) noexcept;
+  const RawFields& raw() const noexcept;
+  [[nodiscard]] bool available() const noexcept;
+  [[nodiscard]] bool hardware_available() const noexcept;
+
+ private:
+  static constexpr std::size_t kSoftwareEvents = 4;  // cpu-clock, context switches, migrations, major faults
+  static constexpr std::size_t kHardwareEvents = 3;  // instructions, cycles, cache misses
+
+  // read() layouts: {nr, values[nr]} and {nr, time_enabled, time_running, values[nr]}.
+  static constexpr std::size_t kSoftwareRecordWords = 1 + kSoftwareEvents;
+  static constexpr std::size_t kHardwareRecordWords = 3 + kHardwareEvents;
+
+  struct CpuHistory {
+    std::uint64_t software[kSoftwareEvents]{};
+    std::uint64_t hardware[kHardwareEvents]{};
+    std::uint64_t time_enabled{0};
+    std::uint64_t time_running{0};
+    bool has_software{false};
+    bool has_hardware{false};
+  };
+
+  void open_all_cpus();
+  static bool read_group(int fd, std::uint64_t* words, std::size_t word_count) noexcept;
+
+  std::vector<CpuGroup> cpus_{};
+  std::vector<CpuHistory> history_{};
+  bool owns_fds_{true};
+  RawFields raw_{};
+  std::uint64_t prev_timestamp_ns_{0};
+  bool has_prev_timestamp_{false};
+};
+
+}  // namespace hw_agent::sensors
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::sensors {
+
+// RAPL energy counters exposed through the powercap framework (/sys/class/powercap/intel-rapl*).
+class PowerCapSensor {
+ public:
+  enum class Domain : std::uint8_t { package, dram };
+
+  struct RawFields {
+    std::size_t package_zones{0};
+    std::size_t dram_zones{0};
+    float package_watts{0.0F};
+    float package_limit_watts{0.0F};
+    float package_limit_ratio{0.0F};
+    float dram_watts{0.0F};
+    float dram_limit_watts{0.0F};
+    float dram_limit_ratio{0.0F};
+  };
+
+  struct ZoneSource {
+    std::string name{};
+    Domain domain{Domain::package};
+    std::FILE* energy_file{nullptr};
+    // Long-term (PL1) constraint; nullptr when the zone exposes no limit.
+    std::FILE* power_limit_file{nullptr};
+    // energy_uj wraps back to zero after this value; 0 disables wrap handling.
+    std::uint64_t max_energy_range_uj{0};
+
+    std::uint64_t prev_energy_uj{0};
+    bool has_prev_energy{false};
+  };
+
+  PowerCapSensor();
+  explicit PowerCapSensor(std::string powercap_root);
+  explicit PowerCapSensor(std::vector<ZoneSource> zones, bool owns_files = false);
+  ~PowerCapSensor();
+
+  PowerCapSensor(const PowerCapSensor&) = delete;
+  PowerCapSensor& operator=(const PowerCapSensor&) = delete;
+  PowerCapSensor(PowerCapSensor&&) = delete;
+  PowerCapSensor& operator=(PowerCapSensor&&) = delete;
+
+  bool sample(model::signal_frame& frame) noexcept;
+  const RawFields& raw() const noexcept;
+  const std::vector<ZoneSource>& zones() const noexcept;
+
+ private:
+  void discover_zones(const std::string& powercap_root);
+  static bool read_u64_file(std::FILE* file, std::uint64_t& value) noexcept;
+
+  std::vector<ZoneSource> zones_{};
+  bool owns_files_{true};
+  RawFields raw_{};
+  std::uint64_t prev_timestamp_ns_{0};
+  bool has_prev_timestamp_{false};
+};
+
+}  // namespace hw_agent::sensors
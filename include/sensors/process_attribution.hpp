@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::sensors {
+
+struct ProcessAttributionOptions {
+  std::string proc_root{"/proc"};
+  std::size_t top_n{5};
+  // Share of one CPU (percent of the tick interval) a scan step may spend in thread CPU time.
+  float cpu_budget_pct{2.0F};
+  std::chrono::nanoseconds tick_interval{std::chrono::milliseconds(100)};
+  // Hard cap on processes read per step, 0 for budget-only pacing.
+  std::size_t max_pids_per_step{0};
+};
+
+// Top-N culprit attribution. Idle (no descriptors, no buffers) until risk:state reaches DEGRADED
+// or a scan is requested, then walks /proc with getdents64 a few hundred PIDs per tick, reading
+// <pid>/stat, io and schedstat through a cached /proc dirfd. Each completed pass after the first
+// yields per-process rates and the top offenders by CPU, major faults, IO bytes and run delay.
+class ProcessAttribution {
+ public:
+  static constexpr std::size_t kCommSize = 16;
+
+  struct ProcessRates {
+    int pid{0};
+    std::array<char, kCommSize> comm{};
+    float cpu_pct{0.0F};
+    float major_faults_per_sec{0.0F};
+    float io_bytes_per_sec{0.0F};
+    float run_delay_ms_per_sec{0.0F};
+  };
+
+  struct Report {
+    std::uint64_t completed_ns{0};
+    model::system_state state{model::system_state::STABLE};
+    std::size_t processes{0};
+    std::size_t steps{0};
+    std::vector<ProcessRates> top_cpu{};
+    std::vector<ProcessRates> top_major_faults{};
+    std::vector<ProcessRates> top_io{};
+    std::vector<ProcessRates> top_run_delay{};
+  };
+
+  explicit ProcessAttribution(ProcessAttributionOptions options = {});
+  ~ProcessAttribution();
+
+  ProcessAttribution(const ProcessAttribution&) = delete;
+  ProcessAttribution& operator=(const ProcessAttribution&) = delete;
+  ProcessAttribution(ProcessAttribution&&) = delete;
+  ProcessAttribution& operator=(ProcessAttribution&&) = delete;
+
+  // Runs the next baseline + measured pass regardless of risk state.
+  void request_scan() noexcept;
+  // Advances the scan within the step budget; true when a new report is ready.
+  bool step(const model::signal_frame& frame);
+  [[nodiscard]] bool active() const noexcept;
+  const Report& report() const noexcept;
+
+ private:
+  struct Counters {
+    int pid{0};
+    std::array<char, kCommSize> comm{};
+    std::uint64_t cpu_ticks{0};
+    std::uint64_t major_faults{0};
+    std::uint64_t io_bytes{0};
+    std::uint64_t run_delay_ns{0};
+    std::uint64_t sampled_ns{0};
+  };
+
+  static constexpr std::size_t kDirentBufferSize = 32 * 1024;
+
+  bool open_proc();
+  void release();
+  bool read_process(int pid, std::uint64_t sampled_ns, Counters& counters) const;
+  bool finish_pass(const model::signal_frame& frame);
+
+  ProcessAttributionOptions options_;
+  int proc_fd_{-1};
+  long clock_ticks_per_sec_{100};
+  std::vector<char> dirent_buffer_{};
+  std::size_t dirent_offset_{0};
+  std::size_t dirent_size_{0};
+  std::vector<Counters> current_{};
+  std::vector<Counters> previous_{};
+  std::vector<ProcessRates> rates_{};
+  std::size_t pass_steps_{0};
+  unsigned requested_passes_{0};
+  Report report_{};
+};
+
+}  // namespace hw_agent::sensors
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::sensors {
+
+class SchedstatSensor {
+ public:
+  struct CpuCounters {
+    int cpu{-1};
+    // Nanoseconds tasks spent running / waiting on this runqueue, and timeslices run.
+    std::uint64_t run_time_ns{0};
+    std::uint64_t run_delay_ns{0};
+    std::uint64_t timeslices{0};
+  };
+
+  struct CpuRates {
+    int cpu{-1};
+    // Runqueue wait in milliseconds per second of wall time (1000 = one task always waiting).
+    float run_delay_ms_per_sec{0.0F};
+    float timeslices_per_sec{0.0F};
+    float wait_per_timeslice_us{0.0F};
+  };
+
+  struct RawFields {
+    unsigned version{0};
+    std::size_t cpu_count{0};
+    std::vector<CpuRates> per_cpu{};
+    float mean_run_delay_ms_per_sec{0.0F};
+    float p99_run_delay_ms_per_sec{0.0F};
+    float max_run_delay_ms_per_sec{0.0F};
+    // CPU with the largest run delay this sample, -1 when nothing waited.
+    int worst_cpu{-1};
+    float wait_per_timeslice_us{0.0F};
+  };
+
+  SchedstatSensor();
+  explicit SchedstatSensor(std::FILE* file, bool owns_file = false);
+  ~SchedstatSensor();
+
+  SchedstatSensor(const SchedstatSensor&) = delete;
+  SchedstatSensor& operator=(const SchedstatSensor&) = delete;
+
+  bool sample(model::signal_frame& frame) noexcept;
+  const RawFields& raw() const noexcept;
+
+ private:
+  // Domain lines carry ~40 counters; cpu lines are short and always fit.
+  static constexpr std::size_t kReadBufferSize = 1024;
+
+  void publish_zero(model::signal_frame& frame) noexcept;
+
+  std::FILE* file_{nullptr};
+  bool owns_file_{true};
+  RawFields raw_{};
+  std::vector<CpuCounters> current_{};
+  std::vector<CpuCounters> previous_{};
+  std::vector<float> sorted_delays_{};
+  std::uint64_t prev_timestamp_ns_{0};
+  bool has_prev_{false};
+};
+
+}  // namespace hw_agent::sensors
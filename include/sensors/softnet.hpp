@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::sensors {
+
+class SoftnetSensor {
+ public:
+  struct CpuCounters {
+    std::uint64_t processed{0};
+    std::uint64_t dropped{0};
+    std::uint64_t time_squeeze{0};
+  };
+
+  struct RawFields {
+    std::size_t cpu_count{0};
+    std::uint64_t dropped_delta{0};
+    std::uint64_t time_squeeze_delta{0};
+    float dropped_per_sec{0.0F};
+    float time_squeeze_per_sec{0.0F};
+    // CPU with the largest dropped+time_squeeze delta this sample, -1 when idle.
+    int hottest_cpu{-1};
+    std::uint64_t hottest_cpu_events{0};
+  };
+
+  SoftnetSensor();
+  explicit SoftnetSensor(std::FILE* file, bool owns_file = false);
+  ~SoftnetSensor();
+
+  SoftnetSensor(const SoftnetSensor&) = delete;
+  SoftnetSensor& operator=(const SoftnetSensor&) = delete;
+
+  bool sample(model::signal_frame& frame) noexcept;
+  const RawFields& raw() const noexcept;
+
+ private:
+  static constexpr std::size_t kReadBufferSize = 512;
+  static constexpr std::size_t kMaxColumns = 16;
+
+  std::FILE* file_{nullptr};
+  bool owns_file_{true};
+  RawFields raw_{};
+  std::vector<CpuCounters> current_{};
+  std::vector<CpuCounters> previous_{};
+  std::vector<int> cpu_ids_{};
+  std::uint64_t prev_timestamp_ns_{0};
+  bool has_prev_{false};
+};
+
+}  // namespace hw_agent::sensors
@@ -1,9 +1,9 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
-#include <string>
+#include <string_view>
 #include <sys/types.h>
-#include <unordered_map>
 
 #include "model/signal_frame.hpp"
 
@@ -11,36 +11,79 @@ namespace hw_agent::sensors {
 
 class TegraStatsSensor {
  public:
+  static constexpr std::size_t kMaxTableEntries = 16;
+  static constexpr std::size_t kMaxNameSize = 24;
+
+  // Fixed-capacity name -> value table; names beyond kMaxTableEntries are counted and dropped.
+  class NamedValues {
+   public:
+    struct Entry {
+      std::array<char, kMaxNameSize> name{};
+      std::uint8_t name_size{0};
+      float value{0.0F};
+
+      [[nodiscard]] std::string_view key() const noexcept { return {name.data(), name_size}; }
+    };
+
+    bool set(std::string_view name, float value) noexcept;
+    [[nodiscard]] const float* find(std::string_view name) const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::size_t dropped() const noexcept { return dropped_; }
+    [[nodiscard]] const Entry* begin() const noexcept { return entries_.data(); }
+    [[nodiscard]] const Entry* end() const noexcept { return entries_.data() + size_; }
+
+   private:
+    std::array<Entry, kMaxTableEntries> entries_{};
+    std::size_t size_{0};
+    std::size_t dropped_{0};
+  };
+
   struct RawFields {
     float gpu_util_pct{0.0F};
     // EMC_FREQ percentage from tegrastats ([0,100]).
     float emc_util_pct{0.0F};
     float total_rail_power_mw{0.0F};
-    std::unordered_map<std::string, float> rail_power_mw{};
-    std::unordered_map<std::string, float> temperatures_c{};
+    NamedValues rail_power_mw{};
+    NamedValues temperatures_c{};
+    // Lines longer than the read ring that had to be discarded.
+    std::size_t overlong_lines{0};
   };
 
   explicit TegraStatsSensor(std::uint32_t interval_ms = 1000U) noexcept;
+  // Reads tegrastats output from an already open descriptor (pipe or recording); -1 leaves the
+  // sensor disabled so parse_line can be driven directly.
+  TegraStatsSensor(int read_fd, bool owns_fd) noexcept;
   ~TegraStatsSensor();
 
   TegraStatsSensor(const TegraStatsSensor&) = delete;
   TegraStatsSensor& operator=(const TegraStatsSensor&) = delete;
 
   bool sample(model::signal_frame& frame) noexcept;
+  // Single pass over whitespace-separated tokens; never allocates. True when any field was found.
+  bool parse_line(std::string_view line) noexcept;
 
   [[nodiscard]] bool enabled() const noexcept;
   [[nodiscard]] const RawFields& raw() const noexcept;
 
  private:
+  // Power of two so ring offsets wrap with a mask; tegrastats lines are a few hundred bytes.
+  static constexpr std::size_t kRingSize = 8192;
+
   bool launch(std::uint32_t interval_ms) noexcept;
   void disable() noexcept;
-  void disable_non_blocking() noexcept;
-  bool parse_line(const std::string& line);
+  bool drain_lines() noexcept;
 
   int read_fd_{-1};
   pid_t child_pid_{-1};
+  bool owns_fd_{true};
   bool enabled_{false};
-  std::string read_buffer_{};
+  // Free-running offsets into ring_; the unread region is [ring_tail_, ring_head_).
+  std::array<char, kRingSize> ring_{};
+  std::size_t ring_head_{0};
+  std::size_t ring_tail_{0};
+  std::size_t ring_scanned_{0};
+  bool discarding_line_{false};
+  std::array<char, kRingSize> line_scratch_{};
   RawFields raw_{};
 };
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <cstdio>
 #include <string>
 #include <vector>
@@ -15,16 +17,29 @@ class ThermalSensor {
     float hottest_temp_c{0.0F};
     float throttle_temp_c{85.0F};
     float headroom_c{0.0F};
+    // Zone with the least headroom to its own trip point (or throttle_temp_c when it has none).
+    std::string limiting_zone{};
+    float limiting_trip_c{0.0F};
+    // Steepest per-zone temperature slope over the history window, in degrees C per second.
+    float max_slope_c_per_s{0.0F};
+    // Shortest projected time for a warming zone to reach its trip: 0 when a zone is at or past it,
+    // kMaxSecondsToTrip when none is warming or no zone could be read.
+    float seconds_to_trip{kMaxSecondsToTrip};
   };
 
   struct ZoneSource {
     std::string name{};
     std::string temp_path{};
     std::FILE* file{nullptr};
+    // Lowest passive/hot/critical trip (thermal zones) or max/crit limit (hwmon), 0 when unknown.
+    float trip_temp_c{0.0F};
   };
 
+  static constexpr float kMaxSecondsToTrip = 3600.0F;
+
   explicit ThermalSensor(float throttle_temp_c = 85.0F);
   ThermalSensor(float throttle_temp_c, std::string thermal_root);
+  ThermalSensor(float throttle_temp_c, std::string thermal_root, std::string hwmon_root);
   ThermalSensor(float throttle_temp_c, std::vector<ZoneSource> zones, bool owns_files = false);
   ~ThermalSensor();
 
@@ -36,12 +51,25 @@ class ThermalSensor {
   bool sample(model::signal_frame& frame) noexcept;
   void set_throttle_temp_c(float throttle_temp_c) noexcept;
   const RawFields& raw() const noexcept;
+  const std::vector<ZoneSource>& zones() const noexcept;
 
  private:
+  static constexpr std::size_t kSlopeWindow = 8;
+
+  struct ZoneHistory {
+    std::array<float, kSlopeWindow> temp_c{};
+    std::array<std::uint64_t, kSlopeWindow> timestamp_ns{};
+    std::size_t count{0};
+    std::size_t next{0};
+  };
+
   void discover_zones(const std::string& thermal_root);
+  void discover_hwmon(const std::string& hwmon_root);
   static bool read_temp_c(std::FILE* file, float& temp_c) noexcept;
+  static float slope_c_per_s(const ZoneHistory& history) noexcept;
 
   std::vector<ZoneSource> zones_{};
+  std::vector<ZoneHistory> history_{};
   bool owns_files_{true};
   RawFields raw_{};
 };
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+
+#include "model/signal_frame.hpp"
+
+namespace hw_agent::sensors {
+
+// Log-linear (HDR-style) histogram of nanosecond values with 1/16 (~6%) relative precision up to ~68 s.
+// Single writer, any number of readers: the writer bumps counters with relaxed load/store pairs,
+// readers take relaxed snapshots and diff them against the previous one to get a window.
+class LatencyHistogram {
+ public:
+  static constexpr unsigned kSubBucketBits = 5;
+  static constexpr std::uint64_t kSubBucketCount = 1ULL << kSubBucketBits;
+  static constexpr std::uint64_t kHalfSubBucketCount = kSubBucketCount / 2;
+  static constexpr unsigned kMaxExponent = 32;
+  static constexpr std::size_t kBucketCount = kSubBucketCount + (kMaxExponent * kHalfSubBucketCount);
+
+  using Snapshot = std::array<std::uint64_t, kBucketCount>;
+
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void record(std::uint64_t value_ns) noexcept;
+  void snapshot(Snapshot& out) const noexcept;
+  // Largest value recorded since the last call; resets the running maximum.
+  std::uint64_t take_max() noexcept;
+
+  static std::size_t bucket_index(std::uint64_t value_ns) noexcept;
+  // Highest value that maps to bucket, the HDR "highest equivalent value".
+  static std::uint64_t bucket_upper_bound(std::size_t bucket) noexcept;
+  // Nearest-rank percentile over a window of counts; 0 when the window is empty.
+  static std::uint64_t percentile(const Snapshot& counts, std::uint64_t total, double quantile) noexcept;
+
+ private:
+  std::array<std::atomic<std::uint64_t>, kBucketCount> counts_{};
+  std::atomic<std::uint64_t> max_ns_{0};
+};
+
+struct WakeupLatencyOptions {
+  // CPUs to pin one probe thread to; empty selects CPU 0.
+  std::vector<int> cpus{};
+  // SCHED_FIFO, SCHED_RR or SCHED_OTHER; RT policies fall back to SCHED_OTHER when refused.
+  int policy{SCHED_FIFO};
+  int priority{80};
+  std::chrono::microseconds interval{1000};
+};
+
+// cyclictest-style probe: one thread per selected CPU sleeps to absolute CLOCK_MONOTONIC deadlines
+// and records how late each wakeup was. The agent thread reads per-window percentiles without locks.
+class WakeupLatencyProbe {
+ public:
+  struct CpuLatency {
+    int cpu{-1};
+    std::uint64_t samples{0};
+    float p50_us{0.0F};
+    float p99_us{0.0F};
+    float p999_us{0.0F};
+    float max_us{0.0F};
+  };
+
+  struct RawFields {
+    std::vector<CpuLatency> per_cpu{};
+    // Threads running at the requested RT policy, and the first scheduling/affinity error seen.
+    std::size_t realtime_threads{0};
+    int setup_errno{0};
+  };
+
+  explicit WakeupLatencyProbe(WakeupLatencyOptions options = {});
+  ~WakeupLatencyProbe();
+
+  WakeupLatencyProbe(const WakeupLatencyProbe&) = delete;
+  WakeupLatencyProbe& operator=(const WakeupLatencyProbe&) = delete;
+
+  void start();
+  void stop() noexcept;
+  bool sample(model::signal_frame& frame) noexcept;
+  const RawFields& raw() const noexcept;
+
+ private:
+  struct CpuProbe {
+    int cpu{-1};
+    LatencyHistogram histogram{};
+    LatencyHistogram::Snapshot previous{};
+    LatencyHistogram::Snapshot window{};
+    std::atomic<int> setup_errno{0};
+    std::atomic<bool> realtime{false};
+    std::thread thread{};
+  };
+
+  void run(CpuProbe& probe) noexcept;
+
+  WakeupLatencyOptions options_;
+  std::vector<std::unique_ptr<CpuProbe>> probes_{};
+  std::atomic<bool> running_{false};
+  RawFields raw_{};
+};
+
+}  // namespace hw_agent::sensors
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hw_agent::sinks {
+
+// Append-only ring of frames in a memory-mapped file, so samples taken while Redis is unreachable
+// survive until they can be backfilled, including across an agent restart. A frame is its wall-clock
+// timestamp plus one double per TS.MADD series, in template slot order. When full, the oldest frame
+// is overwritten. Frames are addressed by a sequence number that keeps counting across wraparound,
+// so a reader can release exactly what it sent even if the ring moved meanwhile.
+class FrameSpool {
+ public:
+  FrameSpool() = default;
+  // Opens or creates path sized to at most max_bytes. An existing file written for another series
+  // layout (see layout_hash) or frame size is started over.
+  FrameSpool(const std::string& path, std::uint64_t layout, std::size_t values_per_frame, std::size_t max_bytes);
+  ~FrameSpool();
+
+  FrameSpool(const FrameSpool&) = delete;
+  FrameSpool& operator=(const FrameSpool&) = delete;
+  FrameSpool(FrameSpool&& other) noexcept;
+  FrameSpool& operator=(FrameSpool&& other) noexcept;
+
+  [[nodiscard]] bool is_open() const noexcept { return header_ != nullptr; }
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] std::size_t capacity() const noexcept;
+  // Frames lost to wraparound since the file was created.
+  [[nodiscard]] std::uint64_t overwritten() const noexcept;
+  // Sequence number of the oldest frame held.
+  [[nodiscard]] std::uint64_t first_sequence() const noexcept;
+
+  // values holds values_per_frame doubles.
+  void push(std::uint64_t timestamp_ms, const double* values) noexcept;
+  // Copies the index-th oldest frame; false when index >= size().
+  bool read(std::size_t index, std::uint64_t& timestamp_ms, double* values) const noexcept;
+  // Drops every frame with a sequence number below sequence.
+  void release_until(std::uint64_t sequence) noexcept;
+
+  // FNV-1a over the series keys, so a spool is never replayed into differently ordered series.
+  static std::uint64_t layout_hash(const std::vector<std::string>& keys) noexcept;
+
+ private:
+  struct Header;
+
+  [[nodiscard]] unsigned char* record(std::uint64_t slot) const noexcept;
+  void close() noexcept;
+
+  Header* header_{nullptr};
+  std::size_t mapped_bytes_{0};
+  std::size_t record_bytes_{0};
+};
+
+}  // namespace hw_agent::sinks
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct redisReply;
+
+namespace hw_agent::sinks {
+
+// Redis Cluster hashes the {tag} of a key (the whole key when it has none) with CRC16 into one of
+// 16384 slots; keys sharing a tag share a slot and can go in one multi-key command.
+inline constexpr std::uint16_t kClusterSlots = 16384;
+[[nodiscard]] std::uint16_t cluster_key_slot(std::string_view key) noexcept;
+
+struct ClusterEndpoint {
+  std::string host{};
+  std::uint16_t port{0};
+
+  bool operator==(const ClusterEndpoint&) const = default;
+};
+
+// A "MOVED <slot> <host>:<port>" or "ASK <slot> <host>:<port>" error reply. The host is empty when
+// the node does not know its own address; the client keeps the one it used.
+struct ClusterRedirect {
+  bool ask{false};
+  std::uint16_t slot{0};
+  ClusterEndpoint endpoint{};
+};
+
+// False when message is not a redirection.
+bool parse_cluster_redirect(std::string_view message, ClusterRedirect& redirect);
+
+// Slot ranges and the master serving each, from CLUSTER SLOTS and patched by MOVED in between.
+class ClusterSlotMap {
+ public:
+  // Replaces the map with a CLUSTER SLOTS reply; masters announced without an address ("" or "?")
+  // get fallback_host. False, leaving the map untouched, when reply is not a slot table.
+  bool update(const redisReply* reply, const std::string& fallback_host);
+  void assign(std::uint16_t slot, const ClusterEndpoint& endpoint);
+  // nullptr when the slot is not covered.
+  [[nodiscard]] const ClusterEndpoint* owner(std::uint16_t slot) const noexcept;
+  [[nodiscard]] bool empty() const noexcept { return ranges_.empty(); }
+
+ private:
+  struct Range {
+    std::uint16_t first{0};
+    std::uint16_t last{0};
+    ClusterEndpoint endpoint{};
+  };
+
+  std::vector<Range> ranges_;
+};
+
+}  // namespace hw_agent::sinks
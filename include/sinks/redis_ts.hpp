@@ -1,17 +1,51 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <random>
+#include <span>
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "model/signal_frame.hpp"
+#include "sensors/gpu/gpu.hpp"
+#include "sensors/perf_events.hpp"
+#include "sensors/process_attribution.hpp"
+#include "sensors/wakeup_latency.hpp"
+#include "sinks/frame_spool.hpp"
+#include "sinks/redis_cluster.hpp"
+#include "sinks/resp_template.hpp"
 
 struct redisContext;
+struct redisReply;
 
 namespace hw_agent::sinks {
 
+// TS.CREATERULE target <key>:<aggregation>_<bucket> (retention 0 keeps every bucket).
+struct TsCompaction {
+  std::string aggregation{};
+  std::uint64_t bucket_ms{0};
+  std::uint64_t retention_ms{0};
+};
+
+// One PUBLISH <prefix>:events message: a risk:state transition, or a PSI threshold or sensor
+// failure turning on (onset) or off (recovery).
+struct RiskEvent {
+  enum class Kind : std::uint8_t { state, psi, sensor };
+  Kind kind{Kind::state};
+  // psi: "cpu", "memory" or "io"; sensor: registry name; state: empty.
+  const char* source{""};
+  // state: the new state is worse than previous; psi/sensor: the condition started.
+  bool onset{false};
+  // state only; other events report the frame's state as both previous and new.
+  model::system_state previous{model::system_state::STABLE};
+};
+
 struct RedisTsOptions {
   std::string host{"127.0.0.1"};
   std::uint16_t port{6379};
@@ -22,6 +56,47 @@ struct RedisTsOptions {
   std::uint32_t connect_timeout_ms{1000};
   bool publish_health{true};
   std::vector<std::string> enabled_metrics{};
+  // Async mode never waits on Redis inside a tick: commands are pipelined on a non-blocking
+  // connection and replies are handled as they arrive (see service_until).
+  bool async{false};
+  // TS.MADD frames awaiting a reply before new frames are dropped.
+  std::uint32_t max_in_flight{4};
+  // A connection whose oldest reply is this late is dropped and reconnected.
+  std::uint32_t reply_timeout_ms{2000};
+  // Connects never block a tick (both modes poll a non-blocking connect and handshake). After a
+  // failure the next attempt waits a jittered delay doubling from reconnect_min_ms up to
+  // reconnect_max_ms; agent:redis_breaker reports closed (0), half-open (1) or open (2).
+  std::uint32_t reconnect_min_ms{100};
+  std::uint32_t reconnect_max_ms{30000};
+  // Change-only mode writes a series only when its sensor refreshed it (see mark_refreshed) and it
+  // moved by more than its deadband since the last written sample, or keepalive_ms has passed.
+  bool change_only{false};
+  std::uint32_t keepalive_ms{10000};
+  // Absolute deadbands by metric suffix ("raw:memory" -> 0.5); unlisted series use 0.
+  std::vector<std::pair<std::string, double>> deadbands{};
+  // Batching joins up to batch_ticks ticks (1 disables it), each with its own timestamp, into one
+  // TS.MADD. batch_ms (0: no limit) bounds how long the oldest held tick waits; a risk:state
+  // change always flushes at once.
+  std::uint32_t batch_ticks{1};
+  std::uint32_t batch_ms{0};
+  // Frames that could not be written are kept in this memory-mapped file (empty disables it) and
+  // backfilled with their original timestamps once Redis is back, at most spool_drain_frames per
+  // write so live frames keep their cadence.
+  std::string spool_path{};
+  std::size_t spool_max_bytes{64U * 1024U * 1024U};
+  std::uint32_t spool_drain_frames{10};
+  // Schema: every series is labelled node (node_label, or key_prefix when empty), family, metric
+  // and sensor, stored compressed with this retention (0: forever) and chunk size in bytes.
+  std::string node_label{};
+  std::uint64_t retention_ms{0};
+  std::uint32_t chunk_size{4096};
+  std::vector<TsCompaction> compactions{};
+  // publish_frame_stream() target: XADD <prefix>:frames MAXLEN ~ frames_maxlen * f <binary frame>.
+  std::uint32_t frames_maxlen{3000};
+  // Redis Cluster: host:port is a seed node. Keys become {<node>}:<suffix> with node the node_label
+  // (the host name when empty), so every key hashes to one slot and a frame stays one TS.MADD.
+  // The slot's master comes from a cached CLUSTER SLOTS; MOVED and ASK replies redirect to it.
+  bool cluster{false};
 };
 
 class RedisTsSink {
@@ -36,29 +111,205 @@ class RedisTsSink {
 
   bool check_connectivity();
   bool publish(model::signal_frame& frame);
+  // Change-only mode: handle for mark_refreshed() naming the agent's registry sensor, or -1 when no
+  // published series comes from that sensor (or change-only mode is off).
+  [[nodiscard]] int refresh_group(const std::string& sensor) const;
+  // The sensor ran this tick; its series are compared again on the next publish.
+  void mark_refreshed(int group) noexcept;
+  // Async mode: waits for socket readiness until deadline, handling replies as they arrive, so the
+  // agent can sleep here instead of in sleep_until. Sync mode just sleeps.
+  void service_until(std::chrono::steady_clock::time_point deadline);
+  // The same for several sinks at once: one wait on every async connection, so replies to one
+  // target are handled while another is slow or down.
+  static void service_until(std::span<RedisTsSink* const> sinks, std::chrono::steady_clock::time_point deadline);
+  // Async sinks service_until() can wait on together.
+  static constexpr std::size_t kMaxServicedSinks = 16;
+  // XADD of the latest top-N culprits to <prefix>:culprits (capped with MAXLEN ~).
+  bool publish_attribution(const sensors::ProcessAttribution::Report& report);
+  // Pipelined TS.ADD of per-CPU probe percentiles to <prefix>:raw:wakeup_latency_<stat>_us:cpu<N>.
+  bool publish_wakeup_latency(const std::vector<sensors::WakeupLatencyProbe::CpuLatency>& per_cpu);
+  // Pipelined TS.ADD of per-CPU perf rates to <prefix>:raw:perf_<stat>:cpu<N>; ipc and llc_misses
+  // only with hardware counters.
+  bool publish_perf_per_cpu(const std::vector<sensors::PerfEventSensor::CpuRates>& per_cpu, bool hardware);
+  // Pipelined TS.ADD of per-device GPU readings to <prefix>:raw:<source>_gpu_<stat>:gpu<N>.
+  bool publish_gpu_devices(const char* source, const std::vector<sensors::gpu::GpuDeviceSample>& devices);
+  // Pipelined XADD of one entry per cgroup to <prefix>:gpu_workloads (capped with MAXLEN ~).
+  bool publish_gpu_workloads(const std::vector<sensors::gpu::GpuWorkload>& workloads);
+  // PUBLISH of event to <prefix>:events with the frame's state, risk and pressures, written at once
+  // rather than batched. Every call takes the next sequence number, so lost messages show as gaps.
+  bool publish_event(const RiskEvent& event, const model::signal_frame& frame);
+  // XADD of the whole frame in the model/frame_codec.hpp encoding to <prefix>:frames, stamped with
+  // the last TS.MADD timestamp, for consumers that XREAD BLOCK instead of polling series.
+  bool publish_frame_stream(const model::signal_frame& frame);
 
  private:
   struct ContextDeleter {
     void operator()(redisContext* context) const;
   };
 
+  enum class ReplyKind : std::uint8_t { handshake, schema, frame, backfill, auxiliary, slots, asking };
+
+  struct PendingReply {
+    ReplyKind kind{ReplyKind::auxiliary};
+    std::chrono::steady_clock::time_point sent_at{};
+  };
+
+  // Cumulative power-of-two buckets: counts[i] holds observations <= 2^i, the last one +Inf.
+  struct Log2Histogram {
+    std::array<std::uint64_t, 12> counts{};
+    void record(double value) noexcept;
+  };
+
+  // One TS.MADD series: its row in the sink's metric table and change-only bookkeeping.
+  struct SeriesSlot {
+    std::size_t metric{0};
+    // Index into refreshed_, or -1 for series recomputed every tick.
+    int group{-1};
+    double deadband{0.0};
+    double value{0.0};
+    double sent_value{0.0};
+    std::uint64_t sent_at_ms{0};
+  };
+
   bool ensure_connected();
-  bool reconnect();
-  bool authenticate();
-  bool select_db();
-  bool ensure_schema();
+  // Sync mode: the pipelined handshake was answered; frames now wait for their replies.
+  bool finish_sync_handshake();
+  [[nodiscard]] std::uint32_t breaker_state() const noexcept;
+  // Counts a failed connect or a dropped connection and sets the next attempt's backoff.
+  void schedule_reconnect();
+  // Renders every TS.CREATE / TS.ALTER / TS.CREATERULE into schema_command_.
+  void build_schema(const std::vector<std::string>& keys);
   bool publish_impl(model::signal_frame& frame);
-  void reserve_command_buffers();
+  // Fills the template and picks the series to write into frame_command_.
+  bool render_frame(const model::signal_frame& frame);
+  // The rendered frame was written: remember what each series last sent.
+  void commit_frame();
+  // Every series goes out with the next frame, as after a connect.
+  void resend_all() noexcept;
+  // Adds the rendered tick to the batch; true (with frame_command_ set) when the batch is due.
+  bool batch_frame(const model::signal_frame& frame);
+  // TS.ADD of both batching histograms to <prefix>:agent:redis_<name>:le<bound>, every few seconds.
+  bool publish_batch_histograms();
+  bool publish_sync(model::signal_frame& frame);
+  // Keeps the current tick (or the held batch) in the spool after a failed write.
+  void spool_unwritten(const model::signal_frame& frame);
+  void spool_values(const model::signal_frame& frame, double* values) const;
+  // Sends the oldest spooled frames as one TS.MADD; they are released once Redis accepts it.
+  bool drain_spool();
+  // Writes a pre-rendered RESP command, bypassing hiredis's argv formatting.
+  bool write_command(std::string_view command);
+  bool write_raw(std::string_view command);
+  // Cluster ASK mode: the ASKING that must precede each command, and its reply.
+  bool write_asking(bool buffered);
+  void expect_asking_reply();
+  // Sync mode: flushes buffered output and waits on the non-blocking socket for one reply, at most
+  // reply_timeout_ms. False (with *reply null) on an I/O error or timeout.
+  bool wait_reply(void** reply);
+  // Sync mode: reads the ASKING replies queued ahead of a single command's reply.
+  bool skip_asking_replies();
+  // Cluster mode: a MOVED or ASK error reply reconnects to the node it names; false otherwise.
+  bool follow_redirect(const char* message);
+  // Cluster mode: the CLUSTER SLOTS reply; reconnects when our slot lives elsewhere.
+  void apply_slot_map(const redisReply* reply);
+  void redirect_to(const ClusterEndpoint& endpoint, const char* reason);
+  // Appends a TS.ADD of <prefix>:<suffix> carrying the schema's retention, encoding, chunk size and
+  // labels, which apply when the add creates the key (per-CPU, per-GPU and histogram series).
+  bool append_series_add(std::string_view suffix, std::string_view timestamp, std::string_view value,
+                         std::string_view sensor);
+  // Appends one command to the output buffer; async mode also queues its reply for handle_reply.
+  bool append_command(ReplyKind kind, int argc, const char** argv, const std::size_t* argv_len);
+  // Sync mode reads count replies; async mode only starts writing and lets handle_reply see them.
+  bool collect_replies(std::size_t count);
+
+  bool publish_async(model::signal_frame& frame);
+  bool async_ready() const;
+  void async_start_connect();
+  void async_finish_connect();
+  void async_service();
+  bool async_flush();
+  void drop_connection(const char* reason);
+  void handle_reply(const PendingReply& pending, const redisReply* reply);
 
   RedisTsOptions options_;
   std::unique_ptr<redisContext, ContextDeleter> context_;
-  std::vector<std::string> command_args_;
-  std::vector<const char*> command_argv_;
-  std::vector<std::size_t> command_argv_len_;
   std::vector<std::string> enabled_metrics_;
-  std::unordered_set<std::string> enabled_metric_set_;
+  MaddTemplate frame_template_;
+  std::vector<SeriesSlot> slots_;
+  std::vector<const char*> refresh_sensors_;
+  std::vector<std::uint8_t> refreshed_;
+  std::vector<std::uint8_t> selected_;
+  std::string_view frame_command_{};
+  std::uint64_t frame_timestamp_ms_{0};
+  std::uint32_t frame_samples_{0};
+  std::uint32_t last_samples_{0};
+  std::uint32_t last_suppressed_{0};
+
+  std::string batch_body_;
+  std::string batch_command_;
+  std::size_t batch_series_{0};
+  std::uint32_t batch_ticks_held_{0};
+  // risk:state of the last batched tick; the sentinel makes the first tick flush.
+  std::uint8_t batch_state_{0xFF};
+  std::chrono::steady_clock::time_point batch_started_{};
+  Log2Histogram batch_size_histogram_{};
+  Log2Histogram flush_latency_histogram_{};
+  std::chrono::steady_clock::time_point histograms_published_{};
+
+  FrameSpool spool_;
+  // Same keys as frame_template_, so backfill never disturbs the live template's digits.
+  MaddTemplate spool_template_;
+  std::vector<std::uint8_t> all_slots_;
+  std::vector<double> spool_values_;
+  std::vector<std::uint64_t> batch_timestamps_;
+  std::vector<double> batch_values_;
+  std::string drain_body_;
+  std::string drain_command_;
+  bool backfill_in_flight_{false};
+  std::uint64_t backfill_until_{0};
   bool timeseries_available_{true};
   bool schema_ready_{false};
+  // One pipelined write creating the whole schema, and the replies it produces.
+  std::string schema_command_;
+  // Rendered once by build_schema for series that TS.ADD creates.
+  std::string series_node_;
+  std::string series_retention_;
+  std::string series_chunk_size_;
+  // TS.ADD key ts value + 9 option words + 8 label words.
+  static constexpr std::size_t kMaxSeriesAddArgs = 21;
+  std::size_t schema_commands_{0};
+  // Pre-rendered frames-stream XADD; the encoded frame is rewritten in place at stream_payload_.
+  std::string stream_command_;
+  std::size_t stream_payload_{0};
+  std::string event_channel_;
+  std::uint64_t event_sequence_{0};
+
+  // Cluster mode: the slot every key hashes to, the node currently written to and the cached
+  // slot map (refreshed on the next connect after a MOVED).
+  std::uint16_t cluster_slot_{0};
+  ClusterEndpoint target_{};
+  ClusterSlotMap slot_map_;
+  bool slot_map_stale_{true};
+  // ASK: our slot is migrating to target_, which only accepts commands preceded by ASKING.
+  bool asking_{false};
+  std::size_t asking_replies_{0};
+  // Redirects since the last accepted frame; past a few, reconnects back off as after failures.
+  std::uint32_t redirects_{0};
+
+  std::deque<PendingReply> pending_replies_;
+  std::size_t frames_in_flight_{0};
+  std::size_t schema_replies_pending_{0};
+  bool schema_failed_{false};
+  bool connecting_{false};
+  // Sync mode: connected, but AUTH/SELECT/schema replies are still being collected across ticks.
+  bool handshake_pending_{false};
+  bool output_pending_{false};
+  std::chrono::steady_clock::time_point connect_started_{};
+  std::chrono::steady_clock::time_point next_connect_attempt_{};
+  std::uint32_t connect_failures_{0};
+  std::minstd_rand backoff_rng_{std::random_device{}()};
+  float last_reply_latency_ms_{0.0F};
+  std::uint32_t reply_errors_{0};
+  std::uint32_t dropped_frames_{0};
 };
 
 }  // namespace hw_agent::sinks
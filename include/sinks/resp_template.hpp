@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hw_agent::sinks {
+
+// "TS.MADD key timestamp value ..." rendered once as RESP with fixed key slots and fixed-width
+// timestamp and value fields. A tick only overwrites digits in place: no per-tick strings,
+// hashing or argv formatting, and the result is written to the socket as is.
+class MaddTemplate {
+ public:
+  // Wall-clock milliseconds have 13 digits from 2001 to 2286; RESP integers cannot be zero-padded.
+  static constexpr std::size_t kTimestampWidth = 13;
+  // Shortest round-trip float (or an integer below 1e14) padded with zeros in the mantissa, e.g.
+  // "41.0000000000000" or "1.50000000000e-7", which every double parser reads back unchanged.
+  static constexpr std::size_t kValueWidth = 16;
+
+  MaddTemplate() = default;
+  explicit MaddTemplate(const std::vector<std::string>& keys);
+
+  [[nodiscard]] std::size_t slots() const noexcept { return value_offsets_.size(); }
+  // False (and the template untouched) when timestamp_ms does not have kTimestampWidth digits.
+  bool set_timestamp(std::uint64_t timestamp_ms) noexcept;
+  void set_value(std::size_t slot, double value) noexcept;
+  [[nodiscard]] std::string_view command() const noexcept { return buffer_; }
+  // The command restricted to the slots whose flag in selected is non-zero, rendered into a
+  // buffer reserved up front; empty when no slot is selected.
+  std::string_view command(const std::vector<std::uint8_t>& selected) noexcept;
+  // Appends the selected slots' "key timestamp value" arguments without a command header, so
+  // several ticks can be joined into one TS.MADD; returns the number of slots appended.
+  std::size_t append_selected(const std::vector<std::uint8_t>& selected, std::string& out) const;
+  // "*<1 + 3 * series>\r\n$7\r\nTS.MADD\r\n"
+  static void append_header(std::size_t series, std::string& out);
+
+  // Writes exactly kValueWidth characters; non-finite values become 0.
+  static void format_value(double value, char* out) noexcept;
+
+ private:
+  std::string buffer_{};
+  std::string subset_{};
+  // Start of each slot's key header; a slot runs to the next one's start.
+  std::vector<std::size_t> slot_offsets_{};
+  std::vector<std::size_t> timestamp_offsets_{};
+  std::vector<std::size_t> value_offsets_{};
+};
+
+}  // namespace hw_agent::sinks
@@ -1,9 +1,11 @@
 #include "core/agent.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "core/timestamp.hpp"
@@ -40,24 +42,68 @@ std::vector<std::string> enabled_redis_metrics(const AgentConfig& config) {
   if (is_sensor_enabled(config, "softirqs")) {
     metrics.push_back("raw:softirqs");
   }
+  if (is_sensor_enabled(config, "softnet")) {
+    metrics.push_back("raw:softnet_squeeze");
+    metrics.push_back("raw:softnet_drops");
+    metrics.push_back("raw:softnet_hot_cpu");
+  }
+  if (is_sensor_enabled(config, "perf")) {
+    metrics.push_back("raw:perf_context_switches");
+    metrics.push_back("raw:perf_migrations");
+    metrics.push_back("raw:perf_major_faults");
+    metrics.push_back("raw:perf_ipc");
+    metrics.push_back("raw:perf_llc_misses");
+    metrics.push_back("raw:perf_hot_cpu");
+  }
+  if (is_sensor_enabled(config, "schedstat")) {
+    metrics.push_back("raw:sched_run_delay");
+    metrics.push_back("raw:sched_run_delay_p99");
+    metrics.push_back("raw:sched_run_delay_max");
+    metrics.push_back("raw:sched_worst_cpu");
+    metrics.push_back("raw:sched_wait_per_slice_us");
+  }
+  if (config.wakeup_probe.enabled) {
+    metrics.push_back("raw:wakeup_latency_p50_us");
+    metrics.push_back("raw:wakeup_latency_p99_us");
+    metrics.push_back("raw:wakeup_latency_p999_us");
+    metrics.push_back("raw:wakeup_latency_max_us");
+  }
   if (is_sensor_enabled(config, "memory")) {
     metrics.push_back("raw:memory");
   }
   if (is_sensor_enabled(config, "thermal")) {
     metrics.push_back("raw:thermal");
+    metrics.push_back("raw:thermal_slope");
+    metrics.push_back("raw:thermal_seconds_to_trip");
   }
   if (is_sensor_enabled(config, "cpufreq")) {
     metrics.push_back("raw:cpufreq");
+    metrics.push_back("raw:cpufreq_min_ratio");
+    metrics.push_back("raw:cpufreq_avg_ratio");
+    metrics.push_back("raw:cpufreq_capped");
+    metrics.push_back("raw:cpufreq_cap_depth");
   }
   if (is_sensor_enabled(config, "cpu_throttle")) {
     metrics.push_back("raw:cpu_throttle_ratio");
   }
+  if (is_sensor_enabled(config, "powercap")) {
+    metrics.push_back("raw:rapl_package_watts");
+    metrics.push_back("raw:rapl_package_limit_ratio");
+    metrics.push_back("raw:rapl_dram_watts");
+    metrics.push_back("raw:rapl_dram_limit_ratio");
+  }
   if (is_sensor_enabled(config, "disk")) {
     metrics.push_back("raw:disk");
   }
   if (is_sensor_enabled(config, "network")) {
     metrics.push_back("raw:network");
   }
+  if (is_sensor_enabled(config, "netstack")) {
+    metrics.push_back("raw:tcp_retrans");
+    metrics.push_back("raw:listen_drops");
+    metrics.push_back("raw:udp_buf_errors");
+    metrics.push_back("raw:tcp_mem_ratio");
+  }
 
   const bool gpu_enabled = is_sensor_enabled(config, "gpu");
   const bool tegrastats_enabled = is_sensor_enabled(config, "tegrastats");
@@ -66,6 +112,13 @@ std::vector<std::string> enabled_redis_metrics(const AgentConfig& config) {
     metrics.push_back("raw:gpu_mem_util");
     metrics.push_back("raw:nvml_gpu_temp");
     metrics.push_back("raw:nvml_gpu_power_ratio");
+    metrics.push_back("raw:nvml_gpu_devices");
+    metrics.push_back("raw:nvml_gpu_throttled");
+    metrics.push_back("raw:nvml_gpu_worst_device");
+    metrics.push_back("raw:drm_gpu_util");
+    metrics.push_back("raw:drm_gpu_temp");
+    metrics.push_back("raw:drm_gpu_clock_ratio");
+    metrics.push_back("raw:drm_gpu_power_ratio");
   }
   if (tegrastats_enabled) {
     metrics.push_back("raw:tegra_gpu_util");
@@ -82,6 +135,11 @@ std::vector<std::string> enabled_redis_metrics(const AgentConfig& config) {
     metrics.push_back("agent:compute_time");
     metrics.push_back("agent:redis_latency");
     metrics.push_back("agent:redis_errors");
+    metrics.push_back("agent:redis_dropped");
+    metrics.push_back("agent:redis_samples");
+    metrics.push_back("agent:redis_suppressed");
+    metrics.push_back("agent:redis_spooled");
+    metrics.push_back("agent:redis_breaker");
     metrics.push_back("agent:sensor_failures");
     metrics.push_back("agent:missed_cycles");
   }
@@ -98,40 +156,169 @@ Agent::Agent(AgentConfig config)
       thermal_sensor_(config.thermal_throttle_temp_c),
       thermal_pressure_(config.thermal_pressure_warning_window_c) {
   if (config.redis.enabled) {
-    sinks::RedisTsOptions options{};
-    options.host = config.redis.host;
-    options.port = config.redis.port;
-    options.unix_socket = config.redis.unix_socket;
-    options.publish_health = config.publish_health;
-    options.enabled_metrics = enabled_redis_metrics(config);
-    redis_sink_ = std::make_unique<sinks::RedisTsSink>(options);
-
-    if (redis_sink_->check_connectivity()) {
-      if (!options.unix_socket.empty()) {
-        std::cerr << "[agent] redis connectivity confirmed at unix://" << options.unix_socket << '\n';
-      } else {
-        std::cerr << "[agent] redis connectivity confirmed at " << options.host << ':' << options.port << '\n';
-      }
+    add_redis_target(config, "", config.redis);
+  }
+  for (const RedisTargetConfig& target : config.redis_targets) {
+    add_redis_target(config, target.name, target.redis);
+  }
+
+  sensors::gpu::NvmlOptions nvml_options{};
+  nvml_options.devices.assign(config.gpu_devices.begin(), config.gpu_devices.end());
+  gpu_sensor_ = sensors::gpu::make_nvml_sensor(nvml_options);
+  if (gpu_sensor_ != nullptr && gpu_sensor_->available()) {
+    std::cerr << "[agent] detected NVML GPU sensor ("
+              << (nvml_options.devices.empty() ? "all devices" : std::to_string(nvml_options.devices.size()) + " devices")
+              << ")\n";
+  } else {
+    // AMD and Intel GPUs: amdgpu/i915 sysfs under the DRM class.
+    gpu_sensor_ = sensors::gpu::make_drm_sensor(config.gpu_sysfs_root);
+    if (gpu_sensor_->available()) {
+      std::cerr << "[agent] NVML unavailable; using DRM GPU sensor under " << config.gpu_sysfs_root << "/class/drm\n";
     } else {
-      if (!options.unix_socket.empty()) {
-        std::cerr << "[agent] redis connectivity check failed at unix://" << options.unix_socket << '\n';
-      } else {
-        std::cerr << "[agent] redis connectivity check failed at " << options.host << ':' << options.port << '\n';
+      std::cerr << "[agent] NVML and DRM GPU sensors unavailable; falling back to none sensor\n";
+      gpu_sensor_ = sensors::gpu::make_none_sensor();
+    }
+  }
+
+  if (sensor_enabled(config, "perf")) {
+    // Opened only when enabled: the counters cost several descriptors per CPU.
+    perf_sensor_ = std::make_unique<sensors::PerfEventSensor>();
+    if (!perf_sensor_->available()) {
+      std::cerr << "[agent] perf_event counters unavailable (errno " << perf_sensor_->raw().software_open_errno
+                << "); check perf_event_paranoid or CAP_PERFMON\n";
+      perf_sensor_.reset();
+    } else {
+      std::cerr << "[agent] perf_event counters on " << perf_sensor_->raw().software_cpus << " CPUs, hardware "
+                << (perf_sensor_->hardware_available() ? "available" : "unavailable") << '\n';
+    }
+  }
+
+  if (config.wakeup_probe.enabled) {
+    sensors::WakeupLatencyOptions probe_options{};
+    probe_options.cpus = config.wakeup_probe.cpus;
+    probe_options.policy = config.wakeup_probe.policy;
+    probe_options.priority = config.wakeup_probe.priority;
+    probe_options.interval = std::chrono::microseconds(config.wakeup_probe.interval_us);
+    wakeup_probe_ = std::make_unique<sensors::WakeupLatencyProbe>(probe_options);
+    wakeup_probe_->start();
+    std::cerr << "[agent] wakeup latency probe on " << wakeup_probe_->raw().per_cpu.size() << " CPUs every "
+              << config.wakeup_probe.interval_us << " us\n";
+  }
+
+  if (sensor_enabled(config, "tegrastats")) {
+    // Only one Jetson backend runs; tegrastats costs a child process, so sysfs wins when usable.
+    if (config.jetson.backend != JetsonBackend::tegrastats) {
+      auto sysfs = std::make_unique<sensors::JetsonSysfsSensor>(config.jetson.sysfs_root);
+      if (sysfs->available()) {
+        std::cerr << "[agent] Jetson sysfs backend: " << sysfs->rails().size() << " INA3221 rails, "
+                  << sysfs->zones().size() << " thermal zones under " << config.jetson.sysfs_root << '\n';
+        jetson_sysfs_sensor_ = std::move(sysfs);
+      } else if (config.jetson.backend == JetsonBackend::sysfs) {
+        std::cerr << "[agent] Jetson sysfs backend found no GPU load or INA3221 rails under "
+                  << config.jetson.sysfs_root << '\n';
+      }
+    }
+    if (jetson_sysfs_sensor_ == nullptr && config.jetson.backend != JetsonBackend::sysfs) {
+      tegrastats_sensor_ = std::make_unique<sensors::TegraStatsSensor>();
+      std::cerr << "[agent] tegrastats " << (tegrastats_sensor_->enabled() ? "detected" : "not detected") << '\n';
+      if (!tegrastats_sensor_->enabled()) {
+        tegrastats_sensor_.reset();
       }
     }
   }
 
-  gpu_sensor_ = sensors::gpu::make_nvml_sensor(config.gpu_device_index);
-  if (gpu_sensor_ != nullptr && gpu_sensor_->available()) {
-    std::cerr << "[agent] detected NVML GPU sensor\n";
+  if (config.attribution.enabled) {
+    sensors::ProcessAttributionOptions attribution_options{};
+    attribution_options.top_n = config.attribution.top_n;
+    attribution_options.cpu_budget_pct = config.attribution.cpu_budget_pct;
+    attribution_options.tick_interval = config.tick_interval;
+    process_attribution_ = std::make_unique<sensors::ProcessAttribution>(attribution_options);
+  }
+
+  register_sensors(config);
+  if (publish_events_) {
+    pending_events_.reserve(sensor_registry_.size() + psi_over_.size() + 1);
+  }
+}
+
+void Agent::add_redis_target(const AgentConfig& config, const std::string& name, const RedisConfig& redis) {
+  const std::string label = name.empty() ? "redis" : "redis target " + name;
+  std::vector<std::string> metrics = enabled_redis_metrics(config);
+  if (!redis.metrics.empty()) {
+    std::erase_if(metrics, [&redis](const std::string& metric) {
+      return std::none_of(redis.metrics.begin(), redis.metrics.end(),
+                          [&metric](const std::string& prefix) { return metric.rfind(prefix, 0) == 0; });
+    });
+  }
+  if (metrics.empty()) {
+    std::cerr << "[agent] " << label << " matches no published metric; not connected\n";
+    return;
+  }
+
+  sinks::RedisTsOptions options{};
+  options.host = redis.host;
+  options.port = redis.port;
+  options.unix_socket = redis.unix_socket;
+  options.publish_health = config.publish_health;
+  options.enabled_metrics = std::move(metrics);
+  options.async = redis.async;
+  options.max_in_flight = redis.max_in_flight;
+  options.reply_timeout_ms = effective_reply_timeout_ms(redis, config.tick_interval);
+  options.reconnect_min_ms = redis.reconnect_min_ms;
+  options.reconnect_max_ms = redis.reconnect_max_ms;
+  options.change_only = redis.change_only;
+  options.keepalive_ms = redis.keepalive_ms;
+  options.deadbands = redis.deadbands;
+  options.batch_ticks = redis.batch_ticks;
+  options.batch_ms = redis.batch_ms;
+  options.spool_path = redis.spool_path;
+  options.spool_max_bytes = static_cast<std::size_t>(redis.spool_max_mb) * 1024U * 1024U;
+  options.spool_drain_frames = redis.spool_drain_frames;
+  options.node_label = redis.node_label;
+  options.retention_ms = redis.retention_ms;
+  options.chunk_size = redis.chunk_size;
+  options.frames_maxlen = redis.frames_maxlen;
+  options.cluster = redis.cluster;
+  for (const core::RedisCompaction& rule : redis.compactions) {
+    options.compactions.push_back({rule.aggregation, rule.bucket_ms, rule.retention_ms});
+  }
+
+  RedisTarget target{};
+  target.name = name;
+  target.sink = std::make_unique<sinks::RedisTsSink>(options);
+  target.every_ticks = redis.every_ticks;
+  target.frames = redis.frames_stream;
+  target.events = redis.events;
+  target.full = redis.metrics.empty();
+
+  if (target.sink->check_connectivity()) {
+    if (!options.unix_socket.empty()) {
+      std::cerr << "[agent] " << label << " connectivity confirmed at unix://" << options.unix_socket << '\n';
+    } else {
+      std::cerr << "[agent] " << label << " connectivity confirmed at " << options.host << ':' << options.port << '\n';
+    }
   } else {
-    std::cerr << "[agent] NVML GPU sensor unavailable; falling back to none sensor\n";
-    gpu_sensor_ = sensors::gpu::make_none_sensor();
+    if (!options.unix_socket.empty()) {
+      std::cerr << "[agent] " << label << " connectivity check failed at unix://" << options.unix_socket << '\n';
+    } else {
+      std::cerr << "[agent] " << label << " connectivity check failed at " << options.host << ':' << options.port << '\n';
+    }
   }
 
-  std::cerr << "[agent] tegrastats " << (tegrastats_sensor_.enabled() ? "detected" : "not detected") << '\n';
 
-  register_sensors(config);
+  // Event detection is shared; the first target that wants events sets its PSI threshold.
+  if (target.events && !publish_events_) {
+    publish_events_ = true;
+    psi_event_threshold_ = redis.events_psi_threshold;
+  }
+  redis_sinks_.push_back(target.sink.get());
+  redis_targets_.push_back(std::move(target));
+}
+
+void Agent::request_process_attribution() noexcept {
+  if (process_attribution_ != nullptr) {
+    process_attribution_->request_scan();
+  }
 }
 
 AgentStats Agent::run_for_ticks(const std::size_t total_ticks) {
@@ -148,6 +335,7 @@ AgentStats Agent::run_for_ticks(const std::size_t total_ticks) {
     collect_sensors(stats);
     compute_derived(stats);
     compute_risk(stats);
+    attribute_processes();
     publish_sinks(stats);
 
     const auto cycle_end = std::chrono::steady_clock::now();
@@ -162,7 +350,12 @@ AgentStats Agent::run_for_ticks(const std::size_t total_ticks) {
     sampler_.advance();
 
     next_wakeup_ += tick_interval_;
-    std::this_thread::sleep_until(next_wakeup_);
+    if (!redis_sinks_.empty()) {
+      // Async sinks handle Redis replies while the loop waits for the next tick.
+      sinks::RedisTsSink::service_until(redis_sinks_, next_wakeup_);
+    } else {
+      std::this_thread::sleep_until(next_wakeup_);
+    }
   }
 
   return stats;
@@ -173,16 +366,55 @@ void Agent::register_sensors(const AgentConfig& config) {
   sensor_registry_.push_back({"cpu", 2, sensor_enabled(config, "cpu"), [this](model::signal_frame& frame) { return cpu_sensor_.sample(frame); }});
   sensor_registry_.push_back({"interrupts", 3, sensor_enabled(config, "interrupts"), [this](model::signal_frame& frame) { return interrupts_sensor_.sample(frame); }});
   sensor_registry_.push_back({"softirqs", 4, sensor_enabled(config, "softirqs"), [this](model::signal_frame& frame) { return softirqs_sensor_.sample(frame); }});
+  sensor_registry_.push_back({"softnet", 4, sensor_enabled(config, "softnet"), [this](model::signal_frame& frame) { return softnet_sensor_.sample(frame); }});
+  sensor_registry_.push_back({"perf", 5, perf_sensor_ != nullptr && sensor_enabled(config, "perf"), [this](model::signal_frame& frame) {
+    perf_ready_ = perf_sensor_->sample(frame);
+    return perf_ready_;
+  }});
+  sensor_registry_.push_back({"schedstat", 4, sensor_enabled(config, "schedstat"), [this](model::signal_frame& frame) { return schedstat_sensor_.sample(frame); }});
   sensor_registry_.push_back({"memory", 5, sensor_enabled(config, "memory"), [this](model::signal_frame& frame) { return memory_sensor_.sample(frame); }});
   sensor_registry_.push_back({"disk", 6, sensor_enabled(config, "disk"), [this](model::signal_frame& frame) { return disk_sensor_.sample(frame); }});
   sensor_registry_.push_back({"network", 7, sensor_enabled(config, "network"), [this](model::signal_frame& frame) { return network_sensor_.sample(frame); }});
-  sensor_registry_.push_back({"tegrastats", 8, sensor_enabled(config, "tegrastats"), [this](model::signal_frame& frame) { return tegrastats_sensor_.sample(frame); }});
+  sensor_registry_.push_back({"netstack", 7, sensor_enabled(config, "netstack"), [this](model::signal_frame& frame) { return netstack_sensor_.sample(frame); }});
+  sensor_registry_.push_back({"tegrastats", 8, tegrastats_sensor_ != nullptr, [this](model::signal_frame& frame) { return tegrastats_sensor_->sample(frame); }});
+  sensor_registry_.push_back({"jetson_sysfs", 5, jetson_sysfs_sensor_ != nullptr, [this](model::signal_frame& frame) { return jetson_sysfs_sensor_->sample(frame); }});
   sensor_registry_.push_back({"thermal", 9, sensor_enabled(config, "thermal"), [this](model::signal_frame& frame) { return thermal_sensor_.sample(frame); }});
   sensor_registry_.push_back({"cpu_throttle", 10, sensor_enabled(config, "cpu_throttle"), [this](model::signal_frame& frame) { return cpu_throttle_sensor_.sample(frame); }});
+  sensor_registry_.push_back({"powercap", 10, sensor_enabled(config, "powercap"), [this](model::signal_frame& frame) { return powercap_sensor_.sample(frame); }});
   sensor_registry_.push_back({"cpufreq", 11, sensor_enabled(config, "cpufreq"), [this](model::signal_frame& frame) { return cpufreq_sensor_.sample(frame); }});
+  sensor_registry_.push_back({"wakeup_latency", 10, wakeup_probe_ != nullptr, [this](model::signal_frame& frame) {
+    wakeup_ready_ = wakeup_probe_->sample(frame);
+    if (!wakeup_setup_logged_ && wakeup_ready_) {
+      // Threads apply policy and affinity themselves, so the outcome is only known after a window.
+      const auto& raw = wakeup_probe_->raw();
+      if (raw.setup_errno != 0) {
+        std::cerr << "[agent] wakeup latency probe setup failed (errno " << raw.setup_errno << "); "
+                  << raw.realtime_threads << " of " << raw.per_cpu.size() << " threads realtime\n";
+      }
+      wakeup_setup_logged_ = true;
+    }
+    return wakeup_ready_;
+  }});
   sensor_registry_.push_back({"gpu", 12, sensor_enabled(config, "gpu"), [this](model::signal_frame& frame) {
-    return gpu_sensor_ != nullptr ? gpu_sensor_->collect(frame) : false;
+    gpu_ready_ = gpu_sensor_ != nullptr && gpu_sensor_->collect(frame);
+    return gpu_ready_;
   }});
+  // Only NVML can attribute GPU time to processes; the other backends would count as failures.
+  const bool gpu_workloads_enabled = sensor_enabled(config, "gpu") && config.gpu_process_utilization &&
+                                     gpu_sensor_ != nullptr && std::string(gpu_sensor_->source()) == "nvml";
+  sensor_registry_.push_back({"gpu_workloads", 50, gpu_workloads_enabled, [this](model::signal_frame&) {
+    gpu_workloads_ready_ = gpu_sensor_->collect_workloads(gpu_workloads_);
+    return gpu_workloads_ready_;
+  }});
+
+  for (RedisTarget& target : redis_targets_) {
+    target.refresh_groups.reserve(sensor_registry_.size());
+    for (const auto& sensor : sensor_registry_) {
+      // Both Jetson backends fill the tegra_* fields.
+      target.refresh_groups.push_back(
+          target.sink->refresh_group(sensor.name == "jetson_sysfs" ? "tegrastats" : sensor.name));
+    }
+  }
 }
 
 bool Agent::sensor_enabled(const AgentConfig& config, const std::string& name) const {
@@ -198,15 +430,27 @@ void Agent::collect_sensors(AgentStats& stats) {
   frame_.monotonic_ns = monotonic_timestamp_now_ns();
   frame_.agent.sensor_failures = 0;
 
-  for (auto& sensor : sensor_registry_) {
+  for (std::size_t index = 0; index < sensor_registry_.size(); ++index) {
+    auto& sensor = sensor_registry_[index];
     if (!sensor.enabled) {
       continue;
     }
 
     if (sampler_.should_sample_every(sensor.every_ticks)) {
-      if (!sensor.sample(frame_)) {
+      const bool failed = !sensor.sample(frame_);
+      if (failed) {
         ++frame_.agent.sensor_failures;
       }
+      if (publish_events_ && failed != sensor.failing) {
+        pending_events_.push_back({sinks::RiskEvent::Kind::sensor, sensor.name.c_str(), failed});
+      }
+      sensor.failing = failed;
+      // Failed samples usually reset their fields, so they count as a refresh too.
+      for (RedisTarget& target : redis_targets_) {
+        if (target.refresh_groups[index] >= 0) {
+          target.sink->mark_refreshed(target.refresh_groups[index]);
+        }
+      }
     }
   }
 }
@@ -225,7 +469,31 @@ void Agent::compute_risk(AgentStats& stats) {
   ++stats.risk_cycles;
   realtime_risk_.sample(frame_);
   saturation_risk_.sample(frame_);
+  const model::system_state previous_state = frame_.state;
   system_state_.sample(frame_);
+  if (publish_events_) {
+    detect_events(previous_state);
+  }
+}
+
+void Agent::detect_events(const model::system_state previous_state) {
+  if (frame_.state != previous_state) {
+    pending_events_.push_back({sinks::RiskEvent::Kind::state, "", frame_.state > previous_state, previous_state});
+  }
+
+  static constexpr const char* kPsiSources[] = {"cpu", "memory", "io"};
+  const float psi[] = {frame_.psi, frame_.psi_memory, frame_.psi_io};
+  for (std::size_t i = 0; i < psi_over_.size(); ++i) {
+    const bool over = psi_over_[i] ? psi[i] >= psi_event_threshold_ * 0.5F : psi[i] >= psi_event_threshold_;
+    if (over != psi_over_[i]) {
+      pending_events_.push_back({sinks::RiskEvent::Kind::psi, kPsiSources[i], over});
+      psi_over_[i] = over;
+    }
+  }
+}
+
+void Agent::attribute_processes() {
+  attribution_ready_ = process_attribution_ != nullptr && process_attribution_->step(frame_);
 }
 
 void Agent::publish_sinks(AgentStats& stats) {
@@ -236,19 +504,75 @@ void Agent::publish_sinks(AgentStats& stats) {
     stdout_sink_.publish(frame_);
   }
 
-  if (redis_sink_ != nullptr) {
-    const bool ok = redis_sink_->publish(frame_);
+  for (std::size_t i = 0; i < redis_targets_.size(); ++i) {
+    publish_redis(redis_targets_[i], i == 0);
+  }
+  pending_events_.clear();
+  wakeup_ready_ = false;
+  perf_ready_ = false;
+  gpu_ready_ = false;
+  gpu_workloads_ready_ = false;
+}
+
+void Agent::publish_redis(RedisTarget& target, const bool first) {
+  if (!first) {
+    target.frame = frame_;
+    target.frame.agent.redis_errors = 0;
+  }
+  model::signal_frame& frame = first ? frame_ : target.frame;
+  sinks::RedisTsSink& sink = *target.sink;
+
+  // Events go out ahead of the frame, outside any batch or cadence.
+  if (target.events) {
+    for (const sinks::RiskEvent& event : pending_events_) {
+      if (!sink.publish_event(event, frame)) {
+        ++frame.agent.redis_errors;
+      }
+    }
+  }
+
+  if (sampler_.should_sample_every(target.every_ticks)) {
+    const bool ok = sink.publish(frame);
     if (!ok) {
-      ++frame_.agent.redis_errors;
-      if (redis_was_ok_) {
-        std::cerr << "[redis] publish failed\n";
-        redis_was_ok_ = false;
+      ++frame.agent.redis_errors;
+      if (target.was_ok) {
+        std::cerr << "[redis] " << (target.name.empty() ? "" : target.name + ": ") << "publish failed\n";
+        target.was_ok = false;
       }
-    } else if (!redis_was_ok_) {
-      std::cerr << "[redis] publish recovered\n";
-      redis_was_ok_ = true;
+    } else if (!target.was_ok) {
+      std::cerr << "[redis] " << (target.name.empty() ? "" : target.name + ": ") << "publish recovered\n";
+      target.was_ok = true;
+    }
+
+    if (target.frames && !sink.publish_frame_stream(frame)) {
+      ++frame.agent.redis_errors;
     }
   }
+
+  if (!target.full) {
+    return;
+  }
+
+  if (wakeup_ready_ && !sink.publish_wakeup_latency(wakeup_probe_->raw().per_cpu)) {
+    ++frame.agent.redis_errors;
+  }
+
+  if (perf_ready_ &&
+      !sink.publish_perf_per_cpu(perf_sensor_->raw().per_cpu, perf_sensor_->hardware_available())) {
+    ++frame.agent.redis_errors;
+  }
+
+  if (gpu_ready_ && !sink.publish_gpu_devices(gpu_sensor_->source(), gpu_sensor_->devices())) {
+    ++frame.agent.redis_errors;
+  }
+
+  if (gpu_workloads_ready_ && !gpu_workloads_.empty() && !sink.publish_gpu_workloads(gpu_workloads_)) {
+    ++frame.agent.redis_errors;
+  }
+
+  if (attribution_ready_ && !sink.publish_attribution(process_attribution_->report())) {
+    ++frame.agent.redis_errors;
+  }
 }
 
 void Agent::update_agent_health(const float actual_period_ms, const float compute_time_ms) {
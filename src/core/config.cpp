@@ -2,15 +2,20 @@
 
 #include <algorithm>
 #include <cctype>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace hw_agent::core {
 namespace {
 
+constexpr int kMaxGpuDevices = 64;
+
 std::string trim(const std::string& value) {
   const auto begin = std::find_if_not(value.begin(), value.end(), [](unsigned char c) { return std::isspace(c) != 0; });
   const auto end = std::find_if_not(value.rbegin(), value.rend(), [](unsigned char c) { return std::isspace(c) != 0; }).base();
@@ -33,6 +38,321 @@ bool parse_bool(const std::string& value) {
   return lower == "true" || lower == "yes" || lower == "on" || lower == "1";
 }
 
+// "0,2-3" style index list; key names the option in error messages.
+std::vector<int> parse_index_list(const std::string& value, const std::string& key, const int limit) {
+  std::vector<int> indices;
+  std::stringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    item = trim(item);
+    if (item.empty()) {
+      continue;
+    }
+    const auto dash = item.find('-');
+    const int first = std::stoi(item.substr(0, dash));
+    const int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+    if (first < 0 || last < first || last >= limit) {
+      throw std::runtime_error(key + " has an invalid range: " + item);
+    }
+    for (int index = first; index <= last; ++index) {
+      indices.push_back(index);
+    }
+  }
+  return indices;
+}
+
+// "500ms", "10s", "1m", "1h", "7d"; a bare number is milliseconds.
+std::uint64_t parse_duration_ms(const std::string& value, const std::string& key) {
+  std::size_t digits = 0;
+  while (digits < value.size() && value[digits] >= '0' && value[digits] <= '9') {
+    ++digits;
+  }
+  const std::string unit = value.substr(digits);
+  std::uint64_t scale = 0;
+  if (unit.empty() || unit == "ms") {
+    scale = 1;
+  } else if (unit == "s") {
+    scale = 1000;
+  } else if (unit == "m") {
+    scale = 60'000;
+  } else if (unit == "h") {
+    scale = 3'600'000;
+  } else if (unit == "d") {
+    scale = 86'400'000;
+  }
+  if (digits == 0 || digits > 9 || scale == 0) {
+    throw std::runtime_error(key + " must use durations such as 500ms, 10s, 1m, 1h or 7d");
+  }
+  return std::stoull(value.substr(0, digits)) * scale;
+}
+
+// key is relative to the redis section, so extra targets parse exactly like the primary one.
+bool apply_redis_key(RedisConfig& redis, const std::string& key, const std::string& value) {
+  if (key == "address") {
+    redis.enabled = !value.empty();
+    if (value.rfind("unix://", 0) == 0) {
+      redis.unix_socket = value.substr(std::string("unix://").size());
+      redis.host.clear();
+      redis.port = 0;
+      return true;
+    }
+
+    if (!value.empty() && value.front() == '/') {
+      redis.unix_socket = value;
+      redis.host.clear();
+      redis.port = 0;
+      return true;
+    }
+
+    redis.unix_socket.clear();
+    const auto split = value.find(':');
+    if (split == std::string::npos) {
+      redis.host = value;
+      return true;
+    }
+
+    redis.host = value.substr(0, split);
+    const auto parsed_port = std::stoi(value.substr(split + 1));
+    if (parsed_port <= 0 || parsed_port > 65535) {
+      throw std::runtime_error("redis.address port must be in range 1..65535");
+    }
+
+    redis.port = static_cast<std::uint16_t>(parsed_port);
+    return true;
+  }
+
+  if (key == "mode") {
+    if (value == "sync") {
+      redis.async = false;
+    } else if (value == "async") {
+      redis.async = true;
+    } else {
+      throw std::runtime_error("redis.mode must be one of sync, async");
+    }
+    return true;
+  }
+
+  if (key == "max_in_flight") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 1 || parsed > 1024) {
+      throw std::runtime_error("redis.max_in_flight must be in range 1..1024");
+    }
+    redis.max_in_flight = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "reply_timeout_ms") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 10 || parsed > 60'000) {
+      throw std::runtime_error("redis.reply_timeout_ms must be in range 10..60000");
+    }
+    redis.reply_timeout_ms = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "reconnect_min_ms") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 10 || parsed > 60'000) {
+      throw std::runtime_error("redis.reconnect_min_ms must be in range 10..60000");
+    }
+    redis.reconnect_min_ms = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "reconnect_max_ms") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 10 || parsed > 600'000) {
+      throw std::runtime_error("redis.reconnect_max_ms must be in range 10..600000");
+    }
+    redis.reconnect_max_ms = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "change_only") {
+    redis.change_only = parse_bool(value);
+    return true;
+  }
+
+  if (key == "keepalive_ms") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 100 || parsed > 3'600'000) {
+      throw std::runtime_error("redis.keepalive_ms must be in range 100..3600000");
+    }
+    redis.keepalive_ms = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "deadband") {
+    redis.deadbands.clear();
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+      item = trim(item);
+      if (item.empty()) {
+        continue;
+      }
+      const auto equals = item.find('=');
+      const std::string metric = equals == std::string::npos ? std::string{} : trim(item.substr(0, equals));
+      const double deadband = metric.empty() ? -1.0 : std::stod(item.substr(equals + 1));
+      if (metric.empty() || !(deadband >= 0.0)) {
+        throw std::runtime_error("redis.deadband must be a list such as raw:memory=0.5 with non-negative values");
+      }
+      redis.deadbands.emplace_back(metric, deadband);
+    }
+    return true;
+  }
+
+  if (key == "batch_ticks") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 1 || parsed > 1000) {
+      throw std::runtime_error("redis.batch_ticks must be in range 1..1000");
+    }
+    redis.batch_ticks = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "batch_ms") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 0 || parsed > 60'000) {
+      throw std::runtime_error("redis.batch_ms must be in range 0..60000");
+    }
+    redis.batch_ms = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "spool_path") {
+    redis.spool_path = value;
+    return true;
+  }
+
+  if (key == "spool_max_mb") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 1 || parsed > 65'536) {
+      throw std::runtime_error("redis.spool_max_mb must be in range 1..65536");
+    }
+    redis.spool_max_mb = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "spool_drain_frames") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 1 || parsed > 1000) {
+      throw std::runtime_error("redis.spool_drain_frames must be in range 1..1000");
+    }
+    redis.spool_drain_frames = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "node_label") {
+    redis.node_label = value;
+    return true;
+  }
+
+  if (key == "retention_ms") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 0) {
+      throw std::runtime_error("redis.retention_ms must be >= 0");
+    }
+    redis.retention_ms = static_cast<std::uint64_t>(parsed);
+    return true;
+  }
+
+  if (key == "chunk_size") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 48 || parsed > 1'048'576 || parsed % 8 != 0) {
+      throw std::runtime_error("redis.chunk_size must be a multiple of 8 in range 48..1048576");
+    }
+    redis.chunk_size = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "compactions") {
+    static constexpr const char* kAggregations[] = {"avg",   "sum",   "min",   "max",   "range", "count", "first",
+                                                    "last",  "std.p", "std.s", "var.p", "var.s", "twa"};
+    redis.compactions.clear();
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+      item = trim(item);
+      if (item.empty()) {
+        continue;
+      }
+      const auto first = item.find(':');
+      const auto second = first == std::string::npos ? std::string::npos : item.find(':', first + 1);
+      RedisCompaction rule{};
+      rule.aggregation = item.substr(0, first);
+      if (first == std::string::npos ||
+          std::find(std::begin(kAggregations), std::end(kAggregations), rule.aggregation) == std::end(kAggregations)) {
+        throw std::runtime_error("redis.compactions must be a list such as avg:1m:30d, max:1h");
+      }
+      rule.bucket_ms = parse_duration_ms(item.substr(first + 1, second - first - 1), key);
+      rule.retention_ms = second == std::string::npos ? 0 : parse_duration_ms(item.substr(second + 1), key);
+      if (rule.bucket_ms == 0) {
+        throw std::runtime_error("redis.compactions bucket must be > 0");
+      }
+      redis.compactions.push_back(std::move(rule));
+    }
+    return true;
+  }
+
+  if (key == "frames_stream") {
+    redis.frames_stream = parse_bool(value);
+    return true;
+  }
+
+  if (key == "frames_maxlen") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 100 || parsed > 1'000'000) {
+      throw std::runtime_error("redis.frames_maxlen must be in range 100..1000000");
+    }
+    redis.frames_maxlen = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  if (key == "events") {
+    redis.events = parse_bool(value);
+    return true;
+  }
+
+  if (key == "events_psi_threshold") {
+    const float parsed = std::stof(value);
+    if (!(parsed > 0.0F && parsed <= 100.0F)) {
+      throw std::runtime_error("redis.events_psi_threshold must be in range (0, 100]");
+    }
+    redis.events_psi_threshold = parsed;
+    return true;
+  }
+
+  if (key == "cluster") {
+    redis.cluster = parse_bool(value);
+    return true;
+  }
+
+  if (key == "metrics") {
+    redis.metrics.clear();
+    std::stringstream items(value);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+      item = trim(item);
+      if (!item.empty()) {
+        redis.metrics.push_back(item);
+      }
+    }
+    return true;
+  }
+
+  if (key == "every_ticks") {
+    const auto parsed = std::stoll(value);
+    if (parsed < 1 || parsed > 10'000) {
+      throw std::runtime_error("redis.every_ticks must be in range 1..10000");
+    }
+    redis.every_ticks = static_cast<std::uint32_t>(parsed);
+    return true;
+  }
+
+  return false;
+}
+
 void apply_key_value(AgentConfig& config, const std::string& key, const std::string& value) {
   if (key == "tick_rate_hz") {
     const auto hz = std::stoi(value);
@@ -67,6 +387,34 @@ void apply_key_value(AgentConfig& config, const std::string& key, const std::str
       throw std::runtime_error("gpu.device_index must be greater than or equal to 0");
     }
     config.gpu_device_index = static_cast<std::uint32_t>(parsed_index);
+    config.gpu_devices = {config.gpu_device_index};
+    return;
+  }
+
+  if (key == "gpu.devices") {
+    config.gpu_devices.clear();
+    if (value == "all") {
+      return;
+    }
+    for (const int index : parse_index_list(value, key, kMaxGpuDevices)) {
+      config.gpu_devices.push_back(static_cast<std::uint32_t>(index));
+    }
+    if (config.gpu_devices.empty()) {
+      throw std::runtime_error("gpu.devices must be \"all\" or a list such as 0,2-3");
+    }
+    return;
+  }
+
+  if (key == "gpu.sysfs_root") {
+    if (value.empty()) {
+      throw std::runtime_error("gpu.sysfs_root must not be empty");
+    }
+    config.gpu_sysfs_root = value;
+    return;
+  }
+
+  if (key == "gpu.process_utilization") {
+    config.gpu_process_utilization = parse_bool(value);
     return;
   }
 
@@ -80,36 +428,114 @@ void apply_key_value(AgentConfig& config, const std::string& key, const std::str
     return;
   }
 
-  if (key == "redis.address") {
-    config.redis.enabled = !value.empty();
-    if (value.rfind("unix://", 0) == 0) {
-      config.redis.unix_socket = value.substr(std::string("unix://").size());
-      config.redis.host.clear();
-      config.redis.port = 0;
-      return;
+  if (key.rfind("redis.targets.", 0) == 0) {
+    const std::size_t name_start = std::string("redis.targets.").size();
+    const std::size_t name_end = key.find('.', name_start);
+    if (name_end == std::string::npos || name_end == name_start) {
+      throw std::runtime_error("redis.targets entries must be named sections");
+    }
+    const std::string name = key.substr(name_start, name_end - name_start);
+    auto target = std::find_if(config.redis_targets.begin(), config.redis_targets.end(),
+                               [&name](const RedisTargetConfig& candidate) { return candidate.name == name; });
+    if (target == config.redis_targets.end()) {
+      RedisTargetConfig added{};
+      added.name = name;
+      added.redis.async = true;
+      config.redis_targets.push_back(std::move(added));
+      target = std::prev(config.redis_targets.end());
+    }
+    (void)apply_redis_key(target->redis, key.substr(name_end + 1), value);
+    if (!target->redis.async) {
+      throw std::runtime_error("redis.targets." + name + " must use mode: async");
     }
+    return;
+  }
 
-    if (!value.empty() && value.front() == '/') {
-      config.redis.unix_socket = value;
-      config.redis.host.clear();
-      config.redis.port = 0;
-      return;
+  if (key.rfind("redis.", 0) == 0 && apply_redis_key(config.redis, key.substr(std::string("redis.").size()), value)) {
+    return;
+  }
+
+  if (key == "attribution.enabled") {
+    config.attribution.enabled = parse_bool(value);
+    return;
+  }
+
+  if (key == "attribution.top_n") {
+    const auto parsed_top_n = std::stoll(value);
+    if (parsed_top_n <= 0 || parsed_top_n > 64) {
+      throw std::runtime_error("attribution.top_n must be in range 1..64");
     }
+    config.attribution.top_n = static_cast<std::uint32_t>(parsed_top_n);
+    return;
+  }
 
-    config.redis.unix_socket.clear();
-    const auto split = value.find(':');
-    if (split == std::string::npos) {
-      config.redis.host = value;
-      return;
+  if (key == "attribution.cpu_budget_pct") {
+    config.attribution.cpu_budget_pct = std::stof(value);
+    if (config.attribution.cpu_budget_pct <= 0.0F || config.attribution.cpu_budget_pct > 100.0F) {
+      throw std::runtime_error("attribution.cpu_budget_pct must be in range (0, 100]");
     }
+    return;
+  }
 
-    config.redis.host = value.substr(0, split);
-    const auto parsed_port = std::stoi(value.substr(split + 1));
-    if (parsed_port <= 0 || parsed_port > 65535) {
-      throw std::runtime_error("redis.address port must be in range 1..65535");
+  if (key == "wakeup_probe.enabled") {
+    config.wakeup_probe.enabled = parse_bool(value);
+    return;
+  }
+
+  if (key == "wakeup_probe.cpus") {
+    config.wakeup_probe.cpus = parse_index_list(value, key, CPU_SETSIZE);
+    return;
+  }
+
+  if (key == "wakeup_probe.policy") {
+    if (value == "fifo") {
+      config.wakeup_probe.policy = SCHED_FIFO;
+    } else if (value == "rr") {
+      config.wakeup_probe.policy = SCHED_RR;
+    } else if (value == "other") {
+      config.wakeup_probe.policy = SCHED_OTHER;
+    } else {
+      throw std::runtime_error("wakeup_probe.policy must be one of fifo, rr, other");
     }
+    return;
+  }
 
-    config.redis.port = static_cast<std::uint16_t>(parsed_port);
+  if (key == "wakeup_probe.priority") {
+    const auto parsed_priority = std::stoi(value);
+    if (parsed_priority < 1 || parsed_priority > 99) {
+      throw std::runtime_error("wakeup_probe.priority must be in range 1..99");
+    }
+    config.wakeup_probe.priority = parsed_priority;
+    return;
+  }
+
+  if (key == "wakeup_probe.interval_us") {
+    const auto parsed_interval = std::stoll(value);
+    if (parsed_interval < 50 || parsed_interval > 1'000'000) {
+      throw std::runtime_error("wakeup_probe.interval_us must be in range 50..1000000");
+    }
+    config.wakeup_probe.interval_us = static_cast<std::uint32_t>(parsed_interval);
+    return;
+  }
+
+  if (key == "jetson.backend") {
+    if (value == "auto") {
+      config.jetson.backend = JetsonBackend::automatic;
+    } else if (value == "sysfs") {
+      config.jetson.backend = JetsonBackend::sysfs;
+    } else if (value == "tegrastats") {
+      config.jetson.backend = JetsonBackend::tegrastats;
+    } else {
+      throw std::runtime_error("jetson.backend must be one of auto, sysfs, tegrastats");
+    }
+    return;
+  }
+
+  if (key == "jetson.sysfs_root") {
+    if (value.empty()) {
+      throw std::runtime_error("jetson.sysfs_root must not be empty");
+    }
+    config.jetson.sysfs_root = value;
     return;
   }
 
@@ -121,6 +547,16 @@ void apply_key_value(AgentConfig& config, const std::string& key, const std::str
 
 }  // namespace
 
+std::uint32_t effective_reply_timeout_ms(const RedisConfig& redis, const std::chrono::milliseconds tick_interval) {
+  if (redis.reply_timeout_ms != 0) {
+    return redis.reply_timeout_ms;
+  }
+  if (redis.async) {
+    return 2000;
+  }
+  return static_cast<std::uint32_t>(std::max<std::chrono::milliseconds::rep>(tick_interval.count() / 2, 1));
+}
+
 AgentConfig load_agent_config(const std::string& path) {
   AgentConfig config{};
 
@@ -180,6 +616,48 @@ AgentConfig load_agent_config(const std::string& path) {
     apply_key_value(config, full_key.str(), value);
   }
 
+  if (config.redis.cluster && !config.redis.unix_socket.empty()) {
+    throw std::runtime_error("redis.cluster needs a host:port redis.address");
+  }
+  // A sync frame waits for its reply inside the tick; a longer wait would stall the loop.
+  if (!config.redis.async && config.redis.reply_timeout_ms != 0 &&
+      config.redis.reply_timeout_ms >= static_cast<std::uint64_t>(config.tick_interval.count())) {
+    throw std::runtime_error("redis.reply_timeout_ms must be below the tick interval in sync mode");
+  }
+  // The primary is published first on the tick thread; a sync one that hangs would hold up every target.
+  if (!config.redis_targets.empty() && config.redis.enabled && !config.redis.async) {
+    throw std::runtime_error("redis.mode must be async when redis.targets are configured");
+  }
+  // One wait covers every connection (RedisTsSink::kMaxServicedSinks).
+  if (config.redis_targets.size() > 15) {
+    throw std::runtime_error("at most 15 redis.targets are supported");
+  }
+  for (const RedisTargetConfig& target : config.redis_targets) {
+    if (!target.redis.enabled) {
+      throw std::runtime_error("redis.targets." + target.name + " needs an address");
+    }
+    if (target.redis.cluster && !target.redis.unix_socket.empty()) {
+      throw std::runtime_error("redis.targets." + target.name + ".cluster needs a host:port address");
+    }
+  }
+  // Each sink maps its spool file shared and owns the ring in it; two sinks on one file would reset
+  // or drain each other's frames.
+  std::vector<std::pair<std::filesystem::path, std::string>> spools;
+  if (config.redis.enabled && !config.redis.spool_path.empty()) {
+    spools.emplace_back(std::filesystem::path(config.redis.spool_path).lexically_normal(), "redis");
+  }
+  for (const RedisTargetConfig& target : config.redis_targets) {
+    if (target.redis.spool_path.empty()) {
+      continue;
+    }
+    const auto path = std::filesystem::path(target.redis.spool_path).lexically_normal();
+    const auto owner =
+        std::find_if(spools.begin(), spools.end(), [&path](const auto& spool) { return spool.first == path; });
+    if (owner != spools.end()) {
+      throw std::runtime_error("redis.targets." + target.name + ".spool_path is already used by " + owner->second);
+    }
+    spools.emplace_back(path, "redis.targets." + target.name);
+  }
   return config;
 }
 
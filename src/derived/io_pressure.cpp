@@ -1,6 +1,7 @@
 #include "derived/io_pressure.hpp"
 #include "core/math.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace hw_agent::derived {
@@ -8,7 +9,11 @@ namespace hw_agent::derived {
 
 void IoPressure::sample(model::signal_frame& frame) noexcept {
   const float disk_norm = core::clamp01(1.0F - std::exp(-frame.disk / 50.0F));
-  const float network_norm = core::clamp01(frame.network);
+  const float netstack_norm = std::max({1.0F - std::exp(-frame.tcp_retrans / 200.0F),
+                                        1.0F - std::exp(-frame.listen_drops / 10.0F),
+                                        1.0F - std::exp(-frame.udp_buf_errors / 50.0F),
+                                        (frame.tcp_mem_ratio - 0.5F) / 0.5F});
+  const float network_norm = std::max(core::clamp01(frame.network), core::clamp01(netstack_norm));
   const float psi_norm = core::clamp01(frame.psi_io / 20.0F);
 
   const float raw_score = (0.70F * disk_norm) + (0.20F * network_norm) + (0.10F * psi_norm);
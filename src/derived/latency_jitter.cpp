@@ -1,8 +1,9 @@
 #include "derived/latency_jitter.hpp"
 #include "core/math.hpp"
 
-namespace hw_agent::derived {
+#include <algorithm>
 
+namespace hw_agent::derived {
 
 void LatencyJitter::sample(model::signal_frame& frame) noexcept {
   float temporal_jitter_norm = 0.0F;
@@ -37,7 +38,14 @@ void LatencyJitter::sample(model::signal_frame& frame) noexcept {
 
   const float sched_norm = core::clamp01(frame.scheduler_pressure);
   const float io_norm = core::clamp01(frame.io_pressure);
-  const float raw_score = (0.60F * temporal_jitter_norm) + (0.25F * sched_norm) + (0.15F * io_norm);
+  const float slice_wait_norm = core::clamp01(frame.sched_wait_per_slice_us / kSliceWaitSaturationUs);
+  // Measured wakeup percentiles describe what an RT task sees; the tick-interval and runqueue
+  // estimates only stand in when the probe is not running.
+  const bool has_wakeup_probe = frame.wakeup_latency_max_us > 0.0F;
+  const float wakeup_norm = std::max(core::clamp01(frame.wakeup_latency_p99_us / kWakeupP99SaturationUs),
+                                     core::clamp01(frame.wakeup_latency_p999_us / kWakeupP999SaturationUs));
+  const float jitter_norm = has_wakeup_probe ? wakeup_norm : std::max(slice_wait_norm, temporal_jitter_norm);
+  const float raw_score = (0.60F * jitter_norm) + (0.25F * sched_norm) + (0.15F * io_norm);
 
   if (!has_ema_) {
     ema_ = raw_score;
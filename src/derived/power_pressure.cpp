@@ -1,12 +1,17 @@
 #include "derived/power_pressure.hpp"
 #include "core/math.hpp"
 
-namespace hw_agent::derived {
+#include <algorithm>
 
+namespace hw_agent::derived {
 
 void PowerPressure::sample(model::signal_frame& frame) noexcept {
-  const float raw_throttle = core::clamp01(frame.cpu_throttle_ratio);
-  const float cpu_norm = core::clamp01(frame.cpu / 100.0F);
+  const float cap_norm = core::cpufreq_cap_norm(frame.cpufreq_cap_depth);
+  const float limit_ratio = std::max(frame.rapl_package_limit_ratio, frame.rapl_dram_limit_ratio);
+  const float limit_norm = core::clamp01((limit_ratio - kLimitKnee) / (1.0F - kLimitKnee));
+  const float raw_throttle = std::max({core::clamp01(frame.cpu_throttle_ratio), cap_norm, limit_norm});
+  // Load term: the larger of CPU busy and measured package draw against PL1.
+  const float cpu_norm = std::max(core::clamp01(frame.cpu / 100.0F), core::clamp01(frame.rapl_package_limit_ratio));
   const float thermal_norm = core::clamp01(frame.thermal_pressure);
 
   const float raw_score = (0.75F * raw_throttle) + (0.15F * cpu_norm) + (0.10F * thermal_norm);
@@ -1,6 +1,7 @@
 #include "derived/scheduler_pressure.hpp"
 #include "core/math.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace hw_agent::derived {
@@ -9,7 +10,10 @@ namespace hw_agent::derived {
 void SchedulerPressure::sample(model::signal_frame& frame) noexcept {
   const float cpu_norm = core::clamp01(frame.cpu / 100.0F);
   const float psi_norm = core::clamp01(frame.psi / 10.0F);
-  const float softirq_norm = core::clamp01(frame.softirqs);
+  // NET_RX starvation (budget exhausted or backlog full) counts as softirq pressure even without a burst.
+  const float softnet_norm = std::max(1.0F - std::exp(-frame.softnet_squeeze / 50.0F),
+                                      1.0F - std::exp(-frame.softnet_drops / 10.0F));
+  const float softirq_norm = std::max(core::clamp01(frame.softirqs), core::clamp01(softnet_norm));
 
   if (!has_irq_baseline_) {
     irq_baseline_ = frame.irq > 1.0F ? frame.irq : 1.0F;
@@ -24,7 +28,11 @@ void SchedulerPressure::sample(model::signal_frame& frame) noexcept {
   const float irq_ratio = frame.irq / ((2.0F * irq_baseline_) + 1.0F);
   const float irq_norm = core::clamp01((irq_ratio - 0.5F) / 1.5F);
 
-  const float raw_score = (0.40F * cpu_norm) + (0.35F * psi_norm) + (0.15F * irq_norm) + (0.10F * softirq_norm);
+  const float heuristic_score = (0.40F * cpu_norm) + (0.35F * psi_norm) + (0.15F * irq_norm) + (0.10F * softirq_norm);
+  // Measured runqueue wait is the direct answer to "will a runnable task wait"; the CPU%/PSI blend
+  // only stands in for it when schedstat is quiet or unavailable.
+  const float runqueue_norm = core::clamp01(frame.sched_run_delay_p99 / kRunDelaySaturationMsPerS);
+  const float raw_score = std::max(runqueue_norm, heuristic_score);
   if (!has_ema_) {
     ema_ = raw_score;
     has_ema_ = true;
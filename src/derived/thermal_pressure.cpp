@@ -1,16 +1,24 @@
 #include "derived/thermal_pressure.hpp"
 #include "core/math.hpp"
 
+#include <algorithm>
+
 namespace hw_agent::derived {
 
 ThermalPressure::ThermalPressure(const float warning_window_c) noexcept : warning_window_c_(warning_window_c > 0.0F ? warning_window_c : 30.0F) {}
 
 void ThermalPressure::sample(model::signal_frame& frame) noexcept {
   const float headroom_pressure = core::clamp01((warning_window_c_ - frame.thermal) / warning_window_c_);
-  const float throttle_norm = core::clamp01(frame.cpu_throttle_ratio);
+  const float trip_eta_pressure = frame.thermal_seconds_to_trip > 0.0F
+                                      ? core::clamp01((kTripHorizonS - frame.thermal_seconds_to_trip) / kTripHorizonS)
+                                      : 0.0F;
+  // Frequency caps (thermal cooling devices or firmware lowering scaling_max_freq) throttle without
+  // necessarily tripping the thermal_throttle counters.
+  const float cap_norm = core::cpufreq_cap_norm(frame.cpufreq_cap_depth);
+  const float throttle_norm = std::max(core::clamp01(frame.cpu_throttle_ratio), cap_norm);
   const float cpu_norm = core::clamp01(frame.cpu / 100.0F);
 
-  const float raw_score = (0.70F * headroom_pressure) + (0.20F * throttle_norm) + (0.10F * cpu_norm);
+  const float raw_score = (0.70F * std::max(headroom_pressure, trip_eta_pressure)) + (0.20F * throttle_norm) + (0.10F * cpu_norm);
 
   if (!has_ema_) {
     ema_ = raw_score;
@@ -9,11 +9,16 @@
 namespace {
 
 volatile std::sig_atomic_t g_shutdown_requested = 0;
+volatile std::sig_atomic_t g_attribution_requested = 0;
 
 void handle_shutdown_signal(int /*signal*/) {
   g_shutdown_requested = 1;
 }
 
+void handle_attribution_signal(int /*signal*/) {
+  g_attribution_requested = 1;
+}
+
 }  // namespace
 
 std::string format_config_settings(const hw_agent::core::AgentConfig& config, const std::string& config_path) {
@@ -22,8 +27,14 @@ std::string format_config_settings(const hw_agent::core::AgentConfig& config, co
          << " | tick_interval_ms=" << config.tick_interval.count()
          << " | thermal_throttle_temp_c=" << config.thermal_throttle_temp_c
          << " | thermal_pressure_warning_window_c=" << config.thermal_pressure_warning_window_c
-         << " | gpu_device_index=" << config.gpu_device_index
-         << " | publish_health=" << (config.publish_health ? "true" : "false")
+         << " | gpu_devices=";
+  if (config.gpu_devices.empty()) {
+    output << "all";
+  }
+  for (std::size_t i = 0; i < config.gpu_devices.size(); ++i) {
+    output << (i == 0 ? "" : ",") << config.gpu_devices[i];
+  }
+  output << " | publish_health=" << (config.publish_health ? "true" : "false")
          << " | stdout_debug=" << (config.stdout_debug ? "true" : "false")
          << " | redis_enabled=" << (config.redis.enabled ? "true" : "false")
          << " | redis_address=";
@@ -33,12 +44,24 @@ std::string format_config_settings(const hw_agent::core::AgentConfig& config, co
   } else {
     output << config.redis.host << ':' << config.redis.port;
   }
+  output << " | redis_mode=" << (config.redis.async ? "async" : "sync")
+         << " | redis_change_only=" << (config.redis.change_only ? "true" : "false")
+         << " | redis_batch_ticks=" << config.redis.batch_ticks
+         << " | redis_spool=" << (config.redis.spool_path.empty() ? "off" : config.redis.spool_path)
+         << " | redis_compactions=" << config.redis.compactions.size()
+         << " | redis_frames_stream=" << (config.redis.frames_stream ? "on" : "off")
+         << " | redis_events=" << (config.redis.events ? "on" : "off")
+         << " | redis_cluster=" << (config.redis.cluster ? "on" : "off")
+         << " | redis_targets=" << config.redis_targets.size();
   return output.str();
 }
 
 int main(int argc, char** argv) {
   std::signal(SIGINT, handle_shutdown_signal);
   std::signal(SIGTERM, handle_shutdown_signal);
+  std::signal(SIGUSR1, handle_attribution_signal);
+  // A Redis server closing the connection must surface as a write error, not kill the agent.
+  std::signal(SIGPIPE, SIG_IGN);
 
   const std::string config_path = argc > 1 ? argv[1] : "configs/agent.all.debug.yaml";
 
@@ -54,6 +77,10 @@ int main(int argc, char** argv) {
 
   hw_agent::core::Agent agent{config};
   while (g_shutdown_requested == 0) {
+    if (g_attribution_requested != 0) {
+      g_attribution_requested = 0;
+      agent.request_process_attribution();
+    }
     agent.run_for_ticks(1);
   }
 
@@ -0,0 +1,107 @@
+#include "model/frame_codec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+namespace hw_agent::model {
+namespace {
+
+constexpr unsigned char kMagic[3] = {'H', 'W', 'F'};
+
+// Every float in signal_frame has a kFrameFloatFields entry; a new field must be appended there.
+constexpr std::size_t kTopLevelFloats =
+    ((offsetof(signal_frame, saturation_risk) - offsetof(signal_frame, psi)) / sizeof(float)) + 1;
+static_assert(std::count_if(std::begin(kFrameFloatFields), std::end(kFrameFloatFields),
+                            [](const FrameFloatField& entry) { return entry.field != nullptr; }) == kTopLevelFloats,
+              "kFrameFloatFields must list every signal_frame float");
+
+template <typename T>
+void store(unsigned char* out, T value) noexcept {
+  auto bits = std::bit_cast<std::array<unsigned char, sizeof(T)>>(value);
+  if constexpr (std::endian::native == std::endian::big) {
+    std::reverse(bits.begin(), bits.end());
+  }
+  std::memcpy(out, bits.data(), sizeof(T));
+}
+
+template <typename T>
+T load(const unsigned char* in) noexcept {
+  std::array<unsigned char, sizeof(T)> bits{};
+  std::memcpy(bits.data(), in, sizeof(T));
+  if constexpr (std::endian::native == std::endian::big) {
+    std::reverse(bits.begin(), bits.end());
+  }
+  return std::bit_cast<T>(bits);
+}
+
+float read_float(const signal_frame& frame, const FrameFloatField& entry) noexcept {
+  return entry.field != nullptr ? frame.*entry.field : frame.agent.*entry.agent_field;
+}
+
+void write_float(signal_frame& frame, const FrameFloatField& entry, const float value) noexcept {
+  if (entry.field != nullptr) {
+    frame.*entry.field = value;
+  } else {
+    frame.agent.*entry.agent_field = value;
+  }
+}
+
+}  // namespace
+
+void encode_frame(const signal_frame& frame, const std::uint64_t unix_ms, unsigned char* out) noexcept {
+  std::memcpy(out, kMagic, sizeof(kMagic));
+  out[3] = kFrameCodecVersion;
+  store<std::uint16_t>(out + 4, static_cast<std::uint16_t>(std::size(kFrameFloatFields)));
+  store<std::uint16_t>(out + 6, static_cast<std::uint16_t>(std::size(kFrameCounterFields)));
+  store<std::uint64_t>(out + 8, unix_ms);
+  store<std::uint64_t>(out + 16, frame.monotonic_ns);
+  store<std::uint64_t>(out + 24, frame.agent.heartbeat_ms);
+  out[32] = static_cast<unsigned char>(frame.state);
+  out[33] = out[34] = out[35] = 0;
+
+  unsigned char* cursor = out + kFrameHeaderSize;
+  for (const FrameFloatField& entry : kFrameFloatFields) {
+    store<float>(cursor, read_float(frame, entry));
+    cursor += 4;
+  }
+  for (const FrameCounterField& entry : kFrameCounterFields) {
+    store<std::uint32_t>(cursor, frame.agent.*entry.field);
+    cursor += 4;
+  }
+}
+
+bool decode_frame(const void* data, const std::size_t size, signal_frame& frame, std::uint64_t& unix_ms) noexcept {
+  const auto* in = static_cast<const unsigned char*>(data);
+  if (size < kFrameHeaderSize || std::memcmp(in, kMagic, sizeof(kMagic)) != 0 || in[3] != kFrameCodecVersion) {
+    return false;
+  }
+  const std::size_t floats = load<std::uint16_t>(in + 4);
+  const std::size_t counters = load<std::uint16_t>(in + 6);
+  if (size < kFrameHeaderSize + ((floats + counters) * 4)) {
+    return false;
+  }
+
+  frame = signal_frame{};
+  unix_ms = load<std::uint64_t>(in + 8);
+  frame.monotonic_ns = load<std::uint64_t>(in + 16);
+  frame.agent.heartbeat_ms = load<std::uint64_t>(in + 24);
+  frame.state = static_cast<system_state>(in[32]);
+
+  const unsigned char* cursor = in + kFrameHeaderSize;
+  const std::size_t known_floats = std::min(floats, std::size(kFrameFloatFields));
+  for (std::size_t i = 0; i < known_floats; ++i) {
+    write_float(frame, kFrameFloatFields[i], load<float>(cursor + (i * 4)));
+  }
+  cursor += floats * 4;
+  const std::size_t known_counters = std::min(counters, std::size(kFrameCounterFields));
+  for (std::size_t i = 0; i < known_counters; ++i) {
+    frame.agent.*kFrameCounterFields[i].field = load<std::uint32_t>(cursor + (i * 4));
+  }
+  return true;
+}
+
+}  // namespace hw_agent::model
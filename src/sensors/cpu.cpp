@@ -1,5 +1,7 @@
 #include "sensors/cpu.hpp"
 
+#include "core/file_io.hpp"
+
 #include <cerrno>
 #include <cstdlib>
 
@@ -22,7 +24,7 @@ bool CpuSensor::sample(model::signal_frame& frame) noexcept {
     return false;
   }
 
-  if (std::fseek(file_, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(file_)) {
     frame.cpu = 0.0F;
     return false;
   }
@@ -1,93 +1,180 @@
 #include "sensors/cpufreq.hpp"
 
+#include "core/file_io.hpp"
+
+#include <algorithm>
 #include <cerrno>
 #include <cstdlib>
-#include <glob.h>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
 #include <utility>
 
 namespace hw_agent::sensors {
 
-CpuFreqSensor::CpuFreqSensor() : owns_files_(true) {
-  glob_t matches{};
-  constexpr const char* pattern = "/sys/devices/system/cpu/cpu*/cpufreq/scaling_cur_freq";
+namespace {
+constexpr const char* kSysCpufreq = "/sys/devices/system/cpu/cpufreq";
+
+std::uint64_t read_static_khz(const std::filesystem::path& path) {
+  std::ifstream input(path);
+  unsigned long long khz = 0;
+  if (!input.is_open() || !(input >> khz)) {
+    return 0;
+  }
+  return khz;
+}
+
+}  // namespace
+
+CpuFreqSensor::CpuFreqSensor() : owns_files_(true) { discover_policies(kSysCpufreq); }
 
-  if (::glob(pattern, 0, nullptr, &matches) == 0) {
-    files_.reserve(matches.gl_pathc);
-    for (std::size_t i = 0; i < matches.gl_pathc; ++i) {
-      if (std::FILE* file = std::fopen(matches.gl_pathv[i], "r"); file != nullptr) {
-        files_.push_back(file);
+CpuFreqSensor::CpuFreqSensor(std::string cpufreq_root) : owns_files_(true) { discover_policies(cpufreq_root); }
+
+CpuFreqSensor::CpuFreqSensor(std::vector<PolicySource> policies, const bool owns_files)
+    : policies_(std::move(policies)), owns_files_(owns_files) {}
+
+void CpuFreqSensor::discover_policies(const std::string& cpufreq_root) {
+  try {
+    if (!std::filesystem::exists(cpufreq_root)) {
+      return;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(cpufreq_root)) {
+      const std::string name = entry.path().filename().string();
+      if (name.rfind("policy", 0) != 0 || !entry.is_directory()) {
+        continue;
       }
+
+      const std::filesystem::path policy_path = entry.path();
+
+      PolicySource source{};
+      source.name = name;
+      source.cur_freq_file = std::fopen((policy_path / "scaling_cur_freq").c_str(), "r");
+      source.scaling_max_file = std::fopen((policy_path / "scaling_max_freq").c_str(), "r");
+      source.cpuinfo_max_khz = read_static_khz(policy_path / "cpuinfo_max_freq");
+      policies_.push_back(source);
     }
+  } catch (const std::filesystem::filesystem_error&) {
+    // Keep whatever was discovered before the error; the files already opened are still usable.
   }
 
-  ::globfree(&matches);
+  // directory_iterator order is unspecified; keep policy0, policy1, ... stable for raw() consumers.
+  std::sort(policies_.begin(), policies_.end(), [](const PolicySource& lhs, const PolicySource& rhs) {
+    return lhs.name.size() != rhs.name.size() ? lhs.name.size() < rhs.name.size() : lhs.name < rhs.name;
+  });
 }
 
-CpuFreqSensor::CpuFreqSensor(std::vector<std::FILE*> files, const bool owns_files)
-    : files_(std::move(files)), owns_files_(owns_files) {}
-
 CpuFreqSensor::~CpuFreqSensor() {
   if (!owns_files_) {
     return;
   }
 
-  for (std::FILE* file : files_) {
-    if (file != nullptr) {
-      std::fclose(file);
+  for (PolicySource& policy : policies_) {
+    for (std::FILE** file : {&policy.cur_freq_file, &policy.scaling_max_file}) {
+      if (*file != nullptr) {
+        std::fclose(*file);
+        *file = nullptr;
+      }
     }
   }
-  files_.clear();
 }
 
 bool CpuFreqSensor::sample(model::signal_frame& frame) noexcept {
-  if (files_.empty()) {
-    frame.cpufreq = 0.0F;
-    return false;
-  }
+  raw_ = RawFields{};
 
-  char value_buffer[64]{};
   double total_mhz = 0.0;
-  std::size_t count = 0;
+  double total_ratio = 0.0;
+  std::size_t ratio_count = 0;
+  float min_ratio = 1.0F;
 
-  for (std::FILE* file : files_) {
-    if (file == nullptr) {
+  for (PolicySource& policy : policies_) {
+    std::uint64_t cur_khz = 0;
+    if (!read_khz(policy.cur_freq_file, cur_khz)) {
       continue;
     }
 
-    if (std::fseek(file, 0L, SEEK_SET) != 0) {
+    total_mhz += static_cast<double>(cur_khz) / 1000.0;
+    ++raw_.readable_policies;
+
+    if (policy.cpuinfo_max_khz == 0) {
       continue;
     }
 
-    if (std::fgets(value_buffer, static_cast<int>(sizeof(value_buffer)), file) == nullptr) {
+    const double max_khz = static_cast<double>(policy.cpuinfo_max_khz);
+    const float ratio = static_cast<float>(std::min(1.0, static_cast<double>(cur_khz) / max_khz));
+    total_ratio += ratio;
+    ++ratio_count;
+    min_ratio = std::min(min_ratio, ratio);
+
+    std::uint64_t scaling_max_khz = 0;
+    if (!read_khz(policy.scaling_max_file, scaling_max_khz) || scaling_max_khz == 0) {
       continue;
     }
 
-    char* end = nullptr;
-    errno = 0;
-    const unsigned long long khz = std::strtoull(value_buffer, &end, 10);
-    if (errno == 0 && end != value_buffer) {
-      total_mhz += static_cast<double>(khz) / 1000.0;
-      ++count;
+    const float limit_ratio = static_cast<float>(std::min(1.0, static_cast<double>(scaling_max_khz) / max_khz));
+    if (limit_ratio < kCapThreshold) {
+      ++raw_.capped_policies;
+      raw_.cap_depth = std::max(raw_.cap_depth, 1.0F - limit_ratio);
     }
   }
 
-  if (count == 0) {
+  if (ratio_count != 0) {
+    raw_.min_ratio = min_ratio;
+    raw_.avg_ratio = static_cast<float>(total_ratio / static_cast<double>(ratio_count));
+  }
+
+  frame.cpufreq_min_ratio = raw_.min_ratio;
+  frame.cpufreq_avg_ratio = raw_.avg_ratio;
+  frame.cpufreq_capped = static_cast<float>(raw_.capped_policies);
+  frame.cpufreq_cap_depth = raw_.cap_depth;
+
+  if (raw_.readable_policies == 0) {
     frame.cpufreq = 0.0F;
     return false;
   }
 
-  const float current_average_mhz = static_cast<float>(total_mhz / static_cast<double>(count));
+  raw_.average_mhz = static_cast<float>(total_mhz / static_cast<double>(raw_.readable_policies));
   constexpr float alpha = 0.25F;
 
   if (!has_ema_) {
     has_ema_ = true;
-    ema_mhz_ = current_average_mhz;
+    ema_mhz_ = raw_.average_mhz;
   } else {
-    ema_mhz_ = ((1.0F - alpha) * ema_mhz_) + (alpha * current_average_mhz);
+    ema_mhz_ = ((1.0F - alpha) * ema_mhz_) + (alpha * raw_.average_mhz);
   }
 
   frame.cpufreq = ema_mhz_;
   return true;
 }
 
+const CpuFreqSensor::RawFields& CpuFreqSensor::raw() const noexcept { return raw_; }
+
+const std::vector<CpuFreqSensor::PolicySource>& CpuFreqSensor::policies() const noexcept { return policies_; }
+
+bool CpuFreqSensor::read_khz(std::FILE* file, std::uint64_t& khz) noexcept {
+  if (file == nullptr) {
+    return false;
+  }
+
+  if (!core::rewind_file(file)) {
+    return false;
+  }
+
+  char value_buffer[64]{};
+  if (std::fgets(value_buffer, static_cast<int>(sizeof(value_buffer)), file) == nullptr) {
+    std::clearerr(file);
+    return false;
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  const unsigned long long parsed = std::strtoull(value_buffer, &end, 10);
+  if (errno != 0 || end == value_buffer) {
+    return false;
+  }
+
+  khz = parsed;
+  return true;
+}
+
 }  // namespace hw_agent::sensors
@@ -1,5 +1,7 @@
 #include "sensors/disk.hpp"
 
+#include "core/file_io.hpp"
+
 #include <cctype>
 #include <cstring>
 
@@ -55,7 +57,7 @@ bool DiskSensor::sample(model::signal_frame& frame) noexcept {
     return false;
   }
 
-  if (std::fseek(diskstats_, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(diskstats_)) {
     frame.disk = 0.0F;
     return false;
   }
@@ -0,0 +1,322 @@
+#include "sensors/gpu/gpu.hpp"
+
+#include "core/file_io.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hw_agent::sensors::gpu {
+namespace {
+
+std::FILE* open_file(const std::filesystem::path& path) { return std::fopen(path.c_str(), "r"); }
+
+void close_file(std::FILE*& file) noexcept {
+  if (file != nullptr) {
+    std::fclose(file);
+    file = nullptr;
+  }
+}
+
+bool read_u64_file(std::FILE* file, std::uint64_t& value) noexcept {
+  if (file == nullptr || !core::rewind_file(file)) {
+    return false;
+  }
+
+  char buffer[32]{};
+  if (std::fgets(buffer, static_cast<int>(sizeof(buffer)), file) == nullptr) {
+    std::clearerr(file);
+    return false;
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  const unsigned long long parsed = std::strtoull(buffer, &end, 10);
+  if (errno != 0 || end == buffer) {
+    return false;
+  }
+  value = static_cast<std::uint64_t>(parsed);
+  return true;
+}
+
+// pp_dpm_sclk lists DPM levels as "N: <MHz>Mhz" with '*' after the active one. Returns the active
+// and highest level clocks.
+bool read_dpm_levels(std::FILE* file, std::uint64_t& current_mhz, std::uint64_t& max_mhz) noexcept {
+  if (file == nullptr || !core::rewind_file(file)) {
+    return false;
+  }
+
+  char buffer[512];
+  const std::size_t bytes_read = std::fread(buffer, 1, sizeof(buffer) - 1, file);
+  std::clearerr(file);
+  buffer[bytes_read] = '\0';
+
+  bool found_current = false;
+  max_mhz = 0;
+  char* line = buffer;
+  while (line != nullptr && *line != '\0') {
+    char* next = std::strchr(line, '\n');
+    if (next != nullptr) {
+      *next++ = '\0';
+    }
+    if (const char* colon = std::strchr(line, ':'); colon != nullptr) {
+      char* end = nullptr;
+      const unsigned long long mhz = std::strtoull(colon + 1, &end, 10);
+      if (end != colon + 1) {
+        max_mhz = std::max<std::uint64_t>(max_mhz, mhz);
+        if (std::strchr(end, '*') != nullptr) {
+          current_mhz = mhz;
+          found_current = true;
+        }
+      }
+    }
+    line = next;
+  }
+  return found_current && max_mhz > 0;
+}
+
+class DrmGpuSensor final : public GpuSensor {
+ public:
+  explicit DrmGpuSensor(const std::string& sysfs_root) { discover(sysfs_root); }
+
+  ~DrmGpuSensor() override {
+    for (Card& card : cards_) {
+      close_file(card.busy_file);
+      close_file(card.vram_used_file);
+      close_file(card.temp_file);
+      close_file(card.power_file);
+      close_file(card.power_cap_file);
+      close_file(card.sclk_file);
+      close_file(card.gt_freq_file);
+      close_file(card.gt_throttle_file);
+    }
+  }
+
+  DrmGpuSensor(const DrmGpuSensor&) = delete;
+  DrmGpuSensor& operator=(const DrmGpuSensor&) = delete;
+
+  const char* source() const override { return "drm"; }
+
+  bool available() const override { return !cards_.empty(); }
+
+  const std::vector<GpuDeviceSample>& devices() const override { return samples_; }
+
+  bool collect(SignalFrame& frame) override {
+    samples_.clear();
+    for (Card& card : cards_) {
+      GpuDeviceSample sample{};
+      if (read_card(card, sample)) {
+        samples_.push_back(sample);
+      }
+    }
+    if (samples_.empty()) {
+      set_defaults(frame);
+      return false;
+    }
+
+    const GpuDeviceSample& worst = worst_device(samples_);
+    float util = 0.0F;
+    float mem_util = 0.0F;
+    float mem_free_mb = samples_.front().mem_free_mb;
+    float temp_c = 0.0F;
+    float power_ratio = 0.0F;
+    bool throttled = false;
+    for (const GpuDeviceSample& sample : samples_) {
+      util = std::max(util, sample.util);
+      mem_util = std::max(mem_util, sample.mem_util);
+      mem_free_mb = std::min(mem_free_mb, sample.mem_free_mb);
+      temp_c = std::max(temp_c, sample.temp_c);
+      power_ratio = std::max(power_ratio, sample.power_ratio);
+      throttled = throttled || sample.throttled;
+    }
+
+    frame.gpu_util = util;
+    frame.gpu_mem_util = mem_util;
+    frame.emc_util = 0.0F;
+    frame.gpu_mem_free = mem_free_mb;
+    frame.gpu_temp = temp_c;
+    frame.gpu_clock_ratio = worst.clock_ratio;
+    frame.gpu_power_ratio = power_ratio;
+    frame.gpu_throttle = throttled ? 1.0F : 0.0F;
+    frame.drm_gpu_util = util;
+    frame.drm_gpu_temp = temp_c;
+    frame.drm_gpu_clock_ratio = worst.clock_ratio;
+    frame.drm_gpu_power_ratio = power_ratio;
+    return true;
+  }
+
+ private:
+  struct Card {
+    unsigned int index{0};
+    // amdgpu: gpu_busy_percent, mem_info_vram_*, pp_dpm_sclk and hwmon power in microwatts.
+    std::FILE* busy_file{nullptr};
+    std::FILE* vram_used_file{nullptr};
+    std::uint64_t vram_total_bytes{0};
+    std::FILE* temp_file{nullptr};
+    std::FILE* power_file{nullptr};
+    std::FILE* power_cap_file{nullptr};
+    std::FILE* sclk_file{nullptr};
+    // i915 has no busy or VRAM files; the GT actual frequency against RP0 gives the clock ratio.
+    std::FILE* gt_freq_file{nullptr};
+    std::uint64_t gt_max_mhz{0};
+    std::FILE* gt_throttle_file{nullptr};
+  };
+
+  void discover(const std::string& sysfs_root) {
+    namespace fs = std::filesystem;
+    const fs::path drm = fs::path(sysfs_root) / "class" / "drm";
+
+    try {
+      if (!fs::exists(drm)) {
+        return;
+      }
+      for (const auto& entry : fs::directory_iterator(drm)) {
+        // card0, card1, ...; connectors such as card0-DP-1 share the prefix.
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("card", 0) != 0 || name.size() == 4 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos) {
+          continue;
+        }
+
+        Card card{};
+        card.index = static_cast<unsigned int>(std::strtoul(name.c_str() + 4, nullptr, 10));
+        const fs::path device = entry.path() / "device";
+        card.busy_file = open_file(device / "gpu_busy_percent");
+        card.vram_used_file = open_file(device / "mem_info_vram_used");
+        if (std::FILE* total = open_file(device / "mem_info_vram_total"); total != nullptr) {
+          (void)read_u64_file(total, card.vram_total_bytes);
+          std::fclose(total);
+        }
+        card.sclk_file = open_file(device / "pp_dpm_sclk");
+
+        const fs::path hwmon = device / "hwmon";
+        if (fs::exists(hwmon)) {
+          for (const auto& hwmon_entry : fs::directory_iterator(hwmon)) {
+            if (card.temp_file == nullptr) {
+              card.temp_file = open_file(hwmon_entry.path() / "temp1_input");
+            }
+            if (card.power_file == nullptr) {
+              // Older amdgpu exposes only the averaged reading, RDNA3 only the instantaneous one.
+              card.power_file = open_file(hwmon_entry.path() / "power1_average");
+              if (card.power_file == nullptr) {
+                card.power_file = open_file(hwmon_entry.path() / "power1_input");
+              }
+            }
+            if (card.power_cap_file == nullptr) {
+              card.power_cap_file = open_file(hwmon_entry.path() / "power1_cap");
+            }
+          }
+        }
+
+        card.gt_freq_file = open_file(entry.path() / "gt_act_freq_mhz");
+        if (std::FILE* rp0 = open_file(entry.path() / "gt_RP0_freq_mhz"); rp0 != nullptr) {
+          (void)read_u64_file(rp0, card.gt_max_mhz);
+          std::fclose(rp0);
+        }
+        card.gt_throttle_file = open_file(entry.path() / "gt" / "gt0" / "throttle_reason_status");
+
+        if (card.busy_file == nullptr && card.sclk_file == nullptr && card.gt_freq_file == nullptr) {
+          // Display-only or unsupported driver: nothing to report.
+          close_file(card.vram_used_file);
+          close_file(card.temp_file);
+          close_file(card.power_file);
+          close_file(card.power_cap_file);
+          close_file(card.gt_throttle_file);
+          continue;
+        }
+        cards_.push_back(card);
+      }
+    } catch (const fs::filesystem_error&) {
+      // Keep whatever was discovered before the error.
+    }
+
+    std::sort(cards_.begin(), cards_.end(), [](const Card& lhs, const Card& rhs) { return lhs.index < rhs.index; });
+    samples_.reserve(cards_.size());
+  }
+
+  static bool read_card(Card& card, GpuDeviceSample& sample) noexcept {
+    bool any_read = false;
+    sample.index = card.index;
+
+    std::uint64_t busy_pct = 0;
+    if (read_u64_file(card.busy_file, busy_pct)) {
+      sample.util = static_cast<float>(std::min<std::uint64_t>(busy_pct, 100));
+      any_read = true;
+    }
+
+    std::uint64_t vram_used = 0;
+    if (card.vram_total_bytes > 0 && read_u64_file(card.vram_used_file, vram_used)) {
+      vram_used = std::min(vram_used, card.vram_total_bytes);
+      sample.mem_util =
+          static_cast<float>(static_cast<double>(vram_used) * 100.0 / static_cast<double>(card.vram_total_bytes));
+      sample.mem_free_mb = static_cast<float>((card.vram_total_bytes - vram_used) / (1024ULL * 1024ULL));
+      any_read = true;
+    }
+
+    std::uint64_t millidegrees = 0;
+    if (read_u64_file(card.temp_file, millidegrees)) {
+      sample.temp_c = static_cast<float>(millidegrees) / 1000.0F;
+      any_read = true;
+    }
+
+    std::uint64_t power_uw = 0;
+    if (read_u64_file(card.power_file, power_uw)) {
+      sample.power_mw = static_cast<float>(power_uw / 1000ULL);
+      std::uint64_t cap_uw = 0;
+      if (read_u64_file(card.power_cap_file, cap_uw) && cap_uw > 0) {
+        sample.power_ratio = static_cast<float>(static_cast<double>(power_uw) / static_cast<double>(cap_uw));
+      }
+      any_read = true;
+    }
+
+    std::uint64_t current_mhz = 0;
+    std::uint64_t max_mhz = 0;
+    if (read_dpm_levels(card.sclk_file, current_mhz, max_mhz)) {
+      sample.clock_ratio = static_cast<float>(current_mhz) / static_cast<float>(max_mhz);
+      any_read = true;
+    } else if (card.gt_max_mhz > 0 && read_u64_file(card.gt_freq_file, current_mhz)) {
+      sample.clock_ratio = std::min(1.0F, static_cast<float>(current_mhz) / static_cast<float>(card.gt_max_mhz));
+      any_read = true;
+    }
+
+    std::uint64_t throttle_status = 0;
+    if (read_u64_file(card.gt_throttle_file, throttle_status)) {
+      sample.throttled = throttle_status != 0;
+    }
+    return any_read;
+  }
+
+  static void set_defaults(SignalFrame& frame) noexcept {
+    frame.gpu_util = 0.0F;
+    frame.gpu_mem_util = 0.0F;
+    frame.emc_util = 0.0F;
+    frame.gpu_mem_free = 0.0F;
+    frame.gpu_temp = 0.0F;
+    frame.gpu_clock_ratio = 0.0F;
+    frame.gpu_power_ratio = 0.0F;
+    frame.gpu_throttle = 0.0F;
+    frame.drm_gpu_util = 0.0F;
+    frame.drm_gpu_temp = 0.0F;
+    frame.drm_gpu_clock_ratio = 0.0F;
+    frame.drm_gpu_power_ratio = 0.0F;
+  }
+
+  std::vector<Card> cards_{};
+  std::vector<GpuDeviceSample> samples_{};
+};
+
+}  // namespace
+
+std::unique_ptr<GpuSensor> make_drm_sensor(const std::string& sysfs_root) {
+  return std::make_unique<DrmGpuSensor>(sysfs_root);
+}
+
+}  // namespace hw_agent::sensors::gpu
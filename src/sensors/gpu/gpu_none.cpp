@@ -1,14 +1,19 @@
 #include "sensors/gpu/gpu.hpp"
 
 #include <memory>
+#include <vector>
 
 namespace hw_agent::sensors::gpu {
 namespace {
 
 class NoneGpuSensor final : public GpuSensor {
  public:
+  const char* source() const override { return "none"; }
+
   bool available() const override { return false; }
 
+  const std::vector<GpuDeviceSample>& devices() const override { return devices_; }
+
   bool collect(SignalFrame& frame) override {
     frame.gpu_util = 0.0F;
     frame.gpu_mem_util = 0.0F;
@@ -21,8 +26,18 @@ class NoneGpuSensor final : public GpuSensor {
     frame.nvml_gpu_util = 0.0F;
     frame.nvml_gpu_temp = 0.0F;
     frame.nvml_gpu_power_ratio = 0.0F;
+    frame.nvml_gpu_devices = 0.0F;
+    frame.nvml_gpu_throttled = 0.0F;
+    frame.nvml_gpu_worst_device = 0.0F;
+    frame.drm_gpu_util = 0.0F;
+    frame.drm_gpu_temp = 0.0F;
+    frame.drm_gpu_clock_ratio = 0.0F;
+    frame.drm_gpu_power_ratio = 0.0F;
     return false;
   }
+
+ private:
+  std::vector<GpuDeviceSample> devices_{};
 };
 
 }  // namespace
@@ -1,14 +1,23 @@
 #include "sensors/gpu/gpu.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <dlfcn.h>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #if defined(HW_AGENT_HAVE_NVML)
 #include <nvml.h>
 #else
 using nvmlReturn_t = int;
 using nvmlDevice_t = struct nvmlDevice_st*;
+using nvmlValueType_t = int;
 
 struct nvmlUtilization_t {
   unsigned int gpu;
@@ -21,18 +30,85 @@ struct nvmlMemory_t {
   unsigned long long used;
 };
 
+union nvmlValue_t {
+  double dVal;
+  unsigned int uiVal;
+  unsigned long ulVal;
+  unsigned long long ullVal;
+  signed long long sllVal;
+};
+
+struct nvmlFieldValue_t {
+  unsigned int fieldId;
+  unsigned int scopeId;
+  long long timestamp;
+  long long latencyUsec;
+  nvmlValueType_t valueType;
+  nvmlReturn_t nvmlReturn;
+  nvmlValue_t value;
+};
+
 constexpr nvmlReturn_t NVML_SUCCESS = 0;
 constexpr unsigned int NVML_TEMPERATURE_GPU = 0;
 constexpr unsigned int NVML_CLOCK_GRAPHICS = 0;
 constexpr unsigned long long nvmlClocksThrottleReasonNone = 0x0000000000000000ULL;
+constexpr nvmlValueType_t NVML_VALUE_TYPE_DOUBLE = 0;
+constexpr nvmlValueType_t NVML_VALUE_TYPE_UNSIGNED_INT = 1;
+constexpr nvmlValueType_t NVML_VALUE_TYPE_UNSIGNED_LONG = 2;
+constexpr nvmlValueType_t NVML_VALUE_TYPE_UNSIGNED_LONG_LONG = 3;
+constexpr nvmlValueType_t NVML_VALUE_TYPE_SIGNED_LONG_LONG = 4;
 #endif
 
 namespace hw_agent::sensors::gpu {
 namespace {
 
+// Field IDs from nvml.h, spelled out so older headers without the power fields still build.
+constexpr unsigned int kFieldTotalEnergyMj = 83;   // NVML_FI_DEV_TOTAL_ENERGY_CONSUMPTION
+constexpr unsigned int kFieldPowerInstantMw = 186;  // NVML_FI_DEV_POWER_INSTANT
+constexpr unsigned int kFieldPowerLimitMw = 190;    // NVML_FI_DEV_POWER_CURRENT_LIMIT
+
+constexpr nvmlReturn_t kErrorNotFound = 6;         // NVML_ERROR_NOT_FOUND
+constexpr nvmlReturn_t kErrorInsufficientSize = 7;  // NVML_ERROR_INSUFFICIENT_SIZE
+constexpr unsigned long long kValueNotAvailable = ~0ULL;
+
+// Layouts of nvmlProcessUtilizationSample_t and nvmlProcessInfo_v2_t; declared here because older
+// nvml.h headers only carry the v1 process info struct.
+struct ProcessUtilizationSample {
+  unsigned int pid;
+  unsigned long long timeStamp;
+  unsigned int smUtil;
+  unsigned int memUtil;
+  unsigned int encUtil;
+  unsigned int decUtil;
+};
+
+struct ProcessInfo {
+  unsigned int pid;
+  unsigned long long usedGpuMemory;
+  unsigned int gpuInstanceId;
+  unsigned int computeInstanceId;
+};
+
+double field_as_double(const nvmlFieldValue_t& field) noexcept {
+  switch (field.valueType) {
+    case NVML_VALUE_TYPE_DOUBLE:
+      return field.value.dVal;
+    case NVML_VALUE_TYPE_UNSIGNED_INT:
+      return static_cast<double>(field.value.uiVal);
+    case NVML_VALUE_TYPE_UNSIGNED_LONG:
+      return static_cast<double>(field.value.ulVal);
+    case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG:
+      return static_cast<double>(field.value.ullVal);
+    case NVML_VALUE_TYPE_SIGNED_LONG_LONG:
+      return static_cast<double>(field.value.sllVal);
+    default:
+      return 0.0;
+  }
+}
+
 class NvmlGpuSensor final : public GpuSensor {
  public:
-  explicit NvmlGpuSensor(unsigned int device_index) noexcept : device_index_(device_index) { init(); }
+  explicit NvmlGpuSensor(NvmlOptions options) noexcept : options_(std::move(options)) { init(); }
 
   ~NvmlGpuSensor() override {
     if (initialized_ && fn_shutdown_ != nullptr) {
@@ -46,52 +122,137 @@ class NvmlGpuSensor final : public GpuSensor {
     }
   }
 
+  const char* source() const override { return "nvml"; }
+
   bool available() const override { return available_; }
 
+  const std::vector<GpuDeviceSample>& devices() const override { return samples_; }
+
+  bool collect_workloads(std::vector<GpuWorkload>& workloads) override {
+    workloads.clear();
+    if (!available_ || fn_device_get_process_utilization_ == nullptr || fn_device_get_compute_processes_ == nullptr) {
+      return false;
+    }
+
+    pid_usage_.clear();
+    bool any_read = false;
+    for (Device& device : devices_) {
+      any_read = read_process_utilization(device) || any_read;
+      any_read = read_compute_processes(device) || any_read;
+    }
+    if (!any_read) {
+      return false;
+    }
+
+    std::unordered_map<std::string, GpuWorkload> by_cgroup;
+    for (const auto& [pid, usage] : pid_usage_) {
+      const std::string& cgroup = cgroup_of(pid);
+      GpuWorkload& workload = by_cgroup[cgroup];
+      workload.cgroup = cgroup;
+      ++workload.processes;
+      workload.sm_util += usage.sm_util;
+      workload.mem_util += usage.mem_util;
+      workload.fb_used_mb += static_cast<float>(usage.fb_used_bytes / (1024ULL * 1024ULL));
+    }
+    for (auto& [cgroup, workload] : by_cgroup) {
+      workloads.push_back(std::move(workload));
+    }
+    std::sort(workloads.begin(), workloads.end(), [](const GpuWorkload& lhs, const GpuWorkload& rhs) {
+      if (lhs.sm_util != rhs.sm_util) {
+        return lhs.sm_util > rhs.sm_util;
+      }
+      return lhs.fb_used_mb > rhs.fb_used_mb;
+    });
+
+    // Forget exited PIDs so a recycled PID is looked up again.
+    for (auto it = cgroup_cache_.begin(); it != cgroup_cache_.end();) {
+      it = pid_usage_.count(it->first) == 0 ? cgroup_cache_.erase(it) : std::next(it);
+    }
+    return true;
+  }
+
   bool collect(SignalFrame& frame) override {
+    samples_.clear();
     if (!available_) {
       set_defaults(frame);
       return false;
     }
 
-    nvmlUtilization_t util{};
-    nvmlMemory_t memory{};
-    unsigned int temp_c = 0;
-    unsigned int graphics_clock_mhz = 0;
-    unsigned int power_mw = 0;
-    unsigned long long throttle_reasons = 0;
-
-    if (fn_device_get_utilization_rates_(device_, &util) != NVML_SUCCESS ||
-        fn_device_get_memory_info_(device_, &memory) != NVML_SUCCESS ||
-        fn_device_get_temperature_(device_, NVML_TEMPERATURE_GPU, &temp_c) != NVML_SUCCESS ||
-        fn_device_get_clock_info_(device_, NVML_CLOCK_GRAPHICS, &graphics_clock_mhz) != NVML_SUCCESS ||
-        fn_device_get_power_usage_(device_, &power_mw) != NVML_SUCCESS ||
-        fn_device_get_current_clocks_throttle_reasons_(device_, &throttle_reasons) != NVML_SUCCESS) {
+    for (Device& device : devices_) {
+      GpuDeviceSample sample{};
+      if (read_device(device, sample)) {
+        samples_.push_back(sample);
+      }
+    }
+    if (samples_.empty()) {
       set_defaults(frame);
       return false;
     }
 
-    frame.gpu_util = static_cast<float>(util.gpu);
-    frame.nvml_gpu_util = static_cast<float>(util.gpu);
-    frame.gpu_mem_util = static_cast<float>(util.memory);
+    const GpuDeviceSample& worst = worst_device(samples_);
+
+    float util = 0.0F;
+    float mem_util = 0.0F;
+    float mem_free_mb = samples_.front().mem_free_mb;
+    float temp_c = 0.0F;
+    float power_ratio = 0.0F;
+    std::size_t throttled = 0;
+    for (const GpuDeviceSample& sample : samples_) {
+      util = std::max(util, sample.util);
+      mem_util = std::max(mem_util, sample.mem_util);
+      mem_free_mb = std::min(mem_free_mb, sample.mem_free_mb);
+      temp_c = std::max(temp_c, sample.temp_c);
+      power_ratio = std::max(power_ratio, sample.power_ratio);
+      throttled += sample.throttled ? 1U : 0U;
+    }
+
+    frame.gpu_util = util;
+    frame.nvml_gpu_util = util;
+    frame.gpu_mem_util = mem_util;
     frame.emc_util = 0.0F;
-    frame.gpu_mem_free = static_cast<float>(memory.free / (1024ULL * 1024ULL));
-    frame.gpu_temp = static_cast<float>(temp_c);
-    frame.nvml_gpu_temp = static_cast<float>(temp_c);
-    frame.gpu_clock_ratio = max_graphics_clock_mhz_ > 0U
-                                ? static_cast<float>(graphics_clock_mhz) / static_cast<float>(max_graphics_clock_mhz_)
-                                : 0.0F;
-    frame.gpu_power_ratio = power_limit_mw_ > 0U ? static_cast<float>(power_mw) / static_cast<float>(power_limit_mw_)
-                                                 : 0.0F;
-    frame.nvml_gpu_power_ratio = frame.gpu_power_ratio;
-    frame.gpu_throttle = throttle_reasons == nvmlClocksThrottleReasonNone ? 0.0F : 1.0F;
+    frame.gpu_mem_free = mem_free_mb;
+    frame.gpu_temp = temp_c;
+    frame.nvml_gpu_temp = temp_c;
+    frame.gpu_clock_ratio = worst.clock_ratio;
+    frame.gpu_power_ratio = power_ratio;
+    frame.nvml_gpu_power_ratio = power_ratio;
+    frame.gpu_throttle = throttled > 0 ? 1.0F : 0.0F;
+    frame.nvml_gpu_devices = static_cast<float>(samples_.size());
+    frame.nvml_gpu_throttled = static_cast<float>(throttled);
+    frame.nvml_gpu_worst_device = static_cast<float>(worst.index);
 
     return true;
   }
 
  private:
+  struct Device {
+    unsigned int index{0};
+    nvmlDevice_t handle{nullptr};
+    unsigned int max_graphics_clock_mhz{0};
+    unsigned int power_limit_mw{0};
+    // Previous energy counter reading; power is averaged over the collect window when available.
+    double energy_mj{0.0};
+    long long energy_timestamp_us{0};
+    std::array<nvmlFieldValue_t, 3> fields{};
+    // Newest process utilization sample seen, passed back so NVML only returns newer ones.
+    unsigned long long last_process_timestamp{0};
+  };
+
+  struct PidUsage {
+    float sm_util{0.0F};
+    float mem_util{0.0F};
+    unsigned long long fb_used_bytes{0};
+  };
+
+  struct PidSamples {
+    unsigned int sm_sum{0};
+    unsigned int mem_sum{0};
+    unsigned int count{0};
+  };
+
   using FnNvmlInit = nvmlReturn_t (*)();
   using FnNvmlShutdown = nvmlReturn_t (*)();
+  using FnNvmlDeviceGetCount = nvmlReturn_t (*)(unsigned int*);
   using FnNvmlDeviceGetHandleByIndex = nvmlReturn_t (*)(unsigned int, nvmlDevice_t*);
   using FnNvmlDeviceGetUtilizationRates = nvmlReturn_t (*)(nvmlDevice_t, nvmlUtilization_t*);
   using FnNvmlDeviceGetMemoryInfo = nvmlReturn_t (*)(nvmlDevice_t, nvmlMemory_t*);
@@ -101,6 +262,10 @@ class NvmlGpuSensor final : public GpuSensor {
   using FnNvmlDeviceGetPowerUsage = nvmlReturn_t (*)(nvmlDevice_t, unsigned int*);
   using FnNvmlDeviceGetEnforcedPowerLimit = nvmlReturn_t (*)(nvmlDevice_t, unsigned int*);
   using FnNvmlDeviceGetCurrentClocksThrottleReasons = nvmlReturn_t (*)(nvmlDevice_t, unsigned long long*);
+  using FnNvmlDeviceGetFieldValues = nvmlReturn_t (*)(nvmlDevice_t, int, nvmlFieldValue_t*);
+  using FnNvmlDeviceGetProcessUtilization =
+      nvmlReturn_t (*)(nvmlDevice_t, ProcessUtilizationSample*, unsigned int*, unsigned long long);
+  using FnNvmlDeviceGetComputeRunningProcesses = nvmlReturn_t (*)(nvmlDevice_t, unsigned int*, ProcessInfo*);
 
   template <typename FnType>
   bool resolve(FnType& fn, const char* symbol) noexcept {
@@ -109,7 +274,7 @@ class NvmlGpuSensor final : public GpuSensor {
   }
 
   void init() noexcept {
-    library_ = dlopen("libnvidia-ml.so.1", RTLD_NOW);
+    library_ = dlopen(options_.library.c_str(), RTLD_NOW);
     if (library_ == nullptr) {
       return;
     }
@@ -122,6 +287,11 @@ class NvmlGpuSensor final : public GpuSensor {
       return;
     }
 
+    if (!resolve(fn_device_get_count_, "nvmlDeviceGetCount_v2") &&
+        !resolve(fn_device_get_count_, "nvmlDeviceGetCount")) {
+      return;
+    }
+
     if (!resolve(fn_device_get_handle_by_index_, "nvmlDeviceGetHandleByIndex_v2") &&
         !resolve(fn_device_get_handle_by_index_, "nvmlDeviceGetHandleByIndex")) {
       return;
@@ -138,18 +308,199 @@ class NvmlGpuSensor final : public GpuSensor {
       return;
     }
 
+    // Optional: pre-Volta drivers lack it and fall back to nvmlDeviceGetPowerUsage.
+    (void)resolve(fn_device_get_field_values_, "nvmlDeviceGetFieldValues");
+    // Optional: per-process attribution needs the v2+ process info layout.
+    (void)resolve(fn_device_get_process_utilization_, "nvmlDeviceGetProcessUtilization");
+    if (!resolve(fn_device_get_compute_processes_, "nvmlDeviceGetComputeRunningProcesses_v3")) {
+      (void)resolve(fn_device_get_compute_processes_, "nvmlDeviceGetComputeRunningProcesses_v2");
+    }
+
     if (fn_init_() != NVML_SUCCESS) {
       return;
     }
     initialized_ = true;
 
-    if (fn_device_get_handle_by_index_(device_index_, &device_) != NVML_SUCCESS) {
-      return;
+    std::vector<unsigned int> indices = options_.devices;
+    if (indices.empty()) {
+      unsigned int count = 0;
+      if (fn_device_get_count_(&count) != NVML_SUCCESS) {
+        return;
+      }
+      for (unsigned int index = 0; index < count; ++index) {
+        indices.push_back(index);
+      }
+    }
+
+    for (const unsigned int index : indices) {
+      Device device{};
+      device.index = index;
+      if (fn_device_get_handle_by_index_(index, &device.handle) != NVML_SUCCESS) {
+        continue;
+      }
+      (void)fn_device_get_max_clock_info_(device.handle, NVML_CLOCK_GRAPHICS, &device.max_graphics_clock_mhz);
+      (void)fn_device_get_enforced_power_limit_(device.handle, &device.power_limit_mw);
+      device.fields[0].fieldId = kFieldTotalEnergyMj;
+      device.fields[1].fieldId = kFieldPowerInstantMw;
+      device.fields[2].fieldId = kFieldPowerLimitMw;
+      devices_.push_back(device);
+    }
+    std::sort(devices_.begin(), devices_.end(),
+              [](const Device& lhs, const Device& rhs) { return lhs.index < rhs.index; });
+    samples_.reserve(devices_.size());
+    available_ = !devices_.empty();
+  }
+
+  bool read_device(Device& device, GpuDeviceSample& sample) noexcept {
+    nvmlUtilization_t util{};
+    nvmlMemory_t memory{};
+    unsigned int temp_c = 0;
+    unsigned int graphics_clock_mhz = 0;
+    unsigned long long throttle_reasons = 0;
+
+    if (fn_device_get_utilization_rates_(device.handle, &util) != NVML_SUCCESS ||
+        fn_device_get_memory_info_(device.handle, &memory) != NVML_SUCCESS ||
+        fn_device_get_temperature_(device.handle, NVML_TEMPERATURE_GPU, &temp_c) != NVML_SUCCESS ||
+        fn_device_get_clock_info_(device.handle, NVML_CLOCK_GRAPHICS, &graphics_clock_mhz) != NVML_SUCCESS ||
+        fn_device_get_current_clocks_throttle_reasons_(device.handle, &throttle_reasons) != NVML_SUCCESS) {
+      return false;
+    }
+
+    double power_mw = -1.0;
+    if (fn_device_get_field_values_ != nullptr &&
+        fn_device_get_field_values_(device.handle, static_cast<int>(device.fields.size()), device.fields.data()) ==
+            NVML_SUCCESS) {
+      const nvmlFieldValue_t& energy = device.fields[0];
+      const nvmlFieldValue_t& instant = device.fields[1];
+      const nvmlFieldValue_t& limit = device.fields[2];
+      if (energy.nvmlReturn == NVML_SUCCESS) {
+        const double energy_mj = field_as_double(energy);
+        if (device.energy_timestamp_us != 0 && energy.timestamp > device.energy_timestamp_us &&
+            energy_mj >= device.energy_mj) {
+          // mJ per microsecond scaled to mW.
+          power_mw = (energy_mj - device.energy_mj) * 1'000'000.0 /
+                     static_cast<double>(energy.timestamp - device.energy_timestamp_us);
+        }
+        device.energy_mj = energy_mj;
+        device.energy_timestamp_us = energy.timestamp;
+      }
+      if (power_mw < 0.0 && instant.nvmlReturn == NVML_SUCCESS) {
+        power_mw = field_as_double(instant);
+      }
+      // Tracks power-cap changes made after startup.
+      if (limit.nvmlReturn == NVML_SUCCESS && field_as_double(limit) > 0.0) {
+        device.power_limit_mw = static_cast<unsigned int>(field_as_double(limit));
+      }
+    }
+    if (power_mw < 0.0) {
+      unsigned int usage_mw = 0;
+      if (fn_device_get_power_usage_(device.handle, &usage_mw) != NVML_SUCCESS) {
+        return false;
+      }
+      power_mw = static_cast<double>(usage_mw);
+    }
+
+    sample.index = device.index;
+    sample.util = static_cast<float>(util.gpu);
+    sample.mem_util = static_cast<float>(util.memory);
+    sample.mem_free_mb = static_cast<float>(memory.free / (1024ULL * 1024ULL));
+    sample.temp_c = static_cast<float>(temp_c);
+    sample.clock_ratio = device.max_graphics_clock_mhz > 0U
+                             ? static_cast<float>(graphics_clock_mhz) / static_cast<float>(device.max_graphics_clock_mhz)
+                             : 0.0F;
+    sample.power_mw = static_cast<float>(power_mw);
+    sample.power_ratio =
+        device.power_limit_mw > 0U ? static_cast<float>(power_mw / static_cast<double>(device.power_limit_mw)) : 0.0F;
+    sample.throttled = throttle_reasons != nvmlClocksThrottleReasonNone;
+    return true;
+  }
+
+  // Averages each PID's samples since the previous window and adds them to pid_usage_.
+  bool read_process_utilization(Device& device) {
+    unsigned int count = static_cast<unsigned int>(utilization_buffer_.size());
+    nvmlReturn_t rc = fn_device_get_process_utilization_(device.handle, utilization_buffer_.data(), &count,
+                                                         device.last_process_timestamp);
+    if (rc == kErrorInsufficientSize) {
+      utilization_buffer_.resize(count + 8U);
+      count = static_cast<unsigned int>(utilization_buffer_.size());
+      rc = fn_device_get_process_utilization_(device.handle, utilization_buffer_.data(), &count,
+                                              device.last_process_timestamp);
+    }
+    if (rc == kErrorNotFound) {
+      // No process ran on the device since the last window.
+      return true;
+    }
+    if (rc != NVML_SUCCESS) {
+      return false;
+    }
+
+    pid_samples_.clear();
+    for (unsigned int i = 0; i < count && i < utilization_buffer_.size(); ++i) {
+      const ProcessUtilizationSample& sample = utilization_buffer_[i];
+      PidSamples& samples = pid_samples_[sample.pid];
+      samples.sm_sum += sample.smUtil;
+      samples.mem_sum += sample.memUtil;
+      ++samples.count;
+      device.last_process_timestamp = std::max(device.last_process_timestamp, sample.timeStamp);
+    }
+    for (const auto& [pid, samples] : pid_samples_) {
+      PidUsage& usage = pid_usage_[pid];
+      usage.sm_util += static_cast<float>(samples.sm_sum) / static_cast<float>(samples.count);
+      usage.mem_util += static_cast<float>(samples.mem_sum) / static_cast<float>(samples.count);
+    }
+    return true;
+  }
+
+  bool read_compute_processes(const Device& device) {
+    unsigned int count = static_cast<unsigned int>(process_buffer_.size());
+    nvmlReturn_t rc = fn_device_get_compute_processes_(device.handle, &count, process_buffer_.data());
+    if (rc == kErrorInsufficientSize) {
+      // Processes can start between the two calls; leave headroom instead of looping.
+      process_buffer_.resize(count + 8U);
+      count = static_cast<unsigned int>(process_buffer_.size());
+      rc = fn_device_get_compute_processes_(device.handle, &count, process_buffer_.data());
+    }
+    if (rc != NVML_SUCCESS) {
+      return false;
     }
 
-    (void)fn_device_get_max_clock_info_(device_, NVML_CLOCK_GRAPHICS, &max_graphics_clock_mhz_);
-    (void)fn_device_get_enforced_power_limit_(device_, &power_limit_mw_);
-    available_ = true;
+    for (unsigned int i = 0; i < count && i < process_buffer_.size(); ++i) {
+      const ProcessInfo& info = process_buffer_[i];
+      PidUsage& usage = pid_usage_[info.pid];
+      // Unavailable under some virtualization modes and on Windows WDDM.
+      if (info.usedGpuMemory != kValueNotAvailable) {
+        usage.fb_used_bytes += info.usedGpuMemory;
+      }
+    }
+    return true;
+  }
+
+  const std::string& cgroup_of(const unsigned int pid) {
+    if (const auto it = cgroup_cache_.find(pid); it != cgroup_cache_.end()) {
+      return it->second;
+    }
+
+    // cgroup v2 has the single "0::<path>" line; on v1 fall back to the first hierarchy listed.
+    std::string cgroup;
+    std::ifstream input(options_.proc_root + "/" + std::to_string(pid) + "/cgroup");
+    std::string line;
+    while (std::getline(input, line)) {
+      const auto second_colon = line.find(':', line.find(':') + 1);
+      if (second_colon == std::string::npos) {
+        continue;
+      }
+      if (line.rfind("0::", 0) == 0 || cgroup.empty()) {
+        cgroup = line.substr(second_colon + 1);
+      }
+      if (line.rfind("0::", 0) == 0) {
+        break;
+      }
+    }
+    if (cgroup.empty()) {
+      // Exited, or not visible from the agent's PID namespace.
+      cgroup = "<unknown>";
+    }
+    return cgroup_cache_.emplace(pid, std::move(cgroup)).first->second;
   }
 
   static void set_defaults(SignalFrame& frame) noexcept {
@@ -164,18 +515,26 @@ class NvmlGpuSensor final : public GpuSensor {
     frame.nvml_gpu_util = 0.0F;
     frame.nvml_gpu_temp = 0.0F;
     frame.nvml_gpu_power_ratio = 0.0F;
+    frame.nvml_gpu_devices = 0.0F;
+    frame.nvml_gpu_throttled = 0.0F;
+    frame.nvml_gpu_worst_device = 0.0F;
   }
 
+  NvmlOptions options_;
   void* library_{nullptr};
   bool available_{false};
   bool initialized_{false};
-  unsigned int device_index_{0};
-  nvmlDevice_t device_{nullptr};
-  unsigned int max_graphics_clock_mhz_{0};
-  unsigned int power_limit_mw_{0};
+  std::vector<Device> devices_{};
+  std::vector<GpuDeviceSample> samples_{};
+  std::vector<ProcessUtilizationSample> utilization_buffer_{};
+  std::vector<ProcessInfo> process_buffer_{};
+  std::unordered_map<unsigned int, PidSamples> pid_samples_{};
+  std::unordered_map<unsigned int, PidUsage> pid_usage_{};
+  std::unordered_map<unsigned int, std::string> cgroup_cache_{};
 
   FnNvmlInit fn_init_{nullptr};
   FnNvmlShutdown fn_shutdown_{nullptr};
+  FnNvmlDeviceGetCount fn_device_get_count_{nullptr};
   FnNvmlDeviceGetHandleByIndex fn_device_get_handle_by_index_{nullptr};
   FnNvmlDeviceGetUtilizationRates fn_device_get_utilization_rates_{nullptr};
   FnNvmlDeviceGetMemoryInfo fn_device_get_memory_info_{nullptr};
@@ -185,12 +544,15 @@ class NvmlGpuSensor final : public GpuSensor {
   FnNvmlDeviceGetPowerUsage fn_device_get_power_usage_{nullptr};
   FnNvmlDeviceGetEnforcedPowerLimit fn_device_get_enforced_power_limit_{nullptr};
   FnNvmlDeviceGetCurrentClocksThrottleReasons fn_device_get_current_clocks_throttle_reasons_{nullptr};
+  FnNvmlDeviceGetFieldValues fn_device_get_field_values_{nullptr};
+  FnNvmlDeviceGetProcessUtilization fn_device_get_process_utilization_{nullptr};
+  FnNvmlDeviceGetComputeRunningProcesses fn_device_get_compute_processes_{nullptr};
 };
 
 }  // namespace
 
-std::unique_ptr<GpuSensor> make_nvml_sensor(unsigned int device_index) {
-  return std::make_unique<NvmlGpuSensor>(device_index);
+std::unique_ptr<GpuSensor> make_nvml_sensor(const NvmlOptions& options) {
+  return std::make_unique<NvmlGpuSensor>(options);
 }
 
 }  // namespace hw_agent::sensors::gpu
@@ -0,0 +1,269 @@
+#include "sensors/jetson_sysfs.hpp"
+
+#include "core/file_io.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <utility>
+
+namespace hw_agent::sensors {
+
+namespace {
+constexpr const char* kSysRoot = "/sys";
+constexpr int kIna3221Channels = 3;
+// Disabled Orin zones (CV*, GPU when power-gated) report -256 C.
+constexpr float kMinValidTempC = -200.0F;
+
+std::string read_first_line(const std::filesystem::path& path) {
+  std::ifstream input(path);
+  std::string line;
+  if (!input.is_open() || !std::getline(input, line)) {
+    return {};
+  }
+  return line;
+}
+
+std::string lowercase(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(),
+                 [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return value;
+}
+
+std::FILE* open_first(const std::filesystem::path& root, std::initializer_list<const char*> candidates) {
+  for (const char* candidate : candidates) {
+    if (std::FILE* file = std::fopen((root / candidate).c_str(), "r"); file != nullptr) {
+      return file;
+    }
+  }
+  return nullptr;
+}
+
+// devfreq names are "<unit-address>.<node>", e.g. 57000000.gpu (Nano), 17000000.gv11b (Xavier)
+// or 17000000.ga10b (Orin).
+bool is_gpu_devfreq(const std::string& name) {
+  const std::string lower = lowercase(name);
+  for (const char* marker : {"gpu", "gv11b", "ga10b", "gp10b", "gm20b"}) {
+    if (lower.find(marker) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void close_file(std::FILE*& file) noexcept {
+  if (file != nullptr) {
+    std::fclose(file);
+    file = nullptr;
+  }
+}
+
+}  // namespace
+
+JetsonSysfsSensor::JetsonSysfsSensor() { discover(kSysRoot); }
+
+JetsonSysfsSensor::JetsonSysfsSensor(std::string sysfs_root) { discover(sysfs_root); }
+
+JetsonSysfsSensor::~JetsonSysfsSensor() {
+  close_file(gpu_load_file_);
+  close_file(emc_activity_file_);
+  close_file(emc_rate_file_);
+  for (Rail& rail : rails_) {
+    close_file(rail.voltage_file);
+    close_file(rail.current_file);
+  }
+  for (Zone& zone : zones_) {
+    close_file(zone.temp_file);
+  }
+}
+
+void JetsonSysfsSensor::discover(const std::string& sysfs_root) {
+  namespace fs = std::filesystem;
+  const fs::path root(sysfs_root);
+
+  try {
+    const fs::path devfreq = root / "class" / "devfreq";
+    if (fs::exists(devfreq)) {
+      for (const auto& entry : fs::directory_iterator(devfreq)) {
+        const std::string name = entry.path().filename().string();
+        if (gpu_load_file_ == nullptr && is_gpu_devfreq(name)) {
+          gpu_load_file_ = open_first(entry.path(), {"device/load", "load"});
+        }
+        if (emc_rate_file_ == nullptr && lowercase(name).find("emc") != std::string::npos) {
+          emc_rate_file_ = open_first(entry.path(), {"cur_freq"});
+        }
+      }
+    }
+    if (gpu_load_file_ == nullptr) {
+      gpu_load_file_ = open_first(root, {"devices/gpu.0/load", "devices/platform/gpu.0/load"});
+    }
+
+    // actmon reports average memory-controller activity in kHz; the EMC clock gives the ceiling.
+    emc_activity_file_ = open_first(root, {"kernel/actmon_avg_activity/mc_all", "kernel/debug/cactmon/mc_all"});
+    if (std::FILE* debug_rate = open_first(root, {"kernel/debug/clk/emc/clk_rate", "kernel/debug/bpmp/debug/clk/emc/rate"});
+        debug_rate != nullptr) {
+      close_file(emc_rate_file_);
+      emc_rate_file_ = debug_rate;
+    }
+
+    const fs::path hwmon = root / "class" / "hwmon";
+    if (fs::exists(hwmon)) {
+      for (const auto& entry : fs::directory_iterator(hwmon)) {
+        // Older kernels keep the attributes on the parent device rather than the hwmon node.
+        for (const fs::path& dir : {entry.path(), entry.path() / "device"}) {
+          if (read_first_line(dir / "name") != "ina3221") {
+            continue;
+          }
+          for (int channel = 1; channel <= kIna3221Channels; ++channel) {
+            const std::string index = std::to_string(channel);
+            Rail rail{};
+            rail.voltage_file = std::fopen((dir / ("in" + index + "_input")).c_str(), "r");
+            rail.current_file = std::fopen((dir / ("curr" + index + "_input")).c_str(), "r");
+            if (rail.voltage_file == nullptr || rail.current_file == nullptr) {
+              close_file(rail.voltage_file);
+              close_file(rail.current_file);
+              continue;
+            }
+            rail.label = read_first_line(dir / ("in" + index + "_label"));
+            if (rail.label.empty()) {
+              rail.label = entry.path().filename().string() + ":in" + index;
+            }
+            rails_.push_back(std::move(rail));
+          }
+          break;
+        }
+      }
+    }
+
+    const fs::path thermal = root / "class" / "thermal";
+    if (fs::exists(thermal)) {
+      for (const auto& entry : fs::directory_iterator(thermal)) {
+        if (entry.path().filename().string().rfind("thermal_zone", 0) != 0) {
+          continue;
+        }
+        Zone zone{};
+        zone.type = read_first_line(entry.path() / "type");
+        zone.gpu = lowercase(zone.type).rfind("gpu", 0) == 0;
+        zone.temp_file = std::fopen((entry.path() / "temp").c_str(), "r");
+        if (zone.temp_file != nullptr) {
+          zones_.push_back(std::move(zone));
+        }
+      }
+    }
+  } catch (const fs::filesystem_error&) {
+    // Keep whatever was discovered before the error.
+  }
+
+  // Stable order for raw() consumers and tests; directory_iterator order is unspecified.
+  std::sort(rails_.begin(), rails_.end(), [](const Rail& lhs, const Rail& rhs) { return lhs.label < rhs.label; });
+  std::sort(zones_.begin(), zones_.end(), [](const Zone& lhs, const Zone& rhs) { return lhs.type < rhs.type; });
+}
+
+bool JetsonSysfsSensor::sample(model::signal_frame& frame) noexcept {
+  bool any_read = false;
+
+  std::uint64_t load_permille = 0;
+  if (read_u64_file(gpu_load_file_, load_permille)) {
+    raw_.gpu_util_pct = std::min(100.0F, static_cast<float>(load_permille) / 10.0F);
+    any_read = true;
+  }
+
+  std::uint64_t activity_khz = 0;
+  std::uint64_t emc_rate = 0;
+  if (read_u64_file(emc_activity_file_, activity_khz) && read_u64_file(emc_rate_file_, emc_rate) && emc_rate != 0) {
+    // Every EMC rate source reports Hz.
+    const double rate_khz = static_cast<double>(emc_rate) / 1000.0;
+    raw_.emc_util_pct = static_cast<float>(std::min(100.0, (static_cast<double>(activity_khz) / rate_khz) * 100.0));
+    any_read = true;
+  }
+
+  double total_mw = 0.0;
+  bool any_rail = false;
+  for (Rail& rail : rails_) {
+    std::uint64_t millivolts = 0;
+    std::uint64_t milliamps = 0;
+    if (!read_u64_file(rail.voltage_file, millivolts) || !read_u64_file(rail.current_file, milliamps)) {
+      continue;
+    }
+    rail.power_mw = static_cast<float>(static_cast<double>(millivolts) * static_cast<double>(milliamps) / 1000.0);
+    total_mw += rail.power_mw;
+    any_rail = true;
+  }
+  if (any_rail) {
+    raw_.total_rail_power_mw = static_cast<float>(total_mw);
+    any_read = true;
+  }
+
+  raw_.has_gpu_temp = false;
+  for (Zone& zone : zones_) {
+    std::int64_t millidegrees = 0;
+    if (!read_i64_file(zone.temp_file, millidegrees)) {
+      continue;
+    }
+    zone.temp_c = static_cast<float>(millidegrees) / 1000.0F;
+    any_read = true;
+    if (zone.temp_c > kMinValidTempC && zone.gpu &&
+        (!raw_.has_gpu_temp || zone.temp_c > raw_.gpu_temp_c)) {
+      raw_.gpu_temp_c = zone.temp_c;
+      raw_.has_gpu_temp = true;
+    }
+  }
+
+  frame.gpu_util = raw_.gpu_util_pct;
+  frame.emc_util = raw_.emc_util_pct;
+  frame.tegra_gpu_util = raw_.gpu_util_pct;
+  frame.tegra_emc_util = raw_.emc_util_pct;
+  if (raw_.has_gpu_temp) {
+    frame.gpu_temp = raw_.gpu_temp_c;
+    frame.tegra_gpu_temp = raw_.gpu_temp_c;
+  }
+  if (raw_.total_rail_power_mw > 0.0F) {
+    frame.gpu_power_ratio = raw_.total_rail_power_mw;
+    frame.tegra_gpu_power_mw = raw_.total_rail_power_mw;
+  }
+  return any_read;
+}
+
+bool JetsonSysfsSensor::available() const noexcept { return gpu_load_file_ != nullptr || !rails_.empty(); }
+
+const JetsonSysfsSensor::RawFields& JetsonSysfsSensor::raw() const noexcept { return raw_; }
+
+const std::vector<JetsonSysfsSensor::Rail>& JetsonSysfsSensor::rails() const noexcept { return rails_; }
+
+const std::vector<JetsonSysfsSensor::Zone>& JetsonSysfsSensor::zones() const noexcept { return zones_; }
+
+bool JetsonSysfsSensor::read_u64_file(std::FILE* file, std::uint64_t& value) noexcept {
+  std::int64_t signed_value = 0;
+  if (!read_i64_file(file, signed_value) || signed_value < 0) {
+    return false;
+  }
+  value = static_cast<std::uint64_t>(signed_value);
+  return true;
+}
+
+bool JetsonSysfsSensor::read_i64_file(std::FILE* file, std::int64_t& value) noexcept {
+  if (file == nullptr || !core::rewind_file(file)) {
+    return false;
+  }
+
+  char buffer[32]{};
+  if (std::fgets(buffer, static_cast<int>(sizeof(buffer)), file) == nullptr) {
+    std::clearerr(file);
+    return false;
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  const long long parsed = std::strtoll(buffer, &end, 10);
+  if (errno != 0 || end == buffer) {
+    return false;
+  }
+  value = static_cast<std::int64_t>(parsed);
+  return true;
+}
+
+}  // namespace hw_agent::sensors
@@ -1,5 +1,7 @@
 #include "sensors/memory.hpp"
 
+#include "core/file_io.hpp"
+
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
@@ -58,7 +60,7 @@ bool MemorySensor::parse_meminfo() noexcept {
     return false;
   }
 
-  if (std::fseek(meminfo_, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(meminfo_)) {
     return false;
   }
 
@@ -99,7 +101,7 @@ bool MemorySensor::parse_vmstat() noexcept {
     return false;
   }
 
-  if (std::fseek(vmstat_, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(vmstat_)) {
     return false;
   }
 
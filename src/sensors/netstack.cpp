@@ -0,0 +1,278 @@
+#include "sensors/netstack.hpp"
+
+#include "core/file_io.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+namespace hw_agent::sensors {
+
+namespace {
+
+struct KeyedField {
+  const char* name;
+  std::uint64_t* value;
+  bool found;
+};
+
+const char* next_token(const char* cursor, std::size_t& length) noexcept {
+  while (*cursor == ' ' || *cursor == '\t') {
+    ++cursor;
+  }
+  length = 0;
+  while (cursor[length] != '\0' && cursor[length] != ' ' && cursor[length] != '\t' && cursor[length] != '\n') {
+    ++length;
+  }
+  return cursor;
+}
+
+// /proc/net/snmp and /proc/net/netstat print each protocol as a pair of lines:
+// "<Prefix>: Name1 Name2 ..." followed by "<Prefix>: value1 value2 ...".
+bool read_keyed_table(std::FILE* file, const char* prefix, KeyedField* fields, const std::size_t field_count,
+                      char* header, char* values, const std::size_t buffer_size) noexcept {
+  if (file == nullptr) {
+    return false;
+  }
+
+  if (!core::rewind_file(file)) {
+    return false;
+  }
+
+  const std::size_t prefix_size = std::strlen(prefix);
+  bool have_header = false;
+  bool parsed = false;
+
+  while (std::fgets(values, static_cast<int>(buffer_size), file) != nullptr) {
+    if (std::strncmp(values, prefix, prefix_size) != 0 || values[prefix_size] != ':') {
+      continue;
+    }
+
+    if (!have_header) {
+      std::memcpy(header, values, std::strlen(values) + 1);
+      have_header = true;
+      continue;
+    }
+
+    const char* name_cursor = header + prefix_size + 1;
+    const char* value_cursor = values + prefix_size + 1;
+    while (true) {
+      std::size_t name_size = 0;
+      std::size_t value_size = 0;
+      name_cursor = next_token(name_cursor, name_size);
+      value_cursor = next_token(value_cursor, value_size);
+      if (name_size == 0 || value_size == 0) {
+        break;
+      }
+
+      for (std::size_t i = 0; i < field_count; ++i) {
+        if (std::strlen(fields[i].name) != name_size || std::strncmp(fields[i].name, name_cursor, name_size) != 0) {
+          continue;
+        }
+
+        char* end = nullptr;
+        errno = 0;
+        const unsigned long long parsed_value = std::strtoull(value_cursor, &end, 10);
+        if (errno == 0 && end != value_cursor) {
+          *fields[i].value = parsed_value;
+          fields[i].found = true;
+        }
+        break;
+      }
+
+      name_cursor += name_size;
+      value_cursor += value_size;
+    }
+
+    parsed = true;
+    break;
+  }
+
+  if (std::ferror(file) != 0) {
+    std::clearerr(file);
+    return false;
+  }
+
+  if (!parsed) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < field_count; ++i) {
+    if (!fields[i].found) {
+      return false;
+    }
+  }
+  return true;
+}
+
+float per_second(const std::uint64_t current, const std::uint64_t previous, const double seconds) noexcept {
+  const std::uint64_t delta = current >= previous ? (current - previous) : 0;
+  return static_cast<float>(static_cast<double>(delta) / seconds);
+}
+
+}  // namespace
+
+NetStackSensor::NetStackSensor()
+    : snmp_(std::fopen("/proc/net/snmp", "r")),
+      netstat_(std::fopen("/proc/net/netstat", "r")),
+      sockstat_(std::fopen("/proc/net/sockstat", "r")),
+      tcp_mem_(std::fopen("/proc/sys/net/ipv4/tcp_mem", "r")),
+      owns_files_(true) {}
+
+NetStackSensor::NetStackSensor(std::FILE* snmp, std::FILE* netstat, std::FILE* sockstat, std::FILE* tcp_mem,
+                               const bool owns_files)
+    : snmp_(snmp), netstat_(netstat), sockstat_(sockstat), tcp_mem_(tcp_mem), owns_files_(owns_files) {}
+
+NetStackSensor::~NetStackSensor() {
+  if (!owns_files_) {
+    return;
+  }
+
+  for (std::FILE** file : {&snmp_, &netstat_, &sockstat_, &tcp_mem_}) {
+    if (*file != nullptr) {
+      std::fclose(*file);
+      *file = nullptr;
+    }
+  }
+}
+
+bool NetStackSensor::sample(model::signal_frame& frame) noexcept {
+  const bool snmp_ok = parse_snmp();
+  const bool netstat_ok = parse_netstat();
+  const bool sockstat_ok = parse_sockstat();
+  const bool tcp_mem_ok = parse_tcp_mem();
+
+  raw_.tcp_mem_ratio = raw_.tcp_mem_max_pages != 0
+                           ? static_cast<float>(raw_.tcp_mem_pages) / static_cast<float>(raw_.tcp_mem_max_pages)
+                           : 0.0F;
+
+  // ListenDrops is a superset of ListenOverflows (the kernel bumps both on accept-queue overflow).
+  const std::uint64_t listen_drops = raw_.listen_drops > raw_.listen_overflows ? raw_.listen_drops : raw_.listen_overflows;
+  const std::uint64_t udp_buf_errors = raw_.udp_rcvbuf_errors + raw_.udp_sndbuf_errors;
+
+  if (!has_prev_) {
+    has_prev_ = true;
+    raw_.tcp_retrans_per_sec = 0.0F;
+    raw_.listen_drops_per_sec = 0.0F;
+    raw_.udp_buf_errors_per_sec = 0.0F;
+  } else {
+    const std::uint64_t time_delta_ns = frame.monotonic_ns - prev_timestamp_ns_;
+    if (time_delta_ns == 0) {
+      raw_.tcp_retrans_per_sec = 0.0F;
+      raw_.listen_drops_per_sec = 0.0F;
+      raw_.udp_buf_errors_per_sec = 0.0F;
+    } else {
+      const double seconds = static_cast<double>(time_delta_ns) / 1'000'000'000.0;
+      raw_.tcp_retrans_per_sec = per_second(raw_.tcp_retrans_segs, prev_retrans_, seconds);
+      raw_.listen_drops_per_sec = per_second(listen_drops, prev_listen_drops_, seconds);
+      raw_.udp_buf_errors_per_sec = per_second(udp_buf_errors, prev_udp_buf_errors_, seconds);
+    }
+  }
+
+  prev_retrans_ = raw_.tcp_retrans_segs;
+  prev_listen_drops_ = listen_drops;
+  prev_udp_buf_errors_ = udp_buf_errors;
+  prev_timestamp_ns_ = frame.monotonic_ns;
+
+  frame.tcp_retrans = raw_.tcp_retrans_per_sec;
+  frame.listen_drops = raw_.listen_drops_per_sec;
+  frame.udp_buf_errors = raw_.udp_buf_errors_per_sec;
+  frame.tcp_mem_ratio = raw_.tcp_mem_ratio;
+  return snmp_ok && netstat_ok && sockstat_ok && tcp_mem_ok;
+}
+
+const NetStackSensor::RawFields& NetStackSensor::raw() const noexcept { return raw_; }
+
+bool NetStackSensor::parse_snmp() noexcept {
+  char header[kReadBufferSize];
+  char values[kReadBufferSize];
+
+  KeyedField tcp_fields[] = {
+      {"RetransSegs", &raw_.tcp_retrans_segs, false},
+      {"OutSegs", &raw_.tcp_out_segs, false},
+  };
+  const bool tcp_ok = read_keyed_table(snmp_, "Tcp", tcp_fields, 2, header, values, kReadBufferSize);
+
+  KeyedField udp_fields[] = {
+      {"RcvbufErrors", &raw_.udp_rcvbuf_errors, false},
+      {"SndbufErrors", &raw_.udp_sndbuf_errors, false},
+  };
+  const bool udp_ok = read_keyed_table(snmp_, "Udp", udp_fields, 2, header, values, kReadBufferSize);
+
+  return tcp_ok && udp_ok;
+}
+
+bool NetStackSensor::parse_netstat() noexcept {
+  char header[kReadBufferSize];
+  char values[kReadBufferSize];
+
+  KeyedField fields[] = {
+      {"ListenOverflows", &raw_.listen_overflows, false},
+      {"ListenDrops", &raw_.listen_drops, false},
+  };
+  return read_keyed_table(netstat_, "TcpExt", fields, 2, header, values, kReadBufferSize);
+}
+
+bool NetStackSensor::parse_sockstat() noexcept {
+  if (sockstat_ == nullptr) {
+    return false;
+  }
+
+  if (!core::rewind_file(sockstat_)) {
+    return false;
+  }
+
+  char buffer[512]{};
+  bool found = false;
+  while (std::fgets(buffer, static_cast<int>(sizeof(buffer)), sockstat_) != nullptr) {
+    if (std::strncmp(buffer, "TCP:", 4) != 0) {
+      continue;
+    }
+
+    const char* mem = std::strstr(buffer, " mem ");
+    if (mem == nullptr) {
+      break;
+    }
+
+    const char* value_begin = mem + 5;
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long pages = std::strtoull(value_begin, &end, 10);
+    if (errno == 0 && end != value_begin) {
+      raw_.tcp_mem_pages = pages;
+      found = true;
+    }
+    break;
+  }
+
+  if (std::ferror(sockstat_) != 0) {
+    std::clearerr(sockstat_);
+    return false;
+  }
+  return found;
+}
+
+bool NetStackSensor::parse_tcp_mem() noexcept {
+  if (tcp_mem_ == nullptr) {
+    return false;
+  }
+
+  if (!core::rewind_file(tcp_mem_)) {
+    return false;
+  }
+
+  unsigned long long min_pages = 0;
+  unsigned long long pressure_pages = 0;
+  unsigned long long max_pages = 0;
+  if (std::fscanf(tcp_mem_, "%llu %llu %llu", &min_pages, &pressure_pages, &max_pages) != 3) {
+    std::clearerr(tcp_mem_);
+    return false;
+  }
+
+  raw_.tcp_mem_pressure_pages = pressure_pages;
+  raw_.tcp_mem_max_pages = max_pages;
+  return true;
+}
+
+}  // namespace hw_agent::sensors
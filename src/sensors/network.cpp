@@ -1,5 +1,7 @@
 #include "sensors/network.hpp"
 
+#include "core/file_io.hpp"
+
 #include <filesystem>
 #include <memory>
 
@@ -128,7 +130,7 @@ bool NetworkSensor::read_u64_file(std::FILE* file, std::uint64_t& value) noexcep
     return false;
   }
 
-  if (std::fseek(file, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(file)) {
     value = 0;
     return false;
   }
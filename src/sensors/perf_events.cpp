@@ -0,0 +1,272 @@
+#include "sensors/perf_events.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace hw_agent::sensors {
+
+namespace {
+
+int perf_event_open(perf_event_attr& attr, const int cpu, const int group_fd) noexcept {
+  // pid = -1 with a concrete cpu counts every task on that CPU.
+  return static_cast<int>(::syscall(SYS_perf_event_open, &attr, -1, cpu, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+perf_event_attr make_attr(const std::uint32_t type, const std::uint64_t config, const std::uint64_t read_format) noexcept {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.read_format = read_format;
+  return attr;
+}
+
+std::uint64_t delta(const std::uint64_t current, const std::uint64_t previous) noexcept {
+  return current >= previous ? current - previous : 0;
+}
+
+void close_fd(int& fd) noexcept {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+// Opens leader + members as one group on cpu; on any failure closes what was opened and returns -1.
+int open_group(const int cpu, const std::uint32_t type, const std::uint64_t* configs, const std::size_t count,
+               const std::uint64_t read_format, std::vector<int>& members, int& open_errno) noexcept {
+  perf_event_attr leader_attr = make_attr(type, configs[0], read_format);
+  int leader = perf_event_open(leader_attr, cpu, -1);
+  if (leader < 0) {
+    open_errno = errno;
+    return -1;
+  }
+
+  const std::size_t first_member = members.size();
+  for (std::size_t i = 1; i < count; ++i) {
+    perf_event_attr member_attr = make_attr(type, configs[i], read_format);
+    const int fd = perf_event_open(member_attr, cpu, leader);
+    if (fd < 0) {
+      open_errno = errno;
+      for (std::size_t m = first_member; m < members.size(); ++m) {
+        close_fd(members[m]);
+      }
+      members.resize(first_member);
+      close_fd(leader);
+      return -1;
+    }
+    members.push_back(fd);
+  }
+  return leader;
+}
+
+}  // namespace
+
+PerfEventSensor::PerfEventSensor() : owns_fds_(true) {
+  open_all_cpus();
+  history_.resize(cpus_.size());
+}
+
+PerfEventSensor::PerfEventSensor(std::vector<CpuGroup> cpus, const bool owns_fds)
+    : cpus_(std::move(cpus)), owns_fds_(owns_fds) {
+  history_.resize(cpus_.size());
+  for (const CpuGroup& group : cpus_) {
+    raw_.software_cpus += group.software_fd >= 0 ? 1 : 0;
+    raw_.hardware_cpus += group.hardware_fd >= 0 ? 1 : 0;
+  }
+}
+
+void PerfEventSensor::open_all_cpus() {
+  const long configured = ::sysconf(_SC_NPROCESSORS_CONF);
+  if (configured <= 0) {
+    return;
+  }
+
+  constexpr std::uint64_t kSoftwareConfigs[kSoftwareEvents] = {
+      PERF_COUNT_SW_CPU_CLOCK,
+      PERF_COUNT_SW_CONTEXT_SWITCHES,
+      PERF_COUNT_SW_CPU_MIGRATIONS,
+      PERF_COUNT_SW_PAGE_FAULTS_MAJ,
+  };
+  constexpr std::uint64_t kHardwareConfigs[kHardwareEvents] = {
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_CACHE_MISSES,
+  };
+
+  for (int cpu = 0; cpu < static_cast<int>(configured); ++cpu) {
+    CpuGroup group{};
+    group.cpu = cpu;
+
+    // Offline CPUs fail with ENODEV; they are skipped rather than counted as an open failure.
+    int software_errno = 0;
+    group.software_fd = open_group(cpu, PERF_TYPE_SOFTWARE, kSoftwareConfigs, kSoftwareEvents, PERF_FORMAT_GROUP,
+                                   group.member_fds, software_errno);
+    if (group.software_fd < 0) {
+      if (software_errno != ENODEV && raw_.software_open_errno == 0) {
+        raw_.software_open_errno = software_errno;
+      }
+      continue;
+    }
+    ++raw_.software_cpus;
+
+    // Stop probing the PMU after the first refusal (no PMU, VM without vPMU, EACCES, EMFILE).
+    if (raw_.hardware_open_errno == 0) {
+      int hardware_errno = 0;
+      group.hardware_fd = open_group(cpu, PERF_TYPE_HARDWARE, kHardwareConfigs, kHardwareEvents,
+                                     PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING,
+                                     group.member_fds, hardware_errno);
+      if (group.hardware_fd >= 0) {
+        ++raw_.hardware_cpus;
+      } else if (hardware_errno != ENODEV) {
+        raw_.hardware_open_errno = hardware_errno;
+      }
+    }
+
+    cpus_.push_back(std::move(group));
+  }
+}
+
+PerfEventSensor::~PerfEventSensor() {
+  if (!owns_fds_) {
+    return;
+  }
+
+  for (CpuGroup& group : cpus_) {
+    for (int& fd : group.member_fds) {
+      close_fd(fd);
+    }
+    close_fd(group.software_fd);
+    close_fd(group.hardware_fd);
+  }
+}
+
+bool PerfEventSensor::sample(model::signal_frame& frame) noexcept {
+  const bool has_interval = has_prev_timestamp_ && frame.monotonic_ns > prev_timestamp_ns_;
+  const std::uint64_t wall_ns = has_interval ? frame.monotonic_ns - prev_timestamp_ns_ : 0;
+  prev_timestamp_ns_ = frame.monotonic_ns;
+  has_prev_timestamp_ = true;
+
+  raw_.per_cpu.resize(cpus_.size());
+  double context_switches = 0.0;
+  double migrations = 0.0;
+  double major_faults = 0.0;
+  double llc_misses = 0.0;
+  std::uint64_t instructions = 0;
+  std::uint64_t cycles = 0;
+  float hot_events = 0.0F;
+  int hot_cpu = -1;
+  bool any_read = false;
+
+  for (std::size_t i = 0; i < cpus_.size(); ++i) {
+    const CpuGroup& group = cpus_[i];
+    CpuHistory& history = history_[i];
+    CpuRates& rates = raw_.per_cpu[i];
+    rates = CpuRates{};
+    rates.cpu = group.cpu;
+
+    std::uint64_t software[kSoftwareRecordWords]{};
+    if (!read_group(group.software_fd, software, kSoftwareRecordWords) || software[0] != kSoftwareEvents) {
+      history.has_software = false;
+      continue;
+    }
+    any_read = true;
+
+    const std::uint64_t* values = software + 1;
+    if (history.has_software && has_interval) {
+      // cpu-clock is the exact window this group counted; fall back to wall time if it did not advance.
+      const std::uint64_t clock_ns = delta(values[0], history.software[0]);
+      const double seconds = static_cast<double>(clock_ns != 0 ? clock_ns : wall_ns) / 1'000'000'000.0;
+      const auto per_second = [&](const std::size_t event) {
+        return static_cast<float>(static_cast<double>(delta(values[event], history.software[event])) / seconds);
+      };
+      rates.context_switches_per_sec = per_second(1);
+      rates.migrations_per_sec = per_second(2);
+      rates.major_faults_per_sec = per_second(3);
+    }
+    std::memcpy(history.software, values, sizeof(history.software));
+    history.has_software = true;
+
+    std::uint64_t hardware[kHardwareRecordWords]{};
+    if (read_group(group.hardware_fd, hardware, kHardwareRecordWords) && hardware[0] == kHardwareEvents) {
+      const std::uint64_t time_enabled = hardware[1];
+      const std::uint64_t time_running = hardware[2];
+      const std::uint64_t* hw_values = hardware + 3;
+      if (history.has_hardware && has_interval) {
+        const std::uint64_t enabled_delta = delta(time_enabled, history.time_enabled);
+        const std::uint64_t running_delta = delta(time_running, history.time_running);
+        const std::uint64_t instructions_delta = delta(hw_values[0], history.hardware[0]);
+        const std::uint64_t cycles_delta = delta(hw_values[1], history.hardware[1]);
+        // The group is scheduled as a unit, so IPC needs no multiplexing correction but rates do.
+        const double scale =
+            running_delta != 0 ? static_cast<double>(enabled_delta) / static_cast<double>(running_delta) : 0.0;
+        const double seconds = static_cast<double>(enabled_delta != 0 ? enabled_delta : wall_ns) / 1'000'000'000.0;
+        const double misses = static_cast<double>(delta(hw_values[2], history.hardware[2])) * scale;
+        rates.ipc = cycles_delta != 0
+                        ? static_cast<float>(static_cast<double>(instructions_delta) / static_cast<double>(cycles_delta))
+                        : 0.0F;
+        rates.llc_misses_per_sec = static_cast<float>(misses / seconds);
+        instructions += instructions_delta;
+        cycles += cycles_delta;
+      }
+      std::memcpy(history.hardware, hw_values, sizeof(history.hardware));
+      history.time_enabled = time_enabled;
+      history.time_running = time_running;
+      history.has_hardware = true;
+    } else {
+      history.has_hardware = false;
+    }
+
+    context_switches += rates.context_switches_per_sec;
+    migrations += rates.migrations_per_sec;
+    major_faults += rates.major_faults_per_sec;
+    llc_misses += rates.llc_misses_per_sec;
+
+    const float events = rates.context_switches_per_sec + rates.migrations_per_sec;
+    if (events > hot_events) {
+      hot_events = events;
+      hot_cpu = group.cpu;
+    }
+  }
+
+  raw_.context_switches_per_sec = static_cast<float>(context_switches);
+  raw_.migrations_per_sec = static_cast<float>(migrations);
+  raw_.major_faults_per_sec = static_cast<float>(major_faults);
+  raw_.llc_misses_per_sec = static_cast<float>(llc_misses);
+  raw_.ipc = cycles != 0 ? static_cast<float>(static_cast<double>(instructions) / static_cast<double>(cycles)) : 0.0F;
+  raw_.hot_cpu = hot_cpu;
+
+  frame.perf_context_switches = raw_.context_switches_per_sec;
+  frame.perf_migrations = raw_.migrations_per_sec;
+  frame.perf_major_faults = raw_.major_faults_per_sec;
+  frame.perf_ipc = raw_.ipc;
+  frame.perf_llc_misses = raw_.llc_misses_per_sec;
+  frame.perf_hot_cpu = static_cast<float>(raw_.hot_cpu);
+  return any_read;
+}
+
+const PerfEventSensor::RawFields& PerfEventSensor::raw() const noexcept { return raw_; }
+
+bool PerfEventSensor::available() const noexcept { return raw_.software_cpus != 0; }
+
+bool PerfEventSensor::hardware_available() const noexcept { return raw_.hardware_cpus != 0; }
+
+bool PerfEventSensor::read_group(const int fd, std::uint64_t* words, const std::size_t word_count) noexcept {
+  if (fd < 0) {
+    return false;
+  }
+
+  const std::size_t expected = word_count * sizeof(std::uint64_t);
+  ssize_t bytes = 0;
+  do {
+    bytes = ::read(fd, words, expected);
+  } while (bytes < 0 && errno == EINTR);
+  return bytes == static_cast<ssize_t>(expected);
+}
+
+}  // namespace hw_agent::sensors
@@ -1,5 +1,7 @@
 #include "sensors/power.hpp"
 
+#include "core/file_io.hpp"
+
 #include <cctype>
 #include <filesystem>
 #include <memory>
@@ -128,7 +130,7 @@ bool CpuThrottleSensor::read_u64_file(std::FILE* file, std::uint64_t& value) noe
     return false;
   }
 
-  if (std::fseek(file, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(file)) {
     value = 0;
     return false;
   }
@@ -0,0 +1,219 @@
+#include "sensors/powercap.hpp"
+
+#include "core/file_io.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <utility>
+
+namespace hw_agent::sensors {
+
+namespace {
+constexpr const char* kSysClassPowercap = "/sys/class/powercap";
+
+std::string read_first_line(const std::filesystem::path& path) {
+  std::ifstream input(path);
+  std::string line;
+  if (!input.is_open() || !std::getline(input, line)) {
+    return {};
+  }
+  return line;
+}
+
+std::uint64_t read_static_u64(const std::filesystem::path& path) {
+  std::ifstream input(path);
+  unsigned long long value = 0;
+  if (!input.is_open() || !(input >> value)) {
+    return 0;
+  }
+  return value;
+}
+
+// PL1 is named "long_term"; older kernels without constraint names put it at index 0.
+std::filesystem::path long_term_limit_path(const std::filesystem::path& zone_path) {
+  for (int index = 0;; ++index) {
+    const std::string prefix = "constraint_" + std::to_string(index) + "_";
+    const std::filesystem::path name_path = zone_path / (prefix + "name");
+    if (!std::filesystem::exists(name_path)) {
+      break;
+    }
+    if (read_first_line(name_path) == "long_term") {
+      return zone_path / (prefix + "power_limit_uw");
+    }
+  }
+  return zone_path / "constraint_0_power_limit_uw";
+}
+
+}  // namespace
+
+PowerCapSensor::PowerCapSensor() : owns_files_(true) { discover_zones(kSysClassPowercap); }
+
+PowerCapSensor::PowerCapSensor(std::string powercap_root) : owns_files_(true) { discover_zones(powercap_root); }
+
+PowerCapSensor::PowerCapSensor(std::vector<ZoneSource> zones, const bool owns_files)
+    : zones_(std::move(zones)), owns_files_(owns_files) {}
+
+void PowerCapSensor::discover_zones(const std::string& powercap_root) {
+  try {
+    if (!std::filesystem::exists(powercap_root)) {
+      return;
+    }
+
+    // The class directory lists every zone and subzone flat ("intel-rapl:0", "intel-rapl:0:2").
+    // "intel-rapl-mmio:*" mirrors the MSR package zones and is skipped to avoid double counting.
+    for (const auto& entry : std::filesystem::directory_iterator(powercap_root)) {
+      const std::string dir_name = entry.path().filename().string();
+      if (dir_name.rfind("intel-rapl:", 0) != 0 || !entry.is_directory()) {
+        continue;
+      }
+
+      const std::filesystem::path zone_path = entry.path();
+      const std::string name = read_first_line(zone_path / "name");
+
+      ZoneSource source{};
+      if (name.rfind("package", 0) == 0) {
+        source.domain = Domain::package;
+      } else if (name == "dram") {
+        source.domain = Domain::dram;
+      } else {
+        continue;
+      }
+
+      source.name = dir_name + ":" + name;
+      source.max_energy_range_uj = read_static_u64(zone_path / "max_energy_range_uj");
+      // energy_uj is root-only on kernels patched for CVE-2020-8694; the zone is still listed so
+      // a missing counter surfaces as a sensor failure instead of silently reading zero watts.
+      source.energy_file = std::fopen((zone_path / "energy_uj").c_str(), "r");
+      source.power_limit_file = std::fopen(long_term_limit_path(zone_path).c_str(), "r");
+      zones_.push_back(source);
+    }
+  } catch (const std::filesystem::filesystem_error&) {
+    // Keep zones discovered before the error.
+  }
+}
+
+PowerCapSensor::~PowerCapSensor() {
+  if (!owns_files_) {
+    return;
+  }
+
+  for (ZoneSource& zone : zones_) {
+    for (std::FILE** file : {&zone.energy_file, &zone.power_limit_file}) {
+      if (*file != nullptr) {
+        std::fclose(*file);
+        *file = nullptr;
+      }
+    }
+  }
+}
+
+bool PowerCapSensor::sample(model::signal_frame& frame) noexcept {
+  raw_ = RawFields{};
+
+  const bool has_interval = has_prev_timestamp_ && frame.monotonic_ns > prev_timestamp_ns_;
+  const double seconds =
+      has_interval ? static_cast<double>(frame.monotonic_ns - prev_timestamp_ns_) / 1'000'000'000.0 : 0.0;
+
+  double package_watts = 0.0;
+  double package_limited_watts = 0.0;
+  double package_limit_watts = 0.0;
+  double dram_watts = 0.0;
+  double dram_limited_watts = 0.0;
+  double dram_limit_watts = 0.0;
+  bool any_read = false;
+
+  for (ZoneSource& zone : zones_) {
+    std::uint64_t energy_uj = 0;
+    if (!read_u64_file(zone.energy_file, energy_uj)) {
+      // A skipped sample would stretch the next delta over two intervals; re-baseline instead.
+      zone.has_prev_energy = false;
+      continue;
+    }
+    any_read = true;
+
+    double watts = 0.0;
+    if (zone.has_prev_energy && has_interval) {
+      std::uint64_t delta_uj = 0;
+      if (energy_uj >= zone.prev_energy_uj) {
+        delta_uj = energy_uj - zone.prev_energy_uj;
+      } else if (zone.max_energy_range_uj >= zone.prev_energy_uj) {
+        delta_uj = (zone.max_energy_range_uj - zone.prev_energy_uj) + energy_uj;
+      }
+      watts = (static_cast<double>(delta_uj) / 1'000'000.0) / seconds;
+    }
+    zone.prev_energy_uj = energy_uj;
+    zone.has_prev_energy = true;
+
+    std::uint64_t limit_uw = 0;
+    const bool has_limit = read_u64_file(zone.power_limit_file, limit_uw) && limit_uw != 0;
+    const double limit_watts = static_cast<double>(limit_uw) / 1'000'000.0;
+
+    if (zone.domain == Domain::package) {
+      ++raw_.package_zones;
+      package_watts += watts;
+      if (has_limit) {
+        package_limited_watts += watts;
+        package_limit_watts += limit_watts;
+      }
+    } else {
+      ++raw_.dram_zones;
+      dram_watts += watts;
+      if (has_limit) {
+        dram_limited_watts += watts;
+        dram_limit_watts += limit_watts;
+      }
+    }
+  }
+
+  prev_timestamp_ns_ = frame.monotonic_ns;
+  has_prev_timestamp_ = true;
+
+  raw_.package_watts = static_cast<float>(package_watts);
+  raw_.package_limit_watts = static_cast<float>(package_limit_watts);
+  raw_.package_limit_ratio =
+      package_limit_watts > 0.0 ? static_cast<float>(package_limited_watts / package_limit_watts) : 0.0F;
+  raw_.dram_watts = static_cast<float>(dram_watts);
+  raw_.dram_limit_watts = static_cast<float>(dram_limit_watts);
+  raw_.dram_limit_ratio = dram_limit_watts > 0.0 ? static_cast<float>(dram_limited_watts / dram_limit_watts) : 0.0F;
+
+  frame.rapl_package_watts = raw_.package_watts;
+  frame.rapl_package_limit_ratio = raw_.package_limit_ratio;
+  frame.rapl_dram_watts = raw_.dram_watts;
+  frame.rapl_dram_limit_ratio = raw_.dram_limit_ratio;
+  return any_read;
+}
+
+const PowerCapSensor::RawFields& PowerCapSensor::raw() const noexcept { return raw_; }
+
+const std::vector<PowerCapSensor::ZoneSource>& PowerCapSensor::zones() const noexcept { return zones_; }
+
+bool PowerCapSensor::read_u64_file(std::FILE* file, std::uint64_t& value) noexcept {
+  if (file == nullptr) {
+    return false;
+  }
+
+  if (!core::rewind_file(file)) {
+    return false;
+  }
+
+  char buffer[64]{};
+  if (std::fgets(buffer, static_cast<int>(sizeof(buffer)), file) == nullptr) {
+    std::clearerr(file);
+    return false;
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  const unsigned long long parsed = std::strtoull(buffer, &end, 10);
+  if (errno != 0 || end == buffer) {
+    return false;
+  }
+
+  value = parsed;
+  return true;
+}
+
+}  // namespace hw_agent::sensors
@@ -0,0 +1,295 @@
+#include "sensors/process_attribution.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace hw_agent::sensors {
+
+namespace {
+
+// Layout returned by getdents64(2); glibc only exposes it through <dirent.h> as struct dirent64.
+struct linux_dirent64 {
+  std::uint64_t d_ino;
+  std::int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+// Budget checks read the thread CPU clock, so they are amortized over a few processes.
+constexpr std::size_t kBudgetCheckInterval = 8;
+
+std::uint64_t thread_cpu_ns() noexcept {
+  timespec now{};
+  if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) {
+    return 0;
+  }
+  return (static_cast<std::uint64_t>(now.tv_sec) * 1'000'000'000ULL) + static_cast<std::uint64_t>(now.tv_nsec);
+}
+
+bool parse_pid(const char* name, int& pid) noexcept {
+  const char* end = name + std::strlen(name);
+  const auto [ptr, ec] = std::from_chars(name, end, pid);
+  return ec == std::errc{} && ptr == end && pid > 0;
+}
+
+// Reads a small procfs file relative to dir_fd into buffer (NUL-terminated); returns bytes read or -1.
+ssize_t read_small_file(const int dir_fd, const char* path, char* buffer, const std::size_t size) noexcept {
+  const int fd = ::openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  ssize_t bytes = 0;
+  do {
+    bytes = ::read(fd, buffer, size - 1);
+  } while (bytes < 0 && errno == EINTR);
+  ::close(fd);
+  if (bytes < 0) {
+    return -1;
+  }
+  buffer[bytes] = '\0';
+  return bytes;
+}
+
+std::uint64_t labelled_value(const char* text, const char* label) noexcept {
+  const char* found = std::strstr(text, label);
+  if (found == nullptr) {
+    return 0;
+  }
+  return std::strtoull(found + std::strlen(label), nullptr, 10);
+}
+
+std::uint64_t counter_delta(const std::uint64_t current, const std::uint64_t previous) noexcept {
+  return current >= previous ? (current - previous) : 0;
+}
+
+}  // namespace
+
+ProcessAttribution::ProcessAttribution(ProcessAttributionOptions options) : options_(std::move(options)) {
+  const long ticks = ::sysconf(_SC_CLK_TCK);
+  clock_ticks_per_sec_ = ticks > 0 ? ticks : 100;
+}
+
+ProcessAttribution::~ProcessAttribution() { release(); }
+
+void ProcessAttribution::request_scan() noexcept { requested_passes_ = 2; }
+
+bool ProcessAttribution::active() const noexcept { return proc_fd_ >= 0; }
+
+const ProcessAttribution::Report& ProcessAttribution::report() const noexcept { return report_; }
+
+bool ProcessAttribution::open_proc() {
+  proc_fd_ = ::open(options_.proc_root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (proc_fd_ < 0) {
+    return false;
+  }
+  dirent_buffer_.resize(kDirentBufferSize);
+  dirent_offset_ = 0;
+  dirent_size_ = 0;
+  pass_steps_ = 0;
+  current_.clear();
+  return true;
+}
+
+void ProcessAttribution::release() {
+  if (proc_fd_ >= 0) {
+    ::close(proc_fd_);
+    proc_fd_ = -1;
+  }
+  // A baseline from a previous incident would average rates over the quiet period in between.
+  std::vector<char>().swap(dirent_buffer_);
+  std::vector<Counters>().swap(current_);
+  std::vector<Counters>().swap(previous_);
+  std::vector<ProcessRates>().swap(rates_);
+}
+
+bool ProcessAttribution::step(const model::signal_frame& frame) {
+  const bool wanted = frame.state >= model::system_state::DEGRADED || requested_passes_ > 0;
+  if (!wanted) {
+    if (active()) {
+      release();
+    }
+    return false;
+  }
+
+  if (!active() && !open_proc()) {
+    return false;
+  }
+
+  ++pass_steps_;
+  const auto budget_ns = static_cast<std::uint64_t>(static_cast<double>(options_.tick_interval.count()) *
+                                                    static_cast<double>(options_.cpu_budget_pct) / 100.0);
+  const std::uint64_t start_ns = thread_cpu_ns();
+  std::size_t processed = 0;
+
+  while (true) {
+    if (dirent_offset_ >= dirent_size_) {
+      const long bytes = ::syscall(SYS_getdents64, proc_fd_, dirent_buffer_.data(), dirent_buffer_.size());
+      if (bytes < 0) {
+        release();
+        return false;
+      }
+      if (bytes == 0) {
+        return finish_pass(frame);
+      }
+      dirent_offset_ = 0;
+      dirent_size_ = static_cast<std::size_t>(bytes);
+    }
+
+    const auto* entry = reinterpret_cast<const linux_dirent64*>(dirent_buffer_.data() + dirent_offset_);
+    dirent_offset_ += entry->d_reclen;
+
+    int pid = 0;
+    if (!parse_pid(entry->d_name, pid)) {
+      continue;
+    }
+
+    Counters counters{};
+    if (read_process(pid, frame.monotonic_ns, counters)) {
+      current_.push_back(counters);
+    }
+    ++processed;
+
+    if (options_.max_pids_per_step != 0 && processed >= options_.max_pids_per_step) {
+      return false;
+    }
+    if (processed % kBudgetCheckInterval == 0 && thread_cpu_ns() - start_ns >= budget_ns) {
+      return false;
+    }
+  }
+}
+
+bool ProcessAttribution::read_process(const int pid, const std::uint64_t sampled_ns, Counters& counters) const {
+  char path[32];
+  char buffer[1024];
+
+  // "<pid>/" stays in place; only the leaf name is rewritten per file.
+  char* leaf_begin = std::to_chars(path, path + 12, pid).ptr;
+  *leaf_begin++ = '/';
+  const auto path_for = [&](const char* leaf) {
+    std::memcpy(leaf_begin, leaf, std::strlen(leaf) + 1);
+    return path;
+  };
+
+  // "<pid> (<comm>) <state> ..."; comm may contain spaces or ')', so split on the last ')'.
+  if (read_small_file(proc_fd_, path_for("stat"), buffer, sizeof(buffer)) <= 0) {
+    return false;
+  }
+  const char* open_paren = std::strchr(buffer, '(');
+  const char* close_paren = std::strrchr(buffer, ')');
+  if (open_paren == nullptr || close_paren == nullptr || close_paren < open_paren) {
+    return false;
+  }
+
+  counters.pid = pid;
+  const std::size_t comm_size = std::min<std::size_t>(static_cast<std::size_t>(close_paren - open_paren - 1), kCommSize - 1);
+  std::memcpy(counters.comm.data(), open_paren + 1, comm_size);
+  counters.comm[comm_size] = '\0';
+
+  // Field 3 (state) is a letter; the numeric fields we need are majflt (12), utime (14) and stime (15).
+  const char* cursor = close_paren + 2;
+  if (cursor >= buffer + sizeof(buffer) || *cursor == '\0') {
+    return false;
+  }
+  ++cursor;
+  std::uint64_t fields[16]{};
+  for (int field = 4; field <= 15; ++field) {
+    char* end = nullptr;
+    fields[field] = std::strtoull(cursor, &end, 10);
+    if (end == cursor) {
+      return false;
+    }
+    cursor = end;
+  }
+  counters.major_faults = fields[12];
+  counters.cpu_ticks = fields[14] + fields[15];
+
+  // io needs ptrace access to the target; without it the process simply reports no IO.
+  if (read_small_file(proc_fd_, path_for("io"), buffer, sizeof(buffer)) > 0) {
+    counters.io_bytes = labelled_value(buffer, "\nread_bytes: ") + labelled_value(buffer, "\nwrite_bytes: ");
+  }
+
+  if (read_small_file(proc_fd_, path_for("schedstat"), buffer, sizeof(buffer)) > 0) {
+    char* end = nullptr;
+    std::strtoull(buffer, &end, 10);
+    counters.run_delay_ns = std::strtoull(end, nullptr, 10);
+  }
+
+  counters.sampled_ns = sampled_ns;
+  return true;
+}
+
+bool ProcessAttribution::finish_pass(const model::signal_frame& frame) {
+  std::sort(current_.begin(), current_.end(), [](const Counters& lhs, const Counters& rhs) { return lhs.pid < rhs.pid; });
+
+  const bool has_baseline = !previous_.empty();
+  if (has_baseline) {
+    rates_.clear();
+    for (const Counters& now : current_) {
+      const auto it = std::lower_bound(previous_.begin(), previous_.end(), now.pid,
+                                       [](const Counters& counters, const int pid) { return counters.pid < pid; });
+      // A reused PID with a different comm is a new process; skip it until it has its own baseline.
+      if (it == previous_.end() || it->pid != now.pid || it->comm != now.comm || now.sampled_ns <= it->sampled_ns) {
+        continue;
+      }
+
+      const double seconds = static_cast<double>(now.sampled_ns - it->sampled_ns) / 1'000'000'000.0;
+      ProcessRates rates{};
+      rates.pid = now.pid;
+      rates.comm = now.comm;
+      rates.cpu_pct = static_cast<float>(static_cast<double>(counter_delta(now.cpu_ticks, it->cpu_ticks)) /
+                                         static_cast<double>(clock_ticks_per_sec_) / seconds * 100.0);
+      rates.major_faults_per_sec =
+          static_cast<float>(static_cast<double>(counter_delta(now.major_faults, it->major_faults)) / seconds);
+      rates.io_bytes_per_sec = static_cast<float>(static_cast<double>(counter_delta(now.io_bytes, it->io_bytes)) / seconds);
+      rates.run_delay_ms_per_sec =
+          static_cast<float>(static_cast<double>(counter_delta(now.run_delay_ns, it->run_delay_ns)) / 1'000'000.0 / seconds);
+      rates_.push_back(rates);
+    }
+
+    const auto select_top = [this](std::vector<ProcessRates>& top, float ProcessRates::*field) {
+      top.clear();
+      for (const ProcessRates& rates : rates_) {
+        if (rates.*field > 0.0F) {
+          top.push_back(rates);
+        }
+      }
+      const std::size_t count = std::min(options_.top_n, top.size());
+      std::partial_sort(top.begin(), top.begin() + static_cast<std::ptrdiff_t>(count), top.end(),
+                        [field](const ProcessRates& lhs, const ProcessRates& rhs) { return lhs.*field > rhs.*field; });
+      top.resize(count);
+    };
+
+    select_top(report_.top_cpu, &ProcessRates::cpu_pct);
+    select_top(report_.top_major_faults, &ProcessRates::major_faults_per_sec);
+    select_top(report_.top_io, &ProcessRates::io_bytes_per_sec);
+    select_top(report_.top_run_delay, &ProcessRates::run_delay_ms_per_sec);
+    report_.completed_ns = frame.monotonic_ns;
+    report_.state = frame.state;
+    report_.processes = current_.size();
+    report_.steps = pass_steps_;
+  }
+
+  std::swap(previous_, current_);
+  current_.clear();
+  pass_steps_ = 0;
+  dirent_offset_ = 0;
+  dirent_size_ = 0;
+  ::lseek(proc_fd_, 0, SEEK_SET);
+
+  if (requested_passes_ > 0) {
+    --requested_passes_;
+  }
+  return has_baseline;
+}
+
+}  // namespace hw_agent::sensors
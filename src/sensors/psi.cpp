@@ -1,5 +1,7 @@
 #include "sensors/psi.hpp"
 
+#include "core/file_io.hpp"
+
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
@@ -50,7 +52,7 @@ bool PsiSensor::read_avg10(Source& source, float& value) noexcept {
     return false;
   }
 
-  if (std::fseek(source.file, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(source.file)) {
     value = 0.0F;
     return false;
   }
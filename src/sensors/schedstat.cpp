@@ -0,0 +1,175 @@
+#include "sensors/schedstat.hpp"
+
+#include "core/file_io.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace hw_agent::sensors {
+
+namespace {
+
+constexpr std::size_t kCpuFields = 9;
+
+std::uint64_t counter_delta(const std::uint64_t current, const std::uint64_t previous) noexcept {
+  return current >= previous ? (current - previous) : 0;
+}
+
+// "cpu<N> yld_count 0 sched_count sched_goidle ttwu_count ttwu_local rq_cpu_time run_delay pcount"
+bool parse_cpu_line(const char* line, SchedstatSensor::CpuCounters& counters) noexcept {
+  if (std::strncmp(line, "cpu", 3) != 0) {
+    return false;
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  const long cpu = std::strtol(line + 3, &end, 10);
+  if (errno != 0 || end == line + 3) {
+    return false;
+  }
+
+  std::uint64_t fields[kCpuFields]{};
+  const char* cursor = end;
+  for (std::size_t i = 0; i < kCpuFields; ++i) {
+    errno = 0;
+    fields[i] = std::strtoull(cursor, &end, 10);
+    if (errno != 0 || end == cursor) {
+      return false;
+    }
+    cursor = end;
+  }
+
+  counters.cpu = static_cast<int>(cpu);
+  counters.run_time_ns = fields[6];
+  counters.run_delay_ns = fields[7];
+  counters.timeslices = fields[8];
+  return true;
+}
+
+}  // namespace
+
+SchedstatSensor::SchedstatSensor() : file_(std::fopen("/proc/schedstat", "r")) {}
+
+SchedstatSensor::SchedstatSensor(std::FILE* file, const bool owns_file) : file_(file), owns_file_(owns_file) {}
+
+SchedstatSensor::~SchedstatSensor() {
+  if (owns_file_ && file_ != nullptr) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+bool SchedstatSensor::sample(model::signal_frame& frame) noexcept {
+  if (file_ == nullptr || !core::rewind_file(file_)) {
+    publish_zero(frame);
+    return false;
+  }
+
+  current_.clear();
+
+  char buffer[kReadBufferSize]{};
+  while (std::fgets(buffer, static_cast<int>(sizeof(buffer)), file_) != nullptr) {
+    if (std::strncmp(buffer, "version ", 8) == 0) {
+      raw_.version = static_cast<unsigned>(std::strtoul(buffer + 8, nullptr, 10));
+      continue;
+    }
+
+    CpuCounters counters{};
+    if (parse_cpu_line(buffer, counters)) {
+      current_.push_back(counters);
+    }
+  }
+
+  if (std::ferror(file_) != 0) {
+    std::clearerr(file_);
+    publish_zero(frame);
+    return false;
+  }
+
+  if (current_.empty()) {
+    publish_zero(frame);
+    return false;
+  }
+
+  raw_.cpu_count = current_.size();
+
+  // CPU hotplug changes the row set; re-baseline instead of mixing rows from different CPUs.
+  if (!has_prev_ || previous_.size() != current_.size() || frame.monotonic_ns <= prev_timestamp_ns_) {
+    has_prev_ = true;
+    std::swap(previous_, current_);
+    prev_timestamp_ns_ = frame.monotonic_ns;
+    publish_zero(frame);
+    return true;
+  }
+
+  const double seconds = static_cast<double>(frame.monotonic_ns - prev_timestamp_ns_) / 1'000'000'000.0;
+  raw_.per_cpu.resize(current_.size());
+  sorted_delays_.clear();
+
+  std::uint64_t total_delay_ns = 0;
+  std::uint64_t total_timeslices = 0;
+  raw_.max_run_delay_ms_per_sec = 0.0F;
+  raw_.worst_cpu = -1;
+
+  for (std::size_t i = 0; i < current_.size(); ++i) {
+    const std::uint64_t delay_ns = counter_delta(current_[i].run_delay_ns, previous_[i].run_delay_ns);
+    const std::uint64_t timeslices = counter_delta(current_[i].timeslices, previous_[i].timeslices);
+    total_delay_ns += delay_ns;
+    total_timeslices += timeslices;
+
+    CpuRates& rates = raw_.per_cpu[i];
+    rates.cpu = current_[i].cpu;
+    rates.run_delay_ms_per_sec = static_cast<float>((static_cast<double>(delay_ns) / 1'000'000.0) / seconds);
+    rates.timeslices_per_sec = static_cast<float>(static_cast<double>(timeslices) / seconds);
+    rates.wait_per_timeslice_us =
+        timeslices != 0 ? static_cast<float>(static_cast<double>(delay_ns) / 1000.0 / static_cast<double>(timeslices)) : 0.0F;
+
+    sorted_delays_.push_back(rates.run_delay_ms_per_sec);
+    if (rates.run_delay_ms_per_sec > raw_.max_run_delay_ms_per_sec) {
+      raw_.max_run_delay_ms_per_sec = rates.run_delay_ms_per_sec;
+      raw_.worst_cpu = rates.cpu;
+    }
+  }
+
+  std::swap(previous_, current_);
+  prev_timestamp_ns_ = frame.monotonic_ns;
+
+  // Nearest-rank p99 across CPUs; on small machines this is the worst CPU.
+  std::sort(sorted_delays_.begin(), sorted_delays_.end());
+  const auto rank = static_cast<std::size_t>(std::ceil(0.99 * static_cast<double>(sorted_delays_.size())));
+  raw_.p99_run_delay_ms_per_sec = sorted_delays_[rank > 0 ? rank - 1 : 0];
+  raw_.mean_run_delay_ms_per_sec = static_cast<float>(
+      (static_cast<double>(total_delay_ns) / 1'000'000.0) / seconds / static_cast<double>(current_.size()));
+  raw_.wait_per_timeslice_us =
+      total_timeslices != 0
+          ? static_cast<float>(static_cast<double>(total_delay_ns) / 1000.0 / static_cast<double>(total_timeslices))
+          : 0.0F;
+
+  frame.sched_run_delay = raw_.mean_run_delay_ms_per_sec;
+  frame.sched_run_delay_p99 = raw_.p99_run_delay_ms_per_sec;
+  frame.sched_run_delay_max = raw_.max_run_delay_ms_per_sec;
+  frame.sched_worst_cpu = static_cast<float>(raw_.worst_cpu);
+  frame.sched_wait_per_slice_us = raw_.wait_per_timeslice_us;
+  return true;
+}
+
+const SchedstatSensor::RawFields& SchedstatSensor::raw() const noexcept { return raw_; }
+
+void SchedstatSensor::publish_zero(model::signal_frame& frame) noexcept {
+  raw_.mean_run_delay_ms_per_sec = 0.0F;
+  raw_.p99_run_delay_ms_per_sec = 0.0F;
+  raw_.max_run_delay_ms_per_sec = 0.0F;
+  raw_.worst_cpu = -1;
+  raw_.wait_per_timeslice_us = 0.0F;
+  frame.sched_run_delay = 0.0F;
+  frame.sched_run_delay_p99 = 0.0F;
+  frame.sched_run_delay_max = 0.0F;
+  frame.sched_worst_cpu = -1.0F;
+  frame.sched_wait_per_slice_us = 0.0F;
+}
+
+}  // namespace hw_agent::sensors
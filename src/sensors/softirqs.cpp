@@ -1,5 +1,7 @@
 #include "sensors/softirqs.hpp"
 
+#include "core/file_io.hpp"
+
 #include <cstdint>
 #include <limits>
 
@@ -22,7 +24,7 @@ bool SoftirqsSensor::sample(model::signal_frame& frame) noexcept {
     return false;
   }
 
-  if (std::fseek(file_, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(file_)) {
     frame.softirqs = 0.0F;
     return false;
   }
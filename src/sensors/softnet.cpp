@@ -0,0 +1,162 @@
+#include "sensors/softnet.hpp"
+
+#include "core/file_io.hpp"
+
+#include <cstdint>
+#include <utility>
+
+namespace hw_agent::sensors {
+
+namespace {
+
+int hex_digit(const char ch) noexcept {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  if (ch >= 'a' && ch <= 'f') {
+    return 10 + (ch - 'a');
+  }
+  if (ch >= 'A' && ch <= 'F') {
+    return 10 + (ch - 'A');
+  }
+  return -1;
+}
+
+// Each /proc/net/softnet_stat row is a list of 32-bit hex counters:
+// processed, dropped, time_squeeze, ..., and (since 5.10) the owning CPU id in 0-based column 12.
+// 6.x kernels append input_qlen and process_qlen after it.
+std::size_t parse_hex_columns(const char* line, std::uint64_t* columns, const std::size_t max_columns) noexcept {
+  std::size_t count = 0;
+  const char* cursor = line;
+  while (count < max_columns) {
+    while (*cursor == ' ' || *cursor == '\t') {
+      ++cursor;
+    }
+
+    int digit = hex_digit(*cursor);
+    if (digit < 0) {
+      break;
+    }
+
+    std::uint64_t value = 0;
+    while (digit >= 0) {
+      value = (value << 4U) | static_cast<std::uint64_t>(digit);
+      ++cursor;
+      digit = hex_digit(*cursor);
+    }
+    columns[count++] = value;
+  }
+  return count;
+}
+
+std::uint64_t counter_delta(const std::uint64_t current, const std::uint64_t previous) noexcept {
+  return current >= previous ? (current - previous) : 0;
+}
+
+}  // namespace
+
+SoftnetSensor::SoftnetSensor() : file_(std::fopen("/proc/net/softnet_stat", "r")) {}
+
+SoftnetSensor::SoftnetSensor(std::FILE* file, const bool owns_file) : file_(file), owns_file_(owns_file) {}
+
+SoftnetSensor::~SoftnetSensor() {
+  if (owns_file_ && file_ != nullptr) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+bool SoftnetSensor::sample(model::signal_frame& frame) noexcept {
+  if (file_ == nullptr) {
+    frame.softnet_squeeze = 0.0F;
+    frame.softnet_drops = 0.0F;
+    return false;
+  }
+
+  if (!core::rewind_file(file_)) {
+    frame.softnet_squeeze = 0.0F;
+    frame.softnet_drops = 0.0F;
+    return false;
+  }
+
+  current_.clear();
+  cpu_ids_.clear();
+
+  char buffer[kReadBufferSize]{};
+  while (std::fgets(buffer, static_cast<int>(sizeof(buffer)), file_) != nullptr) {
+    std::uint64_t columns[kMaxColumns]{};
+    const std::size_t count = parse_hex_columns(buffer, columns, kMaxColumns);
+    if (count < 3) {
+      continue;
+    }
+
+    current_.push_back({columns[0], columns[1], columns[2]});
+    cpu_ids_.push_back(count >= 13 ? static_cast<int>(columns[12]) : static_cast<int>(current_.size() - 1));
+  }
+
+  if (std::ferror(file_) != 0) {
+    std::clearerr(file_);
+    frame.softnet_squeeze = 0.0F;
+    frame.softnet_drops = 0.0F;
+    return false;
+  }
+
+  if (current_.empty()) {
+    frame.softnet_squeeze = 0.0F;
+    frame.softnet_drops = 0.0F;
+    return false;
+  }
+
+  raw_.cpu_count = current_.size();
+  raw_.dropped_delta = 0;
+  raw_.time_squeeze_delta = 0;
+  raw_.hottest_cpu = -1;
+  raw_.hottest_cpu_events = 0;
+
+  // CPU hotplug changes the row set; re-baseline instead of mixing rows from different CPUs.
+  if (!has_prev_ || previous_.size() != current_.size()) {
+    has_prev_ = true;
+    std::swap(previous_, current_);
+    prev_timestamp_ns_ = frame.monotonic_ns;
+    raw_.dropped_per_sec = 0.0F;
+    raw_.time_squeeze_per_sec = 0.0F;
+    frame.softnet_squeeze = 0.0F;
+    frame.softnet_drops = 0.0F;
+    frame.softnet_hot_cpu = -1.0F;
+    return true;
+  }
+
+  for (std::size_t cpu = 0; cpu < current_.size(); ++cpu) {
+    const std::uint64_t dropped = counter_delta(current_[cpu].dropped, previous_[cpu].dropped);
+    const std::uint64_t squeezed = counter_delta(current_[cpu].time_squeeze, previous_[cpu].time_squeeze);
+    raw_.dropped_delta += dropped;
+    raw_.time_squeeze_delta += squeezed;
+
+    if (dropped + squeezed > raw_.hottest_cpu_events) {
+      raw_.hottest_cpu_events = dropped + squeezed;
+      raw_.hottest_cpu = cpu_ids_[cpu];
+    }
+  }
+
+  const std::uint64_t time_delta_ns = frame.monotonic_ns - prev_timestamp_ns_;
+  std::swap(previous_, current_);
+  prev_timestamp_ns_ = frame.monotonic_ns;
+
+  if (time_delta_ns == 0) {
+    raw_.dropped_per_sec = 0.0F;
+    raw_.time_squeeze_per_sec = 0.0F;
+  } else {
+    const double seconds = static_cast<double>(time_delta_ns) / 1'000'000'000.0;
+    raw_.dropped_per_sec = static_cast<float>(static_cast<double>(raw_.dropped_delta) / seconds);
+    raw_.time_squeeze_per_sec = static_cast<float>(static_cast<double>(raw_.time_squeeze_delta) / seconds);
+  }
+
+  frame.softnet_squeeze = raw_.time_squeeze_per_sec;
+  frame.softnet_drops = raw_.dropped_per_sec;
+  frame.softnet_hot_cpu = static_cast<float>(raw_.hottest_cpu);
+  return true;
+}
+
+const SoftnetSensor::RawFields& SoftnetSensor::raw() const noexcept { return raw_; }
+
+}  // namespace hw_agent::sensors
@@ -6,38 +6,77 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <charconv>
 #include <cmath>
-#include <cstdlib>
-#include <regex>
+#include <cstring>
 #include <string>
 
 namespace hw_agent::sensors {
 
 namespace {
-const std::regex kGpuRe(R"((?:GR3D_FREQ|GPU)\s+(\d+)%)");
-const std::regex kEmcRe(R"(EMC_FREQ\s+(\d+)%)");
-const std::regex kTempRe(R"(([A-Za-z0-9_]+)@(-?\d+(?:\.\d+)?)C)");
-const std::regex kRailRe(R"((VDD_[A-Z0-9_]+)\s+(\d+)mW(?:\/(\d+)mW)?)");
-
-float parse_float(const std::string& value) noexcept {
-  const char* begin = value.c_str();
-  char* end = nullptr;
-  const float parsed = std::strtof(begin, &end);
-  if (end == begin || !std::isfinite(parsed)) {
-    return 0.0F;
+
+bool is_space(const char c) noexcept { return c == ' ' || c == '\t' || c == '\r'; }
+
+bool is_digit(const char c) noexcept { return c >= '0' && c <= '9'; }
+
+bool is_rail_char(const char c) noexcept { return (c >= 'A' && c <= 'Z') || is_digit(c) || c == '_'; }
+
+bool is_name_char(const char c) noexcept { return is_rail_char(c) || (c >= 'a' && c <= 'z'); }
+
+// Parses the leading unsigned integer of token and returns the rest, or false without digits.
+bool leading_int(const std::string_view token, int& value, std::string_view& rest) noexcept {
+  if (token.empty() || !is_digit(token.front())) {
+    return false;
   }
-  return parsed;
+  const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+  if (result.ec != std::errc{}) {
+    value = 0;
+  }
+  const char* digits_end = std::find_if_not(token.data(), token.data() + token.size(), is_digit);
+  rest = token.substr(static_cast<std::size_t>(digits_end - token.data()));
+  return true;
 }
 
-int parse_int_or_zero(const std::string& value) noexcept {
-  int parsed = 0;
-  const auto result = std::from_chars(value.data(), value.data() + value.size(), parsed);
-  if (result.ec != std::errc{}) {
-    return 0;
+// "<digits>%..." as in "GR3D_FREQ 12%@921" or "EMC_FREQ 0%".
+bool parse_percent(const std::string_view token, int& value) noexcept {
+  std::string_view rest;
+  return leading_int(token, value, rest) && !rest.empty() && rest.front() == '%';
+}
+
+// "<digits>mW..." as in "VDD_GPU_SOC 3987mW/3987mW".
+bool parse_milliwatts(const std::string_view token, int& value) noexcept {
+  std::string_view rest;
+  return leading_int(token, value, rest) && rest.substr(0, 2) == "mW";
+}
+
+bool is_rail_name(const std::string_view token) noexcept {
+  return token.size() > 4 && token.substr(0, 4) == "VDD_" && std::all_of(token.begin() + 4, token.end(), is_rail_char);
+}
+
+// "<name>@<float>C" as in "CPU@33.5C" or "CV0@-256C".
+bool parse_temperature(const std::string_view token, std::string_view& name, float& value) noexcept {
+  const std::size_t at = token.find('@');
+  if (at == 0 || at == std::string_view::npos || token.size() < at + 3 || token.back() != 'C') {
+    return false;
   }
-  return parsed;
+  name = token.substr(0, at);
+  if (!std::all_of(name.begin(), name.end(), is_name_char)) {
+    return false;
+  }
+
+  const char* begin = token.data() + at + 1;
+  const char* end = token.data() + token.size() - 1;
+  const char* digits = begin != end && *begin == '-' ? begin + 1 : begin;
+  if (digits == end || !is_digit(*digits)) {
+    return false;
+  }
+  const auto result = std::from_chars(begin, end, value, std::chars_format::fixed);
+  if (result.ec != std::errc{} || result.ptr != end || !std::isfinite(value)) {
+    return false;
+  }
+  return true;
 }
 
 void terminate_child_process(const pid_t child_pid) noexcept {
@@ -63,10 +102,40 @@ void terminate_child_process(const pid_t child_pid) noexcept {
 }
 }  // namespace
 
+bool TegraStatsSensor::NamedValues::set(const std::string_view name, const float value) noexcept {
+  for (std::size_t i = 0; i < size_; ++i) {
+    if (entries_[i].key() == name) {
+      entries_[i].value = value;
+      return true;
+    }
+  }
+  if (size_ == entries_.size() || name.size() > kMaxNameSize) {
+    ++dropped_;
+    return false;
+  }
+  Entry& entry = entries_[size_++];
+  std::memcpy(entry.name.data(), name.data(), name.size());
+  entry.name_size = static_cast<std::uint8_t>(name.size());
+  entry.value = value;
+  return true;
+}
+
+const float* TegraStatsSensor::NamedValues::find(const std::string_view name) const noexcept {
+  for (std::size_t i = 0; i < size_; ++i) {
+    if (entries_[i].key() == name) {
+      return &entries_[i].value;
+    }
+  }
+  return nullptr;
+}
+
 TegraStatsSensor::TegraStatsSensor(const std::uint32_t interval_ms) noexcept {
   enabled_ = launch(interval_ms);
 }
 
+TegraStatsSensor::TegraStatsSensor(const int read_fd, const bool owns_fd) noexcept
+    : read_fd_(read_fd), owns_fd_(owns_fd), enabled_(read_fd >= 0) {}
+
 TegraStatsSensor::~TegraStatsSensor() { disable(); }
 
 bool TegraStatsSensor::sample(model::signal_frame& frame) noexcept {
@@ -74,25 +143,25 @@ bool TegraStatsSensor::sample(model::signal_frame& frame) noexcept {
     return false;
   }
 
-  char chunk[4096]{};
   bool parsed_at_least_one_line = false;
 
   while (true) {
-    const ssize_t bytes_read = ::read(read_fd_, chunk, sizeof(chunk));
+    const std::size_t used = ring_head_ - ring_tail_;
+    if (used == kRingSize) {
+      // No newline in a full ring: drop what we have and skip the rest of that line.
+      ++raw_.overlong_lines;
+      discarding_line_ = true;
+      ring_tail_ = ring_head_;
+      ring_scanned_ = ring_head_;
+      continue;
+    }
+
+    const std::size_t head = ring_head_ & (kRingSize - 1);
+    const std::size_t contiguous = std::min(kRingSize - used, kRingSize - head);
+    const ssize_t bytes_read = ::read(read_fd_, ring_.data() + head, contiguous);
     if (bytes_read > 0) {
-      read_buffer_.append(chunk, static_cast<std::size_t>(bytes_read));
-      std::size_t newline_pos = read_buffer_.find('\n');
-      while (newline_pos != std::string::npos) {
-        std::string line = read_buffer_.substr(0, newline_pos);
-        read_buffer_.erase(0, newline_pos + 1);
-        try {
-          parsed_at_least_one_line = parse_line(line) || parsed_at_least_one_line;
-        } catch (...) {
-          disable_non_blocking();
-          return false;
-        }
-        newline_pos = read_buffer_.find('\n');
-      }
+      ring_head_ += static_cast<std::size_t>(bytes_read);
+      parsed_at_least_one_line = drain_lines() || parsed_at_least_one_line;
       continue;
     }
 
@@ -101,6 +170,10 @@ bool TegraStatsSensor::sample(model::signal_frame& frame) noexcept {
       return false;
     }
 
+    if (errno == EINTR) {
+      continue;
+    }
+
     if (errno == EAGAIN || errno == EWOULDBLOCK) {
       break;
     }
@@ -109,7 +182,7 @@ bool TegraStatsSensor::sample(model::signal_frame& frame) noexcept {
     return false;
   }
 
-  if (!parsed_at_least_one_line) {
+  if (!parsed_at_least_one_line && child_pid_ > 0) {
     int status = 0;
     const pid_t wait_result = waitpid(child_pid_, &status, WNOHANG);
     if (wait_result == child_pid_) {
@@ -122,10 +195,9 @@ bool TegraStatsSensor::sample(model::signal_frame& frame) noexcept {
   frame.tegra_gpu_util = raw_.gpu_util_pct;
   frame.tegra_emc_util = raw_.emc_util_pct;
 
-  const auto gpu_temp_it = raw_.temperatures_c.find("GPU");
-  if (gpu_temp_it != raw_.temperatures_c.end()) {
-    frame.gpu_temp = gpu_temp_it->second;
-    frame.tegra_gpu_temp = gpu_temp_it->second;
+  if (const float* gpu_temp = raw_.temperatures_c.find("GPU"); gpu_temp != nullptr) {
+    frame.gpu_temp = *gpu_temp;
+    frame.tegra_gpu_temp = *gpu_temp;
   }
 
   if (raw_.total_rail_power_mw > 0.0F) {
@@ -136,6 +208,42 @@ bool TegraStatsSensor::sample(model::signal_frame& frame) noexcept {
   return true;
 }
 
+bool TegraStatsSensor::drain_lines() noexcept {
+  bool parsed_any = false;
+
+  // Search the unscanned bytes for newlines, at most two contiguous segments of the ring.
+  while (ring_scanned_ < ring_head_) {
+    const std::size_t offset = ring_scanned_ & (kRingSize - 1);
+    const std::size_t span = std::min(ring_head_ - ring_scanned_, kRingSize - offset);
+    const void* newline = std::memchr(ring_.data() + offset, '\n', span);
+    if (newline == nullptr) {
+      ring_scanned_ += span;
+      continue;
+    }
+
+    const std::size_t line_end = ring_scanned_ + static_cast<std::size_t>(static_cast<const char*>(newline) - (ring_.data() + offset));
+    const std::size_t line_size = line_end - ring_tail_;
+    const std::size_t line_start = ring_tail_ & (kRingSize - 1);
+
+    if (discarding_line_) {
+      discarding_line_ = false;
+    } else if (line_start + line_size <= kRingSize) {
+      parsed_any = parse_line(std::string_view(ring_.data() + line_start, line_size)) || parsed_any;
+    } else {
+      // Only lines that wrap around the end of the ring are copied.
+      const std::size_t first = kRingSize - line_start;
+      std::memcpy(line_scratch_.data(), ring_.data() + line_start, first);
+      std::memcpy(line_scratch_.data() + first, ring_.data(), line_size - first);
+      parsed_any = parse_line(std::string_view(line_scratch_.data(), line_size)) || parsed_any;
+    }
+
+    ring_tail_ = line_end + 1;
+    ring_scanned_ = ring_tail_;
+  }
+
+  return parsed_any;
+}
+
 bool TegraStatsSensor::enabled() const noexcept { return enabled_; }
 
 const TegraStatsSensor::RawFields& TegraStatsSensor::raw() const noexcept { return raw_; }
@@ -192,7 +300,9 @@ bool TegraStatsSensor::launch(const std::uint32_t interval_ms) noexcept {
 
 void TegraStatsSensor::disable() noexcept {
   if (read_fd_ >= 0) {
-    close(read_fd_);
+    if (owns_fd_) {
+      close(read_fd_);
+    }
     read_fd_ = -1;
   }
 
@@ -204,69 +314,54 @@ void TegraStatsSensor::disable() noexcept {
   enabled_ = false;
 }
 
-void TegraStatsSensor::disable_non_blocking() noexcept {
-  if (read_fd_ >= 0) {
-    close(read_fd_);
-    read_fd_ = -1;
-  }
-
-  if (child_pid_ > 0) {
-    kill(child_pid_, SIGTERM);
-    int status = 0;
-    const pid_t wait_result = waitpid(child_pid_, &status, WNOHANG);
-    if (wait_result == child_pid_ || wait_result < 0) {
-      child_pid_ = -1;
-    }
-  }
-
-  enabled_ = false;
-}
-
-bool TegraStatsSensor::parse_line(const std::string& line) {
+bool TegraStatsSensor::parse_line(const std::string_view line) noexcept {
   bool parsed_any = false;
-
-  std::smatch match;
-  if (std::regex_search(line, match, kGpuRe) && match.size() >= 2) {
-    raw_.gpu_util_pct = static_cast<float>(parse_int_or_zero(match[1].str()));
-    parsed_any = true;
-  }
-
-  if (std::regex_search(line, match, kEmcRe) && match.size() >= 2) {
-    raw_.emc_util_pct = static_cast<float>(parse_int_or_zero(match[1].str()));
-    parsed_any = true;
-  }
-
-  float rail_sum = 0.0F;
+  bool found_gpu = false;
+  bool found_emc = false;
   bool parsed_rail = false;
-  for (std::sregex_iterator it(line.begin(), line.end(), kRailRe), end; it != end; ++it) {
-    if ((*it).size() < 3) {
-      continue;
+  float rail_sum = 0.0F;
+
+  std::string_view previous;
+  std::size_t pos = 0;
+  while (pos < line.size()) {
+    while (pos < line.size() && is_space(line[pos])) {
+      ++pos;
+    }
+    const std::size_t start = pos;
+    while (pos < line.size() && !is_space(line[pos])) {
+      ++pos;
+    }
+    if (start == pos) {
+      break;
+    }
+    const std::string_view token = line.substr(start, pos - start);
+
+    int value = 0;
+    std::string_view name;
+    float temperature = 0.0F;
+    if (!found_gpu && (previous == "GR3D_FREQ" || previous == "GPU") && parse_percent(token, value)) {
+      raw_.gpu_util_pct = static_cast<float>(value);
+      found_gpu = true;
+    } else if (!found_emc && previous == "EMC_FREQ" && parse_percent(token, value)) {
+      raw_.emc_util_pct = static_cast<float>(value);
+      found_emc = true;
+    } else if (is_rail_name(previous) && parse_milliwatts(token, value)) {
+      raw_.rail_power_mw.set(previous, static_cast<float>(value));
+      rail_sum += static_cast<float>(value);
+      parsed_rail = true;
+    } else if (parse_temperature(token, name, temperature)) {
+      raw_.temperatures_c.set(name, temperature);
+      parsed_any = true;
     }
 
-    const std::string rail_name = (*it)[1].str();
-    const std::string instantaneous = (*it)[2].str();
-    const float rail_power = static_cast<float>(parse_int_or_zero(instantaneous));
-    raw_.rail_power_mw[rail_name] = rail_power;
-    rail_sum += rail_power;
-    parsed_rail = true;
+    previous = token;
   }
+
   if (parsed_rail) {
     raw_.total_rail_power_mw = rail_sum;
-    parsed_any = true;
   }
 
-  bool parsed_temp = false;
-  for (std::sregex_iterator it(line.begin(), line.end(), kTempRe), end; it != end; ++it) {
-    if ((*it).size() < 3) {
-      continue;
-    }
-
-    raw_.temperatures_c[(*it)[1].str()] = parse_float((*it)[2].str());
-    parsed_temp = true;
-  }
-  parsed_any = parsed_any || parsed_temp;
-
-  return parsed_any;
+  return parsed_any || found_gpu || found_emc || parsed_rail;
 }
 
 }  // namespace hw_agent::sensors
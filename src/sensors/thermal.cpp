@@ -1,31 +1,90 @@
 #include "sensors/thermal.hpp"
 
+#include "core/file_io.hpp"
+
 #include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <limits>
-#include <memory>
+#include <string_view>
 #include <utility>
 
 namespace hw_agent::sensors {
 
 namespace {
 constexpr const char* kSysClassThermal = "/sys/class/thermal";
+constexpr const char* kSysClassHwmon = "/sys/class/hwmon";
+// Below this rate a zone is treated as flat rather than projected toward its trip.
+constexpr float kMinWarmingSlopeCPerS = 0.01F;
+
+float read_millidegrees_c(const std::filesystem::path& path) {
+  std::ifstream input(path);
+  long long raw_temp = 0;
+  if (!input.is_open() || !(input >> raw_temp)) {
+    return 0.0F;
+  }
+  return static_cast<float>(raw_temp) / 1000.0F;
 }
 
+std::string read_first_line(const std::filesystem::path& path, std::string fallback) {
+  std::ifstream input(path);
+  std::string line;
+  if (!input.is_open() || !std::getline(input, line) || line.empty()) {
+    return fallback;
+  }
+  return line;
+}
+
+// Lowest trip that throttles or shuts down the zone; active trips only step fans and are ignored.
+float lowest_zone_trip_c(const std::filesystem::path& zone_path) {
+  float lowest = 0.0F;
+  for (int index = 0;; ++index) {
+    const std::string prefix = "trip_point_" + std::to_string(index) + "_";
+    const std::filesystem::path type_path = zone_path / (prefix + "type");
+    if (!std::filesystem::exists(type_path)) {
+      break;
+    }
+
+    const std::string type = read_first_line(type_path, "");
+    if (type != "passive" && type != "hot" && type != "critical") {
+      continue;
+    }
+
+    const float trip_c = read_millidegrees_c(zone_path / (prefix + "temp"));
+    if (trip_c > 0.0F && (lowest <= 0.0F || trip_c < lowest)) {
+      lowest = trip_c;
+    }
+  }
+  return lowest;
+}
+
+}  // namespace
+
 ThermalSensor::ThermalSensor(const float throttle_temp_c) : owns_files_(true) {
   raw_.throttle_temp_c = throttle_temp_c;
   discover_zones(kSysClassThermal);
+  discover_hwmon(kSysClassHwmon);
+  history_.resize(zones_.size());
 }
 
 ThermalSensor::ThermalSensor(const float throttle_temp_c, std::string thermal_root) : owns_files_(true) {
   raw_.throttle_temp_c = throttle_temp_c;
   discover_zones(thermal_root);
+  history_.resize(zones_.size());
+}
+
+ThermalSensor::ThermalSensor(const float throttle_temp_c, std::string thermal_root, std::string hwmon_root)
+    : owns_files_(true) {
+  raw_.throttle_temp_c = throttle_temp_c;
+  discover_zones(thermal_root);
+  discover_hwmon(hwmon_root);
+  history_.resize(zones_.size());
 }
 
 ThermalSensor::ThermalSensor(const float throttle_temp_c, std::vector<ZoneSource> zones, const bool owns_files)
     : zones_(std::move(zones)), owns_files_(owns_files) {
   raw_.throttle_temp_c = throttle_temp_c;
+  history_.resize(zones_.size());
 }
 
 void ThermalSensor::discover_zones(const std::string& thermal_root) {
@@ -46,31 +105,58 @@ void ThermalSensor::discover_zones(const std::string& thermal_root) {
 
       const std::filesystem::path zone_path = entry.path();
 
-      std::ifstream type_file(zone_path / "type");
-      std::string zone_name = name;
-      if (type_file.is_open()) {
-        std::getline(type_file, zone_name);
-      }
-
       ZoneSource source{};
-      source.name = zone_name;
+      source.name = read_first_line(zone_path / "type", name);
       source.temp_path = (zone_path / "temp").string();
+      source.trip_temp_c = lowest_zone_trip_c(zone_path);
+      source.file = std::fopen(source.temp_path.c_str(), "r");
+
+      zones_.push_back(source);
+    }
+  } catch (const std::filesystem::filesystem_error&) {
+    zones_.clear();
+  }
+}
 
-      auto file_closer = [](std::FILE* file) {
-        if (file != nullptr) {
-          std::fclose(file);
+void ThermalSensor::discover_hwmon(const std::string& hwmon_root) {
+  try {
+    if (!std::filesystem::exists(hwmon_root)) {
+      return;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(hwmon_root)) {
+      if (!entry.is_directory()) {
+        continue;
+      }
+
+      const std::filesystem::path hwmon_path = entry.path();
+      const std::string chip = read_first_line(hwmon_path / "name", hwmon_path.filename().string());
+
+      for (const auto& input : std::filesystem::directory_iterator(hwmon_path)) {
+        const std::string file_name = input.path().filename().string();
+        constexpr std::string_view kSuffix = "_input";
+        if (file_name.rfind("temp", 0) != 0 || file_name.size() <= kSuffix.size() ||
+            file_name.compare(file_name.size() - kSuffix.size(), kSuffix.size(), kSuffix) != 0) {
+          continue;
         }
-      };
-      using file_ptr = std::unique_ptr<std::FILE, decltype(file_closer)>;
 
-      file_ptr file(std::fopen(source.temp_path.c_str(), "r"), file_closer);
-      source.file = file.get();
+        // e.g. "temp3" for temp3_input / temp3_label / temp3_max / temp3_crit.
+        const std::string channel = file_name.substr(0, file_name.size() - kSuffix.size());
 
-      zones_.push_back(source);
-      file.release();
+        ZoneSource source{};
+        source.name = chip + ":" + read_first_line(hwmon_path / (channel + "_label"), channel);
+        source.temp_path = input.path().string();
+        source.trip_temp_c = read_millidegrees_c(hwmon_path / (channel + "_max"));
+        if (source.trip_temp_c <= 0.0F) {
+          source.trip_temp_c = read_millidegrees_c(hwmon_path / (channel + "_crit"));
+        }
+        source.file = std::fopen(source.temp_path.c_str(), "r");
+
+        zones_.push_back(source);
+      }
     }
   } catch (const std::filesystem::filesystem_error&) {
-    zones_.clear();
+    // Keep any thermal zones already discovered; hwmon is an additional source.
   }
 }
 
@@ -90,9 +176,16 @@ ThermalSensor::~ThermalSensor() {
 bool ThermalSensor::sample(model::signal_frame& frame) noexcept {
   raw_.hottest_zone.clear();
   raw_.hottest_temp_c = 0.0F;
+  raw_.limiting_zone.clear();
+  raw_.limiting_trip_c = 0.0F;
+  raw_.max_slope_c_per_s = 0.0F;
 
   float max_temp_c = -std::numeric_limits<float>::infinity();
   std::size_t max_index = 0;
+  float min_headroom_c = std::numeric_limits<float>::infinity();
+  std::size_t limiting_index = 0;
+  float min_seconds_to_trip = kMaxSecondsToTrip;
+  bool any_slope = false;
 
   for (std::size_t i = 0; i < zones_.size(); ++i) {
     ZoneSource& zone = zones_[i];
@@ -123,17 +216,55 @@ bool ThermalSensor::sample(model::signal_frame& frame) noexcept {
       max_temp_c = zone_temp_c;
       max_index = i;
     }
+
+    const float trip_c = zone.trip_temp_c > 0.0F ? zone.trip_temp_c : raw_.throttle_temp_c;
+    const float headroom_c = trip_c - zone_temp_c;
+    if (headroom_c < min_headroom_c) {
+      min_headroom_c = headroom_c;
+      limiting_index = i;
+    }
+
+    ZoneHistory& history = history_[i];
+    history.temp_c[history.next] = zone_temp_c;
+    history.timestamp_ns[history.next] = frame.monotonic_ns;
+    history.next = (history.next + 1) % kSlopeWindow;
+    if (history.count < kSlopeWindow) {
+      ++history.count;
+    }
+
+    const float slope = slope_c_per_s(history);
+    if (!any_slope || slope > raw_.max_slope_c_per_s) {
+      raw_.max_slope_c_per_s = slope;
+      any_slope = true;
+    }
+
+    if (headroom_c <= 0.0F) {
+      min_seconds_to_trip = 0.0F;
+    } else if (slope > kMinWarmingSlopeCPerS) {
+      const float seconds = headroom_c / slope;
+      if (seconds < min_seconds_to_trip) {
+        min_seconds_to_trip = seconds;
+      }
+    }
   }
 
-  if (std::isfinite(max_temp_c)) {
+  const bool ok = std::isfinite(max_temp_c);
+  if (ok) {
     raw_.hottest_temp_c = max_temp_c;
     raw_.hottest_zone = zones_[max_index].name;
-    raw_.headroom_c = raw_.throttle_temp_c - raw_.hottest_temp_c;
+    raw_.limiting_zone = zones_[limiting_index].name;
+    raw_.limiting_trip_c = zones_[limiting_index].trip_temp_c > 0.0F ? zones_[limiting_index].trip_temp_c
+                                                                     : raw_.throttle_temp_c;
+    raw_.headroom_c = min_headroom_c;
+    raw_.seconds_to_trip = min_seconds_to_trip;
   } else {
     raw_.headroom_c = 0.0F;
+    raw_.seconds_to_trip = kMaxSecondsToTrip;
   }
   frame.thermal = raw_.headroom_c;
-  return std::isfinite(max_temp_c);
+  frame.thermal_slope = raw_.max_slope_c_per_s;
+  frame.thermal_seconds_to_trip = raw_.seconds_to_trip;
+  return ok;
 }
 
 void ThermalSensor::set_throttle_temp_c(const float throttle_temp_c) noexcept {
@@ -142,13 +273,15 @@ void ThermalSensor::set_throttle_temp_c(const float throttle_temp_c) noexcept {
 
 const ThermalSensor::RawFields& ThermalSensor::raw() const noexcept { return raw_; }
 
+const std::vector<ThermalSensor::ZoneSource>& ThermalSensor::zones() const noexcept { return zones_; }
+
 bool ThermalSensor::read_temp_c(std::FILE* file, float& temp_c) noexcept {
   if (file == nullptr) {
     temp_c = -std::numeric_limits<float>::infinity();
     return false;
   }
 
-  if (std::fseek(file, 0L, SEEK_SET) != 0) {
+  if (!core::rewind_file(file)) {
     temp_c = -std::numeric_limits<float>::infinity();
     return false;
   }
@@ -164,4 +297,40 @@ bool ThermalSensor::read_temp_c(std::FILE* file, float& temp_c) noexcept {
   return true;
 }
 
+float ThermalSensor::slope_c_per_s(const ZoneHistory& history) noexcept {
+  if (history.count < 2) {
+    return 0.0F;
+  }
+
+  // Least-squares fit over the window; timestamps are taken relative to the oldest sample.
+  const std::size_t oldest = (history.next + kSlopeWindow - history.count) % kSlopeWindow;
+  const std::uint64_t origin_ns = history.timestamp_ns[oldest];
+
+  double sum_t = 0.0;
+  double sum_y = 0.0;
+  for (std::size_t n = 0; n < history.count; ++n) {
+    const std::size_t index = (oldest + n) % kSlopeWindow;
+    sum_t += static_cast<double>(history.timestamp_ns[index] - origin_ns) / 1'000'000'000.0;
+    sum_y += static_cast<double>(history.temp_c[index]);
+  }
+
+  const double count = static_cast<double>(history.count);
+  const double mean_t = sum_t / count;
+  const double mean_y = sum_y / count;
+
+  double covariance = 0.0;
+  double variance = 0.0;
+  for (std::size_t n = 0; n < history.count; ++n) {
+    const std::size_t index = (oldest + n) % kSlopeWindow;
+    const double dt = (static_cast<double>(history.timestamp_ns[index] - origin_ns) / 1'000'000'000.0) - mean_t;
+    covariance += dt * (static_cast<double>(history.temp_c[index]) - mean_y);
+    variance += dt * dt;
+  }
+
+  if (variance <= 0.0) {
+    return 0.0F;
+  }
+  return static_cast<float>(covariance / variance);
+}
+
 }  // namespace hw_agent::sensors
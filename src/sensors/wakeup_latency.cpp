@@ -0,0 +1,232 @@
+#include "sensors/wakeup_latency.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include <utility>
+
+#include <pthread.h>
+
+namespace hw_agent::sensors {
+
+namespace {
+
+std::uint64_t to_ns(const timespec& value) noexcept {
+  return (static_cast<std::uint64_t>(value.tv_sec) * 1'000'000'000ULL) + static_cast<std::uint64_t>(value.tv_nsec);
+}
+
+void advance(timespec& value, const long interval_ns) noexcept {
+  value.tv_nsec += interval_ns;
+  while (value.tv_nsec >= 1'000'000'000L) {
+    value.tv_nsec -= 1'000'000'000L;
+    ++value.tv_sec;
+  }
+}
+
+float to_us(const std::uint64_t value_ns) noexcept { return static_cast<float>(static_cast<double>(value_ns) / 1000.0); }
+
+}  // namespace
+
+void LatencyHistogram::record(const std::uint64_t value_ns) noexcept {
+  // Single writer: a plain load/store pair avoids a locked read-modify-write on every wakeup.
+  std::atomic<std::uint64_t>& count = counts_[bucket_index(value_ns)];
+  count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  if (value_ns > max_ns_.load(std::memory_order_relaxed)) {
+    max_ns_.store(value_ns, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::snapshot(Snapshot& out) const noexcept {
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    out[i] = counts_[i].load(std::memory_order_relaxed);
+  }
+}
+
+std::uint64_t LatencyHistogram::take_max() noexcept { return max_ns_.exchange(0, std::memory_order_relaxed); }
+
+std::size_t LatencyHistogram::bucket_index(const std::uint64_t value_ns) noexcept {
+  if (value_ns < kSubBucketCount) {
+    return static_cast<std::size_t>(value_ns);
+  }
+
+  // Keep the top kSubBucketBits bits: the exponent picks a power-of-two range, the mantissa one of
+  // kHalfSubBucketCount linear steps inside it.
+  const unsigned msb = 63U - static_cast<unsigned>(std::countl_zero(value_ns));
+  const unsigned exponent = msb - (kSubBucketBits - 1);
+  if (exponent > kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  const std::uint64_t mantissa = value_ns >> exponent;
+  return static_cast<std::size_t>(kSubBucketCount + ((exponent - 1) * kHalfSubBucketCount) +
+                                  (mantissa - kHalfSubBucketCount));
+}
+
+std::uint64_t LatencyHistogram::bucket_upper_bound(const std::size_t bucket) noexcept {
+  if (bucket < kSubBucketCount) {
+    return bucket;
+  }
+  const std::size_t offset = bucket - kSubBucketCount;
+  const unsigned exponent = static_cast<unsigned>(offset / kHalfSubBucketCount) + 1;
+  const std::uint64_t mantissa = (offset % kHalfSubBucketCount) + kHalfSubBucketCount;
+  return ((mantissa + 1) << exponent) - 1;
+}
+
+std::uint64_t LatencyHistogram::percentile(const Snapshot& counts, const std::uint64_t total,
+                                           const double quantile) noexcept {
+  if (total == 0) {
+    return 0;
+  }
+
+  const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(total))));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return bucket_upper_bound(i);
+    }
+  }
+  return bucket_upper_bound(kBucketCount - 1);
+}
+
+WakeupLatencyProbe::WakeupLatencyProbe(WakeupLatencyOptions options) : options_(std::move(options)) {
+  if (options_.cpus.empty()) {
+    options_.cpus.push_back(0);
+  }
+  for (const int cpu : options_.cpus) {
+    auto probe = std::make_unique<CpuProbe>();
+    probe->cpu = cpu;
+    probes_.push_back(std::move(probe));
+  }
+  raw_.per_cpu.resize(probes_.size());
+}
+
+WakeupLatencyProbe::~WakeupLatencyProbe() { stop(); }
+
+void WakeupLatencyProbe::start() {
+  if (running_.exchange(true)) {
+    return;
+  }
+  for (auto& probe : probes_) {
+    probe->thread = std::thread([this, raw_probe = probe.get()]() { run(*raw_probe); });
+  }
+}
+
+void WakeupLatencyProbe::stop() noexcept {
+  running_.store(false, std::memory_order_relaxed);
+  for (auto& probe : probes_) {
+    if (probe->thread.joinable()) {
+      probe->thread.join();
+    }
+  }
+}
+
+void WakeupLatencyProbe::run(CpuProbe& probe) noexcept {
+  const pthread_t self = ::pthread_self();
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(probe.cpu, &cpus);
+  if (const int rc = ::pthread_setaffinity_np(self, sizeof(cpus), &cpus); rc != 0) {
+    probe.setup_errno.store(rc, std::memory_order_relaxed);
+  }
+
+  if (options_.policy != SCHED_OTHER) {
+    sched_param param{};
+    param.sched_priority = options_.priority;
+    const int rc = ::pthread_setschedparam(self, options_.policy, &param);
+    if (rc == 0) {
+      probe.realtime.store(true, std::memory_order_relaxed);
+    } else if (probe.setup_errno.load(std::memory_order_relaxed) == 0) {
+      probe.setup_errno.store(rc, std::memory_order_relaxed);
+    }
+  }
+
+  const long interval_ns = static_cast<long>(std::chrono::nanoseconds(options_.interval).count());
+  timespec next{};
+  ::clock_gettime(CLOCK_MONOTONIC, &next);
+
+  while (running_.load(std::memory_order_relaxed)) {
+    advance(next, interval_ns);
+    int rc = 0;
+    do {
+      rc = ::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+    } while (rc == EINTR);
+
+    timespec now{};
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    const std::uint64_t deadline_ns = to_ns(next);
+    const std::uint64_t now_ns = to_ns(now);
+    const std::uint64_t overshoot_ns = now_ns > deadline_ns ? now_ns - deadline_ns : 0;
+    probe.histogram.record(overshoot_ns);
+
+    // After a stall longer than one period, restart from now instead of firing catch-up wakeups.
+    if (overshoot_ns > static_cast<std::uint64_t>(interval_ns)) {
+      next = now;
+    }
+  }
+}
+
+bool WakeupLatencyProbe::sample(model::signal_frame& frame) noexcept {
+  float p50_us = 0.0F;
+  float p99_us = 0.0F;
+  float p999_us = 0.0F;
+  float max_us = 0.0F;
+  bool any_samples = false;
+
+  raw_.realtime_threads = 0;
+  for (std::size_t i = 0; i < probes_.size(); ++i) {
+    CpuProbe& probe = *probes_[i];
+    CpuLatency& latency = raw_.per_cpu[i];
+    latency = CpuLatency{};
+    latency.cpu = probe.cpu;
+
+    if (probe.realtime.load(std::memory_order_relaxed)) {
+      ++raw_.realtime_threads;
+    }
+    if (raw_.setup_errno == 0) {
+      raw_.setup_errno = probe.setup_errno.load(std::memory_order_relaxed);
+    }
+
+    // Snapshot into window, then turn it into this window's counts in place.
+    probe.histogram.snapshot(probe.window);
+    std::uint64_t total = 0;
+    for (std::size_t b = 0; b < LatencyHistogram::kBucketCount; ++b) {
+      const std::uint64_t cumulative = probe.window[b];
+      probe.window[b] = cumulative >= probe.previous[b] ? cumulative - probe.previous[b] : 0;
+      probe.previous[b] = cumulative;
+      total += probe.window[b];
+    }
+    const std::uint64_t window_max_ns = probe.histogram.take_max();
+    if (total == 0) {
+      continue;
+    }
+    any_samples = true;
+
+    // Bucket upper bounds can overshoot the largest value actually seen.
+    const auto bounded = [&](const double quantile) {
+      return to_us(std::min(LatencyHistogram::percentile(probe.window, total, quantile), window_max_ns));
+    };
+    latency.samples = total;
+    latency.p50_us = bounded(0.50);
+    latency.p99_us = bounded(0.99);
+    latency.p999_us = bounded(0.999);
+    latency.max_us = to_us(window_max_ns);
+
+    p50_us = std::max(p50_us, latency.p50_us);
+    p99_us = std::max(p99_us, latency.p99_us);
+    p999_us = std::max(p999_us, latency.p999_us);
+    max_us = std::max(max_us, latency.max_us);
+  }
+
+  frame.wakeup_latency_p50_us = p50_us;
+  frame.wakeup_latency_p99_us = p99_us;
+  frame.wakeup_latency_p999_us = p999_us;
+  frame.wakeup_latency_max_us = max_us;
+  return any_samples;
+}
+
+const WakeupLatencyProbe::RawFields& WakeupLatencyProbe::raw() const noexcept { return raw_; }
+
+}  // namespace hw_agent::sensors
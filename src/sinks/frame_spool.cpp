@@ -0,0 +1,159 @@
+#include "sinks/frame_spool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hw_agent::sinks {
+namespace {
+
+constexpr char kMagic[8] = {'H', 'W', 'S', 'P', 'O', 'O', 'L', '1'};
+
+}  // namespace
+
+struct FrameSpool::Header {
+  char magic[8];
+  std::uint64_t layout;
+  std::uint64_t values_per_frame;
+  std::uint64_t capacity;
+  // Sequence number of the oldest frame; its slot is first_sequence % capacity.
+  std::uint64_t first_sequence;
+  std::uint64_t count;
+  std::uint64_t overwritten;
+  std::uint64_t reserved;
+};
+
+FrameSpool::FrameSpool(const std::string& path, const std::uint64_t layout, const std::size_t values_per_frame,
+                       const std::size_t max_bytes) {
+  record_bytes_ = sizeof(std::uint64_t) + (values_per_frame * sizeof(double));
+  if (max_bytes < sizeof(Header) + record_bytes_) {
+    std::cerr << "[spool] " << path << ": size cap below one frame\n";
+    return;
+  }
+  const std::uint64_t capacity = (max_bytes - sizeof(Header)) / record_bytes_;
+  const std::size_t bytes = sizeof(Header) + (capacity * record_bytes_);
+
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    std::cerr << "[spool] cannot open " << path << ": " << std::strerror(errno) << '\n';
+    return;
+  }
+  struct stat info {};
+  const bool existing = ::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) == bytes;
+  if (!existing && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+    std::cerr << "[spool] cannot size " << path << ": " << std::strerror(errno) << '\n';
+    ::close(fd);
+    return;
+  }
+  void* mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    std::cerr << "[spool] cannot map " << path << ": " << std::strerror(errno) << '\n';
+    return;
+  }
+
+  header_ = static_cast<Header*>(mapped);
+  mapped_bytes_ = bytes;
+  if (!existing || std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 || header_->layout != layout ||
+      header_->values_per_frame != values_per_frame || header_->capacity != capacity ||
+      header_->count > capacity) {
+    std::memset(header_, 0, sizeof(Header));
+    std::memcpy(header_->magic, kMagic, sizeof(kMagic));
+    header_->layout = layout;
+    header_->values_per_frame = values_per_frame;
+    header_->capacity = capacity;
+  }
+}
+
+FrameSpool::~FrameSpool() { close(); }
+
+FrameSpool::FrameSpool(FrameSpool&& other) noexcept
+    : header_(std::exchange(other.header_, nullptr)),
+      mapped_bytes_(std::exchange(other.mapped_bytes_, 0)),
+      record_bytes_(std::exchange(other.record_bytes_, 0)) {}
+
+FrameSpool& FrameSpool::operator=(FrameSpool&& other) noexcept {
+  if (this != &other) {
+    close();
+    header_ = std::exchange(other.header_, nullptr);
+    mapped_bytes_ = std::exchange(other.mapped_bytes_, 0);
+    record_bytes_ = std::exchange(other.record_bytes_, 0);
+  }
+  return *this;
+}
+
+void FrameSpool::close() noexcept {
+  if (header_ != nullptr) {
+    ::munmap(header_, mapped_bytes_);
+    header_ = nullptr;
+  }
+}
+
+std::size_t FrameSpool::size() const noexcept { return header_ != nullptr ? header_->count : 0; }
+
+std::size_t FrameSpool::capacity() const noexcept { return header_ != nullptr ? header_->capacity : 0; }
+
+std::uint64_t FrameSpool::overwritten() const noexcept { return header_ != nullptr ? header_->overwritten : 0; }
+
+std::uint64_t FrameSpool::first_sequence() const noexcept {
+  return header_ != nullptr ? header_->first_sequence : 0;
+}
+
+unsigned char* FrameSpool::record(const std::uint64_t slot) const noexcept {
+  return reinterpret_cast<unsigned char*>(header_ + 1) + (slot * record_bytes_);
+}
+
+void FrameSpool::push(const std::uint64_t timestamp_ms, const double* values) noexcept {
+  if (header_ == nullptr) {
+    return;
+  }
+  if (header_->count == header_->capacity) {
+    ++header_->first_sequence;
+    --header_->count;
+    ++header_->overwritten;
+  }
+  // The record is complete before count covers it, so a crash mid-write loses only that frame.
+  unsigned char* out = record((header_->first_sequence + header_->count) % header_->capacity);
+  std::memcpy(out, &timestamp_ms, sizeof(timestamp_ms));
+  std::memcpy(out + sizeof(timestamp_ms), values, record_bytes_ - sizeof(timestamp_ms));
+  ++header_->count;
+}
+
+bool FrameSpool::read(const std::size_t index, std::uint64_t& timestamp_ms, double* values) const noexcept {
+  if (header_ == nullptr || index >= header_->count) {
+    return false;
+  }
+  const unsigned char* in = record((header_->first_sequence + index) % header_->capacity);
+  std::memcpy(&timestamp_ms, in, sizeof(timestamp_ms));
+  std::memcpy(values, in + sizeof(timestamp_ms), record_bytes_ - sizeof(timestamp_ms));
+  return true;
+}
+
+void FrameSpool::release_until(const std::uint64_t sequence) noexcept {
+  if (header_ == nullptr || sequence <= header_->first_sequence) {
+    return;
+  }
+  const std::uint64_t released = std::min<std::uint64_t>(sequence - header_->first_sequence, header_->count);
+  header_->first_sequence += released;
+  header_->count -= released;
+}
+
+std::uint64_t FrameSpool::layout_hash(const std::vector<std::string>& keys) noexcept {
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const std::string& key : keys) {
+    for (const char ch : key) {
+      hash = (hash ^ static_cast<unsigned char>(ch)) * 1099511628211ULL;
+    }
+    hash = (hash ^ 0xFFU) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // namespace hw_agent::sinks
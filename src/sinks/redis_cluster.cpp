@@ -0,0 +1,136 @@
+#include "sinks/redis_cluster.hpp"
+
+#include <charconv>
+#include <utility>
+
+#include <hiredis/hiredis.h>
+
+namespace hw_agent::sinks {
+namespace {
+
+// CRC16-CCITT (XMODEM): polynomial 0x1021, initial value 0, as in the Redis Cluster spec.
+std::uint16_t crc16(const std::string_view data) noexcept {
+  std::uint16_t crc = 0;
+  for (const char ch : data) {
+    crc ^= static_cast<std::uint16_t>(static_cast<unsigned char>(ch) << 8);
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000U) != 0 ? static_cast<std::uint16_t>((crc << 1) ^ 0x1021U) : static_cast<std::uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+template <typename T>
+bool parse_number(const std::string_view text, T& value) {
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc{} && end == text.data() + text.size();
+}
+
+}  // namespace
+
+std::uint16_t cluster_key_slot(const std::string_view key) noexcept {
+  // Only the first '{' counts, and an empty "{}" hashes the whole key.
+  const auto open = key.find('{');
+  if (open != std::string_view::npos) {
+    const auto close = key.find('}', open + 1);
+    if (close != std::string_view::npos && close != open + 1) {
+      return crc16(key.substr(open + 1, close - open - 1)) % kClusterSlots;
+    }
+  }
+  return crc16(key) % kClusterSlots;
+}
+
+bool parse_cluster_redirect(const std::string_view message, ClusterRedirect& redirect) {
+  std::string_view rest;
+  if (message.rfind("MOVED ", 0) == 0) {
+    redirect.ask = false;
+    rest = message.substr(6);
+  } else if (message.rfind("ASK ", 0) == 0) {
+    redirect.ask = true;
+    rest = message.substr(4);
+  } else {
+    return false;
+  }
+
+  const auto space = rest.find(' ');
+  // The port follows the last ':' so IPv6 hosts keep their colons.
+  const auto colon = rest.rfind(':');
+  if (space == std::string_view::npos || colon == std::string_view::npos || colon < space) {
+    return false;
+  }
+  unsigned slot = 0;
+  unsigned port = 0;
+  if (!parse_number(rest.substr(0, space), slot) || slot >= kClusterSlots ||
+      !parse_number(rest.substr(colon + 1), port) || port == 0 || port > 65535) {
+    return false;
+  }
+  redirect.slot = static_cast<std::uint16_t>(slot);
+  redirect.endpoint.host.assign(rest.substr(space + 1, colon - space - 1));
+  redirect.endpoint.port = static_cast<std::uint16_t>(port);
+  return true;
+}
+
+bool ClusterSlotMap::update(const redisReply* reply, const std::string& fallback_host) {
+  if (reply == nullptr || reply->type != REDIS_REPLY_ARRAY) {
+    return false;
+  }
+
+  // [[first, last, [host, port, id, ...], replicas...], ...]
+  std::vector<Range> ranges;
+  ranges.reserve(reply->elements);
+  for (std::size_t i = 0; i < reply->elements; ++i) {
+    const redisReply* entry = reply->element[i];
+    if (entry == nullptr || entry->type != REDIS_REPLY_ARRAY || entry->elements < 3 ||
+        entry->element[0]->type != REDIS_REPLY_INTEGER || entry->element[1]->type != REDIS_REPLY_INTEGER ||
+        entry->element[2]->type != REDIS_REPLY_ARRAY || entry->element[2]->elements < 2) {
+      return false;
+    }
+    const redisReply* master = entry->element[2];
+    const long long first = entry->element[0]->integer;
+    const long long last = entry->element[1]->integer;
+    const long long port = master->element[1]->type == REDIS_REPLY_INTEGER ? master->element[1]->integer : 0;
+    if (first < 0 || last < first || last >= kClusterSlots || port <= 0 || port > 65535 ||
+        master->element[0]->type != REDIS_REPLY_STRING) {
+      return false;
+    }
+    Range range{static_cast<std::uint16_t>(first), static_cast<std::uint16_t>(last), {}};
+    range.endpoint.host.assign(master->element[0]->str, master->element[0]->len);
+    if (range.endpoint.host.empty() || range.endpoint.host == "?") {
+      range.endpoint.host = fallback_host;
+    }
+    range.endpoint.port = static_cast<std::uint16_t>(port);
+    ranges.push_back(std::move(range));
+  }
+  ranges_ = std::move(ranges);
+  return true;
+}
+
+void ClusterSlotMap::assign(const std::uint16_t slot, const ClusterEndpoint& endpoint) {
+  std::vector<Range> ranges;
+  ranges.reserve(ranges_.size() + 2);
+  for (const Range& range : ranges_) {
+    if (slot < range.first || slot > range.last) {
+      ranges.push_back(range);
+      continue;
+    }
+    if (range.first < slot) {
+      ranges.push_back({range.first, static_cast<std::uint16_t>(slot - 1), range.endpoint});
+    }
+    if (slot < range.last) {
+      ranges.push_back({static_cast<std::uint16_t>(slot + 1), range.last, range.endpoint});
+    }
+  }
+  ranges.push_back({slot, slot, endpoint});
+  ranges_ = std::move(ranges);
+}
+
+const ClusterEndpoint* ClusterSlotMap::owner(const std::uint16_t slot) const noexcept {
+  for (const Range& range : ranges_) {
+    if (slot >= range.first && slot <= range.last) {
+      return &range.endpoint;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace hw_agent::sinks
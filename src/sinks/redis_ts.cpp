@@ -1,86 +1,336 @@
 #include "sinks/redis_ts.hpp"
 
 #include "core/timestamp.hpp"
+#include "model/frame_codec.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdio>
 #include <cstring>
+#include <ctime>
 #include <iostream>
+#include <iterator>
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <hiredis/hiredis.h>
 
 namespace hw_agent::sinks {
 namespace {
 
-constexpr std::size_t kMetricCountBase = 29;
-constexpr std::size_t kMetricCountHealth = 7;
-constexpr std::size_t kMaxMetricCount = kMetricCountBase + kMetricCountHealth;
-constexpr std::size_t kMaxCommandArgCount = 1 + (kMaxMetricCount * 3);
+constexpr const char* kCulpritStreamMaxLen = "256";
+constexpr const char* kGpuWorkloadStreamMaxLen = "1024";
+// Async mode: auxiliary pipelines (per-CPU, per-GPU, streams) are skipped beyond this backlog.
+constexpr std::size_t kMaxPendingReplies = 1024;
+constexpr auto kHistogramPublishInterval = std::chrono::seconds(10);
+// agent:redis_breaker values.
+constexpr std::uint32_t kBreakerClosed = 0;
+constexpr std::uint32_t kBreakerHalfOpen = 1;
+constexpr std::uint32_t kBreakerOpen = 2;
+// Cluster redirects followed without backoff before reconnects fall back to the breaker's pace.
+constexpr std::uint32_t kMaxImmediateRedirects = 4;
+constexpr std::string_view kAskingCommand = "*1\r\n$6\r\nASKING\r\n";
+
+std::string local_host_name() {
+  char name[256] = {};
+  if (::gethostname(name, sizeof(name) - 1) != 0 || name[0] == '\0') {
+    return "localhost";
+  }
+  return name;
+}
 
 double sanitize_value(const float value) {
   return std::isfinite(value) ? static_cast<double>(value) : 0.0;
 }
 
-void add_metric_args(std::vector<std::string>& args, const std::string& key_prefix,
-                     const std::uint64_t timestamp_ms, const char* suffix, const double value) {
-  args.emplace_back(key_prefix + ":" + suffix);
-  args.emplace_back(std::to_string(timestamp_ms));
-  args.emplace_back(std::to_string(value));
+using Frame = model::signal_frame;
+
+// Every TS.MADD series in publish order. Float fields are read through the member pointer; enums,
+// counters and the nested health block through read. sensor names the registry sensor that writes
+// the field (both Jetson backends count as tegrastats); the rest are recomputed every tick.
+struct FrameMetric {
+  const char* suffix;
+  const char* sensor;
+  float Frame::*field;
+  double (*read)(const Frame&);
+};
+
+constexpr FrameMetric kFrameMetrics[] = {
+    {"raw:psi", "psi", &Frame::psi, nullptr},
+    {"raw:psi_memory", "psi", &Frame::psi_memory, nullptr},
+    {"raw:psi_io", "psi", &Frame::psi_io, nullptr},
+    {"raw:cpu", "cpu", &Frame::cpu, nullptr},
+    {"raw:irq", "interrupts", &Frame::irq, nullptr},
+    {"raw:softirqs", "softirqs", &Frame::softirqs, nullptr},
+    {"raw:softnet_squeeze", "softnet", &Frame::softnet_squeeze, nullptr},
+    {"raw:softnet_drops", "softnet", &Frame::softnet_drops, nullptr},
+    {"raw:softnet_hot_cpu", "softnet", &Frame::softnet_hot_cpu, nullptr},
+    {"raw:perf_context_switches", "perf", &Frame::perf_context_switches, nullptr},
+    {"raw:perf_migrations", "perf", &Frame::perf_migrations, nullptr},
+    {"raw:perf_major_faults", "perf", &Frame::perf_major_faults, nullptr},
+    {"raw:perf_ipc", "perf", &Frame::perf_ipc, nullptr},
+    {"raw:perf_llc_misses", "perf", &Frame::perf_llc_misses, nullptr},
+    {"raw:perf_hot_cpu", "perf", &Frame::perf_hot_cpu, nullptr},
+    {"raw:sched_run_delay", "schedstat", &Frame::sched_run_delay, nullptr},
+    {"raw:sched_run_delay_p99", "schedstat", &Frame::sched_run_delay_p99, nullptr},
+    {"raw:sched_run_delay_max", "schedstat", &Frame::sched_run_delay_max, nullptr},
+    {"raw:sched_worst_cpu", "schedstat", &Frame::sched_worst_cpu, nullptr},
+    {"raw:sched_wait_per_slice_us", "schedstat", &Frame::sched_wait_per_slice_us, nullptr},
+    {"raw:wakeup_latency_p50_us", "wakeup_latency", &Frame::wakeup_latency_p50_us, nullptr},
+    {"raw:wakeup_latency_p99_us", "wakeup_latency", &Frame::wakeup_latency_p99_us, nullptr},
+    {"raw:wakeup_latency_p999_us", "wakeup_latency", &Frame::wakeup_latency_p999_us, nullptr},
+    {"raw:wakeup_latency_max_us", "wakeup_latency", &Frame::wakeup_latency_max_us, nullptr},
+    {"raw:memory", "memory", &Frame::memory, nullptr},
+    {"raw:thermal", "thermal", &Frame::thermal, nullptr},
+    {"raw:thermal_slope", "thermal", &Frame::thermal_slope, nullptr},
+    {"raw:thermal_seconds_to_trip", "thermal", &Frame::thermal_seconds_to_trip, nullptr},
+    {"raw:cpufreq", "cpufreq", &Frame::cpufreq, nullptr},
+    {"raw:cpufreq_min_ratio", "cpufreq", &Frame::cpufreq_min_ratio, nullptr},
+    {"raw:cpufreq_avg_ratio", "cpufreq", &Frame::cpufreq_avg_ratio, nullptr},
+    {"raw:cpufreq_capped", "cpufreq", &Frame::cpufreq_capped, nullptr},
+    {"raw:cpufreq_cap_depth", "cpufreq", &Frame::cpufreq_cap_depth, nullptr},
+    {"raw:cpu_throttle_ratio", "cpu_throttle", &Frame::cpu_throttle_ratio, nullptr},
+    {"raw:rapl_package_watts", "powercap", &Frame::rapl_package_watts, nullptr},
+    {"raw:rapl_package_limit_ratio", "powercap", &Frame::rapl_package_limit_ratio, nullptr},
+    {"raw:rapl_dram_watts", "powercap", &Frame::rapl_dram_watts, nullptr},
+    {"raw:rapl_dram_limit_ratio", "powercap", &Frame::rapl_dram_limit_ratio, nullptr},
+    {"raw:disk", "disk", &Frame::disk, nullptr},
+    {"raw:network", "network", &Frame::network, nullptr},
+    {"raw:tcp_retrans", "netstack", &Frame::tcp_retrans, nullptr},
+    {"raw:listen_drops", "netstack", &Frame::listen_drops, nullptr},
+    {"raw:udp_buf_errors", "netstack", &Frame::udp_buf_errors, nullptr},
+    {"raw:tcp_mem_ratio", "netstack", &Frame::tcp_mem_ratio, nullptr},
+    {"raw:nvml_gpu_util", "gpu", &Frame::nvml_gpu_util, nullptr},
+    {"raw:gpu_mem_util", "gpu", &Frame::gpu_mem_util, nullptr},
+    {"raw:tegra_emc_util", "tegrastats", &Frame::tegra_emc_util, nullptr},
+    {"raw:nvml_gpu_temp", "gpu", &Frame::nvml_gpu_temp, nullptr},
+    {"raw:nvml_gpu_power_ratio", "gpu", &Frame::nvml_gpu_power_ratio, nullptr},
+    {"raw:nvml_gpu_devices", "gpu", &Frame::nvml_gpu_devices, nullptr},
+    {"raw:nvml_gpu_throttled", "gpu", &Frame::nvml_gpu_throttled, nullptr},
+    {"raw:nvml_gpu_worst_device", "gpu", &Frame::nvml_gpu_worst_device, nullptr},
+    {"raw:drm_gpu_util", "gpu", &Frame::drm_gpu_util, nullptr},
+    {"raw:drm_gpu_temp", "gpu", &Frame::drm_gpu_temp, nullptr},
+    {"raw:drm_gpu_clock_ratio", "gpu", &Frame::drm_gpu_clock_ratio, nullptr},
+    {"raw:drm_gpu_power_ratio", "gpu", &Frame::drm_gpu_power_ratio, nullptr},
+    {"raw:tegra_gpu_util", "tegrastats", &Frame::tegra_gpu_util, nullptr},
+    {"raw:tegra_gpu_temp", "tegrastats", &Frame::tegra_gpu_temp, nullptr},
+    {"raw:tegra_gpu_power_mw", "tegrastats", &Frame::tegra_gpu_power_mw, nullptr},
+    {"derived:scheduler_pressure", nullptr, &Frame::scheduler_pressure, nullptr},
+    {"derived:memory_pressure", nullptr, &Frame::memory_pressure, nullptr},
+    {"derived:io_pressure", nullptr, &Frame::io_pressure, nullptr},
+    {"derived:thermal_pressure", nullptr, &Frame::thermal_pressure, nullptr},
+    {"derived:power_pressure", nullptr, &Frame::power_pressure, nullptr},
+    {"derived:latency_jitter", nullptr, &Frame::latency_jitter, nullptr},
+    {"risk:realtime_risk", nullptr, &Frame::realtime_risk, nullptr},
+    {"risk:saturation_risk", nullptr, &Frame::saturation_risk, nullptr},
+    {"risk:state", nullptr, nullptr,
+     [](const Frame& frame) { return static_cast<double>(static_cast<std::uint8_t>(frame.state)); }},
+    {"agent:heartbeat", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.heartbeat_ms); }},
+    {"agent:loop_jitter", nullptr, nullptr, [](const Frame& frame) { return sanitize_value(frame.agent.loop_jitter_ms); }},
+    {"agent:compute_time", nullptr, nullptr, [](const Frame& frame) { return sanitize_value(frame.agent.compute_time_ms); }},
+    {"agent:redis_latency", nullptr, nullptr, [](const Frame& frame) { return sanitize_value(frame.agent.redis_latency_ms); }},
+    {"agent:redis_errors", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.redis_errors); }},
+    {"agent:redis_dropped", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.redis_dropped); }},
+    {"agent:redis_samples", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.redis_samples); }},
+    {"agent:redis_suppressed", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.redis_suppressed); }},
+    {"agent:redis_spooled", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.redis_spooled); }},
+    {"agent:redis_breaker", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.redis_breaker); }},
+    {"agent:sensor_failures", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.sensor_failures); }},
+    {"agent:missed_cycles", nullptr, nullptr, [](const Frame& frame) { return static_cast<double>(frame.agent.missed_cycles); }},
+};
+
+double frame_metric_value(const FrameMetric& metric, const Frame& frame) {
+  return metric.field != nullptr ? sanitize_value(frame.*metric.field) : metric.read(frame);
+}
+
+bool is_health_metric(const std::string& suffix) { return suffix.rfind("agent:", 0) == 0; }
+
+void append_resp(std::string& out, const std::vector<std::string_view>& argv) {
+  char digits[24];
+  out.push_back('*');
+  out.append(digits, std::to_chars(digits, digits + sizeof(digits), argv.size()).ptr);
+  out.append("\r\n");
+  for (const std::string_view arg : argv) {
+    out.push_back('$');
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), arg.size()).ptr);
+    out.append("\r\n");
+    out.append(arg);
+    out.append("\r\n");
+  }
+}
+
+// Bucket as it appears in compacted key names: "1s", "1m", "1h", "1d", else milliseconds.
+std::string format_bucket(const std::uint64_t bucket_ms) {
+  constexpr std::pair<std::uint64_t, const char*> kUnits[] = {
+      {86'400'000, "d"}, {3'600'000, "h"}, {60'000, "m"}, {1000, "s"}};
+  for (const auto& [scale, unit] : kUnits) {
+    if (bucket_ms % scale == 0) {
+      return std::to_string(bucket_ms / scale) + unit;
+    }
+  }
+  return std::to_string(bucket_ms) + "ms";
+}
+
+// Create-or-update: TS.CREATE fails on an existing key, and the TS.ALTER behind it then brings its
+// retention, chunk size and labels up to date. Returns the number of commands appended.
+// The options a series is created with, appended after the command's own arguments; TS.CREATE
+// names the duplicate policy DUPLICATE_POLICY, TS.ADD names it ON_DUPLICATE.
+void append_series_options(std::vector<std::string_view>& argv, const std::string_view retention,
+                           const std::string_view chunk_size, const std::string_view duplicate_keyword,
+                           const std::vector<std::string_view>& labels) {
+  argv.insert(argv.end(), {"RETENTION", retention, "ENCODING", "COMPRESSED", "CHUNK_SIZE", chunk_size,
+                           duplicate_keyword, "LAST", "LABELS"});
+  argv.insert(argv.end(), labels.begin(), labels.end());
+}
+
+// node, family, metric and sensor labels of <prefix>:<suffix>. Series with no single sensor behind
+// them (derived, risk, health) pass an empty sensor and carry their family instead.
+std::vector<std::string_view> series_labels(const std::string_view node, const std::string_view suffix,
+                                            const std::string_view sensor) {
+  const std::size_t colon = suffix.find(':');
+  const std::string_view family = suffix.substr(0, colon);
+  return {"node", node, "family", family, "metric", suffix.substr(colon + 1),
+          "sensor", sensor.empty() ? family : sensor};
+}
+
+std::size_t append_series_schema(std::string& out, const std::string_view key, const std::string_view retention,
+                                 const std::string_view chunk_size, const std::vector<std::string_view>& labels) {
+  std::vector<std::string_view> argv{"TS.CREATE", key};
+  append_series_options(argv, retention, chunk_size, "DUPLICATE_POLICY", labels);
+  append_resp(out, argv);
+
+  argv.erase(argv.begin() + 4, argv.begin() + 6);
+  argv[0] = "TS.ALTER";
+  append_resp(out, argv);
+  return 2;
 }
 
 const std::vector<std::string>& default_metric_suffixes() {
-  static const std::vector<std::string> kMetricSuffixes = {
-      "raw:psi",
-      "raw:psi_memory",
-      "raw:psi_io",
-      "raw:cpu",
-      "raw:irq",
-      "raw:softirqs",
-      "raw:memory",
-      "raw:thermal",
-      "raw:cpufreq",
-      "raw:cpu_throttle_ratio",
-      "raw:disk",
-      "raw:network",
-      "raw:nvml_gpu_util",
-      "raw:gpu_mem_util",
-      "raw:tegra_emc_util",
-      "raw:nvml_gpu_temp",
-      "raw:nvml_gpu_power_ratio",
-      "raw:tegra_gpu_util",
-      "raw:tegra_gpu_temp",
-      "raw:tegra_gpu_power_mw",
-      "derived:scheduler_pressure",
-      "derived:memory_pressure",
-      "derived:io_pressure",
-      "derived:thermal_pressure",
-      "derived:power_pressure",
-      "derived:latency_jitter",
-      "risk:realtime_risk",
-      "risk:saturation_risk",
-      "risk:state",
-      "agent:heartbeat",
-      "agent:loop_jitter",
-      "agent:compute_time",
-      "agent:redis_latency",
-      "agent:redis_errors",
-      "agent:sensor_failures",
-      "agent:missed_cycles",
-  };
+  static const std::vector<std::string> kMetricSuffixes = []() {
+    std::vector<std::string> suffixes;
+    for (const FrameMetric& metric : kFrameMetrics) {
+      suffixes.emplace_back(metric.suffix);
+    }
+    return suffixes;
+  }();
   return kMetricSuffixes;
 }
 
+// "pid:comm:value,pid:comm:value" with ':' and ',' in comm replaced so the list stays splittable.
+std::string format_culprits(const std::vector<sensors::ProcessAttribution::ProcessRates>& top,
+                            float sensors::ProcessAttribution::ProcessRates::*field) {
+  std::string out;
+  char number[32];
+  for (const auto& rates : top) {
+    if (!out.empty()) {
+      out.push_back(',');
+    }
+    out.append(number, std::to_chars(number, number + sizeof(number), rates.pid).ptr);
+    out.push_back(':');
+    for (const char ch : rates.comm) {
+      if (ch == '\0') {
+        break;
+      }
+      out.push_back(ch == ':' || ch == ',' ? '_' : ch);
+    }
+    out.push_back(':');
+    out.append(number, std::to_chars(number, number + sizeof(number), rates.*field, std::chars_format::fixed, 1).ptr);
+  }
+  return out;
+}
+
 }  // namespace
 
 RedisTsSink::RedisTsSink(RedisTsOptions options) : options_(std::move(options)) {
+  if (options_.cluster) {
+    if (options_.node_label.empty()) {
+      options_.node_label = local_host_name();
+    }
+    options_.key_prefix = "{" + options_.node_label + "}";
+    cluster_slot_ = cluster_key_slot(options_.key_prefix);
+    target_ = {options_.host, options_.port};
+  }
   enabled_metrics_ = options_.enabled_metrics.empty() ? default_metric_suffixes() : options_.enabled_metrics;
-  enabled_metric_set_ = std::unordered_set<std::string>(enabled_metrics_.begin(), enabled_metrics_.end());
-  reserve_command_buffers();
+
+  // Resolve the enabled suffixes once; publish then walks slots_ in table order.
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < std::size(kFrameMetrics); ++i) {
+    const FrameMetric& metric = kFrameMetrics[i];
+    const std::string suffix = metric.suffix;
+    if ((!options_.publish_health && is_health_metric(suffix)) ||
+        std::find(enabled_metrics_.begin(), enabled_metrics_.end(), suffix) == enabled_metrics_.end()) {
+      continue;
+    }
+    keys.push_back(options_.key_prefix + ":" + suffix);
+
+    SeriesSlot slot{};
+    slot.metric = i;
+    if (options_.change_only && metric.sensor != nullptr) {
+      const auto sensor = std::find_if(refresh_sensors_.begin(), refresh_sensors_.end(),
+                                       [&metric](const char* name) { return std::strcmp(name, metric.sensor) == 0; });
+      slot.group = static_cast<int>(sensor - refresh_sensors_.begin());
+      if (sensor == refresh_sensors_.end()) {
+        refresh_sensors_.push_back(metric.sensor);
+      }
+    }
+    slots_.push_back(slot);
+  }
+  frame_template_ = MaddTemplate(keys);
+  build_schema(keys);
+  const std::string stream_key = options_.key_prefix + ":frames";
+  const std::string stream_maxlen = std::to_string(options_.frames_maxlen);
+  const std::string placeholder(model::kEncodedFrameSize, '\0');
+  append_resp(stream_command_, {"XADD", stream_key, "MAXLEN", "~", stream_maxlen, "*", "f", placeholder});
+  stream_payload_ = stream_command_.size() - 2 - placeholder.size();
+  event_channel_ = options_.key_prefix + ":events";
+  // Every series goes out with the first frame.
+  refreshed_.assign(refresh_sensors_.size(), 1);
+  selected_.assign(slots_.size(), 1);
+  if (options_.batch_ticks > 1) {
+    batch_body_.reserve(frame_template_.command().size() * options_.batch_ticks);
+    batch_command_.reserve(batch_body_.capacity() + 32);
+  }
+
+  if (!options_.spool_path.empty()) {
+    spool_ = FrameSpool(options_.spool_path, FrameSpool::layout_hash(keys), slots_.size(), options_.spool_max_bytes);
+    if (spool_.is_open()) {
+      spool_template_ = MaddTemplate(keys);
+      all_slots_.assign(slots_.size(), 1);
+      spool_values_.resize(slots_.size());
+      drain_body_.reserve(spool_template_.command().size() * options_.spool_drain_frames);
+      drain_command_.reserve(drain_body_.capacity() + 32);
+      if (options_.batch_ticks > 1) {
+        batch_timestamps_.reserve(options_.batch_ticks);
+        batch_values_.reserve(slots_.size() * options_.batch_ticks);
+      }
+      if (spool_.size() > 0) {
+        std::cerr << "[redis] spool " << options_.spool_path << " holds " << spool_.size()
+                  << " frames to backfill\n";
+      }
+    }
+  }
+
+  for (const auto& [suffix, deadband] : options_.deadbands) {
+    const auto slot = std::find_if(slots_.begin(), slots_.end(), [&suffix = suffix](const SeriesSlot& candidate) {
+      return suffix == kFrameMetrics[candidate.metric].suffix;
+    });
+    if (slot == slots_.end()) {
+      std::cerr << "[redis] deadband for unpublished metric " << suffix << " ignored\n";
+      continue;
+    }
+    slot->deadband = deadband;
+  }
 }
 
 RedisTsSink::~RedisTsSink() = default;
@@ -89,7 +339,34 @@ RedisTsSink::RedisTsSink(RedisTsSink&&) noexcept = default;
 RedisTsSink& RedisTsSink::operator=(RedisTsSink&&) noexcept = default;
 
 bool RedisTsSink::check_connectivity() {
-  return ensure_connected();
+  // Called before the tick loop starts, so waiting out the connect timeout here is harmless.
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options_.connect_timeout_ms);
+  if (!options_.async) {
+    while (!ensure_connected()) {
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        return false;
+      }
+      if (context_ == nullptr) {
+        // Only a cluster redirect schedules the next connect immediately.
+        if (now < next_connect_attempt_) {
+          return false;
+        }
+        continue;
+      }
+      pollfd descriptor{context_->fd, static_cast<short>(connecting_ || output_pending_ ? POLLOUT : POLLIN), 0};
+      (void)::poll(&descriptor, 1, 10);
+    }
+    return true;
+  }
+
+  async_service();
+  while (connecting_ && std::chrono::steady_clock::now() < deadline) {
+    pollfd descriptor{context_->fd, POLLOUT, 0};
+    (void)::poll(&descriptor, 1, 10);
+    async_service();
+  }
+  return async_ready();
 }
 
 void RedisTsSink::ContextDeleter::operator()(redisContext* context) const {
@@ -103,214 +380,1167 @@ bool RedisTsSink::ensure_connected() {
     return false;
   }
 
-  if (context_ != nullptr && context_->err == REDIS_OK) {
-    return true;
+  if (options_.async) {
+    return async_ready() && pending_replies_.size() < kMaxPendingReplies;
+  }
+
+  if (context_ != nullptr && !handshake_pending_) {
+    if (context_->err == REDIS_OK) {
+      return true;
+    }
+    drop_connection(context_->errstr);
   }
-  return reconnect();
+
+  // Connect and handshake exactly as async mode does, so an unreachable or silent Redis costs a
+  // tick a couple of zero-timeout polls, never the connect timeout. The second pass picks up
+  // handshake replies that are already in.
+  async_service();
+  if (context_ != nullptr && !connecting_ && handshake_pending_) {
+    async_service();
+  }
+  if (context_ == nullptr || connecting_ || !pending_replies_.empty() || output_pending_) {
+    return false;
+  }
+  if (!schema_ready_) {
+    drop_connection("schema not created");
+    return false;
+  }
+  return finish_sync_handshake();
 }
 
-bool RedisTsSink::reconnect() {
-  context_.reset();
+bool RedisTsSink::finish_sync_handshake() {
+  // The socket stays non-blocking: wait_reply bounds each reply by reply_timeout_ms, so a Redis
+  // that hangs after the handshake holds a tick no longer than that.
+  handshake_pending_ = false;
+  connect_failures_ = 0;
+  return true;
+}
 
-  timeval timeout{};
-  timeout.tv_sec = static_cast<time_t>(options_.connect_timeout_ms / 1000);
-  timeout.tv_usec = static_cast<suseconds_t>((options_.connect_timeout_ms % 1000) * 1000);
+std::uint32_t RedisTsSink::breaker_state() const noexcept {
+  if (context_ == nullptr) {
+    return connect_failures_ > 0 ? kBreakerOpen : kBreakerClosed;
+  }
+  return connecting_ || handshake_pending_ || connect_failures_ > 0 ? kBreakerHalfOpen : kBreakerClosed;
+}
 
-  redisContext* raw = nullptr;
-  if (!options_.unix_socket.empty()) {
-    raw = redisConnectUnixWithTimeout(options_.unix_socket.c_str(), timeout);
-  } else {
-    raw = redisConnectWithTimeout(options_.host.c_str(), static_cast<int>(options_.port), timeout);
+void RedisTsSink::schedule_reconnect() {
+  ++connect_failures_;
+  // Exponential from reconnect_min_ms, capped at reconnect_max_ms, with equal jitter so a fleet of
+  // agents does not reconnect in lockstep after a shared Redis restarts.
+  const std::uint32_t doublings = std::min<std::uint32_t>(connect_failures_ - 1, 20);
+  const std::uint64_t ceiling = std::min<std::uint64_t>(static_cast<std::uint64_t>(options_.reconnect_min_ms) << doublings,
+                                                         std::max(options_.reconnect_min_ms, options_.reconnect_max_ms));
+  const std::uint64_t delay_ms = (ceiling / 2) + (backoff_rng_() % ((ceiling / 2) + 1));
+  next_connect_attempt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms);
+}
+
+void RedisTsSink::build_schema(const std::vector<std::string>& keys) {
+  series_node_ = options_.node_label.empty() ? options_.key_prefix : options_.node_label;
+  series_retention_ = std::to_string(options_.retention_ms);
+  series_chunk_size_ = std::to_string(options_.chunk_size);
+  const std::string& retention = series_retention_;
+  const std::string& chunk_size = series_chunk_size_;
+  std::vector<std::pair<std::string, std::string>> rules;
+  for (const TsCompaction& rule : options_.compactions) {
+    rules.emplace_back(rule.aggregation + "_" + format_bucket(rule.bucket_ms), std::to_string(rule.retention_ms));
   }
-  if (raw == nullptr || raw->err != REDIS_OK) {
-    if (raw != nullptr) {
-      std::cerr << "[redis] connect failed: " << raw->errstr << '\n';
-      redisFree(raw);
-    } else {
-      std::cerr << "[redis] connect failed: out of memory\n";
+
+  schema_command_.clear();
+  schema_commands_ = 0;
+  for (std::size_t slot = 0; slot < slots_.size(); ++slot) {
+    const FrameMetric& metric = kFrameMetrics[slots_[slot].metric];
+    std::vector<std::string_view> labels =
+        series_labels(series_node_, metric.suffix, metric.sensor != nullptr ? metric.sensor : "");
+    schema_commands_ += append_series_schema(schema_command_, keys[slot], retention, chunk_size, labels);
+
+    for (std::size_t i = 0; i < rules.size(); ++i) {
+      const TsCompaction& rule = options_.compactions[i];
+      const std::string destination = keys[slot] + ":" + rules[i].first;
+      const std::string bucket_ms = std::to_string(rule.bucket_ms);
+      labels.resize(8);
+      labels.insert(labels.end(), {"aggregation", rule.aggregation, "bucket_ms", bucket_ms});
+      schema_commands_ += append_series_schema(schema_command_, destination, rules[i].second, chunk_size, labels);
+      append_resp(schema_command_, {"TS.CREATERULE", keys[slot], destination, "AGGREGATION", rule.aggregation, bucket_ms});
+      ++schema_commands_;
     }
-    return false;
   }
+}
 
-  context_.reset(raw);
-  if (!authenticate()) {
-    context_.reset();
-    return false;
+int RedisTsSink::refresh_group(const std::string& sensor) const {
+  for (std::size_t group = 0; group < refresh_sensors_.size(); ++group) {
+    if (sensor == refresh_sensors_[group]) {
+      return static_cast<int>(group);
+    }
   }
-  if (!select_db()) {
-    context_.reset();
-    return false;
+  return -1;
+}
+
+void RedisTsSink::mark_refreshed(const int group) noexcept {
+  if (group >= 0 && static_cast<std::size_t>(group) < refreshed_.size()) {
+    refreshed_[static_cast<std::size_t>(group)] = 1;
   }
-  if (!ensure_schema()) {
-    context_.reset();
+}
+
+bool RedisTsSink::publish(model::signal_frame& frame) {
+  frame.agent.redis_samples = last_samples_;
+  frame.agent.redis_suppressed = last_suppressed_;
+  frame.agent.redis_spooled = static_cast<std::uint32_t>(spool_.size());
+  frame.agent.redis_breaker = breaker_state();
+  if (options_.async) {
+    async_service();
+    // Replies to earlier ticks land here, so the latency is a full round trip rather than the time
+    // it took to enqueue.
+    frame.agent.redis_latency_ms = last_reply_latency_ms_;
+    frame.agent.redis_errors += reply_errors_;
+    reply_errors_ = 0;
+    frame.agent.redis_dropped = dropped_frames_;
+  }
+
+  if (!render_frame(frame)) {
     return false;
   }
+  // Batched ticks count as written once held; a batch that fails to go out is re-sent in full.
+  const bool batching = options_.batch_ticks > 1;
+  if (batching && !batch_frame(frame)) {
+    return true;
+  }
+  if (frame_command_.empty()) {
+    if (!batching) {
+      commit_frame();
+    }
+    batch_timestamps_.clear();
+    batch_values_.clear();
+    return true;
+  }
 
-  return true;
+  bool ok = options_.async ? publish_async(frame) : publish_sync(frame);
+  if (ok && !batching) {
+    commit_frame();
+  }
+  // Async: counted as written once queued; drop_connection() re-sends every series if it never lands.
+  if (ok && options_.async && output_pending_) {
+    ok = async_flush();
+  }
+  if (batching && !ok) {
+    resend_all();
+  }
+  if (!ok) {
+    spool_unwritten(frame);
+  }
+  batch_timestamps_.clear();
+  batch_values_.clear();
+  if (ok && batching && !publish_batch_histograms()) {
+    ++frame.agent.redis_errors;
+  }
+  // Backfill rides behind the live frame, never ahead of it.
+  if (ok && !drain_spool()) {
+    ++frame.agent.redis_errors;
+  }
+  return ok;
 }
 
-bool RedisTsSink::authenticate() {
-  if (options_.password.empty()) {
+void RedisTsSink::spool_values(const model::signal_frame& frame, double* values) const {
+  for (std::size_t slot = 0; slot < slots_.size(); ++slot) {
+    values[slot] = frame_metric_value(kFrameMetrics[slots_[slot].metric], frame);
+  }
+}
+
+void RedisTsSink::spool_unwritten(const model::signal_frame& frame) {
+  if (!spool_.is_open()) {
+    return;
+  }
+  if (options_.batch_ticks > 1) {
+    for (std::size_t tick = 0; tick < batch_timestamps_.size(); ++tick) {
+      spool_.push(batch_timestamps_[tick], batch_values_.data() + (tick * slots_.size()));
+    }
+    return;
+  }
+  spool_values(frame, spool_values_.data());
+  spool_.push(frame_timestamp_ms_, spool_values_.data());
+}
+
+bool RedisTsSink::drain_spool() {
+  if (spool_.size() == 0 || backfill_in_flight_) {
+    return true;
+  }
+  if (options_.async && frames_in_flight_ >= options_.max_in_flight) {
     return true;
   }
 
-  redisReply* reply = static_cast<redisReply*>(redisCommand(context_.get(), "AUTH %s", options_.password.c_str()));
-  if (reply == nullptr) {
+  const std::size_t frames = std::min<std::size_t>(spool_.size(), options_.spool_drain_frames);
+  drain_body_.clear();
+  std::size_t series = 0;
+  for (std::size_t index = 0; index < frames; ++index) {
+    std::uint64_t timestamp_ms = 0;
+    if (!spool_.read(index, timestamp_ms, spool_values_.data()) || !spool_template_.set_timestamp(timestamp_ms)) {
+      continue;
+    }
+    for (std::size_t slot = 0; slot < spool_values_.size(); ++slot) {
+      spool_template_.set_value(slot, spool_values_[slot]);
+    }
+    series += spool_template_.append_selected(all_slots_, drain_body_);
+  }
+  const std::uint64_t until = spool_.first_sequence() + frames;
+  if (series == 0) {
+    spool_.release_until(until);
+    return true;
+  }
+  drain_command_.clear();
+  MaddTemplate::append_header(series, drain_command_);
+  drain_command_.append(drain_body_);
+
+  if (options_.async) {
+    if (!write_command(drain_command_)) {
+      drop_connection(std::strerror(errno));
+      return false;
+    }
+    pending_replies_.push_back({ReplyKind::backfill, std::chrono::steady_clock::now()});
+    backfill_in_flight_ = true;
+    backfill_until_ = until;
+    return !output_pending_ || async_flush();
+  }
+
+  void* raw_reply = nullptr;
+  if (!write_command(drain_command_) || !skip_asking_replies() || !wait_reply(&raw_reply)) {
+    drop_connection(context_->err != REDIS_OK ? context_->errstr : "no reply");
     return false;
   }
+  auto* reply = static_cast<redisReply*>(raw_reply);
   const bool ok = reply->type != REDIS_REPLY_ERROR;
-  if (!ok) {
-    std::cerr << "[redis] AUTH rejected\n";
+  if (!ok && reply->str != nullptr) {
+    (void)follow_redirect(reply->str);
   }
   freeReplyObject(reply);
+  if (ok) {
+    spool_.release_until(until);
+  }
   return ok;
 }
 
-bool RedisTsSink::select_db() {
-  if (options_.db == 0) {
-    return true;
-  }
+bool RedisTsSink::publish_sync(model::signal_frame& frame) {
+  // A broken connection is re-established on later ticks; the frame goes to the spool meanwhile.
+  return ensure_connected() && publish_impl(frame);
+}
 
-  redisReply* reply = static_cast<redisReply*>(redisCommand(context_.get(), "SELECT %d", options_.db));
+bool RedisTsSink::publish_impl(model::signal_frame& frame) {
+  const auto publish_start = std::chrono::steady_clock::now();
+  void* raw_reply = nullptr;
+  if (!write_command(frame_command_) || !skip_asking_replies() || !wait_reply(&raw_reply)) {
+    raw_reply = nullptr;
+  }
+  auto* reply = static_cast<redisReply*>(raw_reply);
+  const auto publish_end = std::chrono::steady_clock::now();
+  frame.agent.redis_latency_ms =
+      std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(publish_end - publish_start).count();
   if (reply == nullptr) {
+    drop_connection(context_->err != REDIS_OK ? context_->errstr : "no reply");
     return false;
   }
+
   const bool ok = reply->type != REDIS_REPLY_ERROR;
+  if (!ok && reply->str != nullptr) {
+    (void)follow_redirect(reply->str);
+  } else if (ok) {
+    redirects_ = 0;
+  }
   freeReplyObject(reply);
   return ok;
 }
 
-bool RedisTsSink::ensure_schema() {
-  if (schema_ready_) {
+bool RedisTsSink::render_frame(const model::signal_frame& frame) {
+  frame_timestamp_ms_ = core::unix_timestamp_now_ns() / 1'000'000ULL;
+  if (!frame_template_.set_timestamp(frame_timestamp_ms_)) {
+    return false;
+  }
+
+  if (!options_.change_only) {
+    for (std::size_t slot = 0; slot < slots_.size(); ++slot) {
+      frame_template_.set_value(slot, frame_metric_value(kFrameMetrics[slots_[slot].metric], frame));
+    }
+    frame_command_ = frame_template_.command();
+    frame_samples_ = static_cast<std::uint32_t>(slots_.size());
     return true;
   }
 
-  for (const auto& suffix : enabled_metrics_) {
-    const std::string key = options_.key_prefix + ":" + suffix;
-    redisReply* reply = static_cast<redisReply*>(
-        redisCommand(context_.get(), "TS.CREATE %s DUPLICATE_POLICY LAST", key.c_str()));
-    if (reply == nullptr) {
-      return false;
+  // Series whose sensor did not run keep their last value (and digits); only the keep-alive can
+  // select them.
+  frame_samples_ = 0;
+  for (std::size_t slot = 0; slot < slots_.size(); ++slot) {
+    SeriesSlot& series = slots_[slot];
+    bool changed = false;
+    if (series.group < 0 || refreshed_[static_cast<std::size_t>(series.group)] != 0) {
+      const double value = frame_metric_value(kFrameMetrics[series.metric], frame);
+      if (value != series.value) {
+        frame_template_.set_value(slot, value);
+        series.value = value;
+      }
+      changed = std::fabs(value - series.sent_value) > series.deadband;
+    }
+    const bool keepalive_due =
+        series.sent_at_ms == 0 || frame_timestamp_ms_ - series.sent_at_ms >= options_.keepalive_ms;
+    selected_[slot] = changed || keepalive_due ? 1 : 0;
+    frame_samples_ += selected_[slot];
+  }
+  frame_command_ = frame_template_.command(selected_);
+  return true;
+}
+
+void RedisTsSink::commit_frame() {
+  last_samples_ = frame_samples_;
+  last_suppressed_ = static_cast<std::uint32_t>(slots_.size()) - frame_samples_;
+  if (!options_.change_only) {
+    return;
+  }
+  for (std::size_t slot = 0; slot < slots_.size(); ++slot) {
+    if (selected_[slot] != 0) {
+      slots_[slot].sent_value = slots_[slot].value;
+      slots_[slot].sent_at_ms = frame_timestamp_ms_;
     }
+  }
+  std::fill(refreshed_.begin(), refreshed_.end(), 0);
+}
 
-    const bool already_exists =
-        reply->type == REDIS_REPLY_ERROR && reply->str != nullptr && strstr(reply->str, "already exists") != nullptr;
-    const bool unknown_command =
-        reply->type == REDIS_REPLY_ERROR && reply->str != nullptr && strstr(reply->str, "unknown command") != nullptr;
-    const bool ok = reply->type != REDIS_REPLY_ERROR || already_exists;
-    const std::string reply_message = reply->str != nullptr ? reply->str : "unknown";
-    freeReplyObject(reply);
+void RedisTsSink::resend_all() noexcept {
+  for (SeriesSlot& series : slots_) {
+    series.sent_at_ms = 0;
+  }
+}
+
+void RedisTsSink::Log2Histogram::record(const double value) noexcept {
+  std::size_t bucket = 0;
+  while (bucket + 1 < counts.size() && value > static_cast<double>(1ULL << bucket)) {
+    ++bucket;
+  }
+  for (; bucket < counts.size(); ++bucket) {
+    ++counts[bucket];
+  }
+}
 
-    if (unknown_command) {
-      std::cerr << "[redis] RedisTimeSeries module not available (TS.CREATE unknown command)\n";
-      timeseries_available_ = false;
+bool RedisTsSink::batch_frame(const model::signal_frame& frame) {
+  const auto now = std::chrono::steady_clock::now();
+  if (batch_ticks_held_ == 0) {
+    batch_started_ = now;
+  }
+  batch_series_ += frame_template_.append_selected(selected_, batch_body_);
+  ++batch_ticks_held_;
+  if (spool_.is_open()) {
+    // Held ticks are only in RESP form; keep them spoolable in case the flush fails.
+    batch_timestamps_.push_back(frame_timestamp_ms_);
+    batch_values_.resize(batch_values_.size() + slots_.size());
+    spool_values(frame, batch_values_.data() + batch_values_.size() - slots_.size());
+  }
+  commit_frame();
+
+  const auto state = static_cast<std::uint8_t>(frame.state);
+  const bool state_changed = state != batch_state_;
+  batch_state_ = state;
+  const bool timed_out =
+      options_.batch_ms > 0 && now - batch_started_ >= std::chrono::milliseconds(options_.batch_ms);
+  if (!state_changed && !timed_out && batch_ticks_held_ < options_.batch_ticks) {
+    return false;
+  }
+
+  batch_size_histogram_.record(static_cast<double>(batch_ticks_held_));
+  flush_latency_histogram_.record(std::chrono::duration<double, std::milli>(now - batch_started_).count());
+
+  batch_command_.clear();
+  if (batch_series_ > 0) {
+    MaddTemplate::append_header(batch_series_, batch_command_);
+    batch_command_.append(batch_body_);
+  }
+  frame_command_ = batch_command_;
+  batch_body_.clear();
+  batch_series_ = 0;
+  batch_ticks_held_ = 0;
+  return true;
+}
+
+bool RedisTsSink::publish_batch_histograms() {
+  const auto now = std::chrono::steady_clock::now();
+  if (now - histograms_published_ < kHistogramPublishInterval) {
+    return true;
+  }
+  histograms_published_ = now;
+  if (!ensure_connected()) {
+    return false;
+  }
+
+  char timestamp[24];
+  const std::size_t timestamp_len =
+      static_cast<std::size_t>(std::to_chars(timestamp, timestamp + sizeof(timestamp), frame_timestamp_ms_).ptr - timestamp);
+  std::size_t pending = 0;
+  for (const auto& [name, histogram] : {std::pair<const char*, const Log2Histogram*>{"batch_ticks", &batch_size_histogram_},
+                                        std::pair<const char*, const Log2Histogram*>{"flush_latency_ms", &flush_latency_histogram_}}) {
+    for (std::size_t bucket = 0; bucket < histogram->counts.size(); ++bucket) {
+      const std::string bound = bucket + 1 < histogram->counts.size() ? std::to_string(1ULL << bucket) : "inf";
+      const std::string suffix = std::string("agent:redis_") + name + ":le" + bound;
+      char count[24];
+      const std::size_t count_len =
+          static_cast<std::size_t>(std::to_chars(count, count + sizeof(count), histogram->counts[bucket]).ptr - count);
+      if (!append_series_add(suffix, {timestamp, timestamp_len}, {count, count_len}, "")) {
+        return false;
+      }
+      ++pending;
+    }
+  }
+  return collect_replies(pending);
+}
+
+bool RedisTsSink::append_series_add(const std::string_view suffix, const std::string_view timestamp,
+                                    const std::string_view value, const std::string_view sensor) {
+  const std::string key = options_.key_prefix + ":" + std::string(suffix);
+  std::vector<std::string_view> args{"TS.ADD", key, timestamp, value};
+  append_series_options(args, series_retention_, series_chunk_size_, "ON_DUPLICATE",
+                        series_labels(series_node_, suffix, sensor));
+  std::array<const char*, kMaxSeriesAddArgs> argv{};
+  std::array<std::size_t, kMaxSeriesAddArgs> argv_len{};
+  for (std::size_t i = 0; i < args.size(); ++i) {
+    argv[i] = args[i].data();
+    argv_len[i] = args[i].size();
+  }
+  return append_command(ReplyKind::auxiliary, static_cast<int>(args.size()), argv.data(), argv_len.data());
+}
+
+bool RedisTsSink::write_command(const std::string_view command) {
+  return (!asking_ || write_asking(false)) && write_raw(command);
+}
+
+bool RedisTsSink::write_asking(const bool buffered) {
+  if (buffered ? redisAppendFormattedCommand(context_.get(), kAskingCommand.data(), kAskingCommand.size()) != REDIS_OK
+               : !write_raw(kAskingCommand)) {
+    return false;
+  }
+  expect_asking_reply();
+  return true;
+}
+
+void RedisTsSink::expect_asking_reply() {
+  if (options_.async || handshake_pending_) {
+    pending_replies_.push_back({ReplyKind::asking, std::chrono::steady_clock::now()});
+  } else {
+    ++asking_replies_;
+  }
+}
+
+bool RedisTsSink::wait_reply(void** reply) {
+  *reply = nullptr;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options_.reply_timeout_ms);
+  int written = 0;
+  for (;;) {
+    if (written == 0 && redisBufferWrite(context_.get(), &written) != REDIS_OK) {
+      return false;
+    }
+    output_pending_ = written == 0;
+    if (redisGetReplyFromReader(context_.get(), reply) != REDIS_OK) {
       return false;
     }
-    if (!ok) {
-      std::cerr << "[redis] schema error on TS.CREATE " << key << ": " << reply_message << '\n';
+    if (*reply != nullptr) {
+      return true;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      return false;
+    }
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+    pollfd descriptor{context_->fd, static_cast<short>(written == 0 ? POLLIN | POLLOUT : POLLIN), 0};
+    if (::poll(&descriptor, 1, static_cast<int>(std::max<long long>(remaining, 1))) > 0 &&
+        (descriptor.revents & (POLLIN | POLLERR | POLLHUP)) != 0 && redisBufferRead(context_.get()) != REDIS_OK) {
       return false;
     }
   }
+}
 
-  schema_ready_ = true;
+bool RedisTsSink::skip_asking_replies() {
+  for (; asking_replies_ > 0; --asking_replies_) {
+    void* raw_reply = nullptr;
+    if (!wait_reply(&raw_reply)) {
+      return false;
+    }
+    freeReplyObject(raw_reply);
+  }
   return true;
 }
 
-bool RedisTsSink::publish(model::signal_frame& frame) {
+bool RedisTsSink::write_raw(const std::string_view command) {
+  // Straight to the socket while hiredis has nothing buffered; whatever a non-blocking socket
+  // does not take is handed to hiredis to finish, keeping the byte order intact.
+  std::size_t written = 0;
+  while (!output_pending_ && written < command.size()) {
+    const ssize_t sent = ::send(context_->fd, command.data() + written, command.size() - written, MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      return false;
+    }
+    written += static_cast<std::size_t>(sent);
+  }
+  if (written == command.size()) {
+    return true;
+  }
+  if (redisAppendFormattedCommand(context_.get(), command.data() + written, command.size() - written) != REDIS_OK) {
+    return false;
+  }
+  // Flushed by async_service, or in sync mode by the wait for this command's reply.
+  output_pending_ = true;
+  return true;
+}
+
+bool RedisTsSink::publish_frame_stream(const model::signal_frame& frame) {
   if (!ensure_connected()) {
     return false;
   }
 
-  if (publish_impl(frame)) {
-    return true;
+  const std::uint64_t unix_ms =
+      frame_timestamp_ms_ != 0 ? frame_timestamp_ms_ : core::unix_timestamp_now_ns() / 1'000'000ULL;
+  model::encode_frame(frame, unix_ms, reinterpret_cast<unsigned char*>(stream_command_.data() + stream_payload_));
+  if (!write_command(stream_command_)) {
+    drop_connection(std::strerror(errno));
+    return false;
+  }
+  if (options_.async) {
+    pending_replies_.push_back({ReplyKind::auxiliary, std::chrono::steady_clock::now()});
+  }
+  return collect_replies(1);
+}
+
+bool RedisTsSink::publish_event(const RiskEvent& event, const model::signal_frame& frame) {
+  const std::uint64_t sequence = ++event_sequence_;
+  if (!ensure_connected()) {
+    return false;
   }
 
-  if (!reconnect()) {
+  static constexpr const char* kEventKinds[] = {"state", "psi", "sensor"};
+  const float max_risk = std::max(frame.realtime_risk, frame.saturation_risk);
+  const model::system_state previous = event.kind == RiskEvent::Kind::state ? event.previous : frame.state;
+  std::array<char, 512> payload{};
+  const int written = std::snprintf(
+      payload.data(), payload.size(),
+      "{\"seq\":%llu,\"ts\":%llu,\"event\":\"%s\",\"source\":\"%s\",\"onset\":%s,\"prev\":%u,\"state\":%u,"
+      "\"max_risk\":%.4g,\"pressures\":{\"scheduler\":%.4g,\"memory\":%.4g,\"io\":%.4g,\"thermal\":%.4g,"
+      "\"power\":%.4g,\"latency_jitter\":%.4g},\"psi\":[%.4g,%.4g,%.4g]}",
+      static_cast<unsigned long long>(sequence),
+      static_cast<unsigned long long>(core::unix_timestamp_now_ns() / 1'000'000ULL),
+      kEventKinds[static_cast<std::size_t>(event.kind)], event.source, event.onset ? "true" : "false",
+      static_cast<unsigned>(previous), static_cast<unsigned>(frame.state), sanitize_value(max_risk),
+      sanitize_value(frame.scheduler_pressure), sanitize_value(frame.memory_pressure),
+      sanitize_value(frame.io_pressure), sanitize_value(frame.thermal_pressure), sanitize_value(frame.power_pressure),
+      sanitize_value(frame.latency_jitter), sanitize_value(frame.psi), sanitize_value(frame.psi_memory),
+      sanitize_value(frame.psi_io));
+  if (written < 0 || static_cast<std::size_t>(written) >= payload.size()) {
     return false;
   }
-  return publish_impl(frame);
+
+  // Straight onto the connection, ahead of any batch the frame itself may be waiting in.
+  const char* argv[] = {"PUBLISH", event_channel_.c_str(), payload.data()};
+  const std::size_t argv_len[] = {7, event_channel_.size(), static_cast<std::size_t>(written)};
+  if (!append_command(ReplyKind::auxiliary, 3, argv, argv_len)) {
+    return false;
+  }
+  return collect_replies(1);
 }
 
-bool RedisTsSink::publish_impl(model::signal_frame& frame) {
-  const std::uint64_t timestamp_ms = core::unix_timestamp_now_ns() / 1'000'000ULL;
+bool RedisTsSink::publish_attribution(const sensors::ProcessAttribution::Report& report) {
+  if (!ensure_connected()) {
+    return false;
+  }
 
-  command_args_.clear();
-  command_argv_.clear();
-  command_argv_len_.clear();
-  command_args_.emplace_back("TS.MADD");
+  using Rates = sensors::ProcessAttribution::ProcessRates;
+  const std::vector<std::string> args = {
+      "XADD",
+      options_.key_prefix + ":culprits",
+      "MAXLEN",
+      "~",
+      kCulpritStreamMaxLen,
+      "*",
+      "state",
+      std::to_string(static_cast<unsigned>(report.state)),
+      "processes",
+      std::to_string(report.processes),
+      "steps",
+      std::to_string(report.steps),
+      "cpu_pct",
+      format_culprits(report.top_cpu, &Rates::cpu_pct),
+      "major_faults",
+      format_culprits(report.top_major_faults, &Rates::major_faults_per_sec),
+      "io_bytes",
+      format_culprits(report.top_io, &Rates::io_bytes_per_sec),
+      "run_delay_ms",
+      format_culprits(report.top_run_delay, &Rates::run_delay_ms_per_sec),
+  };
 
-  const auto append_metric = [&](const char* suffix, const double value) {
-    if (enabled_metric_set_.find(suffix) == enabled_metric_set_.end()) {
-      return;
+  std::vector<const char*> argv;
+  std::vector<std::size_t> argv_len;
+  argv.reserve(args.size());
+  argv_len.reserve(args.size());
+  for (const auto& arg : args) {
+    argv.push_back(arg.c_str());
+    argv_len.push_back(arg.size());
+  }
+
+  if (!append_command(ReplyKind::auxiliary, static_cast<int>(argv.size()), argv.data(), argv_len.data())) {
+    return false;
+  }
+  return collect_replies(1);
+}
+
+bool RedisTsSink::publish_wakeup_latency(const std::vector<sensors::WakeupLatencyProbe::CpuLatency>& per_cpu) {
+  if (!ensure_connected()) {
+    return false;
+  }
+
+  using Latency = sensors::WakeupLatencyProbe::CpuLatency;
+  static constexpr std::pair<const char*, float Latency::*> kStats[] = {
+      {"p50_us", &Latency::p50_us},
+      {"p99_us", &Latency::p99_us},
+      {"p999_us", &Latency::p999_us},
+      {"max_us", &Latency::max_us},
+  };
+
+  // TS.ADD (unlike TS.MADD) creates missing keys, with the schema's options, so the per-CPU series
+  // need no schema entries.
+  const std::string timestamp = std::to_string(core::unix_timestamp_now_ns() / 1'000'000ULL);
+  std::size_t pending = 0;
+  for (const Latency& latency : per_cpu) {
+    if (latency.samples == 0) {
+      continue;
+    }
+    for (const auto& [stat, field] : kStats) {
+      const std::string suffix = std::string("raw:wakeup_latency_") + stat + ":cpu" + std::to_string(latency.cpu);
+      if (!append_series_add(suffix, timestamp, std::to_string(sanitize_value(latency.*field)), "wakeup_latency")) {
+        return false;
+      }
+      ++pending;
     }
-    add_metric_args(command_args_, options_.key_prefix, timestamp_ms, suffix, value);
+  }
+
+  return collect_replies(pending);
+}
+
+bool RedisTsSink::publish_perf_per_cpu(const std::vector<sensors::PerfEventSensor::CpuRates>& per_cpu,
+                                       const bool hardware) {
+  if (!ensure_connected()) {
+    return false;
+  }
+
+  using Rates = sensors::PerfEventSensor::CpuRates;
+  static constexpr std::pair<const char*, float Rates::*> kStats[] = {
+      {"context_switches", &Rates::context_switches_per_sec},
+      {"migrations", &Rates::migrations_per_sec},
+      {"major_faults", &Rates::major_faults_per_sec},
+      {"ipc", &Rates::ipc},
+      {"llc_misses", &Rates::llc_misses_per_sec},
   };
+  // The last two come from the hardware group.
+  const std::size_t stats = hardware ? std::size(kStats) : std::size(kStats) - 2;
 
-  append_metric("raw:psi", sanitize_value(frame.psi));
-  append_metric("raw:psi_memory", sanitize_value(frame.psi_memory));
-  append_metric("raw:psi_io", sanitize_value(frame.psi_io));
-  append_metric("raw:cpu", sanitize_value(frame.cpu));
-  append_metric("raw:irq", sanitize_value(frame.irq));
-  append_metric("raw:softirqs", sanitize_value(frame.softirqs));
-  append_metric("raw:memory", sanitize_value(frame.memory));
-  append_metric("raw:thermal", sanitize_value(frame.thermal));
-  append_metric("raw:cpufreq", sanitize_value(frame.cpufreq));
-  append_metric("raw:cpu_throttle_ratio", sanitize_value(frame.cpu_throttle_ratio));
-  append_metric("raw:disk", sanitize_value(frame.disk));
-  append_metric("raw:network", sanitize_value(frame.network));
-  append_metric("raw:nvml_gpu_util", sanitize_value(frame.nvml_gpu_util));
-  append_metric("raw:gpu_mem_util", sanitize_value(frame.gpu_mem_util));
-  append_metric("raw:tegra_emc_util", sanitize_value(frame.tegra_emc_util));
-  append_metric("raw:nvml_gpu_temp", sanitize_value(frame.nvml_gpu_temp));
-  append_metric("raw:nvml_gpu_power_ratio", sanitize_value(frame.nvml_gpu_power_ratio));
-  append_metric("raw:tegra_gpu_util", sanitize_value(frame.tegra_gpu_util));
-  append_metric("raw:tegra_gpu_temp", sanitize_value(frame.tegra_gpu_temp));
-  append_metric("raw:tegra_gpu_power_mw", sanitize_value(frame.tegra_gpu_power_mw));
-  append_metric("derived:scheduler_pressure", sanitize_value(frame.scheduler_pressure));
-  append_metric("derived:memory_pressure", sanitize_value(frame.memory_pressure));
-  append_metric("derived:io_pressure", sanitize_value(frame.io_pressure));
-  append_metric("derived:thermal_pressure", sanitize_value(frame.thermal_pressure));
-  append_metric("derived:power_pressure", sanitize_value(frame.power_pressure));
-  append_metric("derived:latency_jitter", sanitize_value(frame.latency_jitter));
-  append_metric("risk:realtime_risk", sanitize_value(frame.realtime_risk));
-  append_metric("risk:saturation_risk", sanitize_value(frame.saturation_risk));
-  append_metric("risk:state", static_cast<double>(static_cast<std::uint8_t>(frame.state)));
-
-  if (options_.publish_health) {
-    append_metric("agent:heartbeat", static_cast<double>(frame.agent.heartbeat_ms));
-    append_metric("agent:loop_jitter", sanitize_value(frame.agent.loop_jitter_ms));
-    append_metric("agent:compute_time", sanitize_value(frame.agent.compute_time_ms));
-    append_metric("agent:redis_latency", sanitize_value(frame.agent.redis_latency_ms));
-    append_metric("agent:redis_errors", static_cast<double>(frame.agent.redis_errors));
-    append_metric("agent:sensor_failures", static_cast<double>(frame.agent.sensor_failures));
-    append_metric("agent:missed_cycles", static_cast<double>(frame.agent.missed_cycles));
-  }
-
-  for (const auto& arg : command_args_) {
-    command_argv_.push_back(arg.c_str());
-    command_argv_len_.push_back(arg.size());
+  const std::string timestamp = std::to_string(core::unix_timestamp_now_ns() / 1'000'000ULL);
+  std::size_t pending = 0;
+  for (const Rates& rates : per_cpu) {
+    if (rates.cpu < 0) {
+      continue;
+    }
+    for (std::size_t i = 0; i < stats; ++i) {
+      const auto& [stat, field] = kStats[i];
+      const std::string suffix = std::string("raw:perf_") + stat + ":cpu" + std::to_string(rates.cpu);
+      if (!append_series_add(suffix, timestamp, std::to_string(sanitize_value(rates.*field)), "perf")) {
+        return false;
+      }
+      ++pending;
+    }
   }
 
-  const auto publish_start = std::chrono::steady_clock::now();
-  redisReply* reply = static_cast<redisReply*>(
-      redisCommandArgv(context_.get(), static_cast<int>(command_argv_.size()), command_argv_.data(),
-                       command_argv_len_.data()));
-  const auto publish_end = std::chrono::steady_clock::now();
-  frame.agent.redis_latency_ms =
-      std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(publish_end - publish_start).count();
-  if (reply == nullptr) {
+  return collect_replies(pending);
+}
+
+bool RedisTsSink::publish_gpu_devices(const char* source, const std::vector<sensors::gpu::GpuDeviceSample>& devices) {
+  if (!ensure_connected()) {
     return false;
   }
 
-  const bool ok = reply->type != REDIS_REPLY_ERROR;
-  freeReplyObject(reply);
+  using Sample = sensors::gpu::GpuDeviceSample;
+  static constexpr std::pair<const char*, float Sample::*> kStats[] = {
+      {"util", &Sample::util},
+      {"mem_util", &Sample::mem_util},
+      {"mem_free", &Sample::mem_free_mb},
+      {"temp", &Sample::temp_c},
+      {"clock_ratio", &Sample::clock_ratio},
+      {"power_ratio", &Sample::power_ratio},
+  };
+
+  const std::string timestamp = std::to_string(core::unix_timestamp_now_ns() / 1'000'000ULL);
+  std::size_t pending = 0;
+  const auto append = [&](const std::string& suffix, const double value) {
+    if (!append_series_add(suffix, timestamp, std::to_string(value), "gpu")) {
+      return false;
+    }
+    ++pending;
+    return true;
+  };
+
+  const std::string prefix = std::string("raw:") + source + "_gpu_";
+  for (const Sample& sample : devices) {
+    const std::string device = ":gpu" + std::to_string(sample.index);
+    for (const auto& [stat, field] : kStats) {
+      if (!append(prefix + stat + device, sanitize_value(sample.*field))) {
+        return false;
+      }
+    }
+    if (!append(prefix + "throttle" + device, sample.throttled ? 1.0 : 0.0)) {
+      return false;
+    }
+  }
+
+  return collect_replies(pending);
+}
+
+bool RedisTsSink::publish_gpu_workloads(const std::vector<sensors::gpu::GpuWorkload>& workloads) {
+  if (!ensure_connected()) {
+    return false;
+  }
+
+  const std::string key = options_.key_prefix + ":gpu_workloads";
+  for (const sensors::gpu::GpuWorkload& workload : workloads) {
+    const std::string processes = std::to_string(workload.processes);
+    const std::string sm_util = std::to_string(sanitize_value(workload.sm_util));
+    const std::string mem_util = std::to_string(sanitize_value(workload.mem_util));
+    const std::string fb_used_mb = std::to_string(sanitize_value(workload.fb_used_mb));
+    const char* argv[] = {
+        "XADD", key.c_str(), "MAXLEN", "~", kGpuWorkloadStreamMaxLen, "*",
+        "cgroup", workload.cgroup.c_str(),
+        "processes", processes.c_str(),
+        "sm_util", sm_util.c_str(),
+        "mem_util", mem_util.c_str(),
+        "fb_used_mb", fb_used_mb.c_str(),
+    };
+    const std::size_t argv_len[] = {
+        4, key.size(), 6, 1, std::strlen(kGpuWorkloadStreamMaxLen), 1,
+        6, workload.cgroup.size(),
+        9, processes.size(),
+        7, sm_util.size(),
+        8, mem_util.size(),
+        10, fb_used_mb.size(),
+    };
+    if (!append_command(ReplyKind::auxiliary, 16, argv, argv_len)) {
+      return false;
+    }
+  }
+
+  return collect_replies(workloads.size());
+}
+
+bool RedisTsSink::append_command(const ReplyKind kind, const int argc, const char** argv,
+                                 const std::size_t* argv_len) {
+  // Buffered like the command itself, so it cannot overtake commands already waiting in hiredis.
+  if (asking_ && !write_asking(true)) {
+    return false;
+  }
+  if (redisAppendCommandArgv(context_.get(), argc, argv, argv_len) != REDIS_OK) {
+    return false;
+  }
+  if (options_.async || handshake_pending_) {
+    pending_replies_.push_back({kind, std::chrono::steady_clock::now()});
+  }
+  return true;
+}
+
+bool RedisTsSink::collect_replies(const std::size_t count) {
+  if (options_.async) {
+    return async_flush();
+  }
+
+  // ASKING answers +OK ahead of each command, so it can be read in the same pass.
+  const std::size_t total = count + std::exchange(asking_replies_, 0);
+  bool ok = true;
+  for (std::size_t i = 0; i < total; ++i) {
+    void* raw_reply = nullptr;
+    if (!wait_reply(&raw_reply)) {
+      return false;
+    }
+    auto* reply = static_cast<redisReply*>(raw_reply);
+    const bool error = reply->type == REDIS_REPLY_ERROR;
+    const bool redirected = error && reply->str != nullptr && follow_redirect(reply->str);
+    ok = ok && !error;
+    freeReplyObject(reply);
+    if (redirected) {
+      return false;
+    }
+  }
   return ok;
 }
 
-void RedisTsSink::reserve_command_buffers() {
-  command_args_.reserve(kMaxCommandArgCount);
-  command_argv_.reserve(kMaxCommandArgCount);
-  command_argv_len_.reserve(kMaxCommandArgCount);
+bool RedisTsSink::publish_async(model::signal_frame& frame) {
+  if (!async_ready()) {
+    return false;
+  }
+  if (frames_in_flight_ >= options_.max_in_flight) {
+    frame.agent.redis_dropped = ++dropped_frames_;
+    return false;
+  }
+  if (!write_command(frame_command_)) {
+    drop_connection(std::strerror(errno));
+    return false;
+  }
+  pending_replies_.push_back({ReplyKind::frame, std::chrono::steady_clock::now()});
+  ++frames_in_flight_;
+  return true;
+}
+
+void RedisTsSink::service_until(const std::chrono::steady_clock::time_point deadline) {
+  RedisTsSink* const self[] = {this};
+  service_until(self, deadline);
+}
+
+void RedisTsSink::service_until(const std::span<RedisTsSink* const> sinks,
+                                const std::chrono::steady_clock::time_point deadline) {
+  std::array<pollfd, kMaxServicedSinks> descriptors{};
+  for (;;) {
+    for (RedisTsSink* sink : sinks) {
+      if (sink->options_.async) {
+        sink->async_service();
+      }
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      return;
+    }
+
+    // Sync sinks have nothing to wait for; disconnected ones reconnect on the next publish.
+    std::size_t count = 0;
+    for (RedisTsSink* sink : sinks) {
+      short events = 0;
+      if (sink->connecting_ || sink->output_pending_) {
+        events |= POLLOUT;
+      }
+      if (!sink->pending_replies_.empty()) {
+        events |= POLLIN;
+      }
+      if (sink->options_.async && sink->context_ != nullptr && events != 0 && count < descriptors.size()) {
+        descriptors[count++] = {sink->context_->fd, events, 0};
+      }
+    }
+    if (count == 0) {
+      std::this_thread::sleep_until(deadline);
+      return;
+    }
+
+    const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+    timespec timeout{};
+    timeout.tv_sec = static_cast<time_t>(remaining / 1'000'000'000LL);
+    timeout.tv_nsec = static_cast<long>(remaining % 1'000'000'000LL);
+    (void)::ppoll(descriptors.data(), count, &timeout, nullptr);
+  }
+}
+
+bool RedisTsSink::async_ready() const { return context_ != nullptr && !connecting_; }
+
+void RedisTsSink::async_start_connect() {
+  const auto now = std::chrono::steady_clock::now();
+  if (now < next_connect_attempt_) {
+    return;
+  }
+
+  redisContext* raw = nullptr;
+  if (options_.cluster) {
+    raw = redisConnectNonBlock(target_.host.c_str(), static_cast<int>(target_.port));
+  } else if (!options_.unix_socket.empty()) {
+    raw = redisConnectUnixNonBlock(options_.unix_socket.c_str());
+  } else {
+    raw = redisConnectNonBlock(options_.host.c_str(), static_cast<int>(options_.port));
+  }
+  if (raw == nullptr || raw->err != REDIS_OK) {
+    if (raw != nullptr) {
+      std::cerr << "[redis] connect failed: " << raw->errstr << '\n';
+      redisFree(raw);
+    } else {
+      std::cerr << "[redis] connect failed: out of memory\n";
+    }
+    schedule_reconnect();
+    return;
+  }
+
+  context_.reset(raw);
+  handshake_pending_ = !options_.async;
+  connecting_ = true;
+  connect_started_ = now;
+  async_finish_connect();
+}
+
+void RedisTsSink::async_finish_connect() {
+  pollfd descriptor{context_->fd, POLLOUT, 0};
+  const int ready = ::poll(&descriptor, 1, 0);
+  if (ready == 0) {
+    if (std::chrono::steady_clock::now() - connect_started_ >= std::chrono::milliseconds(options_.connect_timeout_ms)) {
+      drop_connection("connect timed out");
+    }
+    return;
+  }
+
+  int error = 0;
+  socklen_t error_size = sizeof(error);
+  if (ready < 0 || ::getsockopt(context_->fd, SOL_SOCKET, SO_ERROR, &error, &error_size) != 0 || error != 0) {
+    std::cerr << "[redis] connect failed: " << std::strerror(error != 0 ? error : errno) << '\n';
+    drop_connection(nullptr);
+    return;
+  }
+  connecting_ = false;
+
+  // The handshake is pipelined ahead of the first frame; Redis answers in order, so frames can
+  // follow without waiting for it.
+  if (!options_.password.empty()) {
+    const char* argv[] = {"AUTH", options_.password.c_str()};
+    const std::size_t argv_len[] = {4, options_.password.size()};
+    if (!append_command(ReplyKind::handshake, 2, argv, argv_len)) {
+      drop_connection("append failed");
+      return;
+    }
+  }
+  // Cluster nodes only have database 0.
+  if (options_.db != 0 && !options_.cluster) {
+    const std::string db = std::to_string(options_.db);
+    const char* argv[] = {"SELECT", db.c_str()};
+    const std::size_t argv_len[] = {6, db.size()};
+    if (!append_command(ReplyKind::handshake, 2, argv, argv_len)) {
+      drop_connection("append failed");
+      return;
+    }
+  }
+  if (options_.cluster && (slot_map_stale_ || slot_map_.empty())) {
+    const char* argv[] = {"CLUSTER", "SLOTS"};
+    const std::size_t argv_len[] = {7, 5};
+    if (!append_command(ReplyKind::slots, 2, argv, argv_len)) {
+      drop_connection("append failed");
+      return;
+    }
+  }
+  // An importing node already holds the migrating series; it would answer TS.CREATE with MOVED.
+  if (!schema_ready_ && !asking_) {
+    schema_failed_ = false;
+    if (!write_command(schema_command_)) {
+      drop_connection(std::strerror(errno));
+      return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < schema_commands_; ++i) {
+      pending_replies_.push_back({ReplyKind::schema, now});
+    }
+    schema_replies_pending_ += schema_commands_;
+  }
+  (void)async_flush();
+}
+
+void RedisTsSink::async_service() {
+  if (!timeseries_available_) {
+    return;
+  }
+  if (context_ == nullptr) {
+    async_start_connect();
+    return;
+  }
+  if (connecting_) {
+    async_finish_connect();
+    return;
+  }
+
+  if (output_pending_ && !async_flush()) {
+    return;
+  }
+
+  if (!pending_replies_.empty()) {
+    // Non-blocking socket: with nothing to read this returns at once without consuming anything.
+    if (redisBufferRead(context_.get()) != REDIS_OK) {
+      drop_connection(context_->errstr);
+      return;
+    }
+    for (;;) {
+      void* raw_reply = nullptr;
+      if (redisGetReplyFromReader(context_.get(), &raw_reply) != REDIS_OK) {
+        drop_connection(context_->errstr);
+        return;
+      }
+      if (raw_reply == nullptr) {
+        break;
+      }
+      if (pending_replies_.empty()) {
+        freeReplyObject(raw_reply);
+        drop_connection("unexpected reply");
+        return;
+      }
+      const PendingReply pending = pending_replies_.front();
+      pending_replies_.pop_front();
+      handle_reply(pending, static_cast<redisReply*>(raw_reply));
+      freeReplyObject(raw_reply);
+      if (context_ == nullptr) {
+        return;
+      }
+    }
+  }
+
+  if (!pending_replies_.empty() && std::chrono::steady_clock::now() - pending_replies_.front().sent_at >=
+                                       std::chrono::milliseconds(options_.reply_timeout_ms)) {
+    drop_connection("reply timed out");
+  }
+}
+
+bool RedisTsSink::async_flush() {
+  int done = 0;
+  if (redisBufferWrite(context_.get(), &done) != REDIS_OK) {
+    drop_connection(context_->errstr);
+    return false;
+  }
+  output_pending_ = done == 0;
+  return true;
+}
+
+void RedisTsSink::drop_connection(const char* reason) {
+  if (reason != nullptr) {
+    std::cerr << "[redis] connection dropped: " << reason << '\n';
+  }
+  context_.reset();
+  handshake_pending_ = false;
+  asking_replies_ = 0;
+  schedule_reconnect();
+  pending_replies_.clear();
+  frames_in_flight_ = 0;
+  schema_replies_pending_ = 0;
+  connecting_ = false;
+  output_pending_ = false;
+  // Frames still in flight may never have landed; an unanswered backfill is simply sent again.
+  resend_all();
+  backfill_in_flight_ = false;
+}
+
+void RedisTsSink::handle_reply(const PendingReply& pending, const redisReply* reply) {
+  const bool error = reply->type == REDIS_REPLY_ERROR;
+  const char* message = reply->str != nullptr ? reply->str : "unknown";
+
+  if (!error) {
+    connect_failures_ = 0;
+  } else if (follow_redirect(message)) {
+    if (pending.kind == ReplyKind::frame) {
+      ++reply_errors_;
+    }
+    return;
+  }
+  switch (pending.kind) {
+    case ReplyKind::handshake:
+      if (error) {
+        std::cerr << "[redis] handshake rejected: " << message << '\n';
+        drop_connection(nullptr);
+      }
+      return;
+    case ReplyKind::schema:
+      if (schema_replies_pending_ > 0) {
+        --schema_replies_pending_;
+      }
+      if (error && strstr(message, "unknown command") != nullptr) {
+        std::cerr << "[redis] RedisTimeSeries module not available (TS.CREATE unknown command)\n";
+        timeseries_available_ = false;
+        drop_connection(nullptr);
+        return;
+      }
+      // "already exists" and "already has a src rule" both mean an earlier run did the work.
+      if (error && strstr(message, "already") == nullptr) {
+        std::cerr << "[redis] schema error: " << message << '\n';
+        schema_failed_ = true;
+      }
+      schema_ready_ = schema_replies_pending_ == 0 && !schema_failed_;
+      return;
+    case ReplyKind::frame: {
+      if (frames_in_flight_ > 0) {
+        --frames_in_flight_;
+      }
+      last_reply_latency_ms_ = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(
+                                   std::chrono::steady_clock::now() - pending.sent_at)
+                                   .count();
+      // TS.MADD answers with one element per sample; a per-key error does not fail the whole reply.
+      bool failed = error;
+      for (std::size_t i = 0; !failed && reply->type == REDIS_REPLY_ARRAY && i < reply->elements; ++i) {
+        failed = reply->element[i] != nullptr && reply->element[i]->type == REDIS_REPLY_ERROR;
+      }
+      if (failed) {
+        ++reply_errors_;
+      } else {
+        redirects_ = 0;
+      }
+      return;
+    }
+    case ReplyKind::backfill:
+      backfill_in_flight_ = false;
+      if (error) {
+        std::cerr << "[redis] spool backfill rejected: " << message << '\n';
+        ++reply_errors_;
+        return;
+      }
+      spool_.release_until(backfill_until_);
+      return;
+    case ReplyKind::auxiliary:
+      if (error) {
+        ++reply_errors_;
+      }
+      return;
+    case ReplyKind::slots:
+      if (!error) {
+        apply_slot_map(reply);
+      }
+      return;
+    case ReplyKind::asking:
+      return;
+  }
+}
+
+bool RedisTsSink::follow_redirect(const char* message) {
+  ClusterRedirect redirect{};
+  if (!options_.cluster || !parse_cluster_redirect(message, redirect)) {
+    return false;
+  }
+  if (redirect.endpoint.host.empty()) {
+    redirect.endpoint.host = target_.host;
+  }
+  // MOVED is permanent and patches the cache until the next CLUSTER SLOTS; ASK only holds while
+  // the slot migrates, so the map keeps its owner.
+  if (!redirect.ask) {
+    slot_map_.assign(redirect.slot, redirect.endpoint);
+    slot_map_stale_ = true;
+  }
+  asking_ = redirect.ask;
+  redirect_to(redirect.endpoint, redirect.ask ? "ASK" : "MOVED");
+  return true;
+}
+
+void RedisTsSink::apply_slot_map(const redisReply* reply) {
+  if (!slot_map_.update(reply, target_.host)) {
+    return;
+  }
+  slot_map_stale_ = false;
+  const ClusterEndpoint* owner = slot_map_.owner(cluster_slot_);
+  if (owner == nullptr) {
+    return;
+  }
+  if (asking_) {
+    // The migration finished once the importing node owns the slot; until then ASK mode stays.
+    asking_ = !(*owner == target_);
+    return;
+  }
+  if (!(*owner == target_)) {
+    redirect_to(*owner, "slot map");
+  }
+}
+
+void RedisTsSink::redirect_to(const ClusterEndpoint& endpoint, const char* reason) {
+  std::cerr << "[redis] " << reason << ": slot " << cluster_slot_ << " served by " << endpoint.host << ':'
+            << endpoint.port << '\n';
+  target_ = endpoint;
+  drop_connection(nullptr);
+  // A redirect is an answer, not an outage: reconnect at once, unless nodes keep bouncing us.
+  if (++redirects_ <= kMaxImmediateRedirects) {
+    connect_failures_ = 0;
+    next_connect_attempt_ = {};
+  }
 }
 
 }  // namespace hw_agent::sinks
@@ -0,0 +1,144 @@
+#include "sinks/resp_template.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace hw_agent::sinks {
+namespace {
+
+void append_bulk_header(std::string& buffer, const std::size_t size) {
+  buffer.push_back('$');
+  buffer.append(std::to_string(size));
+  buffer.append("\r\n");
+}
+
+}  // namespace
+
+MaddTemplate::MaddTemplate(const std::vector<std::string>& keys) {
+  buffer_.append("*");
+  buffer_.append(std::to_string(1 + (keys.size() * 3)));
+  buffer_.append("\r\n$7\r\nTS.MADD\r\n");
+
+  timestamp_offsets_.reserve(keys.size());
+  value_offsets_.reserve(keys.size());
+  slot_offsets_.reserve(keys.size());
+  for (const std::string& key : keys) {
+    slot_offsets_.push_back(buffer_.size());
+    append_bulk_header(buffer_, key.size());
+    buffer_.append(key);
+    buffer_.append("\r\n");
+
+    append_bulk_header(buffer_, kTimestampWidth);
+    timestamp_offsets_.push_back(buffer_.size());
+    buffer_.append(kTimestampWidth, '0');
+    buffer_.append("\r\n");
+
+    append_bulk_header(buffer_, kValueWidth);
+    value_offsets_.push_back(buffer_.size());
+    buffer_.append(kValueWidth, '0');
+    buffer_.append("\r\n");
+  }
+
+  for (std::size_t slot = 0; slot < value_offsets_.size(); ++slot) {
+    set_value(slot, 0.0);
+  }
+  subset_.reserve(buffer_.size());
+}
+
+bool MaddTemplate::set_timestamp(const std::uint64_t timestamp_ms) noexcept {
+  char digits[24];
+  const char* end = std::to_chars(digits, digits + sizeof(digits), timestamp_ms).ptr;
+  if (static_cast<std::size_t>(end - digits) != kTimestampWidth) {
+    return false;
+  }
+  for (const std::size_t offset : timestamp_offsets_) {
+    std::memcpy(buffer_.data() + offset, digits, kTimestampWidth);
+  }
+  return true;
+}
+
+std::string_view MaddTemplate::command(const std::vector<std::uint8_t>& selected) noexcept {
+  const std::size_t slots = std::min(selected.size(), slot_offsets_.size());
+  const auto count = static_cast<std::size_t>(std::count_if(
+      selected.begin(), selected.begin() + static_cast<std::ptrdiff_t>(slots), [](const std::uint8_t flag) { return flag != 0; }));
+  if (count == 0) {
+    return {};
+  }
+  if (count == slot_offsets_.size()) {
+    return buffer_;
+  }
+
+  // The header is never longer than the full command's, so this stays within the reservation.
+  subset_.clear();
+  append_header(count, subset_);
+  append_selected(selected, subset_);
+  return subset_;
+}
+
+std::size_t MaddTemplate::append_selected(const std::vector<std::uint8_t>& selected, std::string& out) const {
+  const std::size_t slots = std::min(selected.size(), slot_offsets_.size());
+  std::size_t appended = 0;
+  // Copy runs of adjacent selected slots in one go.
+  std::size_t slot = 0;
+  while (slot < slots) {
+    if (selected[slot] == 0) {
+      ++slot;
+      continue;
+    }
+    const std::size_t begin = slot_offsets_[slot];
+    while (slot < slots && selected[slot] != 0) {
+      ++slot;
+      ++appended;
+    }
+    const std::size_t end = slot < slot_offsets_.size() ? slot_offsets_[slot] : buffer_.size();
+    out.append(buffer_, begin, end - begin);
+  }
+  return appended;
+}
+
+void MaddTemplate::append_header(const std::size_t series, std::string& out) {
+  char digits[24];
+  out.push_back('*');
+  out.append(digits, std::to_chars(digits, digits + sizeof(digits), 1 + (series * 3)).ptr);
+  out.append("\r\n$7\r\nTS.MADD\r\n");
+}
+
+void MaddTemplate::set_value(const std::size_t slot, const double value) noexcept {
+  format_value(value, buffer_.data() + value_offsets_[slot]);
+}
+
+void MaddTemplate::format_value(const double value, char* out) noexcept {
+  // Frame values are floats or integer counters, so float precision loses nothing and keeps the
+  // shortest representation within 15 characters.
+  constexpr double kFloatMax = static_cast<double>(std::numeric_limits<float>::max());
+  char digits[32];
+  char* end = digits;
+  if (!std::isfinite(value)) {
+    *end++ = '0';
+  } else if (value == std::trunc(value) && std::fabs(value) < 1e14) {
+    end = std::to_chars(digits, digits + sizeof(digits), static_cast<long long>(value)).ptr;
+  } else {
+    end = std::to_chars(digits, digits + sizeof(digits), static_cast<float>(std::clamp(value, -kFloatMax, kFloatMax))).ptr;
+  }
+
+  // Pad inside the mantissa ("12" -> "12.000...", "1e-07" -> "1.000...e-07").
+  const char* exponent = std::find(static_cast<const char*>(digits), static_cast<const char*>(end), 'e');
+  const bool has_point = std::find(static_cast<const char*>(digits), exponent, '.') != exponent;
+  const std::size_t mantissa_size = static_cast<std::size_t>(exponent - digits);
+  const std::size_t exponent_size = static_cast<std::size_t>(end - exponent);
+  const std::size_t padding = kValueWidth - mantissa_size - exponent_size - (has_point ? 0 : 1);
+
+  std::memcpy(out, digits, mantissa_size);
+  out += mantissa_size;
+  if (!has_point) {
+    *out++ = '.';
+  }
+  std::memset(out, '0', padding);
+  out += padding;
+  std::memcpy(out, exponent, exponent_size);
+}
+
+}  // namespace hw_agent::sinks
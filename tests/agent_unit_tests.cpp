@@ -1,14 +1,25 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <new>
 #include <stdexcept>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include <hiredis/hiredis.h>
@@ -21,6 +32,7 @@
 #include "derived/power_pressure.hpp"
 #include "derived/scheduler_pressure.hpp"
 #include "derived/thermal_pressure.hpp"
+#include "model/frame_codec.hpp"
 #include "model/signal_frame.hpp"
 #include "risk/realtime_risk.hpp"
 #include "risk/saturation_risk.hpp"
@@ -28,11 +40,15 @@
 #include "sensors/cpu.hpp"
 #include "sensors/interrupts.hpp"
 #include "sensors/memory.hpp"
+#include "sensors/perf_events.hpp"
 #include "sensors/power.hpp"
 #include "sensors/psi.hpp"
 #include "sensors/softirqs.hpp"
 #include "sensors/thermal.hpp"
+#include "sinks/frame_spool.hpp"
+#include "sinks/redis_cluster.hpp"
 #include "sinks/redis_ts.hpp"
+#include "sinks/resp_template.hpp"
 
 using hw_agent::core::Sampler;
 using hw_agent::core::load_agent_config;
@@ -50,52 +66,207 @@ using hw_agent::risk::SystemState;
 using hw_agent::sensors::CpuSensor;
 using hw_agent::sensors::InterruptsSensor;
 using hw_agent::sensors::MemorySensor;
+using hw_agent::sensors::PerfEventSensor;
 using hw_agent::sensors::CpuThrottleSensor;
 using hw_agent::sensors::PsiSensor;
 using hw_agent::sensors::SoftirqsSensor;
 using hw_agent::sensors::ThermalSensor;
+using hw_agent::sinks::FrameSpool;
+using hw_agent::sinks::MaddTemplate;
 using hw_agent::sinks::RedisTsOptions;
 using hw_agent::sinks::RedisTsSink;
 
 namespace {
 
 struct RedisMockState {
+  // Commands the fake server received, whether written to the socket or handed to hiredis.
   std::vector<std::string> last_argv{};
-  int command_argv_calls{0};
+  std::vector<std::string> appended_commands{};
+  std::vector<std::vector<std::string>> commands{};
+  int madd_calls{0};
+  // Non-blocking reads: replies the fake server may still release (-1: answer everything).
+  int replies_available{-1};
+  // Commands received but not yet answered.
+  int unanswered{0};
+  int peer_fd{-1};
+  // The sink's end of the socketpair; other connections (TCP blackholes) are never answered.
+  int context_fd{-1};
+  std::string wire{};
+  // Off for allocation counting: the wire is drained without building strings.
+  bool record_wire{true};
+  // Simulates an outage: connects fail with an I/O error.
+  bool refuse_connections{false};
+  // Non-zero: non-blocking connects go to this 127.0.0.1 TCP port instead of a socketpair.
+  std::uint16_t connect_port{0};
+  // "host:port" of every non-blocking connect.
+  std::vector<std::string> connects{};
+  // Error messages answered, in order, instead of the next replies.
+  std::deque<std::string> error_replies{};
+  std::string error_text{};
 };
 
 RedisMockState g_redis_mock{};
+std::atomic<std::size_t> g_allocations{0};
+
+void record_command(std::vector<std::string> argv) {
+  g_redis_mock.appended_commands.push_back(argv.front());
+  g_redis_mock.madd_calls += argv.front() == "TS.MADD" ? 1 : 0;
+  g_redis_mock.commands.push_back(argv);
+  ++g_redis_mock.unanswered;
+  g_redis_mock.last_argv = std::move(argv);
+}
 
-extern "C" {
+// Splits complete "*N\r\n$len\r\n<arg>\r\n..." commands off the front of the wire buffer.
+void parse_wire() {
+  std::string& wire = g_redis_mock.wire;
+  for (;;) {
+    if (wire.empty() || wire[0] != '*') {
+      return;
+    }
+    std::size_t pos = wire.find("\r\n");
+    if (pos == std::string::npos) {
+      return;
+    }
+    const long count = std::strtol(wire.c_str() + 1, nullptr, 10);
+    pos += 2;
+    std::vector<std::string> argv;
+    for (long i = 0; i < count; ++i) {
+      const std::size_t header_end = wire.find("\r\n", pos);
+      if (header_end == std::string::npos || wire[pos] != '$') {
+        return;
+      }
+      const auto size = static_cast<std::size_t>(std::strtoul(wire.c_str() + pos + 1, nullptr, 10));
+      if (header_end + 2 + size + 2 > wire.size()) {
+        return;
+      }
+      argv.push_back(wire.substr(header_end + 2, size));
+      pos = header_end + 2 + size + 2;
+    }
+    wire.erase(0, pos);
+    record_command(std::move(argv));
+  }
+}
 
-redisContext* redisConnectWithTimeout(const char*, int, const struct timeval) {
+void drain_wire() {
+  static char buffer[1 << 16];
+  for (;;) {
+    const ssize_t received = recv(g_redis_mock.peer_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (received <= 0) {
+      break;
+    }
+    if (g_redis_mock.record_wire) {
+      g_redis_mock.wire.append(buffer, static_cast<std::size_t>(received));
+    } else {
+      // Unrecorded commands still expect a reply; '*' only starts a RESP array header in our traffic.
+      g_redis_mock.unanswered += static_cast<int>(std::count(buffer, buffer + received, '*'));
+    }
+  }
+  parse_wire();
+}
+
+redisReply* make_reply(const int type) {
+  auto* reply = static_cast<redisReply*>(std::calloc(1, sizeof(redisReply)));
+  reply->type = type;
+  if (!g_redis_mock.error_replies.empty()) {
+    g_redis_mock.error_text = std::move(g_redis_mock.error_replies.front());
+    g_redis_mock.error_replies.pop_front();
+    reply->type = REDIS_REPLY_ERROR;
+    reply->str = g_redis_mock.error_text.data();
+    reply->len = g_redis_mock.error_text.size();
+  }
+  return reply;
+}
+
+// Contexts sit on one end of a socketpair; the test reads what the sink wrote from the other.
+redisContext* make_socket_context(const bool non_blocking) {
   auto* context = static_cast<redisContext*>(std::calloc(1, sizeof(redisContext)));
-  context->err = REDIS_OK;
+  if (g_redis_mock.refuse_connections) {
+    context->err = REDIS_ERR_IO;
+    std::strcpy(context->errstr, "Connection refused");
+    return context;
+  }
+  int fds[2] = {-1, -1};
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    context->err = REDIS_ERR_IO;
+    return context;
+  }
+  if (non_blocking) {
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+  }
+  context->fd = fds[0];
+  context->flags = REDIS_CONNECTED | (non_blocking ? 0 : REDIS_BLOCK);
+  g_redis_mock.peer_fd = fds[1];
+  g_redis_mock.context_fd = fds[0];
   return context;
 }
 
-redisContext* redisConnectUnixWithTimeout(const char*, const struct timeval) {
+extern "C" {
+
+redisContext* redisConnectWithTimeout(const char*, int, const struct timeval) { return make_socket_context(false); }
+
+redisContext* redisConnectUnixWithTimeout(const char*, const struct timeval) { return make_socket_context(false); }
+
+redisContext* redisConnectNonBlock(const char* host, int port) {
+  g_redis_mock.connects.push_back(std::string(host) + ':' + std::to_string(port));
+  if (g_redis_mock.connect_port == 0) {
+    return make_socket_context(true);
+  }
   auto* context = static_cast<redisContext*>(std::calloc(1, sizeof(redisContext)));
-  context->err = REDIS_OK;
+  context->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(g_redis_mock.connect_port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(context->fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 && errno != EINPROGRESS) {
+    context->err = REDIS_ERR_IO;
+  }
+  context->flags = REDIS_CONNECTED;
   return context;
 }
 
-void redisFree(redisContext* c) { std::free(c); }
-
-void* redisCommand(redisContext*, const char*, ...) {
-  auto* reply = static_cast<redisReply*>(std::calloc(1, sizeof(redisReply)));
-  reply->type = REDIS_REPLY_STATUS;
-  return reply;
+void redisFree(redisContext* c) {
+  if (c != nullptr && (c->flags & REDIS_CONNECTED) != 0) {
+    close(c->fd);
+  }
+  std::free(c);
 }
 
-void* redisCommandArgv(redisContext*, int argc, const char** argv, const size_t*) {
-  g_redis_mock.command_argv_calls += 1;
-  g_redis_mock.last_argv.clear();
+int redisAppendCommandArgv(redisContext*, int argc, const char** argv, const size_t* argvlen) {
+  std::vector<std::string> args;
   for (int i = 0; i < argc; ++i) {
-    g_redis_mock.last_argv.emplace_back(argv[i]);
+    args.emplace_back(argv[i], argvlen != nullptr ? argvlen[i] : std::strlen(argv[i]));
+  }
+  record_command(std::move(args));
+  return REDIS_OK;
+}
+
+int redisAppendFormattedCommand(redisContext*, const char* cmd, size_t len) {
+  g_redis_mock.wire.append(cmd, len);
+  parse_wire();
+  return REDIS_OK;
+}
+
+int redisBufferWrite(redisContext*, int* done) {
+  *done = 1;
+  return REDIS_OK;
+}
+
+int redisBufferRead(redisContext*) { return REDIS_OK; }
+
+int redisGetReplyFromReader(redisContext* context, void** reply) {
+  drain_wire();
+  *reply = nullptr;
+  if (context->fd == g_redis_mock.context_fd && g_redis_mock.unanswered > 0 && g_redis_mock.replies_available != 0) {
+    --g_redis_mock.unanswered;
+    g_redis_mock.replies_available -= g_redis_mock.replies_available > 0 ? 1 : 0;
+    *reply = make_reply(REDIS_REPLY_STATUS);
   }
+  return REDIS_OK;
+}
+
+void* redisCommand(redisContext*, const char*, ...) {
   auto* reply = static_cast<redisReply*>(std::calloc(1, sizeof(redisReply)));
-  reply->type = REDIS_REPLY_ARRAY;
+  reply->type = REDIS_REPLY_STATUS;
   return reply;
 }
 
@@ -103,6 +274,22 @@ void freeReplyObject(void* reply) { std::free(reply); }
 
 }  // extern "C"
 
+}  // namespace
+
+void* operator new(const std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size != 0 ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
 bool almost_equal(float a, float b, float eps = 1e-4F) {
   return std::fabs(a - b) <= eps;
 }
@@ -205,6 +392,72 @@ int test_thermal_pressure_warning_window_configurable() {
   return 0;
 }
 
+int test_scheduler_pressure_includes_softnet_starvation() {
+  SchedulerPressure quiet;
+  SchedulerPressure squeezed;
+  signal_frame quiet_frame{};
+  signal_frame squeezed_frame{};
+
+  squeezed_frame.softnet_squeeze = 1000.0F;
+  quiet.sample(quiet_frame);
+  squeezed.sample(squeezed_frame);
+
+  if (!almost_equal(squeezed_frame.scheduler_pressure - quiet_frame.scheduler_pressure, 0.10F, 1e-3F)) {
+    return fail("test_scheduler_pressure_includes_softnet_starvation", "NET_RX squeeze should saturate the softirq term");
+  }
+
+  return 0;
+}
+
+int test_scheduler_pressure_prefers_measured_run_delay() {
+  SchedulerPressure busy;
+  SchedulerPressure waiting;
+  signal_frame busy_frame{};
+  signal_frame waiting_frame{};
+
+  busy_frame.cpu = 50.0F;
+  waiting_frame.cpu = 50.0F;
+  waiting_frame.sched_run_delay_p99 = 400.0F;
+  busy.sample(busy_frame);
+  waiting.sample(waiting_frame);
+
+  if (!almost_equal(busy_frame.scheduler_pressure, 0.20F, 1e-3F)) {
+    return fail("test_scheduler_pressure_prefers_measured_run_delay", "CPU%/PSI blend should apply without run delay");
+  }
+
+  if (!almost_equal(waiting_frame.scheduler_pressure, 0.80F, 1e-3F)) {
+    return fail("test_scheduler_pressure_prefers_measured_run_delay", "p99 run delay should dominate the blend");
+  }
+
+  return 0;
+}
+
+int test_latency_jitter_prefers_measured_wakeup_latency() {
+  LatencyJitter estimated;
+  LatencyJitter measured;
+  signal_frame estimated_frame{};
+  signal_frame measured_frame{};
+
+  estimated_frame.sched_wait_per_slice_us = 2000.0F;
+  measured_frame.sched_wait_per_slice_us = 2000.0F;
+  measured_frame.wakeup_latency_p50_us = 8.0F;
+  measured_frame.wakeup_latency_p99_us = 50.0F;
+  measured_frame.wakeup_latency_p999_us = 100.0F;
+  measured_frame.wakeup_latency_max_us = 120.0F;
+  estimated.sample(estimated_frame);
+  measured.sample(measured_frame);
+
+  if (!almost_equal(estimated_frame.latency_jitter, 0.60F, 1e-3F)) {
+    return fail("test_latency_jitter_prefers_measured_wakeup_latency", "slice wait should drive jitter without the probe");
+  }
+
+  if (!almost_equal(measured_frame.latency_jitter, 0.06F, 1e-3F)) {
+    return fail("test_latency_jitter_prefers_measured_wakeup_latency", "probe percentiles should replace the estimate");
+  }
+
+  return 0;
+}
+
 int test_sampler_should_sample_every() {
   Sampler sampler;
 
@@ -330,10 +583,35 @@ int test_config_parsing_edge_cases() {
     return fail("test_config_parsing_edge_cases", "thermal_pressure_warning_window_c <= 0 should throw");
   }
 
+  const auto bad_attribution_budget = std::filesystem::temp_directory_path() / "hw_agent_bad_attribution_budget.yaml";
+  {
+    std::ofstream out(bad_attribution_budget);
+    out << "attribution:\n  cpu_budget_pct: 0\n";
+  }
+
+  bool bad_attribution_budget_threw = false;
+  try {
+    (void)load_agent_config(bad_attribution_budget.string());
+  } catch (const std::exception&) {
+    bad_attribution_budget_threw = true;
+  }
+  std::filesystem::remove(bad_attribution_budget);
+
+  if (!bad_attribution_budget_threw) {
+    return fail("test_config_parsing_edge_cases", "attribution.cpu_budget_pct <= 0 should throw");
+  }
+
   const auto unix_socket = std::filesystem::temp_directory_path() / "hw_agent_unix_redis.yaml";
   {
     std::ofstream out(unix_socket);
-    out << "redis:\n  address: unix:///var/run/redis/redis.sock\n";
+    out << "redis:\n  address: unix:///var/run/redis/redis.sock\n  mode: async\n  max_in_flight: 8\n"
+        << "  change_only: true\n  keepalive_ms: 5000\n  deadband: raw:memory=0.5, derived:io_pressure=0.02\n"
+        << "  batch_ticks: 10\n  batch_ms: 50\n"
+        << "  spool_path: /tmp/hw.spool\n  spool_max_mb: 8\n  spool_drain_frames: 25\n"
+        << "  retention_ms: 3600000\n  chunk_size: 256\n  compactions: avg:1s:7d, max:1h\n"
+        << "  events: true\n  events_psi_threshold: 25\n"
+        << "  targets:\n    regional:\n      address: 10.1.0.5:6380\n      metrics: risk:, derived:\n"
+        << "      every_ticks: 10\n      batch_ticks: 6\n";
   }
 
   const auto unix_config = load_agent_config(unix_socket.string());
@@ -342,6 +620,170 @@ int test_config_parsing_edge_cases() {
   if (!unix_config.redis.enabled || unix_config.redis.unix_socket != "/var/run/redis/redis.sock") {
     return fail("test_config_parsing_edge_cases", "unix socket redis address should parse");
   }
+  if (!unix_config.redis.async || unix_config.redis.max_in_flight != 8) {
+    return fail("test_config_parsing_edge_cases", "redis.mode and redis.max_in_flight should parse");
+  }
+  if (!unix_config.redis.change_only || unix_config.redis.keepalive_ms != 5000 ||
+      unix_config.redis.deadbands.size() != 2 || unix_config.redis.deadbands[0].first != "raw:memory" ||
+      unix_config.redis.deadbands[1].second != 0.02 || unix_config.redis.batch_ticks != 10 ||
+      unix_config.redis.batch_ms != 50 || unix_config.redis.spool_path != "/tmp/hw.spool" ||
+      unix_config.redis.spool_max_mb != 8 || unix_config.redis.spool_drain_frames != 25 ||
+      unix_config.redis.retention_ms != 3'600'000 || unix_config.redis.chunk_size != 256 ||
+      unix_config.redis.compactions.size() != 2 || unix_config.redis.compactions[0].retention_ms != 604'800'000 ||
+      unix_config.redis.compactions[1].aggregation != "max" || unix_config.redis.compactions[1].bucket_ms != 3'600'000 ||
+      !unix_config.redis.events || unix_config.redis.events_psi_threshold != 25.0F) {
+    return fail("test_config_parsing_edge_cases", "redis change-only settings should parse");
+  }
+  if (unix_config.redis_targets.size() != 1 || unix_config.redis_targets[0].name != "regional" ||
+      unix_config.redis_targets[0].redis.host != "10.1.0.5" || unix_config.redis_targets[0].redis.port != 6380 ||
+      !unix_config.redis_targets[0].redis.async || unix_config.redis_targets[0].redis.metrics.size() != 2 ||
+      unix_config.redis_targets[0].redis.metrics[1] != "derived:" ||
+      unix_config.redis_targets[0].redis.every_ticks != 10 || unix_config.redis_targets[0].redis.batch_ticks != 6 ||
+      unix_config.redis.batch_ticks != 10 || !unix_config.redis.metrics.empty()) {
+    return fail("test_config_parsing_edge_cases", "redis.targets should parse independently of redis");
+    return fail("test_config_parsing_edge_cases", "redis change-only settings should parse");
+  }
+
+  const auto bad_deadband = std::filesystem::temp_directory_path() / "hw_agent_bad_deadband.yaml";
+  {
+    std::ofstream out(bad_deadband);
+    out << "redis:\n  deadband: raw:memory=-1\n";
+  }
+
+  bool bad_deadband_threw = false;
+  try {
+    (void)load_agent_config(bad_deadband.string());
+  } catch (const std::exception&) {
+    bad_deadband_threw = true;
+  }
+  std::filesystem::remove(bad_deadband);
+
+  if (!bad_deadband_threw) {
+    return fail("test_config_parsing_edge_cases", "negative redis.deadband should throw");
+  }
+
+  const auto bad_compaction = std::filesystem::temp_directory_path() / "hw_agent_bad_compaction.yaml";
+  {
+    std::ofstream out(bad_compaction);
+    out << "redis:\n  compactions: median:1m\n";
+  }
+
+  bool bad_compaction_threw = false;
+  try {
+    (void)load_agent_config(bad_compaction.string());
+  } catch (const std::exception&) {
+    bad_compaction_threw = true;
+  }
+  std::filesystem::remove(bad_compaction);
+
+  if (!bad_compaction_threw) {
+    return fail("test_config_parsing_edge_cases", "unknown redis.compactions aggregation should throw");
+  }
+
+  const auto unix_cluster = std::filesystem::temp_directory_path() / "hw_agent_unix_cluster.yaml";
+  {
+    std::ofstream out(unix_cluster);
+    out << "redis:\n  address: unix:///var/run/redis/redis.sock\n  cluster: true\n";
+  }
+
+  bool unix_cluster_threw = false;
+  try {
+    (void)load_agent_config(unix_cluster.string());
+  } catch (const std::exception&) {
+    unix_cluster_threw = true;
+  }
+  std::filesystem::remove(unix_cluster);
+
+  if (!unix_cluster_threw) {
+    return fail("test_config_parsing_edge_cases", "redis.cluster over a unix socket should throw");
+  }
+
+  const auto sync_target = std::filesystem::temp_directory_path() / "hw_agent_sync_target.yaml";
+  {
+    std::ofstream out(sync_target);
+    out << "redis:\n  targets:\n    regional:\n      address: 10.1.0.5:6379\n      mode: sync\n";
+  }
+
+  bool sync_target_threw = false;
+  try {
+    (void)load_agent_config(sync_target.string());
+  } catch (const std::exception&) {
+    sync_target_threw = true;
+  }
+  std::filesystem::remove(sync_target);
+
+  if (!sync_target_threw) {
+    return fail("test_config_parsing_edge_cases", "a sync redis.targets entry should throw");
+  }
+
+  const auto shared_spool = std::filesystem::temp_directory_path() / "hw_agent_shared_spool.yaml";
+  // Two targets on one file (spelled differently), then the primary section and a target.
+  for (const char* yaml : {"redis:\n  targets:\n    regional:\n      address: 10.1.0.5:6379\n"
+                           "      spool_path: /var/lib/hw-agent//b.spool\n    backup:\n"
+                           "      address: 10.1.0.6:6379\n      spool_path: /var/lib/hw-agent/b.spool\n",
+                           "redis:\n  address: 127.0.0.1:6379\n  mode: async\n  spool_path: /var/lib/hw-agent/a.spool\n"
+                           "  targets:\n    regional:\n      address: 10.1.0.5:6379\n"
+                           "      spool_path: /var/lib/hw-agent/a.spool\n"}) {
+    {
+      std::ofstream out(shared_spool);
+      out << yaml;
+    }
+    bool shared_spool_threw = false;
+    try {
+      (void)load_agent_config(shared_spool.string());
+    } catch (const std::exception&) {
+      shared_spool_threw = true;
+    }
+    if (!shared_spool_threw) {
+      std::filesystem::remove(shared_spool);
+      return fail("test_config_parsing_edge_cases", "redis targets sharing a spool_path should throw");
+    }
+  }
+  {
+    std::ofstream out(shared_spool);
+    out << "redis:\n  address: 127.0.0.1:6379\n  mode: async\n  spool_path: /var/lib/hw-agent/a.spool\n  targets:\n"
+        << "    regional:\n      address: 10.1.0.5:6379\n      spool_path: /var/lib/hw-agent/b.spool\n";
+  }
+  const auto distinct_spools = load_agent_config(shared_spool.string());
+  if (distinct_spools.redis_targets.size() != 1 ||
+      hw_agent::core::effective_reply_timeout_ms(hw_agent::core::RedisConfig{}, distinct_spools.tick_interval) != 50 ||
+      hw_agent::core::effective_reply_timeout_ms(distinct_spools.redis_targets[0].redis,
+                                                 distinct_spools.tick_interval) != 2000) {
+    std::filesystem::remove(shared_spool);
+    return fail("test_config_parsing_edge_cases", "reply timeouts should default by mode");
+  }
+  {
+    std::ofstream out(shared_spool);
+    out << "tick_rate_hz: 10\nredis:\n  address: 127.0.0.1:6379\n  reply_timeout_ms: 100\n";
+  }
+  bool slow_sync_threw = false;
+  try {
+    (void)load_agent_config(shared_spool.string());
+  } catch (const std::exception&) {
+    slow_sync_threw = true;
+  }
+  if (!slow_sync_threw) {
+    std::filesystem::remove(shared_spool);
+    return fail("test_config_parsing_edge_cases", "a sync reply_timeout_ms of a whole tick should throw");
+  }
+  {
+    std::ofstream out(shared_spool);
+    out << "redis:\n  address: 127.0.0.1:6379\n  targets:\n    regional:\n      address: 10.1.0.5:6379\n";
+  }
+  bool sync_primary_threw = false;
+  try {
+    (void)load_agent_config(shared_spool.string());
+  } catch (const std::exception&) {
+    sync_primary_threw = true;
+  }
+  if (!sync_primary_threw) {
+    std::filesystem::remove(shared_spool);
+    return fail("test_config_parsing_edge_cases", "a sync primary alongside redis.targets should throw");
+  }
+  std::filesystem::remove(shared_spool);
+  if (distinct_spools.redis_targets.size() != 1 || distinct_spools.redis_targets[0].redis.spool_path.empty()) {
+    return fail("test_config_parsing_edge_cases", "distinct spool paths should be accepted");
+  }
 
   const auto missing_redis = std::filesystem::temp_directory_path() / "hw_agent_missing_redis.yaml";
   {
@@ -365,10 +807,25 @@ int test_config_parsing_edge_cases() {
   const auto gpu_config = load_agent_config(gpu_index.string());
   std::filesystem::remove(gpu_index);
 
-  if (gpu_config.gpu_device_index != 2U) {
+  if (gpu_config.gpu_device_index != 2U || gpu_config.gpu_devices != std::vector<std::uint32_t>{2}) {
     return fail("test_config_parsing_edge_cases", "gpu.device_index should parse");
   }
 
+  const auto gpu_devices = std::filesystem::temp_directory_path() / "hw_agent_gpu_devices.yaml";
+  {
+    std::ofstream out(gpu_devices);
+    out << "gpu:\n  devices: 0,4-6\n  sysfs_root: /tmp/fake-sys\n";
+  }
+
+  const auto gpu_devices_config = load_agent_config(gpu_devices.string());
+  std::filesystem::remove(gpu_devices);
+
+  if (gpu_devices_config.gpu_devices != std::vector<std::uint32_t>{0, 4, 5, 6} ||
+      gpu_devices_config.gpu_sysfs_root != "/tmp/fake-sys" ||
+      !hw_agent::core::AgentConfig{}.gpu_devices.empty()) {
+    return fail("test_config_parsing_edge_cases", "gpu.devices should parse and default to all devices");
+  }
+
   const auto bad_gpu_index = std::filesystem::temp_directory_path() / "hw_agent_bad_gpu_index.yaml";
   {
     std::ofstream out(bad_gpu_index);
@@ -387,6 +844,55 @@ int test_config_parsing_edge_cases() {
     return fail("test_config_parsing_edge_cases", "negative gpu.device_index should throw");
   }
 
+  const auto wakeup_probe = std::filesystem::temp_directory_path() / "hw_agent_wakeup_probe.yaml";
+  {
+    std::ofstream out(wakeup_probe);
+    out << "wakeup_probe:\n  enabled: true\n  cpus: 0,2-3\n  policy: rr\n  priority: 90\n";
+  }
+  const auto wakeup_config = load_agent_config(wakeup_probe.string());
+  std::filesystem::remove(wakeup_probe);
+
+  if (!wakeup_config.wakeup_probe.enabled || wakeup_config.wakeup_probe.cpus != std::vector<int>{0, 2, 3} ||
+      wakeup_config.wakeup_probe.policy != SCHED_RR || wakeup_config.wakeup_probe.priority != 90) {
+    return fail("test_config_parsing_edge_cases", "wakeup_probe section should parse CPU ranges and policy");
+  }
+
+  const auto bad_wakeup_policy = std::filesystem::temp_directory_path() / "hw_agent_bad_wakeup_policy.yaml";
+  {
+    std::ofstream out(bad_wakeup_policy);
+    out << "wakeup_probe:\n  policy: deadline\n";
+  }
+
+  bool bad_wakeup_policy_threw = false;
+  try {
+    (void)load_agent_config(bad_wakeup_policy.string());
+  } catch (const std::exception&) {
+    bad_wakeup_policy_threw = true;
+  }
+  std::filesystem::remove(bad_wakeup_policy);
+
+  if (!bad_wakeup_policy_threw) {
+    return fail("test_config_parsing_edge_cases", "unknown wakeup_probe.policy should throw");
+  }
+
+  const auto bad_jetson_backend = std::filesystem::temp_directory_path() / "hw_agent_bad_jetson_backend.yaml";
+  {
+    std::ofstream out(bad_jetson_backend);
+    out << "jetson:\n  backend: nvpmodel\n";
+  }
+
+  bool bad_jetson_backend_threw = false;
+  try {
+    (void)load_agent_config(bad_jetson_backend.string());
+  } catch (const std::exception&) {
+    bad_jetson_backend_threw = true;
+  }
+  std::filesystem::remove(bad_jetson_backend);
+
+  if (!bad_jetson_backend_threw) {
+    return fail("test_config_parsing_edge_cases", "unknown jetson.backend should throw");
+  }
+
   return 0;
 }
 
@@ -576,7 +1082,7 @@ int test_redis_sink_publish_logic() {
     return fail("test_redis_sink_publish_logic", "publish should succeed with mock redis");
   }
 
-  if (g_redis_mock.command_argv_calls != 1) {
+  if (g_redis_mock.madd_calls != 1) {
     return fail("test_redis_sink_publish_logic", "expected one TS.MADD call");
   }
 
@@ -593,6 +1099,866 @@ int test_redis_sink_publish_logic() {
   return 0;
 }
 
+int test_redis_async_sink_bounds_in_flight_frames() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu", "agent:redis_dropped"};
+  options.async = true;
+  options.max_in_flight = 2;
+  g_redis_mock.replies_available = 0;
+
+  RedisTsSink sink(options);
+  if (!sink.check_connectivity()) {
+    return fail("test_redis_async_sink_bounds_in_flight_frames", "non-blocking connect should complete");
+  }
+  // TS.CREATE then TS.ALTER per series, written in one go.
+  drain_wire();
+  if (g_redis_mock.appended_commands.size() != 4 || g_redis_mock.appended_commands.front() != "TS.CREATE") {
+    return fail("test_redis_async_sink_bounds_in_flight_frames", "schema should be pipelined after connect");
+  }
+
+  // The fake server answers nothing yet: two frames fill the window, the third is dropped.
+  signal_frame frame{};
+  for (int i = 0; i < 2; ++i) {
+    if (!sink.publish(frame)) {
+      return fail("test_redis_async_sink_bounds_in_flight_frames", "frames within the window should be queued");
+    }
+  }
+  if (sink.publish(frame) || frame.agent.redis_dropped != 1) {
+    return fail("test_redis_async_sink_bounds_in_flight_frames", "frame beyond the window should be dropped");
+  }
+
+  // Replies to the schema and both frames reopen the window on the next tick.
+  g_redis_mock.replies_available = 6;
+  if (!sink.publish(frame)) {
+    return fail("test_redis_async_sink_bounds_in_flight_frames", "window should reopen once replies arrive");
+  }
+
+  drain_wire();
+  std::size_t frames = 0;
+  for (const auto& command : g_redis_mock.appended_commands) {
+    frames += command == "TS.MADD" ? 1 : 0;
+  }
+  if (frames != 3) {
+    return fail("test_redis_async_sink_bounds_in_flight_frames", "expected three TS.MADD frames on the wire");
+  }
+
+  bool found_dropped = false;
+  for (std::size_t i = 0; i + 2 < g_redis_mock.last_argv.size(); ++i) {
+    if (g_redis_mock.last_argv[i] == "edge:test:agent:redis_dropped") {
+      found_dropped = g_redis_mock.last_argv[i + 2].find('1') != std::string::npos;
+    }
+  }
+  if (!found_dropped) {
+    return fail("test_redis_async_sink_bounds_in_flight_frames", "agent:redis_dropped should report the drop");
+  }
+
+  // service_until waits on the socket without blocking past its deadline.
+  const auto start = std::chrono::steady_clock::now();
+  sink.service_until(start + std::chrono::milliseconds(20));
+  if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(500)) {
+    return fail("test_redis_async_sink_bounds_in_flight_frames", "service_until overran its deadline");
+  }
+
+  return 0;
+}
+
+int test_madd_template_renders_fixed_width_fields() {
+  MaddTemplate madd({"edge:test:raw:cpu", "edge:test:agent:heartbeat"});
+  const std::size_t size = madd.command().size();
+  if (!madd.set_timestamp(1'700'000'000'123ULL) || madd.set_timestamp(12'345ULL)) {
+    return fail("test_madd_template_renders_fixed_width_fields", "only 13-digit millisecond timestamps fit");
+  }
+  madd.set_value(0, -1.5e-7);
+  madd.set_value(1, 1'700'000'000'123.0);
+  if (madd.command().size() != size) {
+    return fail("test_madd_template_renders_fixed_width_fields", "patching must not resize the command");
+  }
+
+  g_redis_mock = {};
+  g_redis_mock.wire.assign(madd.command());
+  parse_wire();
+  const std::vector<std::string>& argv = g_redis_mock.last_argv;
+  if (argv.size() != 7 || argv[0] != "TS.MADD" || argv[1] != "edge:test:raw:cpu" || argv[2] != "1700000000123" ||
+      argv[4] != "edge:test:agent:heartbeat" || argv[5] != "1700000000123") {
+    return fail("test_madd_template_renders_fixed_width_fields", "template should parse as TS.MADD key ts value");
+  }
+  if (argv[3].size() != MaddTemplate::kValueWidth || std::strtof(argv[3].c_str(), nullptr) != -1.5e-7F ||
+      argv[6] != "1700000000123.00") {
+    return fail("test_madd_template_renders_fixed_width_fields", "values should round-trip at a fixed width");
+  }
+
+  char text[MaddTemplate::kValueWidth + 1]{};
+  MaddTemplate::format_value(41.0, text);
+  if (std::string(text) != "41.0000000000000") {
+    return fail("test_madd_template_renders_fixed_width_fields", "integers should pad after a decimal point");
+  }
+  MaddTemplate::format_value(std::nan(""), text);
+  if (std::strtod(text, nullptr) != 0.0) {
+    return fail("test_madd_template_renders_fixed_width_fields", "non-finite values should publish as 0");
+  }
+  return 0;
+}
+
+int test_redis_frame_publish_does_not_allocate() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  // The first publish connects and creates the schema; only steady-state ticks are counted.
+  if (!sink.publish(frame)) {
+    return fail("test_redis_frame_publish_does_not_allocate", "publish should succeed with mock redis");
+  }
+  g_redis_mock.record_wire = false;
+
+  const std::size_t allocations_before = g_allocations.load(std::memory_order_relaxed);
+  for (int i = 0; i < 100; ++i) {
+    frame.cpu = static_cast<float>(i) * 0.37F;
+    frame.memory = static_cast<float>(i);
+    frame.agent.heartbeat_ms += 100;
+    if (!sink.publish(frame)) {
+      return fail("test_redis_frame_publish_does_not_allocate", "steady-state publish failed");
+    }
+  }
+  if (g_allocations.load(std::memory_order_relaxed) != allocations_before) {
+    return fail("test_redis_frame_publish_does_not_allocate", "TS.MADD publish allocated on the heap");
+  }
+  return 0;
+}
+
+int test_redis_change_only_publishes_refreshed_series() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu", "raw:memory", "derived:memory_pressure"};
+  options.change_only = true;
+  options.keepalive_ms = 200;
+  options.deadbands = {{"raw:memory", 1.0}};
+
+  RedisTsSink sink(options);
+  const int cpu = sink.refresh_group("cpu");
+  const int memory = sink.refresh_group("memory");
+  if (cpu < 0 || memory < 0 || cpu == memory || sink.refresh_group("gpu") != -1) {
+    return fail("test_redis_change_only_publishes_refreshed_series", "refresh groups should follow published sensors");
+  }
+
+  signal_frame frame{};
+  if (!sink.publish(frame) || g_redis_mock.last_argv.size() != 10) {
+    return fail("test_redis_change_only_publishes_refreshed_series", "first frame should carry every series");
+  }
+
+  // Memory moves within its deadband: only the CPU sample goes out.
+  frame.cpu = 5.0F;
+  frame.memory = 0.5F;
+  sink.mark_refreshed(cpu);
+  sink.mark_refreshed(memory);
+  if (!sink.publish(frame) || g_redis_mock.last_argv.size() != 4 || g_redis_mock.last_argv[1] != "edge:test:raw:cpu") {
+    return fail("test_redis_change_only_publishes_refreshed_series", "only the changed series should be written");
+  }
+
+  // The CPU sensor did not run, so its field is not compared and nothing is written.
+  frame.cpu = 7.0F;
+  const int madd_calls = g_redis_mock.madd_calls;
+  if (!sink.publish(frame) || g_redis_mock.madd_calls != madd_calls) {
+    return fail("test_redis_change_only_publishes_refreshed_series", "an unchanged frame should skip TS.MADD");
+  }
+  if (frame.agent.redis_samples != 1 || frame.agent.redis_suppressed != 2) {
+    return fail("test_redis_change_only_publishes_refreshed_series", "previous frame's write volume should be reported");
+  }
+
+  frame.memory = 2.0F;
+  sink.mark_refreshed(memory);
+  if (!sink.publish(frame) || g_redis_mock.last_argv.size() != 4 || g_redis_mock.last_argv[1] != "edge:test:raw:memory" ||
+      std::strtod(g_redis_mock.last_argv[3].c_str(), nullptr) != 2.0) {
+    return fail("test_redis_change_only_publishes_refreshed_series", "a move past the deadband should be written");
+  }
+
+  g_redis_mock.record_wire = false;
+  const std::size_t allocations_before = g_allocations.load(std::memory_order_relaxed);
+  for (int i = 0; i < 50; ++i) {
+    frame.cpu = static_cast<float>(i);
+    sink.mark_refreshed(cpu);
+    if (!sink.publish(frame)) {
+      return fail("test_redis_change_only_publishes_refreshed_series", "steady-state publish failed");
+    }
+  }
+  if (g_allocations.load(std::memory_order_relaxed) != allocations_before) {
+    return fail("test_redis_change_only_publishes_refreshed_series", "subset TS.MADD publish allocated on the heap");
+  }
+  g_redis_mock.record_wire = true;
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  if (!sink.publish(frame) || g_redis_mock.last_argv.size() != 10) {
+    return fail("test_redis_change_only_publishes_refreshed_series", "keep-alive should rewrite every series");
+  }
+  return 0;
+}
+
+int test_redis_batching_keeps_timestamps_and_flushes_on_state_change() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu", "risk:state"};
+  options.batch_ticks = 3;
+
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  if (!sink.publish(frame) || g_redis_mock.madd_calls != 1) {
+    return fail("test_redis_batching_keeps_timestamps_and_flushes_on_state_change", "first tick should flush at once");
+  }
+  // The first flush also publishes both histograms; flush_latency_ms:leinf is the last key.
+  const std::vector<std::string>& histogram = g_redis_mock.last_argv;
+  if (histogram.size() != 21 || histogram[0] != "TS.ADD" ||
+      histogram[1] != "edge:test:agent:redis_flush_latency_ms:leinf" || histogram[3] != "1" ||
+      histogram[18] != "redis_flush_latency_ms:leinf" || histogram[20] != "agent") {
+    return fail("test_redis_batching_keeps_timestamps_and_flushes_on_state_change", "batch histograms should be published");
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    frame.cpu = static_cast<float>(i + 1);
+    if (!sink.publish(frame)) {
+      return fail("test_redis_batching_keeps_timestamps_and_flushes_on_state_change", "batched publish failed");
+    }
+    if (i < 2 && g_redis_mock.madd_calls != 1) {
+      return fail("test_redis_batching_keeps_timestamps_and_flushes_on_state_change", "ticks should be held until the batch fills");
+    }
+  }
+  const std::vector<std::string>& batch = g_redis_mock.last_argv;
+  if (g_redis_mock.madd_calls != 2 || batch.size() != 19) {
+    return fail("test_redis_batching_keeps_timestamps_and_flushes_on_state_change", "three ticks should share one TS.MADD");
+  }
+  // Per tick: raw:cpu then risk:state, each with that tick's own timestamp.
+  if (!(batch[2] < batch[8] && batch[8] < batch[14]) || batch[2] != batch[5] ||
+      std::strtod(batch[9].c_str(), nullptr) != 2.0) {
+    return fail("test_redis_batching_keeps_timestamps_and_flushes_on_state_change", "samples should keep their tick timestamps");
+  }
+
+  frame.state = hw_agent::model::system_state::DEGRADED;
+  if (!sink.publish(frame) || g_redis_mock.madd_calls != 3 || g_redis_mock.last_argv.size() != 7) {
+    return fail("test_redis_batching_keeps_timestamps_and_flushes_on_state_change", "a risk:state change should flush at once");
+  }
+  return 0;
+}
+
+int test_redis_blackhole_outage_keeps_tick_cadence() {
+  // A listener that never accepts: connects complete in the kernel backlog, nothing ever answers.
+  const int listener = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_size = sizeof(address);
+  if (listener < 0 || bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+      listen(listener, 16) != 0 || getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_size) != 0) {
+    return fail("test_redis_blackhole_outage_keeps_tick_cadence", "cannot create blackhole listener");
+  }
+  g_redis_mock = {};
+  g_redis_mock.connect_port = ntohs(address.sin_port);
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu", "agent:redis_breaker"};
+  options.reply_timeout_ms = 60;
+  options.reconnect_min_ms = 20;
+  options.reconnect_max_ms = 40;
+
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  constexpr auto kTick = std::chrono::milliseconds(10);
+  auto next_tick = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration worst_publish{};
+  bool saw_half_open = false;
+  bool saw_open = false;
+  for (int tick = 0; tick < 40; ++tick) {
+    const auto start = std::chrono::steady_clock::now();
+    if (sink.publish(frame)) {
+      close(listener);
+      return fail("test_redis_blackhole_outage_keeps_tick_cadence", "publish cannot succeed against a blackhole");
+    }
+    worst_publish = std::max(worst_publish, std::chrono::steady_clock::now() - start);
+    saw_half_open = saw_half_open || frame.agent.redis_breaker == 1;
+    saw_open = saw_open || frame.agent.redis_breaker == 2;
+    next_tick += kTick;
+    std::this_thread::sleep_until(next_tick);
+  }
+  close(listener);
+
+  // A blocking connect or handshake would hold a tick for the 1000 ms connect timeout.
+  if (worst_publish > std::chrono::milliseconds(20)) {
+    return fail("test_redis_blackhole_outage_keeps_tick_cadence", "a tick waited on the unresponsive server");
+  }
+  if (!saw_half_open || !saw_open) {
+    return fail("test_redis_blackhole_outage_keeps_tick_cadence", "breaker should cycle between half-open and open");
+  }
+  return 0;
+}
+
+int test_redis_sync_reply_wait_fits_in_a_tick() {
+  g_redis_mock = {};
+
+  // The default sync reply wait at a 100 ms tick.
+  constexpr auto kTick = std::chrono::milliseconds(100);
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu"};
+  options.connect_timeout_ms = 1000;
+  options.reply_timeout_ms = hw_agent::core::effective_reply_timeout_ms(hw_agent::core::RedisConfig{}, kTick);
+
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  if (!sink.check_connectivity() || !sink.publish(frame)) {
+    return fail("test_redis_sync_reply_wait_fits_in_a_tick", "sync sink should connect and publish");
+  }
+
+  // Redis accepted the handshake and then hangs.
+  g_redis_mock.replies_available = 0;
+  const auto start = std::chrono::steady_clock::now();
+  if (sink.publish(frame)) {
+    return fail("test_redis_sync_reply_wait_fits_in_a_tick", "an unanswered frame cannot succeed");
+  }
+  const auto waited = std::chrono::steady_clock::now() - start;
+  if (waited < kTick / 2 || waited >= kTick) {
+    return fail("test_redis_sync_reply_wait_fits_in_a_tick", "a hung server should cost half a tick, not more");
+  }
+  // The hung connection was dropped: the next tick backs off instead of waiting again.
+  if (sink.publish(frame) || frame.agent.redis_breaker != 2) {
+    return fail("test_redis_sync_reply_wait_fits_in_a_tick", "the hung connection should be dropped");
+  }
+  return 0;
+}
+
+int test_redis_targets_service_independently() {
+  const int listener = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_size = sizeof(address);
+  if (listener < 0 || bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+      listen(listener, 16) != 0 || getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_size) != 0) {
+    return fail("test_redis_targets_service_independently", "cannot create blackhole listener");
+  }
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu"};
+  options.async = true;
+  options.reply_timeout_ms = 60;
+  options.reconnect_min_ms = 20;
+  options.reconnect_max_ms = 40;
+
+  RedisTsSink local(options);
+  if (!local.check_connectivity()) {
+    close(listener);
+    return fail("test_redis_targets_service_independently", "local target should connect");
+  }
+  // The regional target (and each of its reconnects) goes to a listener that never answers.
+  g_redis_mock.connect_port = ntohs(address.sin_port);
+  RedisTsSink regional(options);
+  signal_frame regional_frame{};
+  (void)regional.publish(regional_frame);
+
+  // The agent publishes its primary first: 30 ticks with the healthy target as primary, then 30 with
+  // the silent one.
+  RedisTsSink* const local_first[] = {&local, &regional};
+  RedisTsSink* const regional_first[] = {&regional, &local};
+  signal_frame local_frame{};
+  constexpr auto kTick = std::chrono::milliseconds(10);
+  auto next_tick = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration worst_overrun{};
+  int local_failures = 0;
+  for (int tick = 0; tick < 60; ++tick) {
+    const std::span<RedisTsSink* const> sinks = tick < 30 ? std::span{local_first} : std::span{regional_first};
+    for (RedisTsSink* sink : sinks) {
+      if (sink == &local) {
+        local_failures += local.publish(local_frame) ? 0 : 1;
+      } else {
+        (void)regional.publish(regional_frame);
+      }
+    }
+    next_tick += kTick;
+    RedisTsSink::service_until(sinks, next_tick);
+    worst_overrun = std::max(worst_overrun, std::chrono::steady_clock::now() - next_tick);
+  }
+  close(listener);
+  g_redis_mock.connect_port = 0;
+
+  if (local_failures != 0 || g_redis_mock.madd_calls != 60 || local_frame.agent.redis_dropped != 0) {
+    return fail("test_redis_targets_service_independently", "the local target should write every tick");
+  }
+  // Well under the regional reply timeout: waiting on that connection would overrun by far more.
+  if (worst_overrun > std::chrono::milliseconds(30)) {
+    return fail("test_redis_targets_service_independently", "a silent target should not hold up the wait");
+  }
+  if (regional_frame.agent.redis_breaker == 0) {
+    return fail("test_redis_targets_service_independently", "the regional target keeps its own breaker");
+  }
+  return 0;
+}
+
+int test_redis_schema_labels_series_and_creates_compactions() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu", "derived:io_pressure"};
+  options.retention_ms = 86'400'000;
+  options.chunk_size = 128;
+  options.compactions = {{"avg", 60'000, 0}, {"max", 3'600'000, 2'592'000'000ULL}};
+
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  if (!sink.publish(frame)) {
+    return fail("test_redis_schema_labels_series_and_creates_compactions", "publish failed");
+  }
+  // Per series: CREATE/ALTER, then CREATE/ALTER/CREATERULE per rule; the frame follows.
+  const std::vector<std::vector<std::string>>& commands = g_redis_mock.commands;
+  if (commands.size() != 17 || commands[16].front() != "TS.MADD") {
+    return fail("test_redis_schema_labels_series_and_creates_compactions", "schema should precede the first frame");
+  }
+  const std::vector<std::string> create = {"TS.CREATE", "edge:test:raw:cpu", "RETENTION", "86400000", "ENCODING",
+                                           "COMPRESSED", "CHUNK_SIZE", "128", "DUPLICATE_POLICY", "LAST", "LABELS",
+                                           "node", "edge:test", "family", "raw", "metric", "cpu", "sensor", "cpu"};
+  if (commands[0] != create || commands[1].front() != "TS.ALTER" || commands[1].size() != create.size() - 2) {
+    return fail("test_redis_schema_labels_series_and_creates_compactions", "series should be created with labels");
+  }
+  const std::vector<std::string>& hourly = commands[5];
+  if (hourly.size() != 23 || hourly[1] != "edge:test:raw:cpu:max_1h" || hourly[3] != "2592000000" ||
+      hourly[20] != "max" || hourly[22] != "3600000") {
+    return fail("test_redis_schema_labels_series_and_creates_compactions", "compacted series should be labelled");
+  }
+  const std::vector<std::string> rule = {"TS.CREATERULE", "edge:test:raw:cpu", "edge:test:raw:cpu:avg_1m",
+                                         "AGGREGATION", "avg", "60000"};
+  if (commands[4] != rule) {
+    return fail("test_redis_schema_labels_series_and_creates_compactions", "compaction rule should follow its series");
+  }
+  if (commands[8][17] != "sensor" || commands[8][18] != "derived" || commands[8][16] != "io_pressure") {
+    return fail("test_redis_schema_labels_series_and_creates_compactions", "derived series should carry their family");
+  }
+
+  // Series that TS.ADD creates on first write get the same options and labels.
+  std::vector<PerfEventSensor::CpuRates> per_cpu(1);
+  per_cpu[0].cpu = 2;
+  g_redis_mock.commands.clear();
+  if (!sink.publish_perf_per_cpu(per_cpu, false) || g_redis_mock.commands.size() != 3) {
+    return fail("test_redis_schema_labels_series_and_creates_compactions", "per-CPU series should be added");
+  }
+  const std::vector<std::string> add = {"TS.ADD", "edge:test:raw:perf_migrations:cpu2", g_redis_mock.commands[1][2],
+                                        g_redis_mock.commands[1][3], "RETENTION", "86400000", "ENCODING",
+                                        "COMPRESSED", "CHUNK_SIZE", "128", "ON_DUPLICATE", "LAST", "LABELS",
+                                        "node", "edge:test", "family", "raw", "metric", "perf_migrations:cpu2",
+                                        "sensor", "perf"};
+  if (g_redis_mock.commands[1] != add) {
+    return fail("test_redis_schema_labels_series_and_creates_compactions", "TS.ADD should carry the series schema");
+  }
+  return 0;
+}
+
+int test_frame_codec_round_trips_and_tolerates_other_versions() {
+  using hw_agent::model::decode_frame;
+  using hw_agent::model::encode_frame;
+  using hw_agent::model::kEncodedFrameSize;
+
+  signal_frame frame{};
+  frame.monotonic_ns = 123'456'789ULL;
+  frame.psi = 0.25F;
+  frame.saturation_risk = 0.75F;
+  frame.state = hw_agent::model::system_state::CRITICAL;
+  frame.agent.heartbeat_ms = 1'700'000'000'123ULL;
+  frame.agent.compute_time_ms = 1.5F;
+  frame.agent.missed_cycles = 7;
+
+  std::vector<unsigned char> bytes(kEncodedFrameSize);
+  encode_frame(frame, 1'700'000'000'456ULL, bytes.data());
+  signal_frame decoded{};
+  std::uint64_t unix_ms = 0;
+  if (!decode_frame(bytes.data(), bytes.size(), decoded, unix_ms) || unix_ms != 1'700'000'000'456ULL ||
+      decoded.monotonic_ns != frame.monotonic_ns || decoded.psi != 0.25F || decoded.saturation_risk != 0.75F ||
+      decoded.state != frame.state || decoded.agent.heartbeat_ms != frame.agent.heartbeat_ms ||
+      decoded.agent.compute_time_ms != 1.5F || decoded.agent.missed_cycles != 7) {
+    return fail("test_frame_codec_round_trips_and_tolerates_other_versions", "frame should round-trip");
+  }
+
+  // A newer producer with one more float and one more counter: known fields still line up.
+  std::vector<unsigned char> newer(bytes.begin(), bytes.begin() + hw_agent::model::kFrameHeaderSize);
+  const std::size_t floats = std::size(hw_agent::model::kFrameFloatFields);
+  const std::size_t counters = std::size(hw_agent::model::kFrameCounterFields);
+  newer[4] = static_cast<unsigned char>(floats + 1);
+  newer[6] = static_cast<unsigned char>(counters + 1);
+  const auto float_bytes = bytes.begin() + static_cast<std::ptrdiff_t>(hw_agent::model::kFrameHeaderSize + (floats * 4));
+  newer.insert(newer.end(), bytes.begin() + hw_agent::model::kFrameHeaderSize, float_bytes);
+  newer.insert(newer.end(), {0, 0, 0x80, 0x3F});
+  newer.insert(newer.end(), float_bytes, bytes.end());
+  newer.insert(newer.end(), {1, 0, 0, 0});
+  if (!decode_frame(newer.data(), newer.size(), decoded, unix_ms) || decoded.saturation_risk != 0.75F ||
+      decoded.agent.missed_cycles != 7) {
+    return fail("test_frame_codec_round_trips_and_tolerates_other_versions", "newer frames should decode known fields");
+  }
+
+  // An older producer without the counters: they decode as zero.
+  std::vector<unsigned char> older(bytes.begin(), float_bytes);
+  older[6] = 0;
+  if (!decode_frame(older.data(), older.size(), decoded, unix_ms) || decoded.psi != 0.25F ||
+      decoded.agent.missed_cycles != 0) {
+    return fail("test_frame_codec_round_trips_and_tolerates_other_versions", "older frames should decode");
+  }
+
+  if (decode_frame(bytes.data(), bytes.size() - 1, decoded, unix_ms) ||
+      decode_frame("HWF\x02", 4, decoded, unix_ms)) {
+    return fail("test_frame_codec_round_trips_and_tolerates_other_versions", "truncated or foreign data must be rejected");
+  }
+  return 0;
+}
+
+int test_redis_frame_stream_xadds_binary_frame() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu"};
+  options.frames_maxlen = 500;
+
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  frame.cpu = 42.0F;
+  if (!sink.publish(frame) || !sink.publish_frame_stream(frame)) {
+    return fail("test_redis_frame_stream_xadds_binary_frame", "publish failed");
+  }
+  const std::vector<std::string> madd = g_redis_mock.commands[g_redis_mock.commands.size() - 2];
+  const std::vector<std::string>& xadd = g_redis_mock.last_argv;
+  if (xadd.size() != 8 || xadd[0] != "XADD" || xadd[1] != "edge:test:frames" || xadd[2] != "MAXLEN" ||
+      xadd[3] != "~" || xadd[4] != "500" || xadd[5] != "*" || xadd[6] != "f" ||
+      xadd[7].size() != hw_agent::model::kEncodedFrameSize) {
+    return fail("test_redis_frame_stream_xadds_binary_frame", "frame should be XADDed to the frames stream");
+  }
+  signal_frame decoded{};
+  std::uint64_t unix_ms = 0;
+  if (!hw_agent::model::decode_frame(xadd[7].data(), xadd[7].size(), decoded, unix_ms) || decoded.cpu != 42.0F ||
+      madd.size() != 4 || std::to_string(unix_ms) != madd[2]) {
+    return fail("test_redis_frame_stream_xadds_binary_frame", "stream frame should carry the TS.MADD timestamp");
+  }
+  return 0;
+}
+
+int test_redis_perf_per_cpu_series() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:perf_context_switches"};
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  if (!sink.publish(frame)) {
+    return fail("test_redis_perf_per_cpu_series", "publish should succeed with mock redis");
+  }
+
+  std::vector<PerfEventSensor::CpuRates> per_cpu(3);
+  per_cpu[0].cpu = 0;
+  per_cpu[0].context_switches_per_sec = 1500.0F;
+  per_cpu[1].cpu = 3;
+  per_cpu[1].major_faults_per_sec = 2.0F;
+  per_cpu[1].ipc = 1.25F;
+  // A CPU that failed to open its counters has no id and no series.
+  g_redis_mock.commands.clear();
+  if (!sink.publish_perf_per_cpu(per_cpu, false) || g_redis_mock.commands.size() != 6 ||
+      g_redis_mock.commands[0][0] != "TS.ADD" ||
+      g_redis_mock.commands[0][1] != "edge:test:raw:perf_context_switches:cpu0" ||
+      g_redis_mock.commands[0][3].rfind("1500", 0) != 0 ||
+      g_redis_mock.commands[5][1] != "edge:test:raw:perf_major_faults:cpu3" ||
+      g_redis_mock.commands[5][3].rfind("2", 0) != 0) {
+    return fail("test_redis_perf_per_cpu_series", "software rates should be one TS.ADD per CPU and stat");
+  }
+
+  g_redis_mock.commands.clear();
+  if (!sink.publish_perf_per_cpu(per_cpu, true) || g_redis_mock.commands.size() != 10 ||
+      g_redis_mock.commands[8][1] != "edge:test:raw:perf_ipc:cpu3" ||
+      g_redis_mock.commands[8][3].rfind("1.25", 0) != 0 ||
+      g_redis_mock.commands[9][1] != "edge:test:raw:perf_llc_misses:cpu3") {
+    return fail("test_redis_perf_per_cpu_series", "hardware rates should follow when the PMU is available");
+  }
+  return 0;
+}
+
+int test_redis_events_publish_transitions_immediately() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"risk:state"};
+  options.batch_ticks = 8;
+
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  if (!sink.publish(frame)) {
+    return fail("test_redis_events_publish_transitions_immediately", "first publish failed");
+  }
+  const int madd_before = g_redis_mock.madd_calls;
+
+  frame.state = hw_agent::model::system_state::UNSTABLE;
+  frame.realtime_risk = 0.75F;
+  frame.memory_pressure = 0.5F;
+  hw_agent::sinks::RiskEvent transition{};
+  transition.onset = true;
+  transition.previous = hw_agent::model::system_state::DEGRADED;
+  if (!sink.publish_event(transition, frame)) {
+    return fail("test_redis_events_publish_transitions_immediately", "state event failed");
+  }
+  const std::vector<std::string> state_event = g_redis_mock.last_argv;
+  if (state_event.size() != 3 || state_event[0] != "PUBLISH" || state_event[1] != "edge:test:events" ||
+      state_event[2].rfind("{\"seq\":1,", 0) != 0 ||
+      state_event[2].find("\"event\":\"state\",\"source\":\"\",\"onset\":true,\"prev\":1,\"state\":2,"
+                          "\"max_risk\":0.75,") == std::string::npos ||
+      state_event[2].find("\"memory\":0.5,") == std::string::npos || g_redis_mock.madd_calls != madd_before) {
+    return fail("test_redis_events_publish_transitions_immediately", "state event payload mismatch");
+  }
+
+  hw_agent::sinks::RiskEvent recovery{hw_agent::sinks::RiskEvent::Kind::sensor, "disk", false};
+  if (!sink.publish_event(recovery, frame) ||
+      g_redis_mock.last_argv[2].find("\"seq\":2,") == std::string::npos ||
+      g_redis_mock.last_argv[2].find("\"event\":\"sensor\",\"source\":\"disk\",\"onset\":false,\"prev\":2,") ==
+          std::string::npos) {
+    return fail("test_redis_events_publish_transitions_immediately", "sensor event payload mismatch");
+  }
+  return 0;
+}
+
+int test_redis_cluster_slots_and_redirects_parse() {
+  using hw_agent::sinks::ClusterEndpoint;
+  using hw_agent::sinks::ClusterRedirect;
+  using hw_agent::sinks::ClusterSlotMap;
+  using hw_agent::sinks::cluster_key_slot;
+
+  // Reference slots from the Redis Cluster specification and CLUSTER KEYSLOT.
+  if (cluster_key_slot("123456789") != 12739 || cluster_key_slot("foo") != 12182 ||
+      cluster_key_slot("{user1000}.following") != cluster_key_slot("{user1000}.followers") ||
+      cluster_key_slot("{edge-01}:raw:cpu") != cluster_key_slot("{edge-01}:risk:state") ||
+      cluster_key_slot("foo{}{bar}") == cluster_key_slot("bar")) {
+    return fail("test_redis_cluster_slots_and_redirects_parse", "key slots should follow hash tags");
+  }
+
+  ClusterRedirect redirect{};
+  if (!hw_agent::sinks::parse_cluster_redirect("MOVED 3999 10.0.0.7:6381", redirect) || redirect.ask ||
+      redirect.slot != 3999 || redirect.endpoint != ClusterEndpoint{"10.0.0.7", 6381} ||
+      !hw_agent::sinks::parse_cluster_redirect("ASK 12 fe80::1:7000", redirect) || !redirect.ask ||
+      redirect.endpoint != ClusterEndpoint{"fe80::1", 7000} ||
+      hw_agent::sinks::parse_cluster_redirect("ERR MOVED", redirect) ||
+      hw_agent::sinks::parse_cluster_redirect("MOVED 16384 a:1", redirect)) {
+    return fail("test_redis_cluster_slots_and_redirects_parse", "MOVED/ASK replies should parse");
+  }
+
+  // [[0, 8191, ["10.0.0.1", 7000, id]], [8192, 16383, ["", 7001, id]]]
+  redisReply first{}, last{}, host{}, port{}, master{}, range{};
+  redisReply* master_fields[] = {&host, &port};
+  host.type = REDIS_REPLY_STRING;
+  host.str = const_cast<char*>("10.0.0.1");
+  host.len = 8;
+  port.type = REDIS_REPLY_INTEGER;
+  port.integer = 7000;
+  master.type = REDIS_REPLY_ARRAY;
+  master.elements = 2;
+  master.element = master_fields;
+  first.type = last.type = REDIS_REPLY_INTEGER;
+  last.integer = 8191;
+  redisReply* range_fields[] = {&first, &last, &master};
+  range.type = REDIS_REPLY_ARRAY;
+  range.elements = 3;
+  range.element = range_fields;
+  redisReply second_first{}, second_last{}, second_host{}, second_port{}, second_master{}, second_range{};
+  redisReply* second_master_fields[] = {&second_host, &second_port};
+  second_host.type = REDIS_REPLY_STRING;
+  second_host.str = const_cast<char*>("");
+  second_port.type = REDIS_REPLY_INTEGER;
+  second_port.integer = 7001;
+  second_master.type = REDIS_REPLY_ARRAY;
+  second_master.elements = 2;
+  second_master.element = second_master_fields;
+  second_first.type = second_last.type = REDIS_REPLY_INTEGER;
+  second_first.integer = 8192;
+  second_last.integer = 16383;
+  redisReply* second_range_fields[] = {&second_first, &second_last, &second_master};
+  second_range.type = REDIS_REPLY_ARRAY;
+  second_range.elements = 3;
+  second_range.element = second_range_fields;
+  redisReply* table_fields[] = {&range, &second_range};
+  redisReply table{};
+  table.type = REDIS_REPLY_ARRAY;
+  table.elements = 2;
+  table.element = table_fields;
+
+  ClusterSlotMap map;
+  redisReply status{};
+  status.type = REDIS_REPLY_STATUS;
+  if (map.update(&status, "seed") || !map.update(&table, "seed") || map.owner(100) == nullptr ||
+      *map.owner(100) != ClusterEndpoint{"10.0.0.1", 7000} || *map.owner(12182) != ClusterEndpoint{"seed", 7001}) {
+    return fail("test_redis_cluster_slots_and_redirects_parse", "CLUSTER SLOTS should map slot ranges");
+  }
+  map.assign(100, {"10.0.0.9", 7009});
+  if (*map.owner(100) != ClusterEndpoint{"10.0.0.9", 7009} || *map.owner(99) != ClusterEndpoint{"10.0.0.1", 7000} ||
+      *map.owner(101) != ClusterEndpoint{"10.0.0.1", 7000}) {
+    return fail("test_redis_cluster_slots_and_redirects_parse", "MOVED should move one slot");
+  }
+  return 0;
+}
+
+int test_redis_cluster_follows_moved_and_ask() {
+  g_redis_mock = {};
+
+  RedisTsOptions options;
+  options.host = "10.0.0.1";
+  options.port = 7000;
+  options.cluster = true;
+  options.node_label = "edge-01";
+  options.enabled_metrics = {"raw:cpu", "risk:state"};
+
+  RedisTsSink sink(options);
+  signal_frame frame{};
+  if (!sink.publish(frame) || g_redis_mock.connects.back() != "10.0.0.1:7000" ||
+      g_redis_mock.last_argv.size() != 7 || g_redis_mock.last_argv[1] != "{edge-01}:raw:cpu" ||
+      g_redis_mock.last_argv[4] != "{edge-01}:risk:state") {
+    return fail("test_redis_cluster_follows_moved_and_ask", "keys should carry the node hash tag");
+  }
+  const bool asked_for_slots = std::any_of(g_redis_mock.commands.begin(), g_redis_mock.commands.end(),
+                                           [](const std::vector<std::string>& argv) {
+                                             return argv.size() == 2 && argv[0] == "CLUSTER" && argv[1] == "SLOTS";
+                                           });
+  if (!asked_for_slots) {
+    return fail("test_redis_cluster_follows_moved_and_ask", "the handshake should fetch CLUSTER SLOTS");
+  }
+
+  const std::string slot = std::to_string(hw_agent::sinks::cluster_key_slot("{edge-01}"));
+  g_redis_mock.error_replies.push_back("MOVED " + slot + " 10.0.0.7:7002");
+  if (sink.publish(frame)) {
+    return fail("test_redis_cluster_follows_moved_and_ask", "a MOVED frame is not written");
+  }
+  if (!sink.publish(frame) || g_redis_mock.connects.back() != "10.0.0.7:7002" ||
+      g_redis_mock.appended_commands.back() != "TS.MADD") {
+    return fail("test_redis_cluster_follows_moved_and_ask", "MOVED should reconnect to the new owner at once");
+  }
+
+  g_redis_mock.error_replies.push_back("ASK " + slot + " 10.0.0.8:7003");
+  (void)sink.publish(frame);
+  if (!sink.publish(frame) || g_redis_mock.connects.back() != "10.0.0.8:7003") {
+    return fail("test_redis_cluster_follows_moved_and_ask", "ASK should reconnect to the importing node");
+  }
+  const auto& sent = g_redis_mock.appended_commands;
+  if (sent.size() < 2 || sent[sent.size() - 1] != "TS.MADD" || sent[sent.size() - 2] != "ASKING" ||
+      std::count(sent.begin(), sent.end(), "TS.CREATE") != 2) {
+    return fail("test_redis_cluster_follows_moved_and_ask", "frames to an importing node need ASKING");
+  }
+  return 0;
+}
+
+int test_frame_spool_wraps_and_survives_reopen() {
+  const std::string path = (std::filesystem::temp_directory_path() / "hw_agent_spool_wrap_test.bin").string();
+  std::filesystem::remove(path);
+  const std::uint64_t layout = FrameSpool::layout_hash({"a", "b"});
+  // Header (64 bytes) plus room for exactly three 24-byte frames.
+  const std::size_t max_bytes = 64 + (3 * 24) + 10;
+  {
+    FrameSpool spool(path, layout, 2, max_bytes);
+    if (!spool.is_open() || spool.capacity() != 3) {
+      return fail("test_frame_spool_wraps_and_survives_reopen", "spool should hold three frames");
+    }
+    for (std::uint64_t i = 0; i < 5; ++i) {
+      const double values[2] = {static_cast<double>(i), static_cast<double>(i) * 10.0};
+      spool.push(1000 + i, values);
+    }
+    if (spool.size() != 3 || spool.overwritten() != 2 || spool.first_sequence() != 2) {
+      return fail("test_frame_spool_wraps_and_survives_reopen", "oldest frames should be overwritten when full");
+    }
+  }
+  {
+    FrameSpool spool(path, layout, 2, max_bytes);
+    std::uint64_t timestamp_ms = 0;
+    double values[2] = {};
+    if (spool.size() != 3 || !spool.read(0, timestamp_ms, values) || timestamp_ms != 1002 || values[1] != 20.0 ||
+        !spool.read(2, timestamp_ms, values) || timestamp_ms != 1004) {
+      return fail("test_frame_spool_wraps_and_survives_reopen", "frames should survive a reopen in order");
+    }
+    spool.release_until(spool.first_sequence() + 2);
+    if (spool.size() != 1 || !spool.read(0, timestamp_ms, values) || timestamp_ms != 1004 || values[0] != 4.0) {
+      return fail("test_frame_spool_wraps_and_survives_reopen", "release should drop the oldest frames only");
+    }
+  }
+  {
+    FrameSpool spool(path, FrameSpool::layout_hash({"b", "a"}), 2, max_bytes);
+    if (spool.size() != 0) {
+      return fail("test_frame_spool_wraps_and_survives_reopen", "a different series layout should start empty");
+    }
+  }
+  std::filesystem::remove(path);
+  return 0;
+}
+
+int test_redis_spool_backfills_after_outage_and_restart() {
+  g_redis_mock = {};
+  g_redis_mock.refuse_connections = true;
+  const std::string path = (std::filesystem::temp_directory_path() / "hw_agent_spool_outage_test.bin").string();
+  std::filesystem::remove(path);
+
+  RedisTsOptions options;
+  options.key_prefix = "edge:test";
+  options.enabled_metrics = {"raw:cpu", "raw:memory"};
+  options.spool_path = path;
+  options.spool_drain_frames = 2;
+  // Retry on every tick instead of backing off.
+  options.reconnect_min_ms = 1;
+  options.reconnect_max_ms = 1;
+
+  signal_frame frame{};
+  std::string outage_timestamp;
+  {
+    RedisTsSink sink(options);
+    for (int i = 0; i < 2; ++i) {
+      frame.cpu = static_cast<float>(i + 1);
+      if (sink.publish(frame)) {
+        return fail("test_redis_spool_backfills_after_outage_and_restart", "publish should fail during the outage");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+  // The agent restarts while Redis is still down; the spool keeps what the first run could not send.
+  RedisTsSink sink(options);
+  frame.cpu = 3.0F;
+  if (sink.publish(frame)) {
+    return fail("test_redis_spool_backfills_after_outage_and_restart", "publish should fail during the outage");
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+  g_redis_mock.refuse_connections = false;
+  frame.cpu = 4.0F;
+  if (!sink.publish(frame) || frame.agent.redis_spooled != 3) {
+    return fail("test_redis_spool_backfills_after_outage_and_restart", "three frames should be spooled");
+  }
+  const std::vector<std::string>& backfill = g_redis_mock.last_argv;
+  // Live frame first, then one backfill TS.MADD capped at spool_drain_frames frames.
+  if (g_redis_mock.madd_calls != 2 || backfill.size() != 13 || backfill[1] != "edge:test:raw:cpu" ||
+      std::strtod(backfill[3].c_str(), nullptr) != 1.0 || std::strtod(backfill[9].c_str(), nullptr) != 2.0 ||
+      !(backfill[2] < backfill[8])) {
+    return fail("test_redis_spool_backfills_after_outage_and_restart", "backfill should replay the oldest frames first");
+  }
+  outage_timestamp = backfill[8];
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  frame.cpu = 5.0F;
+  if (!sink.publish(frame) || frame.agent.redis_spooled != 1 || g_redis_mock.madd_calls != 4 ||
+      g_redis_mock.last_argv.size() != 7 || std::strtod(g_redis_mock.last_argv[3].c_str(), nullptr) != 3.0 ||
+      !(outage_timestamp < g_redis_mock.last_argv[2])) {
+    return fail("test_redis_spool_backfills_after_outage_and_restart", "the restart's frame should be backfilled next");
+  }
+  if (!sink.publish(frame) || frame.agent.redis_spooled != 0 || g_redis_mock.madd_calls != 5) {
+    return fail("test_redis_spool_backfills_after_outage_and_restart", "the spool should be empty after the backfill");
+  }
+  std::filesystem::remove(path);
+  return 0;
+}
+
 int test_end_to_end_sensor_to_sink_pipeline() {
   g_redis_mock = {};
 
@@ -707,7 +2073,8 @@ int test_end_to_end_sensor_to_sink_pipeline() {
       found_saturation = true;
     }
     if (g_redis_mock.last_argv[i] == "edge:test:risk:state") {
-      found_state = g_redis_mock.last_argv[i + 2] == "2.000000" || g_redis_mock.last_argv[i + 2] == "3.000000";
+      const double state = std::strtod(g_redis_mock.last_argv[i + 2].c_str(), nullptr);
+      found_state = state == 2.0 || state == 3.0;
     }
   }
 
@@ -724,6 +2091,9 @@ int main() {
   if (int rc = test_memory_sensor_parser(); rc != 0) return rc;
   if (int rc = test_memory_pressure_computation_and_ema(); rc != 0) return rc;
   if (int rc = test_thermal_pressure_warning_window_configurable(); rc != 0) return rc;
+  if (int rc = test_scheduler_pressure_includes_softnet_starvation(); rc != 0) return rc;
+  if (int rc = test_scheduler_pressure_prefers_measured_run_delay(); rc != 0) return rc;
+  if (int rc = test_latency_jitter_prefers_measured_wakeup_latency(); rc != 0) return rc;
   if (int rc = test_sampler_should_sample_every(); rc != 0) return rc;
   if (int rc = test_sensor_dispatches_once_per_tick(); rc != 0) return rc;
   if (int rc = test_config_parsing_edge_cases(); rc != 0) return rc;
@@ -732,6 +2102,23 @@ int main() {
   if (int rc = test_redis_sink_publish_logic(); rc != 0) return rc;
   if (int rc = test_redis_health_metrics_include_error_counter(); rc != 0) return rc;
   if (int rc = test_gpu_memory_and_emc_metrics_are_distinct(); rc != 0) return rc;
+  if (int rc = test_redis_async_sink_bounds_in_flight_frames(); rc != 0) return rc;
+  if (int rc = test_madd_template_renders_fixed_width_fields(); rc != 0) return rc;
+  if (int rc = test_redis_frame_publish_does_not_allocate(); rc != 0) return rc;
+  if (int rc = test_redis_change_only_publishes_refreshed_series(); rc != 0) return rc;
+  if (int rc = test_redis_batching_keeps_timestamps_and_flushes_on_state_change(); rc != 0) return rc;
+  if (int rc = test_redis_sync_reply_wait_fits_in_a_tick(); rc != 0) return rc;
+  if (int rc = test_redis_targets_service_independently(); rc != 0) return rc;
+  if (int rc = test_redis_schema_labels_series_and_creates_compactions(); rc != 0) return rc;
+  if (int rc = test_redis_blackhole_outage_keeps_tick_cadence(); rc != 0) return rc;
+  if (int rc = test_frame_codec_round_trips_and_tolerates_other_versions(); rc != 0) return rc;
+  if (int rc = test_redis_frame_stream_xadds_binary_frame(); rc != 0) return rc;
+  if (int rc = test_redis_perf_per_cpu_series(); rc != 0) return rc;
+  if (int rc = test_redis_events_publish_transitions_immediately(); rc != 0) return rc;
+  if (int rc = test_redis_cluster_slots_and_redirects_parse(); rc != 0) return rc;
+  if (int rc = test_redis_cluster_follows_moved_and_ask(); rc != 0) return rc;
+  if (int rc = test_frame_spool_wraps_and_survives_reopen(); rc != 0) return rc;
+  if (int rc = test_redis_spool_backfills_after_outage_and_restart(); rc != 0) return rc;
   if (int rc = test_end_to_end_sensor_to_sink_pipeline(); rc != 0) return rc;
 
   std::cout << "[PASS] agent unit tests\n";
@@ -0,0 +1,302 @@
+// Minimal libnvidia-ml stand-in: enough of the NVML ABI for sensors::gpu::make_nvml_sensor.
+
+#include "nvml_stub.hpp"
+
+#include <array>
+
+namespace {
+
+using nvmlReturn_t = int;
+
+constexpr nvmlReturn_t kSuccess = 0;
+constexpr nvmlReturn_t kInvalidArgument = 2;
+constexpr nvmlReturn_t kNotSupported = 3;
+constexpr nvmlReturn_t kNotFound = 6;
+constexpr nvmlReturn_t kInsufficientSize = 7;
+constexpr nvmlReturn_t kUnknown = 999;
+constexpr unsigned int kMaxDevices = 16;
+constexpr unsigned int kMaxProcesses = 64;
+
+struct nvmlDevice_st {
+  unsigned int index;
+};
+
+struct Utilization {
+  unsigned int gpu;
+  unsigned int memory;
+};
+
+struct Memory {
+  unsigned long long total;
+  unsigned long long free;
+  unsigned long long used;
+};
+
+union Value {
+  double dVal;
+  unsigned int uiVal;
+  unsigned long ulVal;
+  unsigned long long ullVal;
+  signed long long sllVal;
+};
+
+struct ProcessUtilizationSample {
+  unsigned int pid;
+  unsigned long long timeStamp;
+  unsigned int smUtil;
+  unsigned int memUtil;
+  unsigned int encUtil;
+  unsigned int decUtil;
+};
+
+struct ProcessInfo {
+  unsigned int pid;
+  unsigned long long usedGpuMemory;
+  unsigned int gpuInstanceId;
+  unsigned int computeInstanceId;
+};
+
+struct FieldValue {
+  unsigned int fieldId;
+  unsigned int scopeId;
+  long long timestamp;
+  long long latencyUsec;
+  int valueType;
+  nvmlReturn_t nvmlReturn;
+  Value value;
+};
+
+unsigned int g_device_count = 0;
+std::array<NvmlStubDevice, kMaxDevices> g_devices{};
+std::array<nvmlDevice_st, kMaxDevices> g_handles{};
+NvmlStubCalls g_calls{};
+std::array<NvmlStubProcess, kMaxProcesses> g_processes{};
+unsigned int g_process_count = 0;
+
+NvmlStubDevice* lookup(nvmlDevice_st* handle) {
+  if (handle == nullptr || handle->index >= g_device_count || g_devices[handle->index].fail) {
+    return nullptr;
+  }
+  return &g_devices[handle->index];
+}
+
+}  // namespace
+
+extern "C" {
+
+void nvml_stub_reset(const unsigned int device_count) {
+  g_device_count = device_count < kMaxDevices ? device_count : kMaxDevices;
+  g_devices = {};
+  g_calls = {};
+  g_process_count = 0;
+  for (unsigned int i = 0; i < kMaxDevices; ++i) {
+    g_handles[i].index = i;
+  }
+}
+
+void nvml_stub_set_device(const unsigned int index, const NvmlStubDevice* device) {
+  if (index < kMaxDevices && device != nullptr) {
+    g_devices[index] = *device;
+  }
+}
+
+void nvml_stub_get_calls(NvmlStubCalls* calls) {
+  if (calls != nullptr) {
+    *calls = g_calls;
+  }
+}
+
+void nvml_stub_set_processes(const NvmlStubProcess* processes, const unsigned int count) {
+  g_process_count = count < kMaxProcesses ? count : kMaxProcesses;
+  for (unsigned int i = 0; i < g_process_count; ++i) {
+    g_processes[i] = processes[i];
+  }
+}
+
+nvmlReturn_t nvmlInit_v2() { return kSuccess; }
+
+nvmlReturn_t nvmlShutdown() { return kSuccess; }
+
+nvmlReturn_t nvmlDeviceGetCount_v2(unsigned int* count) {
+  *count = g_device_count;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetHandleByIndex_v2(const unsigned int index, nvmlDevice_st** device) {
+  if (index >= g_device_count) {
+    return kInvalidArgument;
+  }
+  *device = &g_handles[index];
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetUtilizationRates(nvmlDevice_st* handle, Utilization* util) {
+  ++g_calls.utilization;
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  util->gpu = device->util_gpu;
+  util->memory = device->util_memory;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetMemoryInfo(nvmlDevice_st* handle, Memory* memory) {
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  memory->total = device->memory_total;
+  memory->free = device->memory_free;
+  memory->used = device->memory_total - device->memory_free;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetTemperature(nvmlDevice_st* handle, unsigned int /*sensor*/, unsigned int* temp) {
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  *temp = device->temp_c;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetClockInfo(nvmlDevice_st* handle, unsigned int /*type*/, unsigned int* clock) {
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  *clock = device->graphics_clock_mhz;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetMaxClockInfo(nvmlDevice_st* handle, unsigned int /*type*/, unsigned int* clock) {
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  *clock = device->max_graphics_clock_mhz;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetPowerUsage(nvmlDevice_st* handle, unsigned int* power) {
+  ++g_calls.power_usage;
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  *power = device->power_usage_mw;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetEnforcedPowerLimit(nvmlDevice_st* handle, unsigned int* limit) {
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  *limit = device->power_limit_mw;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetCurrentClocksThrottleReasons(nvmlDevice_st* handle, unsigned long long* reasons) {
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  *reasons = device->throttle_reasons;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetFieldValues(nvmlDevice_st* handle, const int count, FieldValue* values) {
+  ++g_calls.field_values;
+  const NvmlStubDevice* device = lookup(handle);
+  if (device == nullptr) {
+    return kUnknown;
+  }
+  for (int i = 0; i < count; ++i) {
+    FieldValue& field = values[i];
+    field.nvmlReturn = kSuccess;
+    field.timestamp = device->energy_timestamp_us;
+    switch (field.fieldId) {
+      case 83:  // NVML_FI_DEV_TOTAL_ENERGY_CONSUMPTION
+        field.valueType = 3;
+        field.value.ullVal = device->total_energy_mj;
+        field.nvmlReturn = device->energy_timestamp_us != 0 ? kSuccess : kNotSupported;
+        break;
+      case 186:  // NVML_FI_DEV_POWER_INSTANT
+        field.valueType = 1;
+        field.value.uiVal = device->power_instant_mw;
+        field.nvmlReturn = device->power_instant_mw != 0 ? kSuccess : kNotSupported;
+        break;
+      case 190:  // NVML_FI_DEV_POWER_CURRENT_LIMIT
+        field.valueType = 1;
+        field.value.uiVal = device->power_current_limit_mw;
+        field.nvmlReturn = device->power_current_limit_mw != 0 ? kSuccess : kNotSupported;
+        break;
+      default:
+        field.nvmlReturn = kNotSupported;
+        break;
+    }
+  }
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetProcessUtilization(nvmlDevice_st* handle, ProcessUtilizationSample* samples,
+                                             unsigned int* count, const unsigned long long last_seen) {
+  ++g_calls.process_utilization;
+  if (lookup(handle) == nullptr) {
+    return kUnknown;
+  }
+  unsigned int matching = 0;
+  for (unsigned int i = 0; i < g_process_count; ++i) {
+    matching += g_processes[i].device == handle->index && g_processes[i].timestamp_us > last_seen ? 1U : 0U;
+  }
+  if (matching == 0) {
+    *count = 0;
+    return kNotFound;
+  }
+  if (samples == nullptr || *count < matching) {
+    *count = matching;
+    return kInsufficientSize;
+  }
+  unsigned int out = 0;
+  for (unsigned int i = 0; i < g_process_count; ++i) {
+    const NvmlStubProcess& process = g_processes[i];
+    if (process.device == handle->index && process.timestamp_us > last_seen) {
+      samples[out++] = {process.pid, process.timestamp_us, process.sm_util, process.mem_util, 0, 0};
+    }
+  }
+  *count = out;
+  return kSuccess;
+}
+
+nvmlReturn_t nvmlDeviceGetComputeRunningProcesses_v3(nvmlDevice_st* handle, unsigned int* count, ProcessInfo* infos) {
+  ++g_calls.compute_processes;
+  if (lookup(handle) == nullptr) {
+    return kUnknown;
+  }
+  unsigned int matching = 0;
+  for (unsigned int i = 0; i < g_process_count; ++i) {
+    matching += g_processes[i].device == handle->index ? 1U : 0U;
+  }
+  if (*count < matching) {
+    *count = matching;
+    return kInsufficientSize;
+  }
+  // Entries repeated to model several utilization samples are one running process.
+  unsigned int out = 0;
+  for (unsigned int i = 0; i < g_process_count; ++i) {
+    const NvmlStubProcess& process = g_processes[i];
+    bool seen = false;
+    for (unsigned int j = 0; j < out; ++j) {
+      seen = seen || infos[j].pid == process.pid;
+    }
+    if (process.device == handle->index && !seen) {
+      infos[out++] = {process.pid, process.used_gpu_memory, 0, 0};
+    }
+  }
+  *count = out;
+  return kSuccess;
+}
+
+}  // extern "C"
@@ -0,0 +1,48 @@
+#pragma once
+
+// Control interface of the stub libnvidia-ml used by the GPU sensor tests. The test resolves these
+// symbols with dlsym on the same handle the sensor dlopens, so both sides share one stub state.
+
+struct NvmlStubDevice {
+  unsigned int util_gpu;
+  unsigned int util_memory;
+  unsigned long long memory_total;
+  unsigned long long memory_free;
+  unsigned int temp_c;
+  unsigned int graphics_clock_mhz;
+  unsigned int max_graphics_clock_mhz;
+  unsigned int power_usage_mw;
+  unsigned int power_limit_mw;
+  unsigned long long throttle_reasons;
+  // Field-value results; 0 for energy/timestamp means "not supported" on this device.
+  unsigned long long total_energy_mj;
+  long long energy_timestamp_us;
+  unsigned int power_instant_mw;
+  unsigned int power_current_limit_mw;
+  bool fail;
+};
+
+// One process running on a device; returned by both process queries.
+struct NvmlStubProcess {
+  unsigned int device;
+  unsigned int pid;
+  unsigned int sm_util;
+  unsigned int mem_util;
+  unsigned long long used_gpu_memory;
+  unsigned long long timestamp_us;
+};
+
+struct NvmlStubCalls {
+  unsigned int field_values;
+  unsigned int power_usage;
+  unsigned int utilization;
+  unsigned int process_utilization;
+  unsigned int compute_processes;
+};
+
+extern "C" {
+using NvmlStubReset = void (*)(unsigned int device_count);
+using NvmlStubSetDevice = void (*)(unsigned int index, const NvmlStubDevice* device);
+using NvmlStubGetCalls = void (*)(NvmlStubCalls* calls);
+using NvmlStubSetProcesses = void (*)(const NvmlStubProcess* processes, unsigned int count);
+}
@@ -1,32 +1,83 @@
+#include <atomic>
 #include <cmath>
 #include <cstdio>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <new>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include <dlfcn.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "model/signal_frame.hpp"
+#include "nvml_stub.hpp"
 #include "sensors/cpu.hpp"
 #include "sensors/cpufreq.hpp"
 #include "sensors/disk.hpp"
+#include "sensors/gpu/gpu.hpp"
+#include "sensors/jetson_sysfs.hpp"
+#include "sensors/netstack.hpp"
+#include "sensors/perf_events.hpp"
 #include "sensors/power.hpp"
+#include "sensors/process_attribution.hpp"
+#include "sensors/powercap.hpp"
 #include "sensors/psi.hpp"
+#include "sensors/schedstat.hpp"
 #include "sensors/softirqs.hpp"
+#include "sensors/softnet.hpp"
+#include "sensors/tegrastats.hpp"
 #include "sensors/thermal.hpp"
+#include "sensors/wakeup_latency.hpp"
 
 using hw_agent::model::signal_frame;
 using hw_agent::sensors::CpuFreqSensor;
 using hw_agent::sensors::CpuSensor;
 using hw_agent::sensors::DiskSensor;
+using hw_agent::sensors::JetsonSysfsSensor;
 using hw_agent::sensors::CpuThrottleSensor;
+using hw_agent::sensors::NetStackSensor;
+using hw_agent::sensors::PerfEventSensor;
+using hw_agent::sensors::PowerCapSensor;
+using hw_agent::sensors::ProcessAttribution;
+using hw_agent::sensors::ProcessAttributionOptions;
 using hw_agent::sensors::PsiSensor;
+using hw_agent::sensors::SchedstatSensor;
 using hw_agent::sensors::SoftirqsSensor;
+using hw_agent::sensors::SoftnetSensor;
+using hw_agent::sensors::TegraStatsSensor;
 using hw_agent::sensors::ThermalSensor;
+using hw_agent::sensors::LatencyHistogram;
+using hw_agent::sensors::WakeupLatencyOptions;
+using hw_agent::sensors::WakeupLatencyProbe;
+namespace gpu = hw_agent::sensors::gpu;
+
+namespace {
+
+std::atomic<std::size_t> g_allocations{0};
+
+}  // namespace
+
+void* operator new(const std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size != 0 ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
 
 namespace {
 
@@ -58,6 +109,13 @@ bool write_temp_file(std::FILE* file, const std::string& content) {
   return std::fseek(file, 0L, SEEK_SET) == 0;
 }
 
+// Writes a fake sysfs/procfs file, creating its directory.
+void write_fake_file(const std::filesystem::path& path, const std::string& content) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream out(path);
+  out << content;
+}
+
 int test_cpu_sensor_with_injected_proc_stat() {
   std::FILE* stat_file = std::tmpfile();
   if (!write_temp_file(stat_file, "cpu  100 20 30 400 50 0 0 0 0 0\n")) {
@@ -209,6 +267,792 @@ int test_thermal_sensor_with_lazy_opened_zone_does_not_keep_file_when_not_owned(
   return 0;
 }
 
+int test_thermal_sensor_hwmon_trip_points_and_slope() {
+  const auto root = std::filesystem::temp_directory_path() / "hw_agent_thermal_trip_points";
+  std::filesystem::remove_all(root);
+  const auto zone = root / "thermal" / "thermal_zone0";
+  const auto hwmon = root / "hwmon" / "hwmon0";
+  std::filesystem::create_directories(zone);
+  std::filesystem::create_directories(hwmon);
+
+  write_fake_file(zone / "type", "x86_pkg_temp\n");
+  write_fake_file(zone / "temp", "60000\n");
+  write_fake_file(zone / "trip_point_0_type", "active\n");
+  write_fake_file(zone / "trip_point_0_temp", "50000\n");
+  write_fake_file(zone / "trip_point_1_type", "passive\n");
+  write_fake_file(zone / "trip_point_1_temp", "95000\n");
+  write_fake_file(hwmon / "name", "nvme\n");
+  write_fake_file(hwmon / "temp1_label", "Composite\n");
+  write_fake_file(hwmon / "temp1_input", "40000\n");
+  write_fake_file(hwmon / "temp1_crit", "70000\n");
+
+  ThermalSensor sensor(85.0F, (root / "thermal").string(), (root / "hwmon").string());
+  signal_frame frame{};
+  frame.monotonic_ns = 1'000'000'000ULL;
+  if (!sensor.sample(frame) || sensor.zones().size() != 2) {
+    std::filesystem::remove_all(root);
+    return fail("test_thermal_sensor_hwmon_trip_points_and_slope", "thermal zone and hwmon sources should be discovered");
+  }
+
+  if (!almost_equal(frame.thermal, 30.0F) || sensor.raw().limiting_zone != "nvme:Composite" ||
+      sensor.raw().hottest_zone != "x86_pkg_temp") {
+    std::filesystem::remove_all(root);
+    return fail("test_thermal_sensor_hwmon_trip_points_and_slope", "headroom should use per-zone trips, not the active trip");
+  }
+
+  if (!almost_equal(frame.thermal_seconds_to_trip, ThermalSensor::kMaxSecondsToTrip)) {
+    std::filesystem::remove_all(root);
+    return fail("test_thermal_sensor_hwmon_trip_points_and_slope", "no projection expected before a slope exists");
+  }
+
+  write_fake_file(zone / "temp", "62000\n");
+  write_fake_file(hwmon / "temp1_input", "50000\n");
+  frame.monotonic_ns = 3'000'000'000ULL;
+  if (!sensor.sample(frame)) {
+    std::filesystem::remove_all(root);
+    return fail("test_thermal_sensor_hwmon_trip_points_and_slope", "second sample should succeed");
+  }
+
+  if (!almost_equal(frame.thermal_slope, 5.0F) || !almost_equal(frame.thermal_seconds_to_trip, 4.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_thermal_sensor_hwmon_trip_points_and_slope", "slope or seconds-to-trip mismatch");
+  }
+
+  write_fake_file(hwmon / "temp1_input", "72000\n");
+  frame.monotonic_ns = 5'000'000'000ULL;
+  if (!sensor.sample(frame) || !almost_equal(frame.thermal_seconds_to_trip, 0.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_thermal_sensor_hwmon_trip_points_and_slope", "a zone past its trip should report 0 seconds");
+  }
+
+  write_fake_file(zone / "temp", "garbage\n");
+  write_fake_file(hwmon / "temp1_input", "garbage\n");
+  frame.monotonic_ns = 7'000'000'000ULL;
+  if (sensor.sample(frame) || !almost_equal(frame.thermal_seconds_to_trip, ThermalSensor::kMaxSecondsToTrip)) {
+    std::filesystem::remove_all(root);
+    return fail("test_thermal_sensor_hwmon_trip_points_and_slope", "unreadable zones should not look like a trip");
+  }
+
+  std::filesystem::remove_all(root);
+  return 0;
+}
+
+int test_powercap_sensor_package_dram_watts_and_wraparound() {
+  const auto root = std::filesystem::temp_directory_path() / "hw_agent_powercap";
+  std::filesystem::remove_all(root);
+  const auto control = root / "intel-rapl";
+  const auto package = root / "intel-rapl:0";
+  const auto core = root / "intel-rapl:0:0";
+  const auto dram = root / "intel-rapl:0:2";
+  const auto mmio = root / "intel-rapl-mmio:0";
+  for (const auto& dir : {control, package, core, dram, mmio}) {
+    std::filesystem::create_directories(dir);
+  }
+
+  write_fake_file(control / "enabled", "1\n");
+  write_fake_file(package / "name", "package-0\n");
+  write_fake_file(package / "energy_uj", "10000000\n");
+  write_fake_file(package / "max_energy_range_uj", "262143328850\n");
+  write_fake_file(package / "constraint_0_name", "long_term\n");
+  write_fake_file(package / "constraint_0_power_limit_uw", "100000000\n");
+  write_fake_file(package / "constraint_1_name", "short_term\n");
+  write_fake_file(package / "constraint_1_power_limit_uw", "150000000\n");
+  write_fake_file(core / "name", "core\n");
+  write_fake_file(core / "energy_uj", "0\n");
+  write_fake_file(dram / "name", "dram\n");
+  write_fake_file(dram / "energy_uj", "999000000\n");
+  write_fake_file(dram / "max_energy_range_uj", "1000000000\n");
+  write_fake_file(mmio / "name", "package-0\n");
+  write_fake_file(mmio / "energy_uj", "0\n");
+
+  PowerCapSensor sensor(root.string());
+  signal_frame frame{};
+  frame.monotonic_ns = 1'000'000'000ULL;
+  if (!sensor.sample(frame) || sensor.zones().size() != 2) {
+    std::filesystem::remove_all(root);
+    return fail("test_powercap_sensor_package_dram_watts_and_wraparound",
+                "only the MSR package and DRAM zones should be discovered");
+  }
+
+  if (!almost_equal(frame.rapl_package_watts, 0.0F) || !almost_equal(frame.rapl_dram_watts, 0.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_powercap_sensor_package_dram_watts_and_wraparound", "first sample should only baseline");
+  }
+
+  write_fake_file(package / "energy_uj", "60000000\n");
+  write_fake_file(dram / "energy_uj", "4000000\n");
+  frame.monotonic_ns = 2'000'000'000ULL;
+  if (!sensor.sample(frame)) {
+    std::filesystem::remove_all(root);
+    return fail("test_powercap_sensor_package_dram_watts_and_wraparound", "second sample should succeed");
+  }
+
+  if (!almost_equal(frame.rapl_package_watts, 50.0F) || !almost_equal(frame.rapl_package_limit_ratio, 0.5F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_powercap_sensor_package_dram_watts_and_wraparound", "package watts or PL1 ratio mismatch");
+  }
+
+  if (!almost_equal(frame.rapl_dram_watts, 5.0F) || !almost_equal(frame.rapl_dram_limit_ratio, 0.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_powercap_sensor_package_dram_watts_and_wraparound",
+                "DRAM watts should handle max_energy_range_uj wraparound");
+  }
+
+  std::filesystem::remove_all(root);
+  return 0;
+}
+
+// Pipes stand in for perf_event group fds: each write is one PERF_FORMAT_GROUP read() record.
+int test_perf_event_sensor_group_records_per_cpu() {
+  int cpu0_sw[2] = {-1, -1};
+  int cpu1_sw[2] = {-1, -1};
+  int cpu1_hw[2] = {-1, -1};
+  if (::pipe(cpu0_sw) != 0 || ::pipe(cpu1_sw) != 0 || ::pipe(cpu1_hw) != 0) {
+    return fail("test_perf_event_sensor_group_records_per_cpu", "failed creating pipes");
+  }
+
+  const auto write_record = [](const int fd, const std::vector<std::uint64_t>& words) {
+    const auto bytes = static_cast<ssize_t>(words.size() * sizeof(std::uint64_t));
+    return ::write(fd, words.data(), static_cast<std::size_t>(bytes)) == bytes;
+  };
+  const auto close_all = [&]() {
+    for (int fd : {cpu0_sw[0], cpu0_sw[1], cpu1_sw[0], cpu1_sw[1], cpu1_hw[0], cpu1_hw[1]}) {
+      ::close(fd);
+    }
+  };
+
+  std::vector<PerfEventSensor::CpuGroup> groups(2);
+  groups[0].cpu = 0;
+  groups[0].software_fd = cpu0_sw[0];
+  groups[1].cpu = 1;
+  groups[1].software_fd = cpu1_sw[0];
+  groups[1].hardware_fd = cpu1_hw[0];
+  PerfEventSensor sensor(std::move(groups), false);
+  if (!sensor.available() || !sensor.hardware_available()) {
+    close_all();
+    return fail("test_perf_event_sensor_group_records_per_cpu", "injected groups should be available");
+  }
+
+  // {nr, cpu_clock_ns, context_switches, migrations, major_faults}
+  // {nr, time_enabled, time_running, instructions, cycles, cache_misses}
+  if (!write_record(cpu0_sw[1], {4, 1'000'000'000, 100, 10, 0}) ||
+      !write_record(cpu1_sw[1], {4, 1'000'000'000, 200, 20, 5}) ||
+      !write_record(cpu1_hw[1], {3, 1'000'000'000, 1'000'000'000, 1000, 1000, 50})) {
+    close_all();
+    return fail("test_perf_event_sensor_group_records_per_cpu", "failed writing first records");
+  }
+
+  signal_frame frame{};
+  frame.monotonic_ns = 1'000'000'000ULL;
+  if (!sensor.sample(frame) || !almost_equal(frame.perf_context_switches, 0.0F) ||
+      !almost_equal(frame.perf_hot_cpu, -1.0F)) {
+    close_all();
+    return fail("test_perf_event_sensor_group_records_per_cpu", "first sample should only baseline");
+  }
+
+  // cpu0 counted for 500 ms, cpu1 for 1 s; the hardware group ran half of its enabled time.
+  if (!write_record(cpu0_sw[1], {4, 1'500'000'000, 600, 60, 1}) ||
+      !write_record(cpu1_sw[1], {4, 2'000'000'000, 400, 30, 7}) ||
+      !write_record(cpu1_hw[1], {3, 2'000'000'000, 1'500'000'000, 4000, 3000, 150})) {
+    close_all();
+    return fail("test_perf_event_sensor_group_records_per_cpu", "failed writing second records");
+  }
+
+  frame.monotonic_ns = 2'000'000'000ULL;
+  if (!sensor.sample(frame)) {
+    close_all();
+    return fail("test_perf_event_sensor_group_records_per_cpu", "second sample should succeed");
+  }
+
+  const auto& per_cpu = sensor.raw().per_cpu;
+  if (per_cpu.size() != 2 || !almost_equal(per_cpu[0].context_switches_per_sec, 1000.0F) ||
+      !almost_equal(per_cpu[0].migrations_per_sec, 100.0F) || !almost_equal(per_cpu[1].major_faults_per_sec, 2.0F)) {
+    close_all();
+    return fail("test_perf_event_sensor_group_records_per_cpu", "per-CPU rates should use the cpu-clock window");
+  }
+
+  if (!almost_equal(frame.perf_context_switches, 1200.0F) || !almost_equal(frame.perf_migrations, 110.0F) ||
+      !almost_equal(frame.perf_major_faults, 4.0F) || !almost_equal(frame.perf_hot_cpu, 0.0F)) {
+    close_all();
+    return fail("test_perf_event_sensor_group_records_per_cpu", "aggregate rates mismatch");
+  }
+
+  if (!almost_equal(frame.perf_ipc, 1.5F) || !almost_equal(frame.perf_llc_misses, 200.0F)) {
+    close_all();
+    return fail("test_perf_event_sensor_group_records_per_cpu", "IPC or multiplex-scaled cache misses mismatch");
+  }
+
+  close_all();
+  return 0;
+}
+
+int test_schedstat_sensor_run_delay_per_cpu() {
+  std::FILE* file = std::tmpfile();
+  if (!write_temp_file(file,
+                       "version 15\n"
+                       "timestamp 4295000000\n"
+                       "cpu0 0 0 0 0 0 0 1000000000 0 100\n"
+                       "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n"
+                       "cpu1 0 0 0 0 0 0 1000000000 0 100\n"
+                       "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n")) {
+    return fail("test_schedstat_sensor_run_delay_per_cpu", "failed writing first schedstat snapshot");
+  }
+
+  SchedstatSensor sensor(file, false);
+  signal_frame frame{};
+  frame.monotonic_ns = 1'000'000'000ULL;
+  if (!sensor.sample(frame) || sensor.raw().cpu_count != 2 || sensor.raw().version != 15) {
+    return fail("test_schedstat_sensor_run_delay_per_cpu", "cpu rows should parse and domain rows be skipped");
+  }
+
+  // cpu1 waited 400 ms over 200 timeslices in a 2 s window; cpu0 waited 20 ms over 100.
+  if (!write_temp_file(file,
+                       "version 15\n"
+                       "timestamp 4295000500\n"
+                       "cpu0 0 0 0 0 0 0 2000000000 20000000 200\n"
+                       "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n"
+                       "cpu1 0 0 0 0 0 0 2000000000 400000000 300\n"
+                       "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n")) {
+    return fail("test_schedstat_sensor_run_delay_per_cpu", "failed writing second schedstat snapshot");
+  }
+
+  frame.monotonic_ns = 3'000'000'000ULL;
+  if (!sensor.sample(frame)) {
+    return fail("test_schedstat_sensor_run_delay_per_cpu", "second sample should succeed");
+  }
+
+  if (!almost_equal(sensor.raw().per_cpu[0].run_delay_ms_per_sec, 10.0F) ||
+      !almost_equal(sensor.raw().per_cpu[1].timeslices_per_sec, 100.0F) ||
+      !almost_equal(sensor.raw().per_cpu[1].wait_per_timeslice_us, 2000.0F)) {
+    return fail("test_schedstat_sensor_run_delay_per_cpu", "per-CPU rates mismatch");
+  }
+
+  if (!almost_equal(frame.sched_run_delay, 105.0F) || !almost_equal(frame.sched_run_delay_p99, 200.0F) ||
+      !almost_equal(frame.sched_run_delay_max, 200.0F) || !almost_equal(frame.sched_worst_cpu, 1.0F)) {
+    return fail("test_schedstat_sensor_run_delay_per_cpu", "aggregate run delay mismatch");
+  }
+
+  if (!almost_equal(frame.sched_wait_per_slice_us, 1400.0F)) {
+    return fail("test_schedstat_sensor_run_delay_per_cpu", "average wait per timeslice mismatch");
+  }
+
+  std::fclose(file);
+  return 0;
+}
+
+int test_process_attribution_top_offenders_across_ticks() {
+  const auto root = std::filesystem::temp_directory_path() / "hw_agent_fake_proc";
+  std::filesystem::remove_all(root);
+  std::filesystem::create_directories(root / "self");
+  std::filesystem::create_directories(root / "100");
+  std::filesystem::create_directories(root / "200");
+
+  // Fields: pid (comm) state ppid pgrp session tty tpgid flags minflt cminflt majflt cmajflt utime stime ...
+  const auto write_process = [&](const char* pid, const char* comm, int majflt, int utime, int stime,
+                                 std::uint64_t io_bytes, std::uint64_t run_delay_ns) {
+    write_fake_file(root / pid / "stat", std::string(pid) + " (" + comm + ") R 1 1 1 0 -1 0 0 0 " +
+                                             std::to_string(majflt) + " 0 " + std::to_string(utime) + " " +
+                                             std::to_string(stime) + " 0 0 20 0 1 0\n");
+    write_fake_file(root / pid / "io", "rchar: 0\nwchar: 0\nsyscr: 0\nsyscw: 0\nread_bytes: " +
+                                           std::to_string(io_bytes) + "\nwrite_bytes: 0\ncancelled_write_bytes: 0\n");
+    write_fake_file(root / pid / "schedstat", "1000 " + std::to_string(run_delay_ns) + " 10\n");
+  };
+  write_process("100", "web (worker)", 0, 100, 0, 0, 0);
+  write_process("200", "db", 0, 100, 0, 0, 0);
+
+  ProcessAttributionOptions options{};
+  options.proc_root = root.string();
+  options.top_n = 1;
+  options.cpu_budget_pct = 100.0F;
+  options.max_pids_per_step = 1;
+  ProcessAttribution attribution(options);
+
+  signal_frame frame{};
+  frame.state = hw_agent::model::system_state::STABLE;
+  frame.monotonic_ns = 1'000'000'000ULL;
+  if (attribution.step(frame) || attribution.active()) {
+    std::filesystem::remove_all(root);
+    return fail("test_process_attribution_top_offenders_across_ticks", "STABLE state should not start a scan");
+  }
+
+  // Baseline pass: one PID per step, then the end-of-directory step closes the pass.
+  frame.state = hw_agent::model::system_state::DEGRADED;
+  for (int tick = 0; tick < 3; ++tick) {
+    if (attribution.step(frame)) {
+      std::filesystem::remove_all(root);
+      return fail("test_process_attribution_top_offenders_across_ticks", "baseline pass must not produce a report");
+    }
+  }
+
+  write_process("100", "web (worker)", 40, 150, 50, 0, 1'000'000);
+  write_process("200", "db", 2, 120, 0, 8'000'000, 500'000'000);
+  frame.monotonic_ns = 2'000'000'000ULL;
+  bool reported = false;
+  for (int tick = 0; tick < 3 && !reported; ++tick) {
+    reported = attribution.step(frame);
+  }
+
+  const auto& report = attribution.report();
+  if (!reported || report.processes != 2 || report.steps != 3) {
+    std::filesystem::remove_all(root);
+    return fail("test_process_attribution_top_offenders_across_ticks", "second pass should report after three steps");
+  }
+
+  if (report.top_cpu.size() != 1 || report.top_cpu[0].pid != 100 ||
+      std::string(report.top_cpu[0].comm.data()) != "web (worker)" || !almost_equal(report.top_cpu[0].cpu_pct, 100.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_process_attribution_top_offenders_across_ticks", "CPU offender mismatch");
+  }
+
+  if (report.top_major_faults[0].pid != 100 || report.top_io[0].pid != 200 ||
+      !almost_equal(report.top_io[0].io_bytes_per_sec, 8'000'000.0F) || report.top_run_delay[0].pid != 200 ||
+      !almost_equal(report.top_run_delay[0].run_delay_ms_per_sec, 500.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_process_attribution_top_offenders_across_ticks", "fault, IO or run-delay offender mismatch");
+  }
+
+  frame.state = hw_agent::model::system_state::STABLE;
+  attribution.step(frame);
+  if (attribution.active()) {
+    std::filesystem::remove_all(root);
+    return fail("test_process_attribution_top_offenders_across_ticks", "returning to STABLE should release the scan");
+  }
+
+  std::filesystem::remove_all(root);
+  return 0;
+}
+
+int test_latency_histogram_buckets_and_percentiles() {
+  for (std::uint64_t value = 1; value < 100'000'000'000ULL; value = (value * 5) / 3 + 1) {
+    const std::uint64_t upper = LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_index(value));
+    if (upper < value || static_cast<double>(upper - value) > static_cast<double>(value) / 16.0) {
+      return fail("test_latency_histogram_buckets_and_percentiles", "bucket bound outside 1/16 of the value");
+    }
+  }
+
+  auto histogram = std::make_unique<LatencyHistogram>();
+  for (int i = 0; i < 990; ++i) {
+    histogram->record(10'000);
+  }
+  for (int i = 0; i < 9; ++i) {
+    histogram->record(200'000);
+  }
+  histogram->record(5'000'000);
+
+  LatencyHistogram::Snapshot counts{};
+  histogram->snapshot(counts);
+  const auto in_bucket_of = [](const std::uint64_t reported, const std::uint64_t value) {
+    return reported == LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_index(value));
+  };
+  if (!in_bucket_of(LatencyHistogram::percentile(counts, 1000, 0.50), 10'000) ||
+      !in_bucket_of(LatencyHistogram::percentile(counts, 1000, 0.99), 10'000) ||
+      !in_bucket_of(LatencyHistogram::percentile(counts, 1000, 0.999), 200'000) ||
+      !in_bucket_of(LatencyHistogram::percentile(counts, 1000, 1.0), 5'000'000)) {
+    return fail("test_latency_histogram_buckets_and_percentiles", "percentile bucket mismatch");
+  }
+
+  if (histogram->take_max() != 5'000'000 || histogram->take_max() != 0) {
+    return fail("test_latency_histogram_buckets_and_percentiles", "take_max should return and reset the max");
+  }
+
+  return 0;
+}
+
+int test_wakeup_latency_probe_records_windows() {
+  WakeupLatencyOptions options{};
+  options.cpus = {0};
+  options.policy = SCHED_OTHER;
+  options.interval = std::chrono::microseconds(200);
+  WakeupLatencyProbe probe(options);
+  probe.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+  probe.stop();
+
+  signal_frame frame{};
+  const bool sampled = probe.sample(frame);
+
+  const auto& latency = probe.raw().per_cpu.at(0);
+  if (!sampled || latency.cpu != 0 || latency.samples == 0) {
+    return fail("test_wakeup_latency_probe_records_windows", "probe thread should record wakeups");
+  }
+
+  if (!(latency.p50_us <= latency.p99_us && latency.p99_us <= latency.p999_us && latency.p999_us <= latency.max_us) ||
+      !almost_equal(frame.wakeup_latency_max_us, latency.max_us)) {
+    return fail("test_wakeup_latency_probe_records_windows", "percentiles should be ordered and bounded by max");
+  }
+
+  // Stopped threads add nothing, so the next window is empty.
+  if (probe.sample(frame) || frame.wakeup_latency_max_us != 0.0F) {
+    return fail("test_wakeup_latency_probe_records_windows", "window after stop should be empty");
+  }
+
+  return 0;
+}
+
+int test_tegrastats_parser_ring_buffer_and_allocations() {
+  int fds[2]{};
+  if (pipe(fds) != 0 || fcntl(fds[0], F_SETFL, O_NONBLOCK) != 0) {
+    return fail("test_tegrastats_parser_ring_buffer_and_allocations", "pipe setup failed");
+  }
+  TegraStatsSensor sensor(fds[0], false);
+  const auto write_all = [&](const std::string_view text) {
+    return ::write(fds[1], text.data(), text.size()) == static_cast<ssize_t>(text.size());
+  };
+  const auto close_pipe = [&]() {
+    close(fds[0]);
+    close(fds[1]);
+  };
+
+  const std::string orin_nano =
+      "10-02-2024 16:40:11 RAM 3102/7620MB (lfb 2x4MB) SWAP 0/3810MB (cached 0MB) "
+      "CPU [4%@1510,2%@1510,1%@1510,3%@1510,0%@729,0%@729] EMC_FREQ 5%@2133 GR3D_FREQ 37%@[624] "
+      "cpu@47.343C soc2@45.375C soc0@46.187C gpu@45.906C tj@47.343C soc1@45.406C VDD_IN 4628mW/4628mW "
+      "VDD_CPU_GPU_CV 593mW/593mW VDD_SOC 1344mW/1344mW\n";
+
+  // A line split across reads is only parsed once its newline arrives.
+  signal_frame frame{};
+  if (!write_all(orin_nano.substr(0, 120)) || !sensor.sample(frame) || sensor.raw().gpu_util_pct != 0.0F ||
+      !write_all(orin_nano.substr(120)) || !sensor.sample(frame)) {
+    close_pipe();
+    return fail("test_tegrastats_parser_ring_buffer_and_allocations", "split line handling failed");
+  }
+
+  const float* vdd_in = sensor.raw().rail_power_mw.find("VDD_IN");
+  const float* gpu_temp = sensor.raw().temperatures_c.find("gpu");
+  if (!almost_equal(frame.tegra_gpu_util, 37.0F) || !almost_equal(frame.tegra_emc_util, 5.0F) ||
+      !almost_equal(frame.tegra_gpu_power_mw, 6565.0F) || vdd_in == nullptr || !almost_equal(*vdd_in, 4628.0F) ||
+      gpu_temp == nullptr || !almost_equal(*gpu_temp, 45.906F, 1e-3F) || sensor.raw().temperatures_c.size() != 6) {
+    close_pipe();
+    return fail("test_tegrastats_parser_ring_buffer_and_allocations", "Orin Nano fields mismatch");
+  }
+
+  // Push well past the ring size so lines wrap around its end; the last line wins.
+  const std::string xavier_nx =
+      "RAM 2462/7772MB (lfb 867x4MB) SWAP 0/3886MB (cached 0MB) CPU [6%@1190,3%@1190,2%@1190,4%@1190,off,off] "
+      "EMC_FREQ 0% GR3D_FREQ 12% AUX@32.5C CPU@34.5C thermal@33.3C AO@32.5C GPU@33C PMIC@100C\n";
+  for (int i = 0; i < 64; ++i) {
+    if (!write_all(xavier_nx) || !sensor.sample(frame) || !almost_equal(frame.tegra_gpu_util, 12.0F)) {
+      close_pipe();
+      return fail("test_tegrastats_parser_ring_buffer_and_allocations", "wrapped line parse mismatch");
+    }
+  }
+  if (!almost_equal(frame.tegra_gpu_temp, 33.0F) || !almost_equal(frame.tegra_emc_util, 0.0F)) {
+    close_pipe();
+    return fail("test_tegrastats_parser_ring_buffer_and_allocations", "Xavier NX fields mismatch");
+  }
+
+  // A line longer than the ring is dropped whole; parsing resumes at the next line.
+  const std::string overlong(9000, 'x');
+  const std::size_t allocations_before = g_allocations.load(std::memory_order_relaxed);
+  if (!write_all(overlong) || !sensor.sample(frame) || !write_all(" GR3D_FREQ 99%\nEMC_FREQ 7%@1600\n") ||
+      !sensor.sample(frame)) {
+    close_pipe();
+    return fail("test_tegrastats_parser_ring_buffer_and_allocations", "overlong line write failed");
+  }
+  const std::size_t allocations = g_allocations.load(std::memory_order_relaxed) - allocations_before;
+
+  if (sensor.raw().overlong_lines != 1 || !almost_equal(frame.tegra_gpu_util, 12.0F) ||
+      !almost_equal(frame.tegra_emc_util, 7.0F)) {
+    close_pipe();
+    return fail("test_tegrastats_parser_ring_buffer_and_allocations", "overlong line should be skipped");
+  }
+
+  if (allocations != 0 || !sensor.parse_line(orin_nano) ||
+      g_allocations.load(std::memory_order_relaxed) - allocations_before != 0) {
+    close_pipe();
+    return fail("test_tegrastats_parser_ring_buffer_and_allocations", "sampling and parsing must not allocate");
+  }
+
+  close_pipe();
+  return 0;
+}
+
+int test_jetson_sysfs_sensor_with_fake_tree() {
+  const auto root = std::filesystem::temp_directory_path() / "hw_agent_fake_jetson_sys";
+  std::filesystem::remove_all(root);
+
+  write_fake_file(root / "class/devfreq/17000000.ga10b/device/load", "437\n");
+  write_fake_file(root / "kernel/actmon_avg_activity/mc_all", "800000\n");
+  write_fake_file(root / "kernel/debug/clk/emc/clk_rate", "1600000000\n");
+  write_fake_file(root / "class/hwmon/hwmon0/name", "coretemp\n");
+  write_fake_file(root / "class/hwmon/hwmon1/name", "ina3221\n");
+  write_fake_file(root / "class/hwmon/hwmon1/in1_label", "VDD_IN\n");
+  write_fake_file(root / "class/hwmon/hwmon1/in1_input", "5000\n");
+  write_fake_file(root / "class/hwmon/hwmon1/curr1_input", "1000\n");
+  write_fake_file(root / "class/hwmon/hwmon1/in2_label", "VDD_CPU_GPU_CV\n");
+  write_fake_file(root / "class/hwmon/hwmon1/in2_input", "5000\n");
+  write_fake_file(root / "class/hwmon/hwmon1/curr2_input", "200\n");
+  write_fake_file(root / "class/thermal/thermal_zone0/type", "cpu-thermal\n");
+  write_fake_file(root / "class/thermal/thermal_zone0/temp", "51250\n");
+  write_fake_file(root / "class/thermal/thermal_zone1/type", "gpu-thermal\n");
+  write_fake_file(root / "class/thermal/thermal_zone1/temp", "45500\n");
+  write_fake_file(root / "class/thermal/thermal_zone2/type", "GPU-therm\n");
+  write_fake_file(root / "class/thermal/thermal_zone2/temp", "-256000\n");
+
+  JetsonSysfsSensor sensor(root.string());
+  signal_frame frame{};
+  if (!sensor.available() || sensor.rails().size() != 2 || sensor.zones().size() != 3 || !sensor.sample(frame)) {
+    std::filesystem::remove_all(root);
+    return fail("test_jetson_sysfs_sensor_with_fake_tree", "discovery should find devfreq, INA3221 and zones");
+  }
+
+  if (!almost_equal(frame.tegra_gpu_util, 43.7F) || !almost_equal(frame.tegra_emc_util, 50.0F) ||
+      !almost_equal(frame.tegra_gpu_power_mw, 6000.0F) || !almost_equal(frame.tegra_gpu_temp, 45.5F) ||
+      sensor.rails()[0].label != "VDD_CPU_GPU_CV" || !almost_equal(sensor.rails()[0].power_mw, 1000.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_jetson_sysfs_sensor_with_fake_tree", "derived Jetson fields mismatch");
+  }
+
+  // Files stay open across samples; rewritten values must be re-read, not replayed from the buffer.
+  write_fake_file(root / "class/devfreq/17000000.ga10b/device/load", "1000\n");
+  write_fake_file(root / "class/hwmon/hwmon1/curr1_input", "2000\n");
+  if (!sensor.sample(frame) || !almost_equal(frame.tegra_gpu_util, 100.0F) ||
+      !almost_equal(frame.tegra_gpu_power_mw, 11000.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_jetson_sysfs_sensor_with_fake_tree", "second sample should see updated values");
+  }
+
+  std::filesystem::remove_all(root);
+
+  JetsonSysfsSensor missing((std::filesystem::temp_directory_path() / "hw_agent_no_such_sys").string());
+  if (missing.available()) {
+    return fail("test_jetson_sysfs_sensor_with_fake_tree", "empty root should not look like a Jetson");
+  }
+
+  return 0;
+}
+
+int test_nvml_multi_gpu_sensor_with_stub_library() {
+  // Same path the sensor dlopens, so this handle shares the stub's device table.
+  void* stub = dlopen(HW_AGENT_NVML_STUB_PATH, RTLD_NOW);
+  if (stub == nullptr) {
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "failed to load stub libnvidia-ml");
+  }
+  const auto reset = reinterpret_cast<NvmlStubReset>(dlsym(stub, "nvml_stub_reset"));
+  const auto set_device = reinterpret_cast<NvmlStubSetDevice>(dlsym(stub, "nvml_stub_set_device"));
+  const auto get_calls = reinterpret_cast<NvmlStubGetCalls>(dlsym(stub, "nvml_stub_get_calls"));
+  if (reset == nullptr || set_device == nullptr || get_calls == nullptr) {
+    dlclose(stub);
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "stub control symbols missing");
+  }
+
+  constexpr unsigned long long kMiB = 1024ULL * 1024ULL;
+  NvmlStubDevice idle{10, 5, 80000 * kMiB, 70000 * kMiB, 40, 700, 1400, 90000, 300000, 0, 0, 0, 60000, 300000, false};
+  NvmlStubDevice busy{97, 60, 80000 * kMiB, 2000 * kMiB, 78, 1400, 1400, 250000, 300000, 0, 0, 0, 240000, 300000, false};
+  // Hotter-running but not hottest: the power-capped device is still the worst one.
+  NvmlStubDevice capped{90, 40, 80000 * kMiB, 30000 * kMiB, 71, 980, 1400, 200000, 300000, 0x4ULL,
+                        1'000'000, 5'000'000, 0, 250000, false};
+  reset(3);
+  set_device(0, &idle);
+  set_device(1, &busy);
+  set_device(2, &capped);
+
+  gpu::NvmlOptions options{};
+  options.library = HW_AGENT_NVML_STUB_PATH;
+  auto sensor = gpu::make_nvml_sensor(options);
+  signal_frame frame{};
+  if (!sensor->available() || !sensor->collect(frame) || sensor->devices().size() != 3) {
+    dlclose(stub);
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "all stub devices should be monitored");
+  }
+
+  NvmlStubCalls calls{};
+  get_calls(&calls);
+  // Power comes from the batched field query (instant power on the first pass): no extra per-call reads.
+  if (calls.field_values != 3 || calls.power_usage != 1) {
+    dlclose(stub);
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "expected one field query per device");
+  }
+
+  if (!almost_equal(frame.nvml_gpu_util, 97.0F) || !almost_equal(frame.gpu_mem_free, 2000.0F) ||
+      !almost_equal(frame.nvml_gpu_temp, 78.0F) || !almost_equal(frame.nvml_gpu_power_ratio, 0.8F) ||
+      !almost_equal(frame.gpu_throttle, 1.0F) || !almost_equal(frame.nvml_gpu_throttled, 1.0F) ||
+      !almost_equal(frame.nvml_gpu_devices, 3.0F) || !almost_equal(frame.nvml_gpu_worst_device, 2.0F) ||
+      !almost_equal(frame.gpu_clock_ratio, 0.7F)) {
+    dlclose(stub);
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "worst-device aggregates mismatch");
+  }
+
+  // Device 2 exposes an energy counter: the second pass averages power over the window.
+  // 300 J over 1.5 s is 200 W against a 250 W limit.
+  capped.total_energy_mj += 300'000;
+  capped.energy_timestamp_us += 1'500'000;
+  set_device(2, &capped);
+  if (!sensor->collect(frame) || !almost_equal(sensor->devices()[2].power_mw, 200000.0F, 1.0F) ||
+      !almost_equal(sensor->devices()[2].power_ratio, 0.8F)) {
+    dlclose(stub);
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "energy-averaged power mismatch");
+  }
+
+  // A failing device drops out without failing the others.
+  busy.fail = true;
+  set_device(1, &busy);
+  if (!sensor->collect(frame) || sensor->devices().size() != 2 || !almost_equal(frame.nvml_gpu_util, 90.0F)) {
+    dlclose(stub);
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "failed device should be skipped");
+  }
+
+  options.devices = {1, 7};
+  auto pinned = gpu::make_nvml_sensor(options);
+  busy.fail = false;
+  set_device(1, &busy);
+  if (!pinned->available() || !pinned->collect(frame) || pinned->devices().size() != 1 ||
+      pinned->devices()[0].index != 1U || !almost_equal(frame.nvml_gpu_worst_device, 1.0F)) {
+    dlclose(stub);
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "configured device list should be honored");
+  }
+
+  gpu::NvmlOptions missing{};
+  missing.library = "libhw-agent-no-such-nvml.so.1";
+  if (gpu::make_nvml_sensor(missing)->available()) {
+    dlclose(stub);
+    return fail("test_nvml_multi_gpu_sensor_with_stub_library", "missing library should be unavailable");
+  }
+
+  dlclose(stub);
+  return 0;
+}
+
+int test_nvml_process_utilization_maps_pids_to_cgroups() {
+  void* stub = dlopen(HW_AGENT_NVML_STUB_PATH, RTLD_NOW);
+  if (stub == nullptr) {
+    return fail("test_nvml_process_utilization_maps_pids_to_cgroups", "failed to load stub libnvidia-ml");
+  }
+  const auto reset = reinterpret_cast<NvmlStubReset>(dlsym(stub, "nvml_stub_reset"));
+  const auto set_device = reinterpret_cast<NvmlStubSetDevice>(dlsym(stub, "nvml_stub_set_device"));
+  const auto set_processes = reinterpret_cast<NvmlStubSetProcesses>(dlsym(stub, "nvml_stub_set_processes"));
+  const auto get_calls = reinterpret_cast<NvmlStubGetCalls>(dlsym(stub, "nvml_stub_get_calls"));
+  if (reset == nullptr || set_device == nullptr || set_processes == nullptr || get_calls == nullptr) {
+    dlclose(stub);
+    return fail("test_nvml_process_utilization_maps_pids_to_cgroups", "stub control symbols missing");
+  }
+
+  const auto proc = std::filesystem::temp_directory_path() / "hw_agent_fake_gpu_proc";
+  std::filesystem::remove_all(proc);
+  const std::string pod = "/kubepods.slice/kubepods-pod1.slice/cri-containerd-aaa.scope";
+  write_fake_file(proc / "100/cgroup", "0::" + pod + "\n");
+  write_fake_file(proc / "101/cgroup", "0::" + pod + "\n");
+  // cgroup v1 host: first hierarchy wins.
+  write_fake_file(proc / "200/cgroup", "12:cpu,cpuacct:/docker/bbb\n11:memory:/docker/bbb\n");
+
+  constexpr unsigned long long kMiB = 1024ULL * 1024ULL;
+  const NvmlStubDevice device{50, 10, 80000 * kMiB, 40000 * kMiB, 60, 1000, 1400, 100000, 300000, 0,
+                              0, 0, 100000, 300000, false};
+  reset(2);
+  set_device(0, &device);
+  set_device(1, &device);
+  // PID 100 has two samples in the window (averaged); PID 300 holds memory but has no samples and
+  // no /proc entry.
+  const NvmlStubProcess processes[] = {
+      {0, 100, 40, 10, 2048 * kMiB, 10}, {0, 100, 60, 30, 2048 * kMiB, 20}, {1, 101, 30, 5, 1024 * kMiB, 15},
+      {0, 200, 20, 2, 512 * kMiB, 12},   {1, 300, 0, 0, 256 * kMiB, 0},
+  };
+  set_processes(processes, 5);
+
+  gpu::NvmlOptions options{};
+  options.library = HW_AGENT_NVML_STUB_PATH;
+  options.proc_root = proc.string();
+  auto sensor = gpu::make_nvml_sensor(options);
+  std::vector<gpu::GpuWorkload> workloads;
+  if (!sensor->available() || !sensor->collect_workloads(workloads) || workloads.size() != 3) {
+    std::filesystem::remove_all(proc);
+    dlclose(stub);
+    return fail("test_nvml_process_utilization_maps_pids_to_cgroups", "expected three workloads");
+  }
+
+  if (workloads[0].cgroup != pod || workloads[0].processes != 2U || !almost_equal(workloads[0].sm_util, 80.0F) ||
+      !almost_equal(workloads[0].mem_util, 25.0F) || !almost_equal(workloads[0].fb_used_mb, 3072.0F) ||
+      workloads[1].cgroup != "/docker/bbb" || !almost_equal(workloads[1].sm_util, 20.0F) ||
+      workloads[2].cgroup != "<unknown>" || !almost_equal(workloads[2].fb_used_mb, 256.0F)) {
+    std::filesystem::remove_all(proc);
+    dlclose(stub);
+    return fail("test_nvml_process_utilization_maps_pids_to_cgroups", "per-cgroup aggregation mismatch");
+  }
+
+  // No samples newer than the last window: SM time drops to zero, framebuffer usage remains.
+  if (!sensor->collect_workloads(workloads) || workloads.size() != 3 || workloads[0].cgroup != pod ||
+      !almost_equal(workloads[0].sm_util, 0.0F) || !almost_equal(workloads[0].fb_used_mb, 3072.0F)) {
+    std::filesystem::remove_all(proc);
+    dlclose(stub);
+    return fail("test_nvml_process_utilization_maps_pids_to_cgroups", "second window should only carry memory");
+  }
+
+  NvmlStubCalls calls{};
+  get_calls(&calls);
+  // Each buffer grows once on the first device; everything after reuses it.
+  if (calls.process_utilization != 5 || calls.compute_processes != 5) {
+    std::filesystem::remove_all(proc);
+    dlclose(stub);
+    return fail("test_nvml_process_utilization_maps_pids_to_cgroups", "unexpected NVML process query count");
+  }
+
+  std::filesystem::remove_all(proc);
+  dlclose(stub);
+  return 0;
+}
+
+int test_drm_gpu_sensor_with_fake_tree() {
+  const auto root = std::filesystem::temp_directory_path() / "hw_agent_fake_drm_sys";
+  std::filesystem::remove_all(root);
+
+  // card0: amdgpu dGPU. card1: i915 iGPU, GT-throttled. card0-DP-1: connector, must be skipped.
+  const auto amd = root / "class/drm/card0/device";
+  write_fake_file(amd / "gpu_busy_percent", "64\n");
+  write_fake_file(amd / "mem_info_vram_total", "17163091968\n");
+  write_fake_file(amd / "mem_info_vram_used", "4290772992\n");
+  write_fake_file(amd / "pp_dpm_sclk", "0: 500Mhz \n1: 1800Mhz *\n2: 2400Mhz \n");
+  write_fake_file(amd / "hwmon/hwmon3/temp1_input", "67000\n");
+  write_fake_file(amd / "hwmon/hwmon3/power1_average", "150000000\n");
+  write_fake_file(amd / "hwmon/hwmon3/power1_cap", "300000000\n");
+  const auto intel = root / "class/drm/card1";
+  write_fake_file(intel / "device/vendor", "0x8086\n");
+  write_fake_file(intel / "gt_act_freq_mhz", "650\n");
+  write_fake_file(intel / "gt_RP0_freq_mhz", "1300\n");
+  write_fake_file(intel / "gt/gt0/throttle_reason_status", "1\n");
+  write_fake_file(root / "class/drm/card0-DP-1/status", "connected\n");
+
+  auto sensor = gpu::make_drm_sensor(root.string());
+  signal_frame frame{};
+  if (!sensor->available() || !sensor->collect(frame) || sensor->devices().size() != 2 ||
+      std::string(sensor->source()) != "drm") {
+    std::filesystem::remove_all(root);
+    return fail("test_drm_gpu_sensor_with_fake_tree", "discovery should find the amdgpu and i915 cards");
+  }
+
+  const gpu::GpuDeviceSample& amd_sample = sensor->devices()[0];
+  if (!almost_equal(amd_sample.util, 64.0F) || !almost_equal(amd_sample.mem_util, 25.0F, 0.01F) ||
+      !almost_equal(amd_sample.mem_free_mb, 12276.0F) || !almost_equal(amd_sample.temp_c, 67.0F) ||
+      !almost_equal(amd_sample.clock_ratio, 0.75F) || !almost_equal(amd_sample.power_ratio, 0.5F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_drm_gpu_sensor_with_fake_tree", "amdgpu fields mismatch");
+  }
+
+  // The throttled i915 GT is the worst card even though the amdgpu card is busier and hotter.
+  if (!almost_equal(frame.drm_gpu_util, 64.0F) || !almost_equal(frame.gpu_temp, 67.0F) ||
+      !almost_equal(frame.drm_gpu_clock_ratio, 0.5F) || !almost_equal(frame.gpu_throttle, 1.0F) ||
+      !almost_equal(frame.drm_gpu_power_ratio, 0.5F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_drm_gpu_sensor_with_fake_tree", "worst-card aggregates mismatch");
+  }
+
+  write_fake_file(amd / "gpu_busy_percent", "99\n");
+  write_fake_file(amd / "pp_dpm_sclk", "0: 500Mhz \n1: 1800Mhz \n2: 2400Mhz *\n");
+  if (!sensor->collect(frame) || !almost_equal(frame.drm_gpu_util, 99.0F) ||
+      !almost_equal(sensor->devices()[0].clock_ratio, 1.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_drm_gpu_sensor_with_fake_tree", "second collect should see updated values");
+  }
+
+  std::filesystem::remove_all(root);
+
+  if (gpu::make_drm_sensor((std::filesystem::temp_directory_path() / "hw_agent_no_such_drm").string())->available()) {
+    return fail("test_drm_gpu_sensor_with_fake_tree", "empty root should have no DRM GPUs");
+  }
+
+  return 0;
+}
+
 int test_cpu_throttle_sensor_with_injected_throttle_files() {
   std::FILE* core0 = std::tmpfile();
   std::FILE* pkg0 = std::tmpfile();
@@ -250,7 +1094,7 @@ int test_cpufreq_sensor_with_injected_scaling_cur_freq_files() {
     return fail("test_cpufreq_sensor_with_injected_scaling_cur_freq_files", "failed writing first cpufreq snapshot");
   }
 
-  CpuFreqSensor sensor({cpu0, cpu1}, false);
+  CpuFreqSensor sensor({{"policy0", cpu0, nullptr, 0}, {"policy1", cpu1, nullptr, 0}}, false);
   signal_frame frame{};
   if (!sensor.sample(frame) || !almost_equal(frame.cpufreq, 1500.0F)) {
     return fail("test_cpufreq_sensor_with_injected_scaling_cur_freq_files", "first average MHz mismatch");
@@ -269,6 +1113,57 @@ int test_cpufreq_sensor_with_injected_scaling_cur_freq_files() {
   return 0;
 }
 
+int test_cpufreq_sensor_policy_ratios_and_caps() {
+  const auto root = std::filesystem::temp_directory_path() / "hw_agent_cpufreq_policies";
+  std::filesystem::remove_all(root);
+  const auto policy0 = root / "policy0";
+  const auto policy4 = root / "policy4";
+  std::filesystem::create_directories(policy0);
+  std::filesystem::create_directories(policy4);
+
+  write_fake_file(policy0 / "cpuinfo_max_freq", "4000000\n");
+  write_fake_file(policy0 / "scaling_max_freq", "4000000\n");
+  write_fake_file(policy0 / "scaling_cur_freq", "3000000\n");
+  write_fake_file(policy4 / "cpuinfo_max_freq", "2000000\n");
+  write_fake_file(policy4 / "scaling_max_freq", "2000000\n");
+  write_fake_file(policy4 / "scaling_cur_freq", "1000000\n");
+
+  CpuFreqSensor sensor(root.string());
+  signal_frame frame{};
+  if (!sensor.sample(frame) || sensor.policies().size() != 2) {
+    std::filesystem::remove_all(root);
+    return fail("test_cpufreq_sensor_policy_ratios_and_caps", "both policies should be discovered");
+  }
+
+  if (!almost_equal(frame.cpufreq, 2000.0F) || !almost_equal(frame.cpufreq_min_ratio, 0.5F) ||
+      !almost_equal(frame.cpufreq_avg_ratio, 0.625F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_cpufreq_sensor_policy_ratios_and_caps", "ratio of current to hardware max mismatch");
+  }
+
+  if (!almost_equal(frame.cpufreq_capped, 0.0F) || !almost_equal(frame.cpufreq_cap_depth, 0.0F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_cpufreq_sensor_policy_ratios_and_caps", "uncapped policies should not report a cap");
+  }
+
+  // Thermal cooling device clamps policy0 to 60% of its hardware max.
+  write_fake_file(policy0 / "scaling_max_freq", "2400000\n");
+  write_fake_file(policy0 / "scaling_cur_freq", "2400000\n");
+  if (!sensor.sample(frame)) {
+    std::filesystem::remove_all(root);
+    return fail("test_cpufreq_sensor_policy_ratios_and_caps", "second sample should succeed");
+  }
+
+  if (!almost_equal(frame.cpufreq_capped, 1.0F) || !almost_equal(frame.cpufreq_cap_depth, 0.4F) ||
+      !almost_equal(frame.cpufreq_avg_ratio, 0.55F)) {
+    std::filesystem::remove_all(root);
+    return fail("test_cpufreq_sensor_policy_ratios_and_caps", "cap detection mismatch");
+  }
+
+  std::filesystem::remove_all(root);
+  return 0;
+}
+
 int test_cpufreq_sensor_returns_failure_when_all_sources_are_unreadable() {
   std::FILE* cpu0 = std::tmpfile();
   std::FILE* cpu1 = std::tmpfile();
@@ -277,7 +1172,7 @@ int test_cpufreq_sensor_returns_failure_when_all_sources_are_unreadable() {
                 "failed writing unreadable cpufreq snapshots");
   }
 
-  CpuFreqSensor sensor({cpu0, cpu1}, false);
+  CpuFreqSensor sensor({{"policy0", cpu0, nullptr, 0}, {"policy1", cpu1, nullptr, 0}}, false);
   signal_frame frame{};
   if (sensor.sample(frame)) {
     return fail("test_cpufreq_sensor_returns_failure_when_all_sources_are_unreadable",
@@ -400,6 +1295,107 @@ int test_psi_sensor_with_injected_pressure_files() {
   return 0;
 }
 
+int test_netstack_sensor_with_injected_proc_net_files() {
+  std::FILE* snmp = std::tmpfile();
+  std::FILE* netstat = std::tmpfile();
+  std::FILE* sockstat = std::tmpfile();
+  std::FILE* tcp_mem = std::tmpfile();
+
+  const auto snmp_snapshot = [](int retrans, int rcvbuf, int sndbuf) {
+    return "Ip: Forwarding DefaultTTL\nIp: 1 64\n"
+           "Tcp: RtoAlgorithm RtoMin RtoMax MaxConn OutSegs RetransSegs InErrs\n"
+           "Tcp: 1 200 120000 -1 5000 " + std::to_string(retrans) + " 0\n"
+           "Udp: InDatagrams NoPorts InErrors OutDatagrams RcvbufErrors SndbufErrors\n"
+           "Udp: 10 0 0 10 " + std::to_string(rcvbuf) + " " + std::to_string(sndbuf) + "\n"
+           "UdpLite: InDatagrams NoPorts InErrors OutDatagrams RcvbufErrors SndbufErrors\n"
+           "UdpLite: 0 0 0 0 999 999\n";
+  };
+  const auto netstat_snapshot = [](int overflows, int drops) {
+    return "TcpExt: SyncookiesSent ListenOverflows ListenDrops TCPTimeouts\n"
+           "TcpExt: 0 " + std::to_string(overflows) + " " + std::to_string(drops) + " 3\n"
+           "IpExt: InNoRoutes\nIpExt: 0\n";
+  };
+
+  if (!write_temp_file(snmp, snmp_snapshot(100, 4, 1)) || !write_temp_file(netstat, netstat_snapshot(7, 9)) ||
+      !write_temp_file(sockstat, "sockets: used 12\nTCP: inuse 5 orphan 0 tw 1 alloc 7 mem 300\nUDP: inuse 2 mem 4\n") ||
+      !write_temp_file(tcp_mem, "100 200 400\n")) {
+    return fail("test_netstack_sensor_with_injected_proc_net_files", "failed writing first proc/net snapshot");
+  }
+
+  NetStackSensor sensor(snmp, netstat, sockstat, tcp_mem, false);
+  signal_frame frame{};
+  frame.monotonic_ns = 1'000'000'000ULL;
+  if (!sensor.sample(frame) || !almost_equal(frame.tcp_retrans, 0.0F) || !almost_equal(frame.tcp_mem_ratio, 0.75F)) {
+    return fail("test_netstack_sensor_with_injected_proc_net_files", "first sample should initialize baseline");
+  }
+
+  if (sensor.raw().tcp_retrans_segs != 100 || sensor.raw().udp_rcvbuf_errors != 4 || sensor.raw().listen_drops != 9) {
+    return fail("test_netstack_sensor_with_injected_proc_net_files", "keyed table parsing mismatch");
+  }
+
+  if (!write_temp_file(snmp, snmp_snapshot(160, 10, 3)) || !write_temp_file(netstat, netstat_snapshot(11, 13))) {
+    return fail("test_netstack_sensor_with_injected_proc_net_files", "failed writing second proc/net snapshot");
+  }
+
+  frame.monotonic_ns = 3'000'000'000ULL;
+  if (!sensor.sample(frame)) {
+    return fail("test_netstack_sensor_with_injected_proc_net_files", "second sample should succeed");
+  }
+
+  if (!almost_equal(frame.tcp_retrans, 30.0F) || !almost_equal(frame.listen_drops, 2.0F) ||
+      !almost_equal(frame.udp_buf_errors, 4.0F)) {
+    return fail("test_netstack_sensor_with_injected_proc_net_files", "per-second rate mismatch");
+  }
+
+  std::fclose(snmp);
+  std::fclose(netstat);
+  std::fclose(sockstat);
+  std::fclose(tcp_mem);
+  return 0;
+}
+
+int test_softnet_sensor_parses_hex_columns_per_cpu() {
+  std::FILE* softnet = std::tmpfile();
+  if (!write_temp_file(softnet,
+                       "0000024d 00000000 00000000 00000000 00000000 00000000 00000000 00000000 00000000 00000000 "
+                       "00000000 00000000 00000000 00000005 00000000\n"
+                       "00001000 00000002 0000000a 00000000 00000000 00000000 00000000 00000000 00000000 00000000 "
+                       "00000000 00000000 00000002 00000007 00000000\n")) {
+    return fail("test_softnet_sensor_parses_hex_columns_per_cpu", "failed writing first softnet_stat snapshot");
+  }
+
+  SoftnetSensor sensor(softnet, false);
+  signal_frame frame{};
+  frame.monotonic_ns = 1'000'000'000ULL;
+  if (!sensor.sample(frame) || !almost_equal(frame.softnet_squeeze, 0.0F) || sensor.raw().cpu_count != 2) {
+    return fail("test_softnet_sensor_parses_hex_columns_per_cpu", "first sample should initialize baseline");
+  }
+
+  if (!write_temp_file(softnet,
+                       "0000024d 00000000 00000004 00000000 00000000 00000000 00000000 00000000 00000000 00000000 "
+                       "00000000 00000000 00000000 00000003 00000000\n"
+                       "00002000 00000012 0000001e 00000000 00000000 00000000 00000000 00000000 00000000 00000000 "
+                       "00000000 00000000 00000002 00000009 00000000\n")) {
+    return fail("test_softnet_sensor_parses_hex_columns_per_cpu", "failed writing second softnet_stat snapshot");
+  }
+
+  frame.monotonic_ns = 3'000'000'000ULL;
+  if (!sensor.sample(frame)) {
+    return fail("test_softnet_sensor_parses_hex_columns_per_cpu", "second sample should succeed");
+  }
+
+  if (!almost_equal(frame.softnet_squeeze, 12.0F) || !almost_equal(frame.softnet_drops, 8.0F)) {
+    return fail("test_softnet_sensor_parses_hex_columns_per_cpu", "squeeze/drop rate mismatch");
+  }
+
+  if (!almost_equal(frame.softnet_hot_cpu, 2.0F) || sensor.raw().hottest_cpu_events != 36) {
+    return fail("test_softnet_sensor_parses_hex_columns_per_cpu", "hottest CPU should use the cpu id column");
+  }
+
+  std::fclose(softnet);
+  return 0;
+}
+
 }  // namespace
 
 int main() {
@@ -418,12 +1414,51 @@ int main() {
   if (int rc = test_thermal_sensor_with_lazy_opened_zone_does_not_keep_file_when_not_owned(); rc != 0) {
     return rc;
   }
+  if (int rc = test_thermal_sensor_hwmon_trip_points_and_slope(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_powercap_sensor_package_dram_watts_and_wraparound(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_perf_event_sensor_group_records_per_cpu(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_schedstat_sensor_run_delay_per_cpu(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_process_attribution_top_offenders_across_ticks(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_latency_histogram_buckets_and_percentiles(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_wakeup_latency_probe_records_windows(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_tegrastats_parser_ring_buffer_and_allocations(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_jetson_sysfs_sensor_with_fake_tree(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_nvml_multi_gpu_sensor_with_stub_library(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_nvml_process_utilization_maps_pids_to_cgroups(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_drm_gpu_sensor_with_fake_tree(); rc != 0) {
+    return rc;
+  }
   if (int rc = test_cpu_throttle_sensor_with_injected_throttle_files(); rc != 0) {
     return rc;
   }
   if (int rc = test_cpufreq_sensor_with_injected_scaling_cur_freq_files(); rc != 0) {
     return rc;
   }
+  if (int rc = test_cpufreq_sensor_policy_ratios_and_caps(); rc != 0) {
+    return rc;
+  }
   if (int rc = test_cpufreq_sensor_returns_failure_when_all_sources_are_unreadable(); rc != 0) {
     return rc;
   }
@@ -433,6 +1468,12 @@ int main() {
   if (int rc = test_psi_sensor_with_injected_pressure_files(); rc != 0) {
     return rc;
   }
+  if (int rc = test_netstack_sensor_with_injected_proc_net_files(); rc != 0) {
+    return rc;
+  }
+  if (int rc = test_softnet_sensor_parses_hex_columns_per_cpu(); rc != 0) {
+    return rc;
+  }
 
   std::cout << "[PASS] sensors unit tests\n";
   return 0;